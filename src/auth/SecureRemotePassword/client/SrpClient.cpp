@@ -29,17 +29,114 @@
 #include "../auth/SecureRemotePassword/client/SrpClient.h"
 #include "../auth/SecureRemotePassword/srp.h"
 #include "../common/classes/ImplementHelper.h"
+#include "../common/classes/objects_array.h"
 
 using namespace Firebird;
 
+namespace {
+
+// Session resumption tickets received by this client, per server and database
+class Tickets
+{
+public:
+	explicit Tickets(MemoryPool& p)
+		: tickets(p)
+	{ }
+
+	void add(const PathName& target, const char* login, const string& password,
+		const string& id, const UCharBuffer& key, time_t expires)
+	{
+		MutexLockGuard g(mutex, FB_FUNCTION);
+
+		const FB_SIZE_T pos = lookup(target, login, password);
+		if (pos != NOT_FOUND)
+			tickets.remove(pos);
+
+		if (tickets.getCount() >= MAX_TICKETS)
+			tickets.remove((FB_SIZE_T) 0);
+
+		Ticket& ticket = tickets.add();
+		ticket.target = target;
+		ticket.login = login;
+		ticket.password = password;
+		ticket.id = id;
+		ticket.key = key;
+		ticket.expires = expires;
+	}
+
+	// Ticket is removed from cache when taken - it's returned back by add() when accepted by server
+	bool take(const PathName& target, const char* login, const string& password,
+		string& id, UCharBuffer& key, time_t& expires)
+	{
+		MutexLockGuard g(mutex, FB_FUNCTION);
+
+		const FB_SIZE_T pos = lookup(target, login, password);
+		if (pos == NOT_FOUND)
+			return false;
+
+		const Ticket& ticket = tickets[pos];
+		const bool valid = ticket.expires > time(NULL);
+		if (valid)
+		{
+			id = ticket.id;
+			key = ticket.key;
+			expires = ticket.expires;
+		}
+
+		tickets.remove(pos);
+		return valid;
+	}
+
+private:
+	static const FB_SIZE_T MAX_TICKETS = 64;
+	static const FB_SIZE_T NOT_FOUND = ~FB_SIZE_T(0);
+
+	FB_SIZE_T lookup(const PathName& target, const char* login, const string& password) const
+	{
+		for (FB_SIZE_T i = 0; i < tickets.getCount(); ++i)
+		{
+			if (tickets[i].target == target && tickets[i].login == login &&
+				tickets[i].password == password)
+			{
+				return i;
+			}
+		}
+
+		return NOT_FOUND;
+	}
+
+	struct Ticket
+	{
+		explicit Ticket(MemoryPool& p)
+			: target(p), login(p), password(p), id(p), key(p), expires(0)
+		{ }
+
+		PathName target;	// server and database
+		string login;
+		string password;	// hash, not a password itself
+		string id;
+		UCharBuffer key;
+		time_t expires;
+	};
+
+	ObjectsArray<Ticket> tickets;
+	Mutex mutex;
+};
+
+GlobalPtr<Tickets> tickets;
+
+} // anonymous namespace
+
 namespace Auth {
 
 class SrpClient : public StdPlugin<IClientImpl<SrpClient, CheckStatusWrapper> >
 {
 public:
-	explicit SrpClient(IPluginConfig*)
+	explicit SrpClient(IPluginConfig* par)
 		: client(NULL), data(getPool()),
-		  sessionKey(getPool())
+		  sessionKey(getPool()), iParameter(par),
+		  passwordHash(getPool()), clientNonce(getPool()), ticketId(getPool()),
+		  ticketTarget(getPool()), ticketExpires(0), ticketLifetime(0)
 	{ }
 
 	~SrpClient()
@@ -50,10 +147,18 @@ public:
 	// IClient implementation
 	int authenticate(CheckStatusWrapper*, IClientBlock* cb);
 
+private:
+	int sendProof(CheckStatusWrapper* status, IClientBlock* cb);
+
 private:
 	RemotePassword* client;
 	string data;
 	UCharBuffer sessionKey;
+	RefPtr<IPluginConfig> iParameter;
+	string passwordHash, clientNonce, ticketId;
+	PathName ticketTarget;
+	time_t ticketExpires;
+	unsigned ticketLifetime;
 
 protected:
     virtual RemotePassword* remotePasswordFactory() = 0;
@@ -77,7 +182,7 @@ int SrpClient::authenticate(CheckStatusWrapper* status, IClientBlock* cb)
 {
 	try
 	{
-		if (sessionKey.hasData())
+		if (sessionKey.hasData() && !clientNonce.hasData())
 		{
 			// Why are we called when auth is completed?
 			(Arg::Gds(isc_random) << "Auth sync failure - SRP's authenticate called more times than supported").raise();
@@ -95,6 +200,35 @@ int SrpClient::authenticate(CheckStatusWrapper* status, IClientBlock* cb)
 			client = remotePasswordFactory();
 			client->genClientKey(data);
 			dumpIt("Clnt: clientPubKey", data);
+
+			// tickets are bound to server and database, without them resumption is off
+			const char* target = cb->getTarget();
+			ticketLifetime = target ? getTicketLifetime(iParameter) : 0;
+			if (ticketLifetime)
+			{
+				ticketTarget = target;
+
+				// password is never kept in tickets cache, only its hash
+				client->getUserHash(cb->getLogin(), RemotePassword::plugName, cb->getPassword()).
+					getText(passwordHash);
+
+				// leading zero is skipped by any server when parsing hex public key
+				data.insert(data.begin(), RemotePassword::TICKET_MARKER);
+
+				// having a ticket means that server understands extended format
+				UCharBuffer ticketKey;
+				if (tickets->take(ticketTarget, cb->getLogin(), passwordHash,
+						ticketId, ticketKey, ticketExpires))
+				{
+					RemotePassword::genNonce(clientNonce);
+					data += RemotePassword::TICKET_SEPARATOR;
+					data.append(ticketId);
+					data += RemotePassword::TICKET_SEPARATOR;
+					data.append(clientNonce);
+					sessionKey = ticketKey;		// keep it till server's answer
+				}
+			}
+
 			cb->putData(status, data.length(), data.begin());
 
 			if (status->getState() & IStatus::STATE_ERRORS)
@@ -110,6 +244,40 @@ int SrpClient::authenticate(CheckStatusWrapper* status, IClientBlock* cb)
 		{
 			Arg::Gds(isc_auth_data).raise();
 		}
+
+		bool newTicket = false;
+		if (ticketLifetime)
+		{
+			if (*saltAndKey == RemotePassword::TICKET_RESUMED && clientNonce.hasData())
+			{
+				HANDSHAKE_DEBUG(fprintf(stderr, "Cli: SRP phase2 - resuming session by ticket\n"));
+
+				const string serverNonce(saltAndKey + 1, length - 1);
+				const UCharBuffer ticketKey(sessionKey);
+				tickets->add(ticketTarget, cb->getLogin(), passwordHash, ticketId, ticketKey, ticketExpires);
+				client->resumeSessionKey(sessionKey, ticketKey, clientNonce.c_str(), serverNonce.c_str());
+				dumpIt("Clnt: sessionKey", sessionKey);
+
+				BigInteger cProof = client->resumeProof(cb->getLogin(), clientNonce.c_str(),
+					serverNonce.c_str(), sessionKey);
+				cProof.getText(data);
+				clientNonce.erase();
+
+				return sendProof(status, cb);
+			}
+
+			// ticket was not accepted - perform full handshake
+			sessionKey.clear();
+			clientNonce.erase();
+
+			if (*saltAndKey == RemotePassword::TICKET_ISSUED)
+			{
+				newTicket = true;
+				++saltAndKey;
+				--length;
+			}
+		}
+
 		const unsigned expectedLength =
 			(RemotePassword::SRP_SALT_SIZE + RemotePassword::SRP_KEY_SIZE + 2) * 2;
 		if (length > expectedLength)
@@ -150,29 +318,43 @@ int SrpClient::authenticate(CheckStatusWrapper* status, IClientBlock* cb)
 		cProof.getText(data);
 		dumpIt("Clnt: Client Proof", cProof);
 
-		cb->putData(status, data.length(), data.c_str());
-		if (status->getState() & IStatus::STATE_ERRORS)
+		if (newTicket)
 		{
-			return AUTH_FAILED;
+			// server will derive the same ticket from session key
+			UCharBuffer ticketKey;
+			client->ticketKeys(sessionKey, ticketId, ticketKey);
+			tickets->add(ticketTarget, cb->getLogin(), passwordHash, ticketId, ticketKey,
+				time(NULL) + ticketLifetime);
 		}
 
-		// output the key
-		ICryptKey* cKey = cb->newKey(status);
-		if (status->getState() & IStatus::STATE_ERRORS)
-		{
-			return AUTH_FAILED;
-		}
-		cKey->setSymmetric(status, "Symmetric", sessionKey.getCount(), sessionKey.begin());
-		if (status->getState() & IStatus::STATE_ERRORS)
-		{
-			return AUTH_FAILED;
-		}
+		return sendProof(status, cb);
 	}
 	catch (const Exception& ex)
 	{
 		ex.stuffException(status);
 		return AUTH_FAILED;
 	}
+}
+
+int SrpClient::sendProof(CheckStatusWrapper* status, IClientBlock* cb)
+{
+	cb->putData(status, data.length(), data.c_str());
+	if (status->getState() & IStatus::STATE_ERRORS)
+	{
+		return AUTH_FAILED;
+	}
+
+	// output the key
+	ICryptKey* cKey = cb->newKey(status);
+	if (status->getState() & IStatus::STATE_ERRORS)
+	{
+		return AUTH_FAILED;
+	}
+	cKey->setSymmetric(status, "Symmetric", sessionKey.getCount(), sessionKey.begin());
+	if (status->getState() & IStatus::STATE_ERRORS)
+	{
+		return AUTH_FAILED;
+	}
 
 	return AUTH_SUCCESS;
 }
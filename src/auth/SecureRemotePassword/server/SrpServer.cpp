@@ -31,6 +31,7 @@
 #include "../auth/SecureRemotePassword/srp.h"
 #include "../common/classes/ImplementHelper.h"
 #include "../common/classes/ClumpletWriter.h"
+#include "../common/classes/objects_array.h"
 #include "../common/status.h"
 #include "../common/classes/ParsedList.h"
 #include "../common/isc_proto.h"
@@ -70,6 +71,98 @@ struct Metadata
 InitInstance<Metadata> meta;
 
 
+// Session resumption tickets issued by this server
+class Tickets
+{
+public:
+	explicit Tickets(MemoryPool& p)
+		: tickets(p)
+	{ }
+
+	void add(const string& id, const string& account, const PathName& secDbName,
+		const UCharBuffer& verifier, const string& salt, const UCharBuffer& key, unsigned lifetime)
+	{
+		MutexLockGuard g(mutex, FB_FUNCTION);
+
+		const time_t now = time(NULL);
+		for (FB_SIZE_T i = 0; i < tickets.getCount(); )
+		{
+			if (tickets[i].expires <= now || tickets[i].id == id)
+				tickets.remove(i);
+			else
+				++i;
+		}
+
+		if (tickets.getCount() >= MAX_TICKETS)
+			tickets.remove((FB_SIZE_T) 0);
+
+		Ticket& ticket = tickets.add();
+		ticket.id = id;
+		ticket.account = account;
+		ticket.secDbName = secDbName;
+		ticket.verifier = verifier;
+		ticket.salt = salt;
+		ticket.key = key;
+		ticket.expires = now + lifetime;
+	}
+
+	// Ticket is valid only while account's verifier and salt remain the same,
+	// i.e. it becomes useless when password is changed or user is dropped
+	bool find(const string& id, const string& account, const PathName& secDbName,
+		const UCharBuffer& verifier, const string& salt, UCharBuffer& key)
+	{
+		MutexLockGuard g(mutex, FB_FUNCTION);
+
+		for (FB_SIZE_T i = 0; i < tickets.getCount(); ++i)
+		{
+			const Ticket& ticket = tickets[i];
+			if (ticket.id != id)
+				continue;
+
+			if (ticket.expires <= time(NULL))
+			{
+				tickets.remove(i);
+				return false;
+			}
+
+			if (ticket.account != account || ticket.secDbName != secDbName ||
+				!(ticket.verifier == verifier) || ticket.salt != salt)
+			{
+				return false;
+			}
+
+			key = ticket.key;
+			return true;
+		}
+
+		return false;
+	}
+
+private:
+	static const FB_SIZE_T MAX_TICKETS = 1024;
+
+	struct Ticket
+	{
+		explicit Ticket(MemoryPool& p)
+			: id(p), account(p), secDbName(p), verifier(p), salt(p), key(p), expires(0)
+		{ }
+
+		string id;
+		string account;
+		PathName secDbName;
+		UCharBuffer verifier;
+		string salt;
+		UCharBuffer key;
+		time_t expires;
+	};
+
+	ObjectsArray<Ticket> tickets;
+	Mutex mutex;
+};
+
+GlobalPtr<Tickets> tickets;
+
+
 class SrpServer : public StdPlugin<IServerImpl<SrpServer, CheckStatusWrapper> >
 {
 public:
@@ -77,7 +170,8 @@ public:
 		: server(NULL), data(getPool()), account(getPool()),
 		  clientPubKey(getPool()), serverPubKey(getPool()),
 		  verifier(getPool()), salt(getPool()), sessionKey(getPool()),
-		  iParameter(par), secDbName(getPool()), cryptCallback(NULL)
+		  iParameter(par), secDbName(getPool()), cryptCallback(NULL),
+		  clientNonce(getPool()), serverNonce(getPool()), ticketLifetime(0), resumed(false)
 	{ }
 
 	// IServer implementation
@@ -100,6 +194,9 @@ private:
 	RefPtr<IPluginConfig> iParameter;
 	PathName secDbName;
 	ICryptKeyCallback* cryptCallback;
+	string clientNonce, serverNonce;
+	unsigned ticketLifetime;
+	bool resumed;
 
 protected:
     virtual RemotePassword* remotePasswordFactory() = 0;
@@ -263,7 +360,7 @@ int SrpServer::authenticate(CheckStatusWrapper* status, IServerBlock* sb, IWrite
 {
 	try
 	{
-		if (!server)
+		if (!server && !resumed)
 		{
 			HANDSHAKE_DEBUG(fprintf(stderr, "Srv: SRP phase1\n"));
 
@@ -285,6 +382,29 @@ int SrpServer::authenticate(CheckStatusWrapper* status, IServerBlock* sb, IWrite
 				return AUTH_MORE_DATA;
 			}
 
+			// client supporting session resumption prefixes its public key with a marker
+			// (public key text never starts with zero) and may append a ticket to it
+			string ticketId;
+			if (clientPubKey[0] == RemotePassword::TICKET_MARKER)
+			{
+				ticketLifetime = getTicketLifetime(iParameter);
+				clientPubKey.erase(0, 1);
+
+				const FB_SIZE_T sep = clientPubKey.find(RemotePassword::TICKET_SEPARATOR);
+				if (sep != string::npos)
+				{
+					const string ticket(clientPubKey.substr(sep + 1));
+					clientPubKey.erase(sep);
+
+					const FB_SIZE_T nonceSep = ticket.find(RemotePassword::TICKET_SEPARATOR);
+					if (ticketLifetime && nonceSep != string::npos)
+					{
+						ticketId = ticket.substr(0, nonceSep);
+						clientNonce = ticket.substr(nonceSep + 1);
+					}
+				}
+			}
+
 			// load verifier and salt from security database
 			Metadata messages;
 			messages.param->login.set(account.c_str());
@@ -315,12 +435,37 @@ int SrpServer::authenticate(CheckStatusWrapper* status, IServerBlock* sb, IWrite
 			BigInteger(s).getText(salt);
 			dumpIt("Srv: salt", salt);
 
+			UCharBuffer ticketKey;
+			if (ticketId.hasData() && clientNonce.hasData() &&
+				tickets->find(ticketId, account, secDbName, verifier, salt, ticketKey))
+			{
+				HANDSHAKE_DEBUG(fprintf(stderr, "Srv: SRP1: resuming session by ticket\n"));
+
+				// no need in SRP math - session key is derived from ticket key
+				RemotePassword::genNonce(serverNonce);
+				data = "";
+				data += char(RemotePassword::TICKET_RESUMED);
+				data.append(serverNonce);
+				sb->putData(status, data.length(), data.c_str());
+				if (status->getState() & IStatus::STATE_ERRORS)
+				{
+					return AUTH_FAILED;
+				}
+
+				server = remotePasswordFactory();
+				server->resumeSessionKey(sessionKey, ticketKey, clientNonce.c_str(), serverNonce.c_str());
+				resumed = true;
+				return AUTH_MORE_DATA;
+			}
+
 			// create SRP-calculating server
 			server = remotePasswordFactory();
 			server->genServerKey(serverPubKey, verifier);
 
 			// Ready to prepare data for client and calculate session key
 			data = "";
+			if (ticketLifetime)
+				data += char(RemotePassword::TICKET_ISSUED);
 			fb_assert(salt.length() <= RemotePassword::SRP_SALT_SIZE * 2);
 			data += char(salt.length());
 			data += char(salt.length() >> 8);
@@ -348,7 +493,9 @@ int SrpServer::authenticate(CheckStatusWrapper* status, IServerBlock* sb, IWrite
 		string proof;
 		proof.assign(val, length);
 		BigInteger clientProof(proof.c_str());
-		BigInteger serverProof = server->clientProof(account.c_str(), salt.c_str(), sessionKey);
+		BigInteger serverProof = resumed ?
+			server->resumeProof(account.c_str(), clientNonce.c_str(), serverNonce.c_str(), sessionKey) :
+			server->clientProof(account.c_str(), salt.c_str(), sessionKey);
 		HANDSHAKE_DEBUG(fprintf(stderr, "Client Proof Received, Length = %d\n", clientProof.length()));
 		dumpIt("Srv: Client Proof", clientProof);
 		dumpIt("Srv: Server Proof", serverProof);
@@ -379,6 +526,15 @@ int SrpServer::authenticate(CheckStatusWrapper* status, IServerBlock* sb, IWrite
 				return AUTH_FAILED;
 			}
 
+			// client will derive the same ticket from session key
+			if (ticketLifetime && !resumed)
+			{
+				string ticketId;
+				UCharBuffer ticketKey;
+				server->ticketKeys(sessionKey, ticketId, ticketKey);
+				tickets->add(ticketId, account, secDbName, verifier, salt, ticketKey, ticketLifetime);
+			}
+
 			return AUTH_SUCCESS;
 		}
 	}
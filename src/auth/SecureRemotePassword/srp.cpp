@@ -7,6 +7,7 @@
 #include "../common/classes/init.h"
 #include "../common/classes/fb_string.h"
 #include "../common/sha.h"
+#include "../common/status.h"
 
 using namespace Firebird;
 
@@ -198,6 +199,44 @@ BigInteger RemotePassword::clientProof(const char* account, const char* salt, co
 	return makeProof(n1, n2, salt, sessionKey);
 }
 
+void RemotePassword::genNonce(string& nonce)
+{
+	BigInteger n;
+	n.random(RemotePassword::SRP_NONCE_SIZE);
+	n.getText(nonce);
+}
+
+void RemotePassword::ticketKeys(const UCharBuffer& sessionKey, string& ticketId, UCharBuffer& ticketKey)
+{
+	hash.reset();
+	hash.process("ticket id");
+	hash.process(sessionKey);
+	BigInteger id;
+	hash.getInt(id);
+	id.getText(ticketId);
+
+	hash.reset();
+	hash.process("ticket key");
+	hash.process(sessionKey);
+	hash.getHash(ticketKey);
+}
+
+void RemotePassword::resumeSessionKey(UCharBuffer& sessionKey, const UCharBuffer& ticketKey,
+									  const char* clientNonce, const char* serverNonce)
+{
+	hash.reset();
+	hash.process(ticketKey);
+	hash.process(clientNonce);
+	hash.process(serverNonce);
+	hash.getHash(sessionKey);
+}
+
+BigInteger RemotePassword::resumeProof(const char* account, const char* clientNonce,
+									   const char* serverNonce, const UCharBuffer& sessionKey)
+{
+	return makeResumeProof(account, clientNonce, serverNonce, sessionKey);
+}
+
 RemotePassword::~RemotePassword()
 { }
 
@@ -231,6 +270,21 @@ void dumpIt(const char* name, const BigInteger& bi)
 }
 #endif
 
+unsigned getTicketLifetime(IPluginConfig* pluginConfig)
+{
+	FbLocalStatus s;
+	RefPtr<IFirebirdConf> config(REF_NO_INCR, pluginConfig->getFirebirdConf(&s));
+	check(&s);
+
+	static GlobalPtr<ConfigKeys> keys;
+	const unsigned int key = keys->getKey(config, "SrpTicketLifetime");
+	if (key == ConfigKeys::INVALID_KEY)
+		return 0;
+
+	const SINT64 lifetime = config->asInteger(key);
+	return lifetime > 0 ? (unsigned) lifetime : 0;
+}
+
 void checkStatusVectorForMissingTable(const ISC_STATUS* v, std::function<void ()> cleanup)
 {
 	while (v[0] == isc_arg_gds)
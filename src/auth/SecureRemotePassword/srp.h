@@ -48,6 +48,20 @@ namespace Auth {
  *
  * 		For full details, see http://www.ietf.org/rfc/rfc5054.txt
  *
+ * Session resumption (SrpTicketLifetime > 0 at both sides):
+ *
+ * 		Client prefixes its public key with TICKET_MARKER in step 2, a leading
+ * 		zero digit which old servers skip when parsing hex. If it has a ticket
+ * 		issued by the same server and database in previous handshake, it
+ * 		appends TICKET_SEPARATOR, ticket id, TICKET_SEPARATOR and random client
+ * 		nonce - only a server that issued a ticket gets them. When server
+ * 		finds valid ticket for that account and its verifier did not change,
+ * 		it answers TICKET_RESUMED and random server nonce instead of salt and
+ * 		public key, and both sides derive session key from ticket key and
+ * 		nonces skipping modular exponentiation.
+ * 		Otherwise server answers TICKET_ISSUED followed by usual data, and
+ * 		after full handshake both sides derive new ticket from session key.
+ *
  */
 
 class RemoteGroup;
@@ -93,6 +107,8 @@ private:
 protected:
     virtual Firebird::BigInteger makeProof(const Firebird::BigInteger n1, const Firebird::BigInteger n2,
                 const char* salt, const Firebird::UCharBuffer& sessionKey) = 0;
+	virtual Firebird::BigInteger makeResumeProof(const char* account, const char* clientNonce,
+				const char* serverNonce, const Firebird::UCharBuffer& sessionKey) = 0;
 
 public:
 	Firebird::BigInteger	clientPublicKey;
@@ -127,6 +143,21 @@ public:
 	Firebird::BigInteger clientProof(const char* account,
 									 const char* salt,
 									 const Firebird::UCharBuffer& sessionKey);
+
+	// session resumption
+	static const char TICKET_MARKER = '0';
+	static const char TICKET_SEPARATOR = '/';
+	static const UCHAR TICKET_ISSUED = 0xFE;
+	static const UCHAR TICKET_RESUMED = 0xFF;
+	static const unsigned SRP_NONCE_SIZE = 16;
+
+	static void genNonce(Firebird::string& nonce);
+	void ticketKeys(const Firebird::UCharBuffer& sessionKey, Firebird::string& ticketId,
+					Firebird::UCharBuffer& ticketKey);
+	void resumeSessionKey(Firebird::UCharBuffer& sessionKey, const Firebird::UCharBuffer& ticketKey,
+						  const char* clientNonce, const char* serverNonce);
+	Firebird::BigInteger resumeProof(const char* account, const char* clientNonce,
+									 const char* serverNonce, const Firebird::UCharBuffer& sessionKey);
 };
 
 template <class SHA> class RemotePasswordImpl : public RemotePassword
@@ -147,6 +178,20 @@ protected:
 		digest.getInt(rc);
 		return rc;
 	}
+
+	Firebird::BigInteger makeResumeProof(const char* account, const char* clientNonce,
+				const char* serverNonce, const Firebird::UCharBuffer& sessionKey)
+	{
+		Auth::SecureHash<SHA> digest;
+		digest.process(account);			// I
+		digest.process(clientNonce);		// client nonce
+		digest.process(serverNonce);		// server nonce
+		digest.process(sessionKey);			// K
+
+		Firebird::BigInteger rc;
+		digest.getInt(rc);
+		return rc;
+	}
 };
 
 
@@ -163,6 +208,7 @@ void static inline dumpIt(const char* /*name*/, const Firebird::string& /*str*/)
 void static inline dumpBin(const char* /*name*/, const Firebird::string& /*str*/) { }
 #endif
 
+unsigned getTicketLifetime(Firebird::IPluginConfig* pluginConfig);
 void checkStatusVectorForMissingTable(const ISC_STATUS* v, std::function<void ()> cleanup = nullptr);
 
 } // namespace Auth
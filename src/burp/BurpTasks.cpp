@@ -836,6 +836,32 @@ void RestoreRelationTask::verbRecsFinal()
 	}
 }
 
+bool RestoreRelationTask::commitData()
+{
+	bool ret = true;
+	MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+	for (Item** p = m_items.begin(); p < m_items.end(); p++)
+	{
+		Item* item = *p;
+		if (!item->m_ownAttach || !item->m_tra)
+			continue;
+
+		FbLocalStatus status;
+		item->m_tra->commit(&status);
+		if (status->getState() & IStatus::STATE_ERRORS)
+		{
+			ret = false;
+			BURP_print_status(false, &status);
+
+			item->m_tra->rollback(&status);
+		}
+		item->m_tra = nullptr;
+	}
+
+	return ret;
+}
+
 bool RestoreRelationTask::finish()
 {
 	bool ret = true;
@@ -899,6 +925,11 @@ void RestoreRelationTask::initItem(BurpGlobals* tdgbl, Item& item)
 				BURP_print_status(true, &status);
 				BURP_abort();
 			}
+		}
+
+		if (!item.m_tra)
+		{
+			FbLocalStatus status;
 
 			// SET TRANSACTION NO_AUTO_UNDO, see at the end of get_data()
 
@@ -1131,4 +1162,205 @@ void RestoreRelationTask::ExcReadDone::raise()
 	throw ExcReadDone();
 }
 
+/// class RestoreIndexTask
+
+RestoreIndexTask::RestoreIndexTask(BurpGlobals* tdgbl) : Task(),
+	m_coord(getDefaultMemoryPool()),
+	m_database(*getDefaultMemoryPool(), tdgbl->gbl_database_file_name, fb_strlen(tdgbl->gbl_database_file_name)),
+	m_dpb(*getDefaultMemoryPool()),
+	m_started(false),
+	m_closed(false),
+	m_queue(*getDefaultMemoryPool())
+{
+	ClumpletWriter dpb(ClumpletReader::dpbList, 128,
+		tdgbl->gbl_dpb_data.begin(),
+		tdgbl->gbl_dpb_data.getCount());
+
+	dpb.deleteWithTag(isc_dpb_gbak_attach);
+	m_dpb.assign(dpb.getBuffer(), dpb.getBufferLength());
+
+	// every index build uses engine parallel workers, therefore half of
+	// workers is enough to keep few indices building at the same time
+	int builders = tdgbl->gbl_sw_par_workers / 2;
+	if (builders <= 0)
+		builders = 1;
+
+	MemoryPool* pool = getDefaultMemoryPool();
+	for (int i = 0; i < builders; i++)
+		m_items.add(FB_NEW_POOL(*pool) Item(this));
+}
+
+RestoreIndexTask::~RestoreIndexTask()
+{
+	finish();
+
+	for (Item** p = m_items.begin(); p < m_items.end(); p++)
+		delete *p;
+}
+
+THREAD_ENTRY_DECLARE RestoreIndexTask::runTask(THREAD_ENTRY_PARAM arg)
+{
+	RestoreIndexTask* task = static_cast<RestoreIndexTask*>(arg);
+
+	try
+	{
+		task->m_coord.runSync(task);
+	}
+	catch (const Exception&)
+	{} // not activated indices are left deferred
+
+	return 0;
+}
+
+void RestoreIndexTask::activate(const char* name)
+{
+	MutexLockGuard guard(m_mutex, FB_FUNCTION);
+	fb_assert(!m_closed);
+
+	m_queue.add(string(name));
+	m_queueCond.notifyOne();
+
+	if (!m_started)
+	{
+		Thread::start(runTask, this, THREAD_medium, &m_thread);
+		m_started = true;
+	}
+}
+
+void RestoreIndexTask::finish()
+{
+	{ // scope
+		MutexLockGuard guard(m_mutex, FB_FUNCTION);
+		m_closed = true;
+		m_queueCond.notifyAll();
+	}
+
+	if (m_started)
+	{
+		Thread::waitForCompletion(m_thread);
+		m_started = false;
+	}
+
+	for (Item** p = m_items.begin(); p < m_items.end(); p++)
+	{
+		Item* item = *p;
+		if (item->m_att)
+		{
+			FbLocalStatus status;
+			item->m_att->detach(&status);
+			item->m_att = nullptr;
+		}
+	}
+}
+
+bool RestoreIndexTask::handler(WorkItem& _item)
+{
+	Item* item = reinterpret_cast<Item*>(&_item);
+
+	try
+	{
+		activateIndex(*item);
+	}
+	catch (const Exception&)
+	{} // index is left deferred
+
+	return true;
+}
+
+void RestoreIndexTask::activateIndex(Item& item)
+{
+	FbLocalStatus status;
+
+	if (!item.m_att)
+	{
+		DispatcherPtr provider;
+		item.m_att = provider->attachDatabase(&status, m_database.c_str(),
+			m_dpb.getCount(), m_dpb.begin());
+
+		if (status->getState() & IStatus::STATE_ERRORS)
+		{
+			item.m_att = nullptr;
+			return;
+		}
+	}
+
+	// don't wait for locks, index is activated later by main connection
+	// if relation is still in use
+	ClumpletWriter tpb(ClumpletReader::Tpb, 128, isc_tpb_version3);
+	tpb.insertTag(isc_tpb_read_committed);
+	tpb.insertTag(isc_tpb_rec_version);
+	tpb.insertTag(isc_tpb_nowait);
+
+	ITransaction* tra = item.m_att->startTransaction(&status, tpb.getBufferLength(), tpb.getBuffer());
+	if (status->getState() & IStatus::STATE_ERRORS)
+		return;
+
+	string sql("ALTER INDEX \"");
+	for (const char* p = item.m_index.c_str(); *p; p++)
+	{
+		if (*p == '"')
+			sql += '"';
+		sql += *p;
+	}
+	sql += "\" ACTIVE";
+
+	item.m_att->execute(&status, tra, 0, sql.c_str(), SQL_DIALECT_V6, NULL, NULL, NULL, NULL);
+
+	if (!(status->getState() & IStatus::STATE_ERRORS))
+	{
+		tra->commit(&status);
+		if (!(status->getState() & IStatus::STATE_ERRORS))
+			return;
+	}
+
+	FbLocalStatus rollbackStatus;
+	tra->rollback(&rollbackStatus);
+}
+
+bool RestoreIndexTask::getWorkItem(WorkItem** pItem)
+{
+	Item* item = reinterpret_cast<Item*> (*pItem);
+
+	MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+	if (!item)
+	{
+		for (Item** p = m_items.begin(); p < m_items.end(); p++)
+		{
+			if (!(*p)->m_inuse)
+			{
+				(*p)->m_inuse = true;
+				*pItem = item = *p;
+				break;
+			}
+		}
+
+		if (!item)
+			return false;
+	}
+
+	while (m_queue.isEmpty() && !m_closed)
+		m_queueCond.wait(m_mutex);
+
+	if (m_queue.isEmpty())
+	{
+		item->m_inuse = false;
+		return false;
+	}
+
+	item->m_index = m_queue[0];
+	m_queue.remove((FB_SIZE_T) 0);
+	return true;
+}
+
+bool RestoreIndexTask::getResult(IStatus* status)
+{
+	return true;
+}
+
+int RestoreIndexTask::getMaxWorkers()
+{
+	return m_items.getCount();
+}
+
 } // namespace Firebird
@@ -33,10 +33,13 @@
 #include "../common/ThreadData.h"
 #include "../common/Task.h"
 #include "../common/UtilSvc.h"
+#include "../common/ThreadStart.h"
 #include "../common/classes/array.h"
 #include "../common/classes/auto.h"
 #include "../common/classes/condition.h"
 #include "../common/classes/fb_atomic.h"
+#include "../common/classes/fb_string.h"
+#include "../common/classes/objects_array.h"
 
 namespace Burp {
 
@@ -424,6 +427,10 @@ public:
 	void verbRecs(FB_UINT64& records, bool total);
 	void verbRecsFinal();
 
+	// commit transactions of worker connections, new ones are started
+	// when next relation is restored
+	bool commitData();
+
 	// commit and detach all worker connections
 	bool finish();
 
@@ -470,6 +477,67 @@ private:
 };
 
 
+// Activates deferred indices of restored relations using own connections.
+// Indices are queued as soon as relation data is committed and are built
+// concurrently with the rest of the data restore, each build uses engine
+// parallel workers. Failed indices are left deferred and are handled by
+// the final activation step of restore.
+class RestoreIndexTask : public Firebird::Task
+{
+public:
+	RestoreIndexTask(BurpGlobals* tdgbl);
+	~RestoreIndexTask();
+
+	bool handler(WorkItem& _item);
+	bool getWorkItem(WorkItem** pItem);
+	bool getResult(Firebird::IStatus* status);
+	int getMaxWorkers();
+
+	// Regular index restored as deferred may be activated in background.
+	// Foreign key and expression indices are left to the final step of restore.
+	static bool canActivate(SSHORT inactive, bool foreignKey, bool expression)
+	{
+		return (inactive == FALSE || inactive == DEFERRED_ACTIVE) && !foreignKey && !expression;
+	}
+
+	// queue index for activation
+	void activate(const char* name);
+
+	// wait for all queued indices and detach worker connections
+	void finish();
+
+	class Item : public Firebird::Task::WorkItem
+	{
+	public:
+		Item(RestoreIndexTask* task) : WorkItem(task),
+			m_inuse(false),
+			m_att(0),
+			m_index(*getDefaultMemoryPool())
+		{}
+
+		bool m_inuse;
+		Firebird::IAttachment* m_att;
+		Firebird::string m_index;
+	};
+
+private:
+	static THREAD_ENTRY_DECLARE runTask(THREAD_ENTRY_PARAM arg);
+	void activateIndex(Item& item);
+
+	Firebird::Coordinator m_coord;
+	Firebird::PathName m_database;
+	Firebird::Array<UCHAR> m_dpb;
+	Thread::Handle m_thread;
+	bool m_started;
+	bool m_closed;
+
+	Firebird::Mutex m_mutex;
+	Firebird::Condition m_queueCond;
+	Firebird::ObjectsArray<Firebird::string> m_queue;
+	Firebird::HalfStaticArray<Item*, 8> m_items;
+};
+
+
 class IOBuffer
 {
 public:
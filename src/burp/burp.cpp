@@ -1454,6 +1454,9 @@ int gbak(Firebird::UtilSvc* uSvc)
 		exit_code = FINI_ERROR;
 	}
 
+	// Stop compression threads if backup file was not closed normally
+	MVOL_cleanup(tdgbl);
+
 	// Close the gbak file handles if they still open
 	for (burp_fil* file = tdgbl->gbl_sw_backup_files; file; file = file->fil_next)
 	{
@@ -215,6 +215,14 @@ const int SERIES				= 1;
 
 const USHORT MAX_UPDATE_DBKEY_RECURSION_DEPTH = 16;
 
+const int DEFERRED_ACTIVE		= 3;	// RDB$INDEX_INACTIVE setting for Foreign Keys
+										// This setting is used temporarily while
+										// restoring a database. This was required
+										// in order to differentiate a partial
+										// "inactive" state of SOME indices from
+										// "inactive" state of ALL indices (gbak -i)
+										// -bsriram, 11-May-1999      BUG: 10016
+
 
 enum att_type {
 	att_end = 0,		// end of major record
@@ -233,6 +241,7 @@ enum att_type {
 	att_backup_zip,			// zipped backup file
 	att_backup_hash,		// hash of crypt key
 	att_backup_crypt,		// name of crypt plugin
+	att_backup_zip_frames,	// backup file zipped by independent frames
 
 	// Database attributes
 
@@ -925,6 +934,7 @@ const FB_UINT64 MIN_SPLIT_SIZE	= FB_CONST64(2048);		// bytes
 // Global switches and data
 
 struct BurpCrypt;
+class BurpFrames;
 
 
 class GblPool
@@ -1010,6 +1020,7 @@ public:
 	bool		gbl_sw_overwrite;
 	bool		gbl_sw_direct_io;
 	bool		gbl_sw_zip;
+	bool		gbl_zip_frames;
 	const SCHAR*	gbl_sw_keyholder;
 	const SCHAR*	gbl_sw_crypt;
 	const SCHAR*	gbl_sw_keyname;
@@ -1027,6 +1038,7 @@ public:
 	unsigned	gbl_network_protocol;
 	burp_act*	action;
 	BurpCrypt*	gbl_crypt;
+	BurpFrames*	gbl_frames;
 	ULONG		io_buffer_size;
 	redirect_vals	sw_redirect;
 	bool		burp_throw;
@@ -421,6 +421,581 @@ static ULONG crypt_read_block(BurpGlobals* tdgbl, UCHAR* buffer, FB_SIZE_T buffe
 }
 
 
+#ifdef HAVE_ZLIB_H
+
+// Block-framed compressed stream, used for -ZIP backups when parallel workers
+// are requested. Every frame is compressed independently, therefore frames are
+// packed and unpacked by a set of worker threads while the main thread keeps
+// their order in the backup file. Frame header is stored in little endian
+// byte order and contains the length of raw data (zero marks end of stream),
+// the length of packed data, CRC32 of raw data and frame flags.
+
+class BurpFrames
+{
+public:
+	static const ULONG FRAME_SIZE = 1024 * 1024;
+	static const ULONG HEADER_SIZE = 16;
+	static const int MAX_WORKERS = 64;
+
+	static const ULONG FLAG_DATA = 0x01;		// frame contains relation data records only
+	static const ULONG FLAG_STORED = 0x02;		// frame is stored without compression
+
+	BurpFrames(BurpGlobals* gbl, bool write);
+	~BurpFrames();
+
+	void write(const UCHAR* buffer, ULONG length);
+	void markData(bool data);
+	void finish();
+
+	ULONG read(UCHAR* buffer, ULONG length);
+	bool skipData(ULONG unread);
+
+private:
+	enum FrameState {FRAME_PENDING, FRAME_WORKING, FRAME_DONE};
+
+	struct Frame
+	{
+		explicit Frame(MemoryPool& p)
+			: raw(p), packed(p), number(0), flags(0), crc(0),
+			  state(FRAME_PENDING), error(Z_OK), badCrc(false)
+		{ }
+
+		Firebird::Array<UCHAR> raw;
+		Firebird::Array<UCHAR> packed;
+		FB_UINT64 number;
+		ULONG flags;
+		ULONG crc;
+		FrameState state;
+		int error;
+		bool badCrc;
+	};
+
+	static THREAD_ENTRY_DECLARE workerThread(THREAD_ENTRY_PARAM arg);
+	void worker();
+	void stopWorkers();
+	void pack(Frame* frame);
+	void unpack(Frame* frame);
+
+	Frame* newFrame();
+	void releaseFrame(Frame* frame);
+	void queueFrame(Frame* frame);
+	void writeFrames(bool all);
+	bool nextFrame();
+	Frame* readFrame();
+	void readAhead();
+	void readFully(UCHAR* buffer, ULONG length);
+
+	static void putLong(UCHAR* ptr, ULONG value);
+	static ULONG getLong(const UCHAR* ptr);
+
+	BurpGlobals* const tdgbl;
+	MemoryPool& pool;
+	const bool writing;
+
+	Firebird::Mutex mutex;
+	Firebird::Condition workCond;	// frame is queued or workers should stop
+	Firebird::Condition doneCond;	// frame is processed by worker
+	Firebird::HalfStaticArray<Frame*, 16> queue;	// frames in backup file order
+	Firebird::HalfStaticArray<Frame*, 16> spare;
+	Firebird::HalfStaticArray<Thread::Handle, 16> threads;
+	FB_SIZE_T maxQueue;
+	bool stop;
+
+	Frame* current;		// frame being filled by writer or consumed by reader
+	ULONG position;		// reader position in current frame
+	ULONG nextFlags;	// flags of the next frame to be filled by writer
+	FB_UINT64 frameNumber;
+	UCHAR* inPtr;		// reader: data not parsed yet in gbl_decompress
+	ULONG inCount;
+	bool eof;
+};
+
+BurpFrames::BurpFrames(BurpGlobals* gbl, bool write)
+	: tdgbl(gbl), pool(gbl->getPool()), writing(write),
+	  queue(pool), spare(pool), threads(pool), maxQueue(0), stop(false),
+	  current(NULL), position(0), nextFlags(0), frameNumber(0),
+	  inPtr(NULL), inCount(0), eof(false)
+{
+	const int workers = MIN(MAX(tdgbl->gbl_sw_par_workers, 1), MAX_WORKERS);
+	maxQueue = workers * 2;
+
+	try
+	{
+		for (int i = 0; i < workers; i++)
+		{
+			Thread::Handle handle;
+			Thread::start(workerThread, this, THREAD_medium, &handle);
+			threads.add(handle);
+		}
+	}
+	catch (const Firebird::Exception&)
+	{
+		stopWorkers();
+		throw;
+	}
+}
+
+BurpFrames::~BurpFrames()
+{
+	stopWorkers();
+
+	delete current;
+
+	for (FB_SIZE_T i = 0; i < queue.getCount(); i++)
+		delete queue[i];
+
+	for (FB_SIZE_T i = 0; i < spare.getCount(); i++)
+		delete spare[i];
+}
+
+void BurpFrames::stopWorkers()
+{
+	{	// scope
+		Firebird::MutexLockGuard guard(mutex, FB_FUNCTION);
+		stop = true;
+		workCond.notifyAll();
+	}
+
+	for (FB_SIZE_T i = 0; i < threads.getCount(); i++)
+		Thread::waitForCompletion(threads[i]);
+
+	threads.clear();
+}
+
+THREAD_ENTRY_DECLARE BurpFrames::workerThread(THREAD_ENTRY_PARAM arg)
+{
+	static_cast<BurpFrames*>(arg)->worker();
+	return 0;
+}
+
+void BurpFrames::worker()
+{
+	Firebird::MutexLockGuard guard(mutex, FB_FUNCTION);
+
+	while (!stop)
+	{
+		Frame* frame = NULL;
+		for (FB_SIZE_T i = 0; i < queue.getCount(); i++)
+		{
+			if (queue[i]->state == FRAME_PENDING)
+			{
+				frame = queue[i];
+				break;
+			}
+		}
+
+		if (!frame)
+		{
+			workCond.wait(mutex);
+			continue;
+		}
+
+		frame->state = FRAME_WORKING;
+
+		{	// scope
+			Firebird::MutexUnlockGuard unlock(mutex, FB_FUNCTION);
+
+			if (writing)
+				pack(frame);
+			else
+				unpack(frame);
+		}
+
+		frame->state = FRAME_DONE;
+		doneCond.notifyAll();
+	}
+}
+
+void BurpFrames::pack(Frame* frame)
+{
+	const ULONG length = frame->raw.getCount();
+	frame->crc = zlib().crc32(0, frame->raw.begin(), length);
+
+	uLongf packedLength = zlib().compressBound(length);
+	UCHAR* const packed = frame->packed.getBuffer(packedLength, false);
+
+	frame->error = zlib().compress2(packed, &packedLength, frame->raw.begin(), length,
+		Z_DEFAULT_COMPRESSION);
+
+	if (frame->error != Z_OK)
+		return;
+
+	// Incompressible data is stored as is
+	if (packedLength >= length)
+	{
+		frame->flags |= FLAG_STORED;
+		frame->packed.clear();
+	}
+	else
+		frame->packed.shrink(packedLength);
+}
+
+void BurpFrames::unpack(Frame* frame)
+{
+	if (!(frame->flags & FLAG_STORED))
+	{
+		uLongf length = frame->raw.getCount();
+		frame->error = zlib().uncompress(frame->raw.begin(), &length,
+			frame->packed.begin(), frame->packed.getCount());
+
+		if (frame->error == Z_OK && length != frame->raw.getCount())
+			frame->error = Z_DATA_ERROR;
+
+		if (frame->error != Z_OK)
+			return;
+	}
+
+	frame->badCrc = (zlib().crc32(0, frame->raw.begin(), frame->raw.getCount()) != frame->crc);
+}
+
+BurpFrames::Frame* BurpFrames::newFrame()
+{
+	if (spare.hasData())
+		return spare.pop();
+
+	return FB_NEW_POOL(pool) Frame(pool);
+}
+
+void BurpFrames::releaseFrame(Frame* frame)
+{
+	frame->raw.clear();
+	frame->packed.clear();
+	frame->number = 0;
+	frame->flags = 0;
+	frame->crc = 0;
+	frame->state = FRAME_PENDING;
+	frame->error = Z_OK;
+	frame->badCrc = false;
+
+	spare.push(frame);
+}
+
+void BurpFrames::queueFrame(Frame* frame)
+{
+	Firebird::MutexLockGuard guard(mutex, FB_FUNCTION);
+
+	frame->state = FRAME_PENDING;
+	queue.add(frame);
+	workCond.notifyOne();
+}
+
+void BurpFrames::putLong(UCHAR* ptr, ULONG value)
+{
+	for (int i = 0; i < 4; i++, value >>= 8)
+		*ptr++ = (UCHAR) value;
+}
+
+ULONG BurpFrames::getLong(const UCHAR* ptr)
+{
+	return ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | ((ULONG) ptr[3] << 24);
+}
+
+void BurpFrames::write(const UCHAR* buffer, ULONG length)
+{
+	while (length)
+	{
+		if (!current)
+		{
+			current = newFrame();
+			current->flags = nextFlags;
+		}
+
+		const ULONG n = MIN(length, FRAME_SIZE - current->raw.getCount());
+		current->raw.add(buffer, n);
+		buffer += n;
+		length -= n;
+
+		if (current->raw.getCount() == FRAME_SIZE)
+		{
+			queueFrame(current);
+			current = NULL;
+			writeFrames(false);
+		}
+	}
+}
+
+void BurpFrames::markData(bool data)
+{
+	// Relation data starts and ends at the frame boundary
+	if (current)
+	{
+		queueFrame(current);
+		current = NULL;
+		writeFrames(false);
+	}
+
+	nextFlags = data ? FLAG_DATA : 0;
+}
+
+void BurpFrames::finish()
+{
+	if (current)
+	{
+		queueFrame(current);
+		current = NULL;
+	}
+
+	writeFrames(true);
+
+	UCHAR header[HEADER_SIZE];
+	memset(header, 0, sizeof(header));
+	crypt_write_block(tdgbl, header, HEADER_SIZE, true);
+}
+
+// Write processed frames in order. Wait for the oldest frame if too many
+// frames are in progress, or if all frames should be written.
+
+void BurpFrames::writeFrames(bool all)
+{
+	for (;;)
+	{
+		Frame* frame;
+
+		{	// scope
+			Firebird::MutexLockGuard guard(mutex, FB_FUNCTION);
+
+			if (queue.isEmpty())
+				return;
+
+			frame = queue[0];
+			if (frame->state != FRAME_DONE)
+			{
+				if (!all && queue.getCount() < maxQueue)
+					return;
+
+				while (frame->state != FRAME_DONE)
+					doneCond.wait(mutex);
+			}
+
+			queue.remove((FB_SIZE_T) 0);
+		}
+
+		const int error = frame->error;
+		if (error != Z_OK)
+		{
+			releaseFrame(frame);
+			BURP_error(380, true, SafeArg() << error);
+			// msg 380 Deflate error
+		}
+
+		const Firebird::Array<UCHAR>& data = (frame->flags & FLAG_STORED) ? frame->raw : frame->packed;
+
+		UCHAR header[HEADER_SIZE];
+		putLong(header, frame->raw.getCount());
+		putLong(header + 4, data.getCount());
+		putLong(header + 8, frame->crc);
+		putLong(header + 12, frame->flags);
+
+		crypt_write_block(tdgbl, header, HEADER_SIZE, false);
+		crypt_write_block(tdgbl, data.begin(), data.getCount(), false);
+
+		releaseFrame(frame);
+	}
+}
+
+void BurpFrames::readFully(UCHAR* buffer, ULONG length)
+{
+	while (length)
+	{
+		// Crypt layer returns data in whole crypt steps only, keep the rest for next time
+		if (!inCount)
+		{
+			inPtr = tdgbl->gbl_decompress;
+			inCount = crypt_read_block(tdgbl, inPtr, ZC_BUFSIZE);
+		}
+
+		const ULONG n = MIN(length, inCount);
+		if (buffer)
+		{
+			memcpy(buffer, inPtr, n);
+			buffer += n;
+		}
+
+		inPtr += n;
+		inCount -= n;
+		length -= n;
+	}
+}
+
+BurpFrames::Frame* BurpFrames::readFrame()
+{
+	if (eof)
+		return NULL;
+
+	UCHAR header[HEADER_SIZE];
+	readFully(header, HEADER_SIZE);
+
+	const ULONG rawLength = getLong(header);
+	const ULONG packedLength = getLong(header + 4);
+
+	if (!rawLength)
+	{
+		eof = true;
+		return NULL;
+	}
+
+	++frameNumber;
+
+	const ULONG flags = getLong(header + 12);
+	if (rawLength > FRAME_SIZE || packedLength > zlib().compressBound(FRAME_SIZE) ||
+		((flags & FLAG_STORED) && packedLength != rawLength))
+	{
+		BURP_error(411, true, SafeArg() << frameNumber);
+		// msg 411 Invalid header of compressed block @1 in backup file
+	}
+
+	Frame* const frame = newFrame();
+	frame->number = frameNumber;
+	frame->flags = flags;
+	frame->crc = getLong(header + 8);
+
+	UCHAR* const raw = frame->raw.getBuffer(rawLength, false);
+
+	if (flags & FLAG_STORED)
+		readFully(raw, rawLength);
+	else
+		readFully(frame->packed.getBuffer(packedLength, false), packedLength);
+
+	return frame;
+}
+
+void BurpFrames::readAhead()
+{
+	while (!eof)
+	{
+		{	// scope
+			Firebird::MutexLockGuard guard(mutex, FB_FUNCTION);
+
+			if (queue.getCount() >= maxQueue)
+				return;
+		}
+
+		Frame* const frame = readFrame();
+		if (!frame)
+			return;
+
+		queueFrame(frame);
+	}
+}
+
+bool BurpFrames::nextFrame()
+{
+	if (current)
+	{
+		releaseFrame(current);
+		current = NULL;
+	}
+
+	readAhead();
+
+	{	// scope
+		Firebird::MutexLockGuard guard(mutex, FB_FUNCTION);
+
+		if (queue.isEmpty())
+			return false;
+
+		current = queue[0];
+		while (current->state != FRAME_DONE)
+			doneCond.wait(mutex);
+
+		queue.remove((FB_SIZE_T) 0);
+	}
+
+	position = 0;
+
+	if (current->error != Z_OK)
+	{
+		BURP_error(379, true, SafeArg() << current->error);
+		// msg 379 Inflate error
+	}
+
+	if (current->badCrc)
+	{
+		BURP_error(410, true, SafeArg() << current->number);
+		// msg 410 Checksum mismatch in compressed block @1 of backup file
+	}
+
+	// Let workers unpack next frames while current one is parsed
+	readAhead();
+
+	return true;
+}
+
+ULONG BurpFrames::read(UCHAR* buffer, ULONG length)
+{
+	while (!current || position >= current->raw.getCount())
+	{
+		if (!nextFrame())
+		{
+			BURP_error_redirect(NULL, 220);
+			// msg 220 Unexpected I/O error while reading from backup file
+		}
+	}
+
+	const ULONG n = MIN(length, current->raw.getCount() - position);
+	memcpy(buffer, current->raw.begin() + position, n);
+	position += n;
+
+	return n;
+}
+
+// Skip data of relation without decompression. Possible only when the data
+// record just read is the first byte of a data frame, i.e. when the backup was
+// made with frames. Argument is the count of bytes passed to the caller but
+// not parsed yet.
+
+bool BurpFrames::skipData(ULONG unread)
+{
+	if (!current || !(current->flags & FLAG_DATA) || position != unread + 1)
+		return false;
+
+	releaseFrame(current);
+	current = NULL;
+
+	for (;;)
+	{
+		Frame* frame = NULL;
+
+		{	// scope
+			Firebird::MutexLockGuard guard(mutex, FB_FUNCTION);
+
+			if (queue.hasData())
+			{
+				frame = queue[0];
+				if (!(frame->flags & FLAG_DATA))
+					return true;
+
+				// Nobody should unpack it, but wait for the worker which already does
+				if (frame->state == FRAME_PENDING)
+					frame->state = FRAME_DONE;
+
+				while (frame->state != FRAME_DONE)
+					doneCond.wait(mutex);
+
+				queue.remove((FB_SIZE_T) 0);
+			}
+		}
+
+		if (!frame)
+		{
+			frame = readFrame();
+			if (!frame)
+				return true;
+
+			if (!(frame->flags & FLAG_DATA))
+			{
+				queueFrame(frame);
+				return true;
+			}
+		}
+
+		releaseFrame(frame);
+	}
+}
+
+#endif // HAVE_ZLIB_H
+
+
 //____________________________________________________________
 //
 //
@@ -433,6 +1008,9 @@ static ULONG unzip_read_block(BurpGlobals* tdgbl, UCHAR* buffer, FB_SIZE_T buffe
 	}
 
 #ifdef HAVE_ZLIB_H
+	if (tdgbl->gbl_frames)
+		return tdgbl->gbl_frames->read(buffer, buffer_length);
+
 	z_stream& strm = tdgbl->gbl_stream;
 	strm.avail_out = buffer_length;
 	strm.next_out = buffer;
@@ -500,6 +1078,14 @@ static void zip_write_block(BurpGlobals* tdgbl, const UCHAR* buffer, FB_SIZE_T b
 	}
 
 #ifdef HAVE_ZLIB_H
+	if (tdgbl->gbl_frames)
+	{
+		tdgbl->gbl_frames->write(buffer, buffer_length);
+		if (flash)
+			tdgbl->gbl_frames->finish();
+		return;
+	}
+
 	z_stream& strm = tdgbl->gbl_stream;
 	strm.avail_in = buffer_length;
 	strm.next_in = (Bytef*)buffer;
@@ -566,7 +1152,12 @@ FB_UINT64 MVOL_fini_read()
 	BurpGlobals* tdgbl = BurpGlobals::getSpecific();
 
 #ifdef HAVE_ZLIB_H
-	if (tdgbl->gbl_sw_zip)
+	if (tdgbl->gbl_frames)
+	{
+		delete tdgbl->gbl_frames;
+		tdgbl->gbl_frames = NULL;
+	}
+	else if (tdgbl->gbl_sw_zip)
 	{
 		zlib().inflateEnd(&tdgbl->gbl_stream);
 	}
@@ -611,7 +1202,12 @@ FB_UINT64 MVOL_fini_write()
 	zip_write_block(tdgbl, tdgbl->gbl_compress_buffer, tdgbl->gbl_io_ptr - tdgbl->gbl_compress_buffer, true);
 
 #ifdef HAVE_ZLIB_H
-	if (tdgbl->gbl_sw_zip)
+	if (tdgbl->gbl_frames)
+	{
+		delete tdgbl->gbl_frames;
+		tdgbl->gbl_frames = NULL;
+	}
+	else if (tdgbl->gbl_sw_zip)
 	{
 		zlib().deflateEnd(&tdgbl->gbl_stream);
 	}
@@ -707,6 +1303,13 @@ void MVOL_init_read(const char* file_name, USHORT* format)
 	if (tdgbl->gbl_sw_zip)
 	{
 #ifdef HAVE_ZLIB_H
+		checkCompression();
+		if (tdgbl->gbl_zip_frames)
+		{
+			tdgbl->gbl_frames = FB_NEW_POOL(tdgbl->getPool()) BurpFrames(tdgbl, false);
+			return;
+		}
+
 		z_stream& strm = tdgbl->gbl_stream;
 
 		strm.zalloc = Firebird::ZLib::allocFunc;
@@ -714,7 +1317,6 @@ void MVOL_init_read(const char* file_name, USHORT* format)
 		strm.opaque = Z_NULL;
 		strm.avail_in = 0;
 		strm.next_in = Z_NULL;
-		checkCompression();
 		int ret = zlib().inflateInit(&strm);
 		if (ret != Z_OK)
 #endif
@@ -771,6 +1373,9 @@ void MVOL_init_write(const char* file_name)
 {
 	BurpGlobals* tdgbl = BurpGlobals::getSpecific();
 
+	// Parallel backup compresses independent frames by a few threads
+	tdgbl->gbl_zip_frames = tdgbl->gbl_sw_zip && tdgbl->gbl_sw_par_workers > 1;
+
 	mvol_init_write(tdgbl, file_name, &tdgbl->blk_io_cnt, &tdgbl->blk_io_ptr);
 
 	tdgbl->gbl_io_cnt = ZC_BUFSIZE;
@@ -779,12 +1384,18 @@ void MVOL_init_write(const char* file_name)
 #ifdef HAVE_ZLIB_H
 	if (tdgbl->gbl_sw_zip)
 	{
+		checkCompression();
+		if (tdgbl->gbl_zip_frames)
+		{
+			tdgbl->gbl_frames = FB_NEW_POOL(tdgbl->getPool()) BurpFrames(tdgbl, true);
+			return;
+		}
+
 		z_stream& strm = tdgbl->gbl_stream;
 
 		strm.zalloc = Firebird::ZLib::allocFunc;
 		strm.zfree = Firebird::ZLib::freeFunc;
 		strm.opaque = Z_NULL;
-		checkCompression();
 		int ret = zlib().deflateInit(&strm, Z_DEFAULT_COMPRESSION);
 		if (ret != Z_OK)
 			BURP_error(384, true, SafeArg() << ret);
@@ -1031,6 +1642,60 @@ void MVOL_skip_block( BurpGlobals* tdgbl, ULONG count)
 }
 
 
+//____________________________________________________________
+//
+// Mark start or end of relation data in the backup file. Compressed
+// frames are split at this point, so restore may skip data frames of
+// relations which are not restored without decompression.
+//
+void MVOL_mark_data(BurpGlobals* tdgbl, bool data)
+{
+#ifdef HAVE_ZLIB_H
+	if (!tdgbl->gbl_frames)
+		return;
+
+	zip_write_block(tdgbl, tdgbl->gbl_compress_buffer, tdgbl->gbl_io_ptr - tdgbl->gbl_compress_buffer, false);
+
+	tdgbl->gbl_io_cnt = ZC_BUFSIZE;
+	tdgbl->gbl_io_ptr = tdgbl->gbl_compress_buffer;
+
+	tdgbl->gbl_frames->markData(data);
+#endif
+}
+
+
+//____________________________________________________________
+//
+// Skip relation data following just read rec_data. Returns false if
+// the backup file format does not allow it and data should be read.
+//
+bool MVOL_skip_data(BurpGlobals* tdgbl)
+{
+#ifdef HAVE_ZLIB_H
+	if (tdgbl->gbl_frames && tdgbl->gbl_frames->skipData(MAX(tdgbl->gbl_io_cnt, 0)))
+	{
+		tdgbl->gbl_io_cnt = 0;
+		return true;
+	}
+#endif
+
+	return false;
+}
+
+
+//____________________________________________________________
+//
+// Release resources left after failed backup or restore.
+//
+void MVOL_cleanup(BurpGlobals* tdgbl)
+{
+#ifdef HAVE_ZLIB_H
+	delete tdgbl->gbl_frames;
+	tdgbl->gbl_frames = NULL;
+#endif
+}
+
+
 #ifdef WIN_NT
 //____________________________________________________________
 //
@@ -1960,6 +2625,14 @@ static bool read_header(DESC handle, ULONG* buffer_size, USHORT* format, bool in
 				tdgbl->gbl_sw_zip = true;
 			break;
 
+		case att_backup_zip_frames:
+			if (get_numeric())
+			{
+				tdgbl->gbl_sw_zip = true;
+				tdgbl->gbl_zip_frames = true;
+			}
+			break;
+
 		case att_backup_hash:
 			if (!tdgbl->gbl_sw_keyholder)
 				BURP_error(376, true);
@@ -2014,7 +2687,9 @@ static bool write_header(DESC handle, ULONG backup_buffer_size, bool full_buffer
 		if (tdgbl->gbl_sw_transportable)
 			put_numeric(att_backup_transportable, 1);
 
-		if (tdgbl->gbl_sw_zip)
+		if (tdgbl->gbl_zip_frames)
+			put_numeric(att_backup_zip_frames, 1);
+		else if (tdgbl->gbl_sw_zip)
 			put_numeric(att_backup_zip, 1);
 
 		put_numeric(att_backup_blksize, backup_buffer_size);
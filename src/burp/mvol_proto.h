@@ -39,6 +39,9 @@ bool			MVOL_split_hdr_read();
 void			MVOL_read(BurpGlobals*);
 UCHAR*			MVOL_read_block(BurpGlobals*, UCHAR*, ULONG);
 void			MVOL_skip_block(BurpGlobals*, ULONG);
+void			MVOL_mark_data(BurpGlobals*, bool);
+bool			MVOL_skip_data(BurpGlobals*);
+void			MVOL_cleanup(BurpGlobals*);
 void			MVOL_write(BurpGlobals*);
 const UCHAR*	MVOL_write_block(BurpGlobals*, const UCHAR*, ULONG);
 Firebird::ICryptKeyCallback*	MVOL_get_crypt(BurpGlobals*);
@@ -44,7 +44,8 @@ namespace
 	{
 		TextTypeImpl(charset* a_cs, UnicodeUtil::Utf16Collation* a_collation)
 			: cs(a_cs),
-			  collation(a_collation)
+			  collation(a_collation),
+			  utf8(strcmp(a_cs->charset_name, "UTF8") == 0)
 		{
 		}
 
@@ -58,6 +59,7 @@ namespace
 
 		charset* cs;
 		UnicodeUtil::Utf16Collation* collation;
+		bool utf8;	// compare operands without conversion to UTF-16
 	};
 }
 
@@ -855,6 +857,9 @@ static SSHORT unicodeCompare(texttype* tt, ULONG len1, const UCHAR* str1,
 	{
 		*errorFlag = false;
 
+		if (impl->utf8)
+			return impl->collation->compareUtf8(len1, str1, len2, str2, errorFlag);
+
 		charset* cs = impl->cs;
 
 		HalfStaticArray<UCHAR, BUFFER_SMALL> utf16Str1;
@@ -0,0 +1,119 @@
+/*
+ *	PROGRAM:	Client/Server Common Code
+ *	MODULE:		BloomFilter.h
+ *	DESCRIPTION:	Bloom filter of 32-bit hashes
+ *
+ *  The contents of this file are subject to the Initial
+ *  Developer's Public License Version 1.0 (the "License");
+ *  you may not use this file except in compliance with the
+ *  License. You may obtain a copy of the License at
+ *  http://www.ibphoenix.com/main.nfs?a=ibphoenix&page=ibp_idpl.
+ *
+ *  Software distributed under the License is distributed AS IS,
+ *  WITHOUT WARRANTY OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing rights
+ *  and limitations under the License.
+ *
+ *  The Original Code was created by the Firebird development team
+ *  for the Firebird Open Source RDBMS project.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+ *
+ */
+
+#ifndef CLASSES_BLOOM_FILTER_H
+#define CLASSES_BLOOM_FILTER_H
+
+#include "../common/classes/alloc.h"
+#include "../common/classes/array.h"
+#include "../common/classes/objects_array.h"
+
+namespace Firebird {
+
+// Set of bit arrays, one per added group of hashes. A hash passes check()
+// when it may be present in every group: false positives are possible,
+// false negatives are not.
+
+class BloomFilter : public PermanentStorage
+{
+	static const ULONG BITS_PER_KEY = 8;
+	static const ULONG MIN_BITS = 512;
+	static const ULONG MAX_BITS = 1 << 26;	// 8MB per group
+	static const ULONG HASH_FUNCTIONS = 3;
+
+	struct Filter
+	{
+		explicit Filter(MemoryPool& pool)
+			: bits(pool), mask(0)
+		{}
+
+		Array<ULONG> bits;
+		ULONG mask;
+	};
+
+public:
+	explicit BloomFilter(MemoryPool& pool)
+		: PermanentStorage(pool), m_filters(pool)
+	{}
+
+	void add(const Array<ULONG>& hashes)
+	{
+		ULONG bitCount = MIN_BITS;
+		while (bitCount < MAX_BITS && bitCount < hashes.getCount() * BITS_PER_KEY)
+			bitCount <<= 1;
+
+		Filter& filter = m_filters.add();
+		filter.mask = bitCount - 1;
+		filter.bits.resize(bitCount / BITS_PER_LONG);
+		memset(filter.bits.begin(), 0, filter.bits.getCount() * sizeof(ULONG));
+
+		for (const auto hash : hashes)
+		{
+			ULONG h1 = hash, h2 = getStep(hash);
+
+			for (ULONG i = 0; i < HASH_FUNCTIONS; i++, h1 += h2)
+			{
+				const ULONG bit = h1 & filter.mask;
+				filter.bits[bit / BITS_PER_LONG] |= 1u << (bit % BITS_PER_LONG);
+			}
+		}
+	}
+
+	bool check(ULONG hash) const
+	{
+		const ULONG h2 = getStep(hash);
+
+		for (const auto& filter : m_filters)
+		{
+			ULONG h1 = hash;
+
+			for (ULONG i = 0; i < HASH_FUNCTIONS; i++, h1 += h2)
+			{
+				const ULONG bit = h1 & filter.mask;
+				if (!(filter.bits[bit / BITS_PER_LONG] & (1u << (bit % BITS_PER_LONG))))
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	FB_SIZE_T getCount() const
+	{
+		return m_filters.getCount();
+	}
+
+private:
+	static ULONG getStep(ULONG hash)
+	{
+		// Derive the second hash function from the first one (double hashing)
+		return (((hash >> 16) | (hash << 16)) * 0x9E3779B1) | 1;
+	}
+
+	ObjectsArray<Filter> m_filters;
+};
+
+} // namespace Firebird
+
+#endif // CLASSES_BLOOM_FILTER_H
@@ -0,0 +1,1395 @@
+/*
+ *	PROGRAM:	Client/Server Common Code
+ *	MODULE:		roaring_bitmap.h
+ *	DESCRIPTION:	compressed bitmap of integers with hybrid containers
+ *
+ *  The contents of this file are subject to the Initial
+ *  Developer's Public License Version 1.0 (the "License");
+ *  you may not use this file except in compliance with the
+ *  License. You may obtain a copy of the License at
+ *  http://www.ibphoenix.com/main.nfs?a=ibphoenix&page=ibp_idpl.
+ *
+ *  Software distributed under the License is distributed AS IS,
+ *  WITHOUT WARRANTY OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing rights
+ *  and limitations under the License.
+ *
+ *  The Original Code was created by the Firebird development team
+ *  for the Firebird Open Source RDBMS project.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+ *
+ */
+
+#ifndef ROARING_BITMAP_H
+#define ROARING_BITMAP_H
+
+#include "../common/classes/alloc.h"
+#include "../common/classes/array.h"
+#include "../common/classes/tree.h"
+
+namespace Firebird {
+
+// Set of 16-bit values making one 64K chunk of a RoaringBitmap.
+// Container keeps its data in one of three forms, whichever is the most
+// compact for the current contents:
+//   array  - sorted list of values, used for up to ARRAY_MAX values;
+//   bitset - plain bit vector of CHUNK_SIZE bits;
+//   runs   - sorted list of [start, last] intervals, produced by optimize().
+// Modifications never produce runs, a run container is unpacked first.
+// Bulk operations on bitsets are written as plain loops over 64-bit words
+// for the compiler to vectorize them.
+
+class RoaringContainer
+{
+public:
+	enum {
+		CHUNK_BITS = 16,
+		CHUNK_SIZE = 1 << CHUNK_BITS,
+		WORD_BITS = 64,
+		BITSET_WORDS = CHUNK_SIZE / WORD_BITS,
+		ARRAY_MAX = 4096	// array of this size occupies the same space as a bitset
+	};
+
+	explicit RoaringContainer(MemoryPool& p)
+		: pool(p), values(p), runs(p), words(NULL), count(0), type(TYPE_ARRAY)
+	{ }
+
+	RoaringContainer(MemoryPool& p, const RoaringContainer& from)
+		: pool(p), values(p), runs(p), words(NULL), count(from.count), type(from.type)
+	{
+		switch (type)
+		{
+		case TYPE_ARRAY:
+			values.assign(from.values);
+			break;
+		case TYPE_RUN:
+			runs.assign(from.runs);
+			break;
+		case TYPE_BITSET:
+			words = allocWords();
+			memcpy(words, from.words, BITSET_WORDS * sizeof(FB_UINT64));
+			break;
+		}
+	}
+
+	~RoaringContainer()
+	{
+		delete[] words;
+	}
+
+	ULONG getCount() const
+	{
+		return count;
+	}
+
+	size_t approxSize() const
+	{
+		return sizeof(*this) + values.getCapacity() * sizeof(USHORT) +
+			runs.getCapacity() * sizeof(Run) + (words ? BITSET_WORDS * sizeof(FB_UINT64) : 0);
+	}
+
+	bool test(USHORT value) const
+	{
+		FB_SIZE_T pos;
+
+		switch (type)
+		{
+		case TYPE_ARRAY:
+			return findValue(value, pos);
+		case TYPE_BITSET:
+			return (words[value / WORD_BITS] >> (value % WORD_BITS)) & 1;
+		case TYPE_RUN:
+			return findRun(value, pos);
+		}
+
+		return false;
+	}
+
+	// Returns true if value was not set before
+	bool set(USHORT value)
+	{
+		if (type == TYPE_RUN)
+		{
+			if (test(value))
+				return false;
+
+			unpack();
+		}
+
+		if (type == TYPE_ARRAY)
+		{
+			FB_SIZE_T pos;
+			if (findValue(value, pos))
+				return false;
+
+			if (count < ARRAY_MAX)
+			{
+				values.insert(pos, value);
+				count++;
+				return true;
+			}
+
+			toBitset();
+		}
+
+		FB_UINT64& word = words[value / WORD_BITS];
+		const FB_UINT64 mask = WORD_ONE << (value % WORD_BITS);
+
+		if (word & mask)
+			return false;
+
+		word |= mask;
+		count++;
+		return true;
+	}
+
+	// Returns true if value was set before
+	bool clear(USHORT value)
+	{
+		FB_SIZE_T pos;
+
+		switch (type)
+		{
+		case TYPE_RUN:
+			if (!findRun(value, pos))
+				return false;
+
+			unpack();
+			return clear(value);
+
+		case TYPE_ARRAY:
+			if (!findValue(value, pos))
+				return false;
+
+			values.remove(pos);
+			count--;
+			return true;
+
+		case TYPE_BITSET:
+			{
+				FB_UINT64& word = words[value / WORD_BITS];
+				const FB_UINT64 mask = WORD_ONE << (value % WORD_BITS);
+
+				if (!(word & mask))
+					return false;
+
+				word &= ~mask;
+
+				// Leave some room to not convert back and forth on every change
+				if (--count < ARRAY_MAX / 2)
+					toArray();
+
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Find the smallest value which is not less than given one
+	bool findNext(ULONG from, USHORT& found) const
+	{
+		if (from >= CHUNK_SIZE)
+			return false;
+
+		FB_SIZE_T pos;
+
+		switch (type)
+		{
+		case TYPE_ARRAY:
+			findValue((USHORT) from, pos);
+			if (pos >= values.getCount())
+				return false;
+
+			found = values[pos];
+			return true;
+
+		case TYPE_BITSET:
+			{
+				ULONG n = from / WORD_BITS;
+				FB_UINT64 word = words[n] & (~WORD_ZERO << (from % WORD_BITS));
+
+				while (!word)
+				{
+					if (++n == BITSET_WORDS)
+						return false;
+
+					word = words[n];
+				}
+
+				found = (USHORT) (n * WORD_BITS + lowestBit(word));
+				return true;
+			}
+
+		case TYPE_RUN:
+			findRun((USHORT) from, pos);
+			if (pos >= runs.getCount())
+				return false;
+
+			found = MAX(runs[pos].start, (USHORT) from);
+			return true;
+		}
+
+		return false;
+	}
+
+	// Find the largest value which is not greater than given one
+	bool findPrev(SLONG from, USHORT& found) const
+	{
+		if (from < 0)
+			return false;
+
+		FB_SIZE_T pos;
+
+		switch (type)
+		{
+		case TYPE_ARRAY:
+			if (findValue((USHORT) from, pos))
+			{
+				found = (USHORT) from;
+				return true;
+			}
+
+			if (pos == 0)
+				return false;
+
+			found = values[pos - 1];
+			return true;
+
+		case TYPE_BITSET:
+			{
+				ULONG n = from / WORD_BITS;
+				FB_UINT64 word = words[n] & (~WORD_ZERO >> (WORD_BITS - 1 - from % WORD_BITS));
+
+				while (!word)
+				{
+					if (n == 0)
+						return false;
+
+					word = words[--n];
+				}
+
+				found = (USHORT) (n * WORD_BITS + highestBit(word));
+				return true;
+			}
+
+		case TYPE_RUN:
+			if (findRun((USHORT) from, pos))
+			{
+				found = (USHORT) from;
+				return true;
+			}
+
+			if (pos == 0)
+				return false;
+
+			found = runs[pos - 1].last;
+			return true;
+		}
+
+		return false;
+	}
+
+	// Union with another container
+	void unite(const RoaringContainer& other)
+	{
+		if (type == TYPE_RUN)
+			unpack();
+
+		if (type == TYPE_ARRAY && other.type == TYPE_ARRAY && count + other.count <= ARRAY_MAX)
+		{
+			mergeValues(other.values);
+			return;
+		}
+
+		if (type != TYPE_BITSET)
+			toBitset();
+
+		switch (other.type)
+		{
+		case TYPE_BITSET:
+			{
+				FB_UINT64* const dst = words;
+				const FB_UINT64* const src = other.words;
+
+				for (ULONG n = 0; n < BITSET_WORDS; n++)
+					dst[n] |= src[n];
+			}
+			break;
+
+		case TYPE_ARRAY:
+			for (const USHORT* value = other.values.begin(); value != other.values.end(); ++value)
+				words[*value / WORD_BITS] |= WORD_ONE << (*value % WORD_BITS);
+			break;
+
+		case TYPE_RUN:
+			for (const Run* run = other.runs.begin(); run != other.runs.end(); ++run)
+				fillRange(run->start, run->last + 1, true);
+			break;
+		}
+
+		count = countBits();
+	}
+
+	// Intersection with another container. Caller should get rid of empty result.
+	void intersect(const RoaringContainer& other)
+	{
+		if (type == TYPE_RUN)
+			unpack();
+
+		if (type == TYPE_ARRAY)
+		{
+			USHORT* const data = values.begin();
+			FB_SIZE_T n = 0;
+
+			if (other.type == TYPE_ARRAY)
+			{
+				const USHORT* src = other.values.begin();
+				const USHORT* const end = other.values.end();
+
+				for (FB_SIZE_T i = 0; i < values.getCount() && src != end; )
+				{
+					if (data[i] < *src)
+						i++;
+					else if (data[i] > *src)
+						++src;
+					else
+					{
+						data[n++] = data[i++];
+						++src;
+					}
+				}
+			}
+			else
+			{
+				for (FB_SIZE_T i = 0; i < values.getCount(); i++)
+				{
+					if (other.test(data[i]))
+						data[n++] = data[i];
+				}
+			}
+
+			values.shrink(n);
+			count = n;
+			return;
+		}
+
+		switch (other.type)
+		{
+		case TYPE_BITSET:
+			{
+				FB_UINT64* const dst = words;
+				const FB_UINT64* const src = other.words;
+
+				for (ULONG n = 0; n < BITSET_WORDS; n++)
+					dst[n] &= src[n];
+			}
+			break;
+
+		case TYPE_ARRAY:
+			// Result can't be larger than the array, build it directly
+			for (const USHORT* value = other.values.begin(); value != other.values.end(); ++value)
+			{
+				if ((words[*value / WORD_BITS] >> (*value % WORD_BITS)) & 1)
+					values.add(*value);
+			}
+
+			delete[] words;
+			words = NULL;
+			type = TYPE_ARRAY;
+			count = values.getCount();
+			return;
+
+		case TYPE_RUN:
+			{
+				ULONG from = 0;
+
+				for (const Run* run = other.runs.begin(); run != other.runs.end(); ++run)
+				{
+					fillRange(from, run->start, false);
+					from = run->last + 1;
+				}
+
+				fillRange(from, CHUNK_SIZE, false);
+			}
+			break;
+		}
+
+		count = countBits();
+
+		if (count <= ARRAY_MAX)
+			toArray();
+	}
+
+	// Choose the most compact representation
+	void optimize()
+	{
+		const size_t runBytes = countRuns() * sizeof(Run);
+		const size_t plainBytes = (count <= ARRAY_MAX) ?
+			count * sizeof(USHORT) : BITSET_WORDS * sizeof(FB_UINT64);
+
+		if (runBytes < plainBytes)
+		{
+			if (type != TYPE_RUN)
+				toRuns();
+		}
+		else if (type == TYPE_RUN)
+			unpack();
+		else if (type == TYPE_BITSET && count <= ARRAY_MAX)
+			toArray();
+	}
+
+private:
+	RoaringContainer(const RoaringContainer& from); // Not implemented
+	RoaringContainer& operator =(const RoaringContainer& from); // Not implemented
+
+	enum Type : UCHAR
+	{
+		TYPE_ARRAY,
+		TYPE_BITSET,
+		TYPE_RUN
+	};
+
+	struct Run
+	{
+		USHORT start;
+		USHORT last;
+	};
+
+	static const FB_UINT64 WORD_ZERO = 0;
+	static const FB_UINT64 WORD_ONE = 1;
+
+	static unsigned popCount(FB_UINT64 word)
+	{
+#if defined(__GNUC__)
+		return __builtin_popcountll(word);
+#else
+		word = word - ((word >> 1) & QUADCONST(0x5555555555555555));
+		word = (word & QUADCONST(0x3333333333333333)) + ((word >> 2) & QUADCONST(0x3333333333333333));
+		word = (word + (word >> 4)) & QUADCONST(0x0F0F0F0F0F0F0F0F);
+		return (unsigned) ((word * QUADCONST(0x0101010101010101)) >> 56);
+#endif
+	}
+
+	static unsigned lowestBit(FB_UINT64 word)
+	{
+		fb_assert(word);
+#if defined(__GNUC__)
+		return __builtin_ctzll(word);
+#else
+		unsigned n = 0;
+		for (; !(word & 1); word >>= 1)
+			n++;
+		return n;
+#endif
+	}
+
+	static unsigned highestBit(FB_UINT64 word)
+	{
+		fb_assert(word);
+#if defined(__GNUC__)
+		return WORD_BITS - 1 - __builtin_clzll(word);
+#else
+		unsigned n = WORD_BITS - 1;
+		for (; !(word >> n); n--)
+			;
+		return n;
+#endif
+	}
+
+	FB_UINT64* allocWords()
+	{
+		FB_UINT64* const result = FB_NEW_POOL(pool) FB_UINT64[BITSET_WORDS];
+		memset(result, 0, BITSET_WORDS * sizeof(FB_UINT64));
+		return result;
+	}
+
+	// Set pos to the first array element not less than value
+	bool findValue(USHORT value, FB_SIZE_T& pos) const
+	{
+		FB_SIZE_T lo = 0, hi = values.getCount();
+
+		while (lo < hi)
+		{
+			const FB_SIZE_T mid = (lo + hi) / 2;
+			if (values[mid] < value)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+
+		pos = lo;
+		return pos < values.getCount() && values[pos] == value;
+	}
+
+	// Set pos to the first run which does not end before value
+	bool findRun(USHORT value, FB_SIZE_T& pos) const
+	{
+		FB_SIZE_T lo = 0, hi = runs.getCount();
+
+		while (lo < hi)
+		{
+			const FB_SIZE_T mid = (lo + hi) / 2;
+			if (runs[mid].last < value)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+
+		pos = lo;
+		return pos < runs.getCount() && runs[pos].start <= value;
+	}
+
+	// Set or clear bits in range [from, to)
+	void fillRange(ULONG from, ULONG to, bool value)
+	{
+		if (from >= to)
+			return;
+
+		const ULONG first = from / WORD_BITS;
+		const ULONG last = (to - 1) / WORD_BITS;
+		FB_UINT64 firstMask = ~WORD_ZERO << (from % WORD_BITS);
+		const FB_UINT64 lastMask = ~WORD_ZERO >> (WORD_BITS - 1 - (to - 1) % WORD_BITS);
+
+		if (first == last)
+			firstMask &= lastMask;
+
+		if (value)
+			words[first] |= firstMask;
+		else
+			words[first] &= ~firstMask;
+
+		if (first == last)
+			return;
+
+		const FB_UINT64 fill = value ? ~WORD_ZERO : WORD_ZERO;
+		for (ULONG n = first + 1; n < last; n++)
+			words[n] = fill;
+
+		if (value)
+			words[last] |= lastMask;
+		else
+			words[last] &= ~lastMask;
+	}
+
+	ULONG countBits() const
+	{
+		ULONG result = 0;
+
+		for (ULONG n = 0; n < BITSET_WORDS; n++)
+			result += popCount(words[n]);
+
+		return result;
+	}
+
+	ULONG countRuns() const
+	{
+		ULONG result = 0;
+
+		switch (type)
+		{
+		case TYPE_ARRAY:
+			for (FB_SIZE_T i = 0; i < values.getCount(); i++)
+			{
+				if (i == 0 || values[i] != values[i - 1] + 1)
+					result++;
+			}
+			break;
+
+		case TYPE_BITSET:
+			{
+				// Count bits which have no neighbour set below them
+				FB_UINT64 carry = 0;
+
+				for (ULONG n = 0; n < BITSET_WORDS; n++)
+				{
+					const FB_UINT64 word = words[n];
+					result += popCount(word & ~((word << 1) | carry));
+					carry = word >> (WORD_BITS - 1);
+				}
+			}
+			break;
+
+		case TYPE_RUN:
+			result = runs.getCount();
+			break;
+		}
+
+		return result;
+	}
+
+	// Merge another sorted array into ours, moving from the tail to do it in place
+	void mergeValues(const Array<USHORT>& other)
+	{
+		const FB_SIZE_T total = values.getCount() + other.getCount();
+		FB_SIZE_T i = values.getCount(), j = other.getCount(), k = total;
+
+		values.grow(total);
+		USHORT* const data = values.begin();
+		const USHORT* const src = other.begin();
+
+		while (j > 0)
+		{
+			if (i > 0 && data[i - 1] > src[j - 1])
+				data[--k] = data[--i];
+			else
+			{
+				if (i > 0 && data[i - 1] == src[j - 1])
+					--i;
+				data[--k] = src[--j];
+			}
+		}
+
+		// Duplicates left a gap between the untouched head and the merged tail
+		if (k > i)
+		{
+			memmove(data + k - i, data, i * sizeof(USHORT));
+			values.removeRange(0, k - i);
+		}
+
+		count = values.getCount();
+	}
+
+	void toBitset()
+	{
+		fb_assert(type != TYPE_BITSET);
+
+		words = allocWords();
+
+		if (type == TYPE_ARRAY)
+		{
+			for (const USHORT* value = values.begin(); value != values.end(); ++value)
+				words[*value / WORD_BITS] |= WORD_ONE << (*value % WORD_BITS);
+
+			values.free();
+		}
+		else
+		{
+			for (const Run* run = runs.begin(); run != runs.end(); ++run)
+				fillRange(run->start, run->last + 1, true);
+
+			runs.free();
+		}
+
+		type = TYPE_BITSET;
+	}
+
+	void toArray()
+	{
+		fb_assert(type != TYPE_ARRAY && count <= ARRAY_MAX);
+
+		USHORT* data = values.getBuffer(count, false);
+
+		if (type == TYPE_BITSET)
+		{
+			for (ULONG n = 0; n < BITSET_WORDS; n++)
+			{
+				for (FB_UINT64 word = words[n]; word; word &= word - 1)
+					*data++ = (USHORT) (n * WORD_BITS + lowestBit(word));
+			}
+
+			delete[] words;
+			words = NULL;
+		}
+		else
+		{
+			for (const Run* run = runs.begin(); run != runs.end(); ++run)
+			{
+				for (ULONG value = run->start; value <= run->last; value++)
+					*data++ = (USHORT) value;
+			}
+
+			runs.free();
+		}
+
+		fb_assert(data == values.end());
+		type = TYPE_ARRAY;
+	}
+
+	void toRuns()
+	{
+		fb_assert(type != TYPE_RUN);
+
+		if (type == TYPE_ARRAY)
+		{
+			for (const USHORT* value = values.begin(); value != values.end(); ++value)
+			{
+				if (runs.hasData() && runs.back().last + 1 == *value)
+					runs.back().last = *value;
+				else
+				{
+					Run run;
+					run.start = run.last = *value;
+					runs.add(run);
+				}
+			}
+
+			values.free();
+		}
+		else
+		{
+			ULONG from = 0;
+			USHORT start;
+
+			while (findNext(from, start))
+			{
+				// Look for the first clear bit after the start of run
+				ULONG n = start / WORD_BITS;
+				FB_UINT64 word = ~words[n] & (~WORD_ZERO << (start % WORD_BITS));
+
+				while (!word && ++n < BITSET_WORDS)
+					word = ~words[n];
+
+				from = word ? n * WORD_BITS + lowestBit(word) : (ULONG) CHUNK_SIZE;
+
+				Run run;
+				run.start = start;
+				run.last = (USHORT) (from - 1);
+				runs.add(run);
+			}
+
+			delete[] words;
+			words = NULL;
+		}
+
+		type = TYPE_RUN;
+	}
+
+	void unpack()
+	{
+		fb_assert(type == TYPE_RUN);
+
+		if (count <= ARRAY_MAX)
+			toArray();
+		else
+			toBitset();
+	}
+
+	MemoryPool& pool;
+	Array<USHORT> values;
+	Array<Run> runs;
+	FB_UINT64* words;
+	ULONG count;
+	Type type;
+};
+
+
+// Bitmap of integers split into 64K chunks, each kept in a RoaringContainer.
+// Interface and semantics are the same as of SparseBitmap, plus optimize()
+// which should be called when bitmap is fully built to compress dense chunks.
+
+template <typename T>
+class RoaringBitmap : public AutoStorage
+{
+public:
+	// Default constructor, stack placement
+	RoaringBitmap() :
+		singular(false), singular_value(0), tree(&getPool()), defaultAccessor(this)
+	{ }
+
+	// Pooled constructor
+	explicit RoaringBitmap(MemoryPool& p) :
+		AutoStorage(p), singular(false), singular_value(0), tree(&getPool()), defaultAccessor(this)
+	{ }
+
+	~RoaringBitmap()
+	{
+		clear();
+	}
+
+	// Default accessor methods
+	bool locate(T key) { return defaultAccessor.locate(locEqual, key); }
+
+	bool locate(LocType lt, T key) { return defaultAccessor.locate(lt, key); }
+
+	bool getFirst() { return defaultAccessor.getFirst(); }
+
+	bool getLast() { return defaultAccessor.getLast(); }
+
+	bool getNext() { return defaultAccessor.getNext(); }
+
+	bool getPrev() { return defaultAccessor.getPrev(); }
+
+	T current() const { return defaultAccessor.current(); }
+
+	// Set bit
+	void set(T value)
+	{
+		if (singular)
+		{
+			// If we are trying to set the same bit as already set - do nothing
+			if (singular_value == value)
+				return;
+
+			// Add singular value to the tree
+			fb_assert(tree.isEmpty());
+
+			singular = false;
+			getChunk(singular_value)->set(lowPart(singular_value));
+		}
+		else
+		{
+			if (tree.isEmpty())
+			{
+				singular = true;
+				singular_value = value;
+				return;
+			}
+		}
+
+		getChunk(value)->set(lowPart(value));
+	}
+
+	bool clear(T value)
+	{
+		if (singular)
+		{
+			fb_assert(tree.isEmpty());
+
+			if (value == singular_value)
+			{
+				singular = false;
+				return true;
+			}
+			return false;
+		}
+
+		const T val_aligned = value & ~CHUNK_MASK;
+		if (tree.isPositioned(val_aligned) || tree.locate(val_aligned))
+		{
+			RoaringContainer* const container = tree.current().container;
+			if (container->clear(lowPart(value)))
+			{
+				if (!container->getCount())
+				{
+					delete container;
+					tree.fastRemove();
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool test(T value)
+	{
+		if (singular)
+		{
+			fb_assert(tree.isEmpty());
+			return (value == singular_value);
+		}
+
+		const T val_aligned = value & ~CHUNK_MASK;
+		if (tree.isPositioned(val_aligned) || tree.locate(val_aligned))
+			return tree.current().container->test(lowPart(value));
+
+		return false;
+	}
+
+	static bool test(RoaringBitmap* bitmap, T value)
+	{
+		if (!bitmap)
+			return false;
+		return bitmap->test(value);
+	}
+
+	// Clear bitmap if it is not NULL
+	static void reset(RoaringBitmap* bitmap)
+	{
+		if (bitmap)
+			bitmap->clear();
+	}
+
+	size_t approxSize() const
+	{
+		size_t size = sizeof(*this) + tree.approxSize();
+
+		typename ChunkTree::ConstAccessor accessor(&tree);
+		if (accessor.getFirst())
+		{
+			do {
+				size += accessor.current().container->approxSize();
+			} while (accessor.getNext());
+		}
+
+		return size;
+	}
+
+	// Make bitmap empty
+	void clear()
+	{
+		singular = false;
+
+		if (tree.getFirst())
+		{
+			do {
+				delete tree.current().container;
+			} while (tree.getNext());
+		}
+
+		tree.clear();
+	}
+
+	// Convert every chunk to its most compact form
+	void optimize()
+	{
+		if (tree.getFirst())
+		{
+			do {
+				tree.current().container->optimize();
+			} while (tree.getNext());
+		}
+	}
+
+ 	// Compute the union of two bitmaps.
+	// Note: this method uses one of the bitmaps to return result
+	static RoaringBitmap** bit_or(RoaringBitmap** bitmap1, RoaringBitmap** bitmap2);
+
+ 	// Compute the intersection of two bitmaps.
+	// Note: this method uses one of the bitmaps to return result
+	static RoaringBitmap** bit_and(RoaringBitmap** bitmap1, RoaringBitmap** bitmap2);
+
+protected:
+	static const T CHUNK_MASK = (T) RoaringContainer::CHUNK_SIZE - 1;
+
+	static USHORT lowPart(T value)
+	{
+		return (USHORT) (value & CHUNK_MASK);
+	}
+
+	// Chunk of values sharing the same high bits
+	struct Chunk
+	{
+		T start_value;					// starting value, CHUNK_SIZE-aligned
+		RoaringContainer* container;	// chunk data, never empty
+		inline static const T& generate(const void* /*sender*/, const Chunk& i)
+		{
+			return i.start_value;
+		}
+	};
+
+	typedef BePlusTree<Chunk, T, MemoryPool, Chunk> ChunkTree;
+	typedef typename ChunkTree::Accessor ChunkTreeAccessor;
+
+	// Find or create the container for given value
+	RoaringContainer* getChunk(T value)
+	{
+		const T val_aligned = value & ~CHUNK_MASK;
+		if (tree.isPositioned(val_aligned) || tree.locate(val_aligned))
+			return tree.current().container;
+
+		addChunk(val_aligned, FB_NEW_POOL(getPool()) RoaringContainer(getPool()));
+		return tree.current().container;
+	}
+
+	// Add new chunk and position the tree on it
+	void addChunk(T start_value, RoaringContainer* container)
+	{
+		AutoPtr<RoaringContainer> guard(container);
+
+		Chunk chunk;
+		chunk.start_value = start_value;
+		chunk.container = container;
+		tree.add(chunk);
+		guard.release();
+
+		tree.locate(start_value);
+	}
+
+	// Set if bitmap contains a single value only
+	bool singular;
+	T singular_value;
+
+	ChunkTree tree;
+
+private:
+	RoaringBitmap(const RoaringBitmap& from); // Copy constructor. Not implemented for now.
+	RoaringBitmap& operator =(const RoaringBitmap& from); // Assignment operator. Not implemented for now.
+
+public:
+	class Accessor
+	{
+	public:
+		Accessor(RoaringBitmap* _bitmap) :
+			bitmap(_bitmap), treeAccessor(_bitmap ? &_bitmap->tree : NULL), current_value(0)
+		{}
+
+		bool locate(T key)
+		{
+			return locate(locEqual, key);
+		}
+
+		// Position accessor on item having LocType relationship with given key
+		// If method returns false position of accessor is not defined.
+		bool locate(LocType lt, T key)
+		{
+			// Small convenience related to fact engine likes to use NULL bitmap pointers
+			if (!bitmap)
+				return false;
+
+			if (bitmap->singular)
+			{
+				// Trivial handling for singular bitmap
+				current_value = bitmap->singular_value;
+
+				switch (lt)
+				{
+				case locEqual:
+					return current_value == key;
+				case locGreatEqual:
+					return current_value >= key;
+				case locLessEqual:
+					return current_value <= key;
+				case locLess:
+					return current_value < key;
+				case locGreat:
+					return current_value > key;
+				}
+				return false;
+			}
+
+			// Transform locLess and locGreat to locLessEqual and locGreatEqual
+			switch (lt)
+			{
+				case locLess:
+					if (key == 0)
+						return false;
+					key--;
+					lt = locLessEqual;
+					break;
+				case locGreat:
+					if (key == ~(T)0)
+						return false;
+					key++;
+					lt = locGreatEqual;
+					break;
+				default:
+					break;
+			}
+
+			// Look up a chunk for our key
+			const T key_aligned = key & ~CHUNK_MASK;
+			if (!treeAccessor.locate(lt, key_aligned))
+			{
+				// If we didn't find the desired chunk no way we can find desired value
+				return false;
+			}
+
+			const Chunk& chunk = treeAccessor.current();
+			USHORT found;
+
+			switch (lt)
+			{
+				case locEqual:
+					current_value = key;
+					return chunk.container->test(lowPart(key));
+
+				case locGreatEqual:
+				{
+					const ULONG from = (chunk.start_value == key_aligned) ? lowPart(key) : 0;
+					if (chunk.container->findNext(from, found))
+					{
+						current_value = chunk.start_value + found;
+						return true;
+					}
+
+					return nextChunk();
+				}
+
+				case locLessEqual:
+				{
+					const SLONG from = (chunk.start_value == key_aligned) ?
+						lowPart(key) : RoaringContainer::CHUNK_SIZE - 1;
+					if (chunk.container->findPrev(from, found))
+					{
+						current_value = chunk.start_value + found;
+						return true;
+					}
+
+					return prevChunk();
+				}
+
+				default:
+					break;
+			}
+			fb_assert(false); // Invalid constant is used ?
+			return false;
+		}
+
+		// If method returns false it means list is empty and
+		// position of accessor is not defined.
+		bool getFirst()
+		{
+			// Small convenience related to fact engine likes to use NULL bitmap pointers
+			if (!bitmap)
+				return false;
+
+			if (bitmap->singular)
+			{
+				current_value = bitmap->singular_value;
+				return true;
+			}
+
+			if (!treeAccessor.getFirst())
+				return false;
+
+			return firstInChunk();
+		}
+
+		// If method returns false it means list is empty and
+		// position of accessor is not defined.
+		bool getLast()
+		{
+			// Small convenience related to fact engine likes to use NULL bitmap pointers
+			if (!bitmap)
+				return false;
+
+			if (bitmap->singular)
+			{
+				current_value = bitmap->singular_value;
+				return true;
+			}
+
+			if (!treeAccessor.getLast())
+				return false;
+
+			return lastInChunk();
+		}
+
+		// Accessor position must be establised via successful call to getFirst(),
+		// getLast() or locate() before you can call this method
+		bool getNext()
+		{
+			if (bitmap->singular)
+				return false;
+
+			const Chunk& chunk = treeAccessor.current();
+			USHORT found;
+
+			if (chunk.container->findNext((ULONG) (current_value - chunk.start_value) + 1, found))
+			{
+				current_value = chunk.start_value + found;
+				return true;
+			}
+
+			return nextChunk();
+		}
+
+		// Accessor position must be establised via successful call to getFirst(),
+		// getLast() or locate() before you can call this method
+		bool getPrev()
+		{
+			if (bitmap->singular)
+				return false;
+
+			const Chunk& chunk = treeAccessor.current();
+			USHORT found;
+
+			if (chunk.container->findPrev((SLONG) (current_value - chunk.start_value) - 1, found))
+			{
+				current_value = chunk.start_value + found;
+				return true;
+			}
+
+			return prevChunk();
+		}
+
+	    T current() const { return current_value; }
+
+	private:
+		bool firstInChunk()
+		{
+			const Chunk& chunk = treeAccessor.current();
+			USHORT found;
+
+			// Chunk must contain one value at least
+			if (!chunk.container->findNext(0, found))
+			{
+				fb_assert(false);
+				return false;
+			}
+
+			current_value = chunk.start_value + found;
+			return true;
+		}
+
+		bool lastInChunk()
+		{
+			const Chunk& chunk = treeAccessor.current();
+			USHORT found;
+
+			// Chunk must contain one value at least
+			if (!chunk.container->findPrev(RoaringContainer::CHUNK_SIZE - 1, found))
+			{
+				fb_assert(false);
+				return false;
+			}
+
+			current_value = chunk.start_value + found;
+			return true;
+		}
+
+		bool nextChunk()
+		{
+			return treeAccessor.getNext() && firstInChunk();
+		}
+
+		bool prevChunk()
+		{
+			return treeAccessor.getPrev() && lastInChunk();
+		}
+
+		RoaringBitmap* bitmap;
+		ChunkTreeAccessor treeAccessor;
+		T current_value;
+	};
+private:
+	Accessor defaultAccessor;
+
+	friend class Accessor;
+};
+
+template <typename T>
+RoaringBitmap<T>** RoaringBitmap<T>::bit_or(RoaringBitmap<T>** bitmap1, RoaringBitmap<T>** bitmap2)
+{
+	RoaringBitmap *map1, *map2;
+
+	// Handle the case when one or the other of the bitmaps is NULL
+	if (!bitmap1 || !(map1 = *bitmap1)) {
+		return bitmap2;
+	}
+
+	if (!bitmap2 || !(map2 = *bitmap2)) {
+		return bitmap1;
+	}
+
+	// Make sure we work on 2 different bitmaps
+	fb_assert(map1 != map2);
+
+	// First bitmap is singular. Set appropriate bit in second and return it
+	if (map1->singular)
+	{
+		map2->set(map1->singular_value);
+		return bitmap2;
+	}
+
+	// Second bitmap is singular. Set appropriate bit in first and return it
+	if (map2->singular)
+	{
+		map1->set(map2->singular_value);
+		return bitmap1;
+	}
+
+	RoaringBitmap *source, *dest, **result;
+
+	// If second bitmap seems larger then use it as a target
+	if (map2->tree.seemsBiggerThan(map1->tree))
+	{
+		dest = map2;
+		source = map1;
+		result = bitmap2;
+	}
+	else
+	{
+		dest = map1;
+		source = map2;
+		result = bitmap1;
+	}
+
+	MemoryPool& pool = dest->getPool();
+
+	// Source chunks are copied, as source bitmap remains owned by the caller
+	for (bool sourceFound = source->tree.getFirst(); sourceFound; sourceFound = source->tree.getNext())
+	{
+		const Chunk& chunk = source->tree.current();
+
+		if (dest->tree.isPositioned(chunk.start_value) || dest->tree.locate(chunk.start_value))
+			dest->tree.current().container->unite(*chunk.container);
+		else
+		{
+			dest->addChunk(chunk.start_value,
+				FB_NEW_POOL(pool) RoaringContainer(pool, *chunk.container));
+		}
+	}
+
+	return result;
+}
+
+template <typename T>
+RoaringBitmap<T>** RoaringBitmap<T>::bit_and(RoaringBitmap<T>** bitmap1, RoaringBitmap<T>** bitmap2)
+{
+	RoaringBitmap *map1, *map2;
+
+	// Handle the case when one or the other of the bitmaps is NULL
+	if (!bitmap1 || !bitmap2 || !(map1 = *bitmap1) || !(map2 = *bitmap2)) {
+		return NULL;
+	}
+
+	// Make sure we work on 2 different bitmaps
+	fb_assert(map1 != map2);
+
+	// First bitmap is singular. Test appropriate bit in second and return first
+	if (map1->singular)
+	{
+		if (map2->test(map1->singular_value))
+			return bitmap1;
+
+		return NULL;
+	}
+
+	// Second bitmap is singular. Test appropriate bit in first and return second
+	if (map2->singular)
+	{
+		if (map1->test(map2->singular_value))
+			return bitmap2;
+
+		return NULL;
+	}
+
+	RoaringBitmap *source, *dest, **result;
+
+	// If second bitmap seems smaller then use it as a target
+	if (map1->tree.seemsBiggerThan(map2->tree))
+	{
+		dest = map2;
+		source = map1;
+		result = bitmap2;
+	}
+	else
+	{
+		dest = map1;
+		source = map2;
+		result = bitmap1;
+	}
+
+	bool destFound = dest->tree.getFirst();
+
+	while (destFound)
+	{
+		const T destValue = dest->tree.current().start_value;
+		RoaringContainer* const container = dest->tree.current().container;
+
+		// Chunks missing in the source vanish, others are intersected
+		if (source->tree.locate(destValue))
+		{
+			container->intersect(*source->tree.current().container);
+
+			if (container->getCount())
+			{
+				destFound = dest->tree.getNext();
+				continue;
+			}
+		}
+
+		delete container;
+		destFound = dest->tree.fastRemove();
+	}
+
+	return result;
+}
+
+} // namespace Firebird
+
+#endif // ROARING_BITMAP_H
@@ -0,0 +1,109 @@
+#include "firebird.h"
+#include "boost/test/unit_test.hpp"
+#include "../common/classes/BloomFilter.h"
+
+using namespace Firebird;
+
+// Spread consecutive numbers like a real hash function does
+static ULONG mix(ULONG value)
+{
+	value ^= value >> 16;
+	value *= 0x85EBCA6B;
+	value ^= value >> 13;
+	value *= 0xC2B2AE35;
+	value ^= value >> 16;
+	return value;
+}
+
+static void fill(Array<ULONG>& hashes, ULONG from, ULONG to)
+{
+	for (ULONG value = from; value < to; value++)
+		hashes.add(mix(value));
+}
+
+BOOST_AUTO_TEST_SUITE(CommonSuite)
+BOOST_AUTO_TEST_SUITE(BloomFilterSuite)
+
+
+BOOST_AUTO_TEST_SUITE(BloomFilterTests)
+
+BOOST_AUTO_TEST_CASE(EmptyTest)
+{
+	BloomFilter filter(*getDefaultMemoryPool());
+	BOOST_TEST(filter.getCount() == 0u);
+
+	// Nothing to check against - everything passes
+	BOOST_TEST(filter.check(0));
+	BOOST_TEST(filter.check(mix(1)));
+
+	// Empty group rejects everything
+	Array<ULONG> hashes(*getDefaultMemoryPool());
+	filter.add(hashes);
+	BOOST_TEST(filter.getCount() == 1u);
+	BOOST_TEST(!filter.check(mix(1)));
+}
+
+BOOST_AUTO_TEST_CASE(NoFalseNegativesTest)
+{
+	BloomFilter filter(*getDefaultMemoryPool());
+
+	Array<ULONG> hashes(*getDefaultMemoryPool());
+	fill(hashes, 0, 10000);
+	filter.add(hashes);
+
+	for (const auto hash : hashes)
+		BOOST_TEST(filter.check(hash));
+}
+
+BOOST_AUTO_TEST_CASE(FalsePositiveRateTest)
+{
+	BloomFilter filter(*getDefaultMemoryPool());
+
+	Array<ULONG> hashes(*getDefaultMemoryPool());
+	fill(hashes, 0, 10000);
+	filter.add(hashes);
+
+	// At least 8 bits per key and 3 hash functions keep false positives within few percents
+	unsigned passed = 0;
+	for (ULONG value = 100000; value < 200000; value++)
+	{
+		if (filter.check(mix(value)))
+			passed++;
+	}
+
+	BOOST_TEST(passed < 10000u);
+}
+
+BOOST_AUTO_TEST_CASE(SeveralGroupsTest)
+{
+	BloomFilter filter(*getDefaultMemoryPool());
+
+	Array<ULONG> hashes1(*getDefaultMemoryPool());
+	fill(hashes1, 0, 1000);
+	filter.add(hashes1);
+
+	Array<ULONG> hashes2(*getDefaultMemoryPool());
+	fill(hashes2, 500, 1500);
+	filter.add(hashes2);
+
+	BOOST_TEST(filter.getCount() == 2u);
+
+	// Hash should be present in every group
+	for (ULONG value = 500; value < 1000; value++)
+		BOOST_TEST(filter.check(mix(value)));
+
+	unsigned passed = 0;
+	for (ULONG value = 1000; value < 1500; value++)
+	{
+		if (filter.check(mix(value)))
+			passed++;
+	}
+
+	BOOST_TEST(passed < 100u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()	// BloomFilterTests
+
+
+BOOST_AUTO_TEST_SUITE_END()	// BloomFilterSuite
+BOOST_AUTO_TEST_SUITE_END()	// CommonSuite
@@ -0,0 +1,168 @@
+#include "firebird.h"
+#include "boost/test/unit_test.hpp"
+#include "../common/classes/roaring_bitmap.h"
+#include <set>
+
+using namespace Firebird;
+
+typedef RoaringBitmap<FB_UINT64> Bitmap;
+typedef std::set<FB_UINT64> Reference;
+
+static void fill(Bitmap& bitmap, Reference& reference, FB_UINT64 from, FB_UINT64 to, FB_UINT64 step)
+{
+	for (FB_UINT64 value = from; value < to; value += step)
+	{
+		bitmap.set(value);
+		reference.insert(value);
+	}
+}
+
+static bool matches(Bitmap& bitmap, const Reference& reference)
+{
+	Reference::const_iterator iter = reference.begin();
+
+	if (bitmap.getFirst())
+	{
+		do {
+			if (iter == reference.end() || *iter != bitmap.current())
+				return false;
+			++iter;
+		} while (bitmap.getNext());
+	}
+
+	return iter == reference.end();
+}
+
+BOOST_AUTO_TEST_SUITE(CommonSuite)
+BOOST_AUTO_TEST_SUITE(RoaringBitmapSuite)
+
+
+BOOST_AUTO_TEST_SUITE(RoaringBitmapTests)
+
+BOOST_AUTO_TEST_CASE(SetTestClearTest)
+{
+	Bitmap bitmap(*getDefaultMemoryPool());
+	Reference reference;
+
+	// Sparse chunk stays an array, dense one becomes a bitset
+	fill(bitmap, reference, 0, 100000, 37);
+	fill(bitmap, reference, 200000, 210000, 1);
+
+	BOOST_TEST(matches(bitmap, reference));
+	BOOST_TEST(bitmap.test(37));
+	BOOST_TEST(!bitmap.test(38));
+	BOOST_TEST(bitmap.test(205000));
+
+	for (FB_UINT64 value = 200000; value < 210000; value += 2)
+	{
+		BOOST_TEST(bitmap.clear(value));
+		reference.erase(value);
+	}
+
+	BOOST_TEST(!bitmap.clear(200000));
+	BOOST_TEST(matches(bitmap, reference));
+
+	bitmap.clear();
+	BOOST_TEST(!bitmap.getFirst());
+}
+
+BOOST_AUTO_TEST_CASE(OptimizeTest)
+{
+	Bitmap bitmap(*getDefaultMemoryPool());
+	Reference reference;
+
+	fill(bitmap, reference, 0, 65536 * 3, 1);
+	fill(bitmap, reference, 65536 * 5 + 10, 65536 * 5 + 20, 1);
+
+	const size_t plainSize = bitmap.approxSize();
+	bitmap.optimize();
+
+	BOOST_TEST(bitmap.approxSize() < plainSize);
+	BOOST_TEST(matches(bitmap, reference));
+	BOOST_TEST(bitmap.test(65536));
+	BOOST_TEST(!bitmap.test(65536 * 5 + 20));
+
+	// Modification of a run container
+	bitmap.set(65536 * 5 + 30);
+	reference.insert(65536 * 5 + 30);
+	BOOST_TEST(bitmap.clear(1000));
+	reference.erase(1000);
+
+	BOOST_TEST(matches(bitmap, reference));
+}
+
+BOOST_AUTO_TEST_CASE(LocateTest)
+{
+	Bitmap bitmap(*getDefaultMemoryPool());
+	Reference reference;
+
+	fill(bitmap, reference, 100, 70000, 1000);
+	bitmap.optimize();
+
+	BOOST_TEST(bitmap.locate(locGreatEqual, 101));
+	BOOST_TEST(bitmap.current() == 1100u);
+
+	BOOST_TEST(bitmap.locate(locLessEqual, 65535));
+	BOOST_TEST(bitmap.current() == 65100u);
+
+	BOOST_TEST(bitmap.locate(locGreat, 65100));
+	BOOST_TEST(bitmap.current() == 66100u);
+
+	BOOST_TEST(bitmap.getPrev());
+	BOOST_TEST(bitmap.current() == 65100u);
+
+	BOOST_TEST(!bitmap.locate(locLess, 100));
+	BOOST_TEST(!bitmap.locate(locGreat, 69100));
+
+	BOOST_TEST(bitmap.getLast());
+	BOOST_TEST(bitmap.current() == 69100u);
+}
+
+BOOST_AUTO_TEST_CASE(BitOrTest)
+{
+	Bitmap* bitmap1 = FB_NEW_POOL(*getDefaultMemoryPool()) Bitmap(*getDefaultMemoryPool());
+	Bitmap* bitmap2 = FB_NEW_POOL(*getDefaultMemoryPool()) Bitmap(*getDefaultMemoryPool());
+	Reference reference;
+
+	fill(*bitmap1, reference, 0, 300000, 3);
+	fill(*bitmap2, reference, 0, 300000, 5);
+	fill(*bitmap2, reference, 500000, 500100, 1);
+	bitmap2->optimize();
+
+	Bitmap** result = Bitmap::bit_or(&bitmap1, &bitmap2);
+	BOOST_TEST(matches(**result, reference));
+
+	delete bitmap1;
+	delete bitmap2;
+}
+
+BOOST_AUTO_TEST_CASE(BitAndTest)
+{
+	Bitmap* bitmap1 = FB_NEW_POOL(*getDefaultMemoryPool()) Bitmap(*getDefaultMemoryPool());
+	Bitmap* bitmap2 = FB_NEW_POOL(*getDefaultMemoryPool()) Bitmap(*getDefaultMemoryPool());
+	Reference reference1, reference2, reference;
+
+	fill(*bitmap1, reference1, 0, 300000, 2);
+	fill(*bitmap1, reference1, 400000, 410000, 1);
+	fill(*bitmap2, reference2, 0, 200000, 3);
+	fill(*bitmap2, reference2, 405000, 420000, 1);
+	bitmap1->optimize();
+
+	for (Reference::const_iterator iter = reference1.begin(); iter != reference1.end(); ++iter)
+	{
+		if (reference2.count(*iter))
+			reference.insert(*iter);
+	}
+
+	Bitmap** result = Bitmap::bit_and(&bitmap1, &bitmap2);
+	BOOST_TEST(matches(**result, reference));
+
+	delete bitmap1;
+	delete bitmap2;
+}
+
+BOOST_AUTO_TEST_SUITE_END()	// RoaringBitmapTests
+
+
+BOOST_AUTO_TEST_SUITE_END()	// RoaringBitmapSuite
+BOOST_AUTO_TEST_SUITE_END()	// CommonSuite
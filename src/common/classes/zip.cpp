@@ -53,6 +53,10 @@ void ZLib::symbols()
 	FB_ZSYMB(inflate)
 	FB_ZSYMB(deflateEnd)
 	FB_ZSYMB(inflateEnd)
+	FB_ZSYMB(compressBound)
+	FB_ZSYMB(compress2)
+	FB_ZSYMB(uncompress)
+	FB_ZSYMB(crc32)
 #undef FB_ZSYMB
 }
 
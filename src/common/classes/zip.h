@@ -45,6 +45,10 @@ namespace Firebird {
 		int ZEXPORT (*inflate)(z_stream* strm, int flush);
 		void ZEXPORT (*deflateEnd)(z_stream* strm);
 		void ZEXPORT (*inflateEnd)(z_stream* strm);
+		uLong ZEXPORT (*compressBound)(uLong sourceLen);
+		int ZEXPORT (*compress2)(Bytef* dest, uLongf* destLen, const Bytef* source, uLong sourceLen, int level);
+		int ZEXPORT (*uncompress)(Bytef* dest, uLongf* destLen, const Bytef* source, uLong sourceLen);
+		uLong ZEXPORT (*crc32)(uLong crc, const Bytef* buf, uInt len);
 
 		operator bool() { return z.hasData(); }
 		bool operator!() { return !z.hasData(); }
@@ -192,6 +192,12 @@ enum ConfigKey
 	KEY_MAX_STATEMENT_CACHE_SIZE,
 	KEY_PARALLEL_WORKERS,
 	KEY_MAX_PARALLEL_WORKERS,
+	KEY_NBACKUP_CHANGE_MAP,
+	KEY_MONITORING_REFRESH_INTERVAL,
+	KEY_ATTACHMENT_POOL_SIZE,
+	KEY_SRP_TICKET_LIFETIME,
+	KEY_EXT_FUNCTION_BATCH_SIZE,
+	KEY_TEMP_COMPRESSION,
 	MAX_CONFIG_KEY		// keep it last
 };
 
@@ -310,7 +316,13 @@ constexpr ConfigEntry entries[MAX_CONFIG_KEY] =
 	{TYPE_STRING,	"TempTableDirectory",		false,	""},
 	{TYPE_INTEGER,	"MaxStatementCacheSize",	false,	2 * 1048576},	// bytes
 	{TYPE_INTEGER,	"ParallelWorkers",			true,	1},
-	{TYPE_INTEGER,	"MaxParallelWorkers",		true,	1}
+	{TYPE_INTEGER,	"MaxParallelWorkers",		true,	1},
+	{TYPE_BOOLEAN,	"NBackupChangeMap",			false,	false},
+	{TYPE_INTEGER,	"MonitoringRefreshInterval",	false,	0},		// seconds
+	{TYPE_INTEGER,	"AttachmentPoolSize",		true,	0},
+	{TYPE_INTEGER,	"SrpTicketLifetime",		false,	0},		// seconds
+	{TYPE_INTEGER,	"ExternalFunctionBatchSize",	false,	1},
+	{TYPE_BOOLEAN,	"TempCompression",			false,	false}
 };
 
 
@@ -638,6 +650,18 @@ public:
 	CONFIG_GET_GLOBAL_INT(getParallelWorkers, KEY_PARALLEL_WORKERS);
 
 	CONFIG_GET_GLOBAL_INT(getMaxParallelWorkers, KEY_MAX_PARALLEL_WORKERS);
+
+	CONFIG_GET_PER_DB_BOOL(getNBackupChangeMap, KEY_NBACKUP_CHANGE_MAP);
+
+	CONFIG_GET_PER_DB_INT(getMonitoringRefreshInterval, KEY_MONITORING_REFRESH_INTERVAL);
+
+	CONFIG_GET_GLOBAL_INT(getAttachmentPoolSize, KEY_ATTACHMENT_POOL_SIZE);
+
+	CONFIG_GET_PER_DB_INT(getSrpTicketLifetime, KEY_SRP_TICKET_LIFETIME);
+
+	CONFIG_GET_PER_DB_INT(getExternalFunctionBatchSize, KEY_EXT_FUNCTION_BATCH_SIZE);
+
+	CONFIG_GET_PER_DB_BOOL(getTempCompression, KEY_TEMP_COMPRESSION);
 };
 
 // Implementation of interface to access master configuration file
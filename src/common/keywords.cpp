@@ -387,6 +387,7 @@ static const TOK tokens[] =
 	{TOK_RDB_GET_CONTEXT, "RDB$GET_CONTEXT", false},
 	{TOK_RDB_GET_TRANSACTION_CN, "RDB$GET_TRANSACTION_CN", false},
 	{TOK_RDB_RECORD_VERSION, "RDB$RECORD_VERSION", false},
+	{TOK_RDB_RESET_STATEMENT_STATISTICS, "RDB$RESET_STATEMENT_STATISTICS", false},
 	{TOK_RDB_ROLE_IN_USE, "RDB$ROLE_IN_USE", false},
 	{TOK_RDB_SET_CONTEXT, "RDB$SET_CONTEXT", false},
 	{TOK_RDB_SYSTEM_PRIVILEGE, "RDB$SYSTEM_PRIVILEGE", false},
@@ -0,0 +1,151 @@
+#include "firebird.h"
+#include "boost/test/unit_test.hpp"
+#include "../common/unicode_util.h"
+#include <string.h>
+
+using namespace Firebird;
+using namespace Jrd;
+
+// Weights resembling a case sensitive collation: controls are ignorable,
+// letters of different case share the primary weight
+static void fillWeights(UnicodeUtil::AsciiWeights& weights, bool primaryOnly)
+{
+	weights.valid = true;
+	weights.primaryOnly = primaryOnly;
+
+	UCHAR rank = 0;
+
+	for (unsigned ch = 0; ch < 128; ++ch)
+	{
+		if (ch < 0x20 || ch == 0x7F)
+			weights.primary[ch] = 0;
+		else if (ch >= 'a' && ch <= 'z')
+			weights.primary[ch] = weights.primary[ch - 'a' + 'A'];
+		else
+			weights.primary[ch] = ++rank;
+	}
+}
+
+// Returns 2 when the result is left to ICU
+static int compare(const UnicodeUtil::AsciiWeights& weights, const char* str1, const char* str2)
+{
+	SSHORT result;
+
+	if (!weights.compare(strlen(str1), reinterpret_cast<const UCHAR*>(str1),
+			strlen(str2), reinterpret_cast<const UCHAR*>(str2), &result))
+	{
+		return 2;
+	}
+
+	return result;
+}
+
+static int compare(const UnicodeUtil::AsciiWeights& weights,
+	ULONG len1, const USHORT* str1, ULONG len2, const USHORT* str2)
+{
+	SSHORT result;
+
+	if (!weights.compare(len1, str1, len2, str2, &result))
+		return 2;
+
+	return result;
+}
+
+
+BOOST_AUTO_TEST_SUITE(CommonSuite)
+BOOST_AUTO_TEST_SUITE(UnicodeUtilSuite)
+BOOST_AUTO_TEST_SUITE(AsciiWeightsTests)
+
+BOOST_AUTO_TEST_CASE(InvalidTest)
+{
+	UnicodeUtil::AsciiWeights weights;
+
+	BOOST_TEST(compare(weights, "a", "a") == 2);
+	BOOST_TEST(compare(weights, "a", "b") == 2);
+
+	fillWeights(weights, true);
+	BOOST_TEST(compare(weights, "a", "b") == -1);
+
+	// Not 7-bit characters
+	BOOST_TEST(compare(weights, "a\xC3\xA1", "b") == 2);
+	BOOST_TEST(compare(weights, "b", "\x80") == 2);
+}
+
+BOOST_AUTO_TEST_CASE(PrimaryTest)
+{
+	UnicodeUtil::AsciiWeights weights;
+	fillWeights(weights, false);
+
+	BOOST_TEST(compare(weights, "abc", "abd") == -1);
+	BOOST_TEST(compare(weights, "abd", "abc") == 1);
+	BOOST_TEST(compare(weights, "1", "a") == -1);
+
+	// Primary difference wins over the case one
+	BOOST_TEST(compare(weights, "ABC", "abd") == -1);
+	BOOST_TEST(compare(weights, "b", "A") == 1);
+
+	// Shorter string is less
+	BOOST_TEST(compare(weights, "ab", "abc") == -1);
+	BOOST_TEST(compare(weights, "abc", "ab") == 1);
+	BOOST_TEST(compare(weights, "", "a") == -1);
+	BOOST_TEST(compare(weights, "a", "") == 1);
+	BOOST_TEST(compare(weights, "", "") == 0);
+}
+
+BOOST_AUTO_TEST_CASE(IgnorableTest)
+{
+	UnicodeUtil::AsciiWeights weights;
+	fillWeights(weights, false);
+
+	BOOST_TEST(compare(weights, "a\x01" "c", "ab") == 1);
+	BOOST_TEST(compare(weights, "\x02" "ab", "ac\x02") == -1);
+	BOOST_TEST(compare(weights, "ab\x01", "ab" "c") == -1);
+
+	// Same primary weights of different strings
+	BOOST_TEST(compare(weights, "a\x01" "b", "ab") == 2);
+	BOOST_TEST(compare(weights, "\x01", "") == 2);
+
+	fillWeights(weights, true);
+	BOOST_TEST(compare(weights, "a\x01" "b", "ab") == 0);
+	BOOST_TEST(compare(weights, "\x01", "") == 0);
+}
+
+BOOST_AUTO_TEST_CASE(LowerLevelsTest)
+{
+	UnicodeUtil::AsciiWeights weights;
+	fillWeights(weights, false);
+
+	BOOST_TEST(compare(weights, "abc", "abc") == 0);
+	BOOST_TEST(compare(weights, "abc", "ABC") == 2);
+	BOOST_TEST(compare(weights, "Abc", "aBc") == 2);
+
+	fillWeights(weights, true);
+	BOOST_TEST(compare(weights, "abc", "ABC") == 0);
+	BOOST_TEST(compare(weights, "Abc", "aBc") == 0);
+}
+
+BOOST_AUTO_TEST_CASE(Utf16Test)
+{
+	UnicodeUtil::AsciiWeights weights;
+	fillWeights(weights, false);
+
+	const USHORT lower[] = {'a', 'b', 'c'};
+	const USHORT upper[] = {'A', 'B', 'D'};
+	const USHORT accented[] = {'a', 0xE1, 'c'};
+	const USHORT high[] = {'a', 0x100 + 'b', 'c'};
+
+	BOOST_TEST(compare(weights, 3, lower, 3, upper) == -1);
+	BOOST_TEST(compare(weights, 2, upper, 2, lower) == 2);
+	BOOST_TEST(compare(weights, 3, lower, 3, lower) == 0);
+	BOOST_TEST(compare(weights, 1, upper, 3, lower) == -1);
+
+	// Characters above 7-bit must not be truncated to the table
+	BOOST_TEST(compare(weights, 3, accented, 3, lower) == 2);
+	BOOST_TEST(compare(weights, 3, lower, 3, high) == 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()	// AsciiWeightsTests
+
+
+BOOST_AUTO_TEST_SUITE_END()	// UnicodeUtilSuite
+BOOST_AUTO_TEST_SUITE_END()	// CommonSuite
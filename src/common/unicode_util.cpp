@@ -287,6 +287,12 @@ public:
 		UColAttributeValue value, UErrorCode* status);
 	UCollationResult (U_EXPORT2 *ucolStrColl)(const UCollator* coll, const UChar* source,
 		int32_t sourceLength, const UChar* target, int32_t targetLength);
+	// optional UTF-8 entries, NULL when not exported by the loaded ICU
+	UCollationResult (U_EXPORT2 *ucolStrCollUTF8)(const UCollator* coll, const char* source,
+		int32_t sourceLength, const char* target, int32_t targetLength, UErrorCode* status);
+	UCollationResult (U_EXPORT2 *ucolStrCollIter)(const UCollator* coll, UCharIterator* sIter,
+		UCharIterator* tIter, UErrorCode* status);
+	void (U_EXPORT2 *uiterSetUTF8)(UCharIterator* iter, const char* s, int32_t length);
 	void (U_EXPORT2 *ucolGetVersion)(const UCollator* coll, UVersionInfo info);
 
 	void (U_EXPORT2 *utransClose)(UTransliterator* trans);
@@ -1265,6 +1271,9 @@ UnicodeUtil::ICU* UnicodeUtil::loadICU(const string& icuVersion, const string& c
 			icu->getEntryPoint("ucol_openRules", icu->inModule, icu->ucolOpenRules);
 			icu->getEntryPoint("ucol_setAttribute", icu->inModule, icu->ucolSetAttribute);
 			icu->getEntryPoint("ucol_strcoll", icu->inModule, icu->ucolStrColl);
+			icu->getEntryPoint("ucol_strcollUTF8", icu->inModule, icu->ucolStrCollUTF8, true);
+			icu->getEntryPoint("ucol_strcollIter", icu->inModule, icu->ucolStrCollIter, true);
+			icu->getEntryPoint("uiter_setUTF8", icu->ucModule, icu->uiterSetUTF8, true);
 			icu->getEntryPoint("ucol_getVersion", icu->inModule, icu->ucolGetVersion);
 			icu->getEntryPoint("utrans_openU", icu->inModule, icu->utransOpenU);
 			icu->getEntryPoint("utrans_close", icu->inModule, icu->utransClose);
@@ -1638,9 +1647,32 @@ UnicodeUtil::Utf16Collation* UnicodeUtil::Utf16Collation::create(
 	obj->numericSort = isNumericSort;
 	obj->maxContractionsPrefixLength = 0;
 
+	obj->asciiWeights.valid = !isNumericSort;
+	obj->asciiWeights.primaryOnly =
+		(attributes & (TEXTTYPE_ATTR_CASE_INSENSITIVE | TEXTTYPE_ATTR_ACCENT_INSENSITIVE)) ==
+			(TEXTTYPE_ATTR_CASE_INSENSITIVE | TEXTTYPE_ATTR_ACCENT_INSENSITIVE);
+
 	USet* contractions = icu->usetOpen(1, 0);
+	USet* expansions = icu->usetOpen(1, 0);
 	// status not verified here.
-	icu->ucolGetContractionsAndExpansions(partialCollator, contractions, nullptr, false, &status);
+	icu->ucolGetContractionsAndExpansions(partialCollator, contractions, expansions, false, &status);
+
+	// The ASCII table is valid only when every 7-bit character maps to a single collation element.
+	int expansionsCount = icu->usetGetItemCount(expansions);
+
+	for (int expansionIndex = 0; expansionIndex < expansionsCount && obj->asciiWeights.valid; ++expansionIndex)
+	{
+		UChar strChars[10];
+		UChar32 start, end;
+
+		status = U_ZERO_ERROR;
+		int len = icu->usetGetItem(expansions, expansionIndex, &start, &end, strChars, sizeof(strChars), &status);
+
+		if ((len == 0 && start < 0x80) || (len > 0 && strChars[0] < 0x80))
+			obj->asciiWeights.valid = false;
+	}
+
+	icu->usetClose(expansions);
 
 	int contractionsCount = icu->usetGetItemCount(contractions);
 
@@ -1654,6 +1686,9 @@ UnicodeUtil::Utf16Collation* UnicodeUtil::Utf16Collation::create(
 
 		if (len >= 2)
 		{
+			if (strChars[0] < 0x80)
+				obj->asciiWeights.valid = false;
+
 			obj->maxContractionsPrefixLength = len - 1 > obj->maxContractionsPrefixLength ?
 				len - 1 : obj->maxContractionsPrefixLength;
 
@@ -1683,6 +1718,52 @@ UnicodeUtil::Utf16Collation* UnicodeUtil::Utf16Collation::create(
 
 	icu->usetClose(contractions);
 
+	if (obj->asciiWeights.valid)
+	{
+		// Rank 7-bit characters by the primary weights of their single character keys.
+		UCHAR keys[128][BUFFER_TINY];
+		UCHAR chars[128];
+
+		for (unsigned ch = 0; ch < 128; ++ch)
+		{
+			const UChar uch = ch;
+			const int keyLen = icu->ucolGetSortKey(partialCollator, &uch, 1, keys[ch], sizeof(keys[ch]));
+
+			if (keyLen <= 0 || keyLen > int(sizeof(keys[ch])))
+			{
+				obj->asciiWeights.valid = false;
+				break;
+			}
+
+			chars[ch] = ch;
+		}
+
+		if (obj->asciiWeights.valid)
+		{
+			// primary strength keys are zero terminated
+			std::sort(chars, chars + 128, [&](UCHAR c1, UCHAR c2) {
+				return strcmp((const char*) keys[c1], (const char*) keys[c2]) < 0;
+			});
+
+			UCHAR rank = 0;
+
+			for (unsigned i = 0; i < 128; ++i)
+			{
+				const UCHAR ch = chars[i];
+
+				if (keys[ch][0] == 0)
+					obj->asciiWeights.primary[ch] = 0;
+				else
+				{
+					if (rank == 0 || strcmp((const char*) keys[ch], (const char*) keys[chars[i - 1]]) != 0)
+						++rank;
+
+					obj->asciiWeights.primary[ch] = rank;
+				}
+			}
+		}
+	}
+
 	ContractionsPrefixMap::Accessor accessor(&obj->contractionsPrefix);
 
 	for (bool found = accessor.getFirst(); found; found = accessor.getNext())
@@ -2015,6 +2096,10 @@ SSHORT UnicodeUtil::Utf16Collation::compare(ULONG len1, const USHORT* str1,
 		len2 = pad - str2 + 1;
 	}
 
+	SSHORT result;
+	if (asciiWeights.compare(len1, str1, len2, str2, &result))
+		return result;
+
 	len1 *= sizeof(*str1);
 	len2 *= sizeof(*str2);
 
@@ -2032,6 +2117,68 @@ SSHORT UnicodeUtil::Utf16Collation::compare(ULONG len1, const USHORT* str1,
 }
 
 
+SSHORT UnicodeUtil::Utf16Collation::compareUtf8(ULONG len1, const UCHAR* str1,
+												ULONG len2, const UCHAR* str2,
+												INTL_BOOL* error_flag) const
+{
+	fb_assert(str1 != NULL && str2 != NULL);
+	fb_assert(error_flag != NULL);
+
+	*error_flag = false;
+
+	if (tt->texttype_pad_option)
+	{
+		while (len1 && str1[len1 - 1] == ' ')
+			--len1;
+
+		while (len2 && str2[len2 - 1] == ' ')
+			--len2;
+	}
+
+	SSHORT result;
+	if (asciiWeights.compare(len1, str1, len2, str2, &result))
+		return result;
+
+	// Numeric sort needs normalization of the UTF-16 representation
+	if (!numericSort)
+	{
+		UErrorCode status = U_ZERO_ERROR;
+
+		if (icu->ucolStrCollUTF8)
+		{
+			result = (SSHORT) icu->ucolStrCollUTF8(compareCollator,
+				reinterpret_cast<const char*>(str1), len1,
+				reinterpret_cast<const char*>(str2), len2, &status);
+
+			if (U_SUCCESS(status))
+				return result;
+		}
+		else if (icu->ucolStrCollIter && icu->uiterSetUTF8)
+		{
+			UCharIterator iter1, iter2;
+			icu->uiterSetUTF8(&iter1, reinterpret_cast<const char*>(str1), len1);
+			icu->uiterSetUTF8(&iter2, reinterpret_cast<const char*>(str2), len2);
+
+			result = (SSHORT) icu->ucolStrCollIter(compareCollator, &iter1, &iter2, &status);
+
+			if (U_SUCCESS(status))
+				return result;
+		}
+	}
+
+	HalfStaticArray<USHORT, BUFFER_SMALL / 2> utf16Str1, utf16Str2;
+	USHORT errCode;
+	ULONG errPosition;
+
+	len1 = utf8ToUtf16(len1, str1, len1 * sizeof(USHORT), utf16Str1.getBuffer(len1),
+		&errCode, &errPosition);
+	len2 = utf8ToUtf16(len2, str2, len2 * sizeof(USHORT), utf16Str2.getBuffer(len2),
+		&errCode, &errPosition);
+
+	return compare(len1, utf16Str1.begin(), len2, utf16Str2.begin(), error_flag);
+}
+
+
 ULONG UnicodeUtil::Utf16Collation::canonical(ULONG srcLen, const USHORT* src, ULONG dstLen, ULONG* dst,
 	const ULONG* exceptions)
 {
@@ -2149,4 +2296,69 @@ void UnicodeUtil::Utf16Collation::normalize(ULONG* strLen, const USHORT** str, b
 }
 
 
+// Compare 7-bit strings using the precomputed primary weights.
+template <typename CharType>
+bool UnicodeUtil::AsciiWeights::compare(ULONG len1, const CharType* str1,
+	ULONG len2, const CharType* str2, SSHORT* result) const
+{
+	if (!valid)
+		return false;
+
+	for (ULONG i = 0; i < len1; ++i)
+	{
+		if (str1[i] >= 0x80)
+			return false;
+	}
+
+	for (ULONG i = 0; i < len2; ++i)
+	{
+		if (str2[i] >= 0x80)
+			return false;
+	}
+
+	ULONG pos1 = 0, pos2 = 0;
+
+	while (true)
+	{
+		while (pos1 < len1 && !primary[str1[pos1]])
+			++pos1;
+
+		while (pos2 < len2 && !primary[str2[pos2]])
+			++pos2;
+
+		if (pos1 == len1 || pos2 == len2)
+			break;
+
+		const UCHAR weight1 = primary[str1[pos1++]];
+		const UCHAR weight2 = primary[str2[pos2++]];
+
+		if (weight1 != weight2)
+		{
+			*result = weight1 < weight2 ? -1 : 1;
+			return true;
+		}
+	}
+
+	if (pos1 < len1 || pos2 < len2)
+	{
+		*result = pos1 < len1 ? 1 : -1;
+		return true;
+	}
+
+	// Primary weights are equal, lower levels are left to ICU unless strings are the same
+	if (primaryOnly || (len1 == len2 && memcmp(str1, str2, len1 * sizeof(CharType)) == 0))
+	{
+		*result = 0;
+		return true;
+	}
+
+	return false;
+}
+
+template bool UnicodeUtil::AsciiWeights::compare<UCHAR>(ULONG, const UCHAR*, ULONG, const UCHAR*,
+	SSHORT*) const;
+template bool UnicodeUtil::AsciiWeights::compare<USHORT>(ULONG, const USHORT*, ULONG, const USHORT*,
+	SSHORT*) const;
+
+
 }	// namespace Jrd
@@ -182,6 +182,26 @@ public:
 	static ICU* getCollVersion(const Firebird::string& icuVersion,
 		const Firebird::string& configInfo, Firebird::string& collVersion);
 
+	// Primary weight ranks of 7-bit characters of a collation
+	class AsciiWeights
+	{
+	public:
+		AsciiWeights()
+			: valid(false), primaryOnly(false)
+		{
+			memset(primary, 0, sizeof(primary));
+		}
+
+		// Returns false when the result could not be determined without ICU
+		template <typename CharType>
+		bool compare(ULONG len1, const CharType* str1, ULONG len2, const CharType* str2,
+			SSHORT* result) const;
+
+		bool valid;				// every 7-bit character is a single collation element
+		bool primaryOnly;		// lower levels are ignored (CI + AI)
+		UCHAR primary[128];		// 0 - ignorable
+	};
+
 	class Utf16Collation
 	{
 	public:
@@ -201,6 +221,8 @@ public:
 						   USHORT key_type) const;
 		SSHORT compare(ULONG len1, const USHORT* str1, ULONG len2, const USHORT* str2,
 					   INTL_BOOL* error_flag) const;
+		SSHORT compareUtf8(ULONG len1, const UCHAR* str1, ULONG len2, const UCHAR* str2,
+						   INTL_BOOL* error_flag) const;
 		ULONG canonical(ULONG srcLen, const USHORT* src, ULONG dstLen, ULONG* dst, const ULONG* exceptions);
 
 	private:
@@ -258,6 +280,7 @@ public:
 		ContractionsPrefixMap contractionsPrefix;
 		unsigned maxContractionsPrefixLength;	// number of characters
 		bool numericSort;
+		AsciiWeights asciiWeights;
 	};
 
 	friend class Utf16Collation;
@@ -435,6 +435,23 @@ bool AggNode::aggPass(thread_db* tdbb, Request* request) const
 	return true;
 }
 
+bool AggNode::aggRemove(thread_db* tdbb, Request* request) const
+{
+	dsc* desc = NULL;
+
+	if (arg)
+	{
+		// DISTINCT is not allowed in sliding frames
+		fb_assert(!distinct);
+
+		desc = EVL_expr(tdbb, request, arg);
+		if (request->req_flags & req_null)
+			return true;
+	}
+
+	return aggRemove(tdbb, request, desc);
+}
+
 void AggNode::aggFinish(thread_db* /*tdbb*/, Request* request) const
 {
 	if (asb)
@@ -720,6 +737,20 @@ void AvgAggNode::aggPass(thread_db* tdbb, Request* request, dsc* desc) const
 		ArithmeticNode::add2(tdbb, desc, impure, this, blr_add);
 }
 
+bool AvgAggNode::aggRemove(thread_db* tdbb, Request* request, dsc* desc) const
+{
+	// Approximate sums can't be reverted exactly
+	if (nodFlags & (FLAG_DOUBLE | FLAG_DECFLOAT))
+		return false;
+
+	impure_value_ex* impure = request->getImpure<impure_value_ex>(impureOffset);
+	--impure->vlux_count;
+
+	ArithmeticNode::add2(tdbb, desc, impure, this, blr_subtract);
+
+	return true;
+}
+
 dsc* AvgAggNode::aggExecute(thread_db* tdbb, Request* request) const
 {
 	impure_value_ex* impure = request->getImpure<impure_value_ex>(impureOffset);
@@ -1018,6 +1049,18 @@ void CountAggNode::aggPass(thread_db* /*tdbb*/, Request* request, dsc* /*desc*/)
 		++impure->vlu_misc.vlu_int64;
 }
 
+bool CountAggNode::aggRemove(thread_db* /*tdbb*/, Request* request, dsc* /*desc*/) const
+{
+	impure_value_ex* impure = request->getImpure<impure_value_ex>(impureOffset);
+
+	if (dialect1)
+		--impure->vlu_misc.vlu_long;
+	else
+		--impure->vlu_misc.vlu_int64;
+
+	return true;
+}
+
 dsc* CountAggNode::aggExecute(thread_db* /*tdbb*/, Request* request) const
 {
 	impure_value_ex* impure = request->getImpure<impure_value_ex>(impureOffset);
@@ -1280,6 +1323,23 @@ void SumAggNode::aggPass(thread_db* tdbb, Request* request, dsc* desc) const
 		ArithmeticNode::add2(tdbb, desc, impure, this, blr_add);
 }
 
+bool SumAggNode::aggRemove(thread_db* tdbb, Request* request, dsc* desc) const
+{
+	// Approximate sums can't be reverted exactly
+	if (nodFlags & (FLAG_DOUBLE | FLAG_DECFLOAT))
+		return false;
+
+	impure_value_ex* impure = request->getImpure<impure_value_ex>(impureOffset);
+	--impure->vlux_count;
+
+	if (dialect1)
+		ArithmeticNode::add(tdbb, desc, impure, this, blr_subtract);
+	else
+		ArithmeticNode::add2(tdbb, desc, impure, this, blr_subtract);
+
+	return true;
+}
+
 dsc* SumAggNode::aggExecute(thread_db* /*tdbb*/, Request* request) const
 {
 	impure_value_ex* impure = request->getImpure<impure_value_ex>(impureOffset);
@@ -1303,9 +1363,116 @@ AggNode* SumAggNode::dsqlCopy(DsqlCompilerScratch* dsqlScratch) /*const*/
 static AggNode::Register<MaxMinAggNode> maxAggInfo("MAX", blr_agg_max);
 static AggNode::Register<MaxMinAggNode> minAggInfo("MIN", blr_agg_min);
 
+// Monotonic queue of candidates for the result in a sliding window frame. Values are kept in
+// order they were passed and every next one is better than previous ones, so the head is the
+// result. New value drops the older ones which are not better, they leave the frame earlier.
+class MaxMinAggNode::SlidingQueue
+{
+public:
+	explicit SlidingQueue(MemoryPool& p)
+		: pool(p),
+		  entries(p),
+		  spare(p),
+		  head(0),
+		  passed(0),
+		  removed(0)
+	{
+	}
+
+	~SlidingQueue()
+	{
+		clear();
+
+		for (FB_SIZE_T i = 0; i < spare.getCount(); ++i)
+		{
+			delete spare[i]->value.vlu_string;
+			delete spare[i];
+		}
+	}
+
+	void clear()
+	{
+		for (FB_SIZE_T i = head; i < entries.getCount(); ++i)
+			spare.push(entries[i]);
+
+		entries.clear();
+		head = 0;
+		passed = removed = 0;
+	}
+
+	void push(thread_db* tdbb, const dsc* desc, MaxMinType type)
+	{
+		while (entries.getCount() > head)
+		{
+			Entry* const last = entries.back();
+			const int result = MOV_compare(tdbb, desc, &last->value.vlu_desc);
+
+			if ((type == TYPE_MAX && result < 0) || (type == TYPE_MIN && result > 0))
+				break;
+
+			entries.pop();
+			spare.push(last);
+		}
+
+		Entry* const entry = spare.hasData() ? spare.pop() : FB_NEW_POOL(pool) Entry;
+		EVL_make_value(tdbb, desc, &entry->value, &pool);
+		entry->number = passed++;
+		entries.push(entry);
+	}
+
+	// Remove the oldest passed value, returns true if the result is changed.
+	bool remove()
+	{
+		bool changed = false;
+
+		if (entries.getCount() > head && entries[head]->number == removed)
+		{
+			spare.push(entries[head++]);
+			changed = true;
+
+			if (head >= COMPACT_THRESHOLD && head * 2 >= entries.getCount())
+			{
+				entries.removeCount(0, head);
+				head = 0;
+			}
+		}
+
+		++removed;
+		return changed;
+	}
+
+	const dsc* getResult() const
+	{
+		return entries.getCount() > head ? &entries[head]->value.vlu_desc : NULL;
+	}
+
+private:
+	struct Entry
+	{
+		Entry()
+			: number(0)
+		{
+			memset(&value, 0, sizeof(value));
+		}
+
+		FB_UINT64 number;
+		impure_value value;
+	};
+
+	static const FB_SIZE_T COMPACT_THRESHOLD = 64;
+
+	MemoryPool& pool;
+	Array<Entry*> entries;
+	Array<Entry*> spare;
+	FB_SIZE_T head;
+	FB_UINT64 passed;
+	FB_UINT64 removed;
+};
+
 MaxMinAggNode::MaxMinAggNode(MemoryPool& pool, MaxMinType aType, ValueExprNode* aArg)
 	: AggNode(pool, (aType == MaxMinAggNode::TYPE_MAX ? maxAggInfo : minAggInfo), false, false, aArg),
-	  type(aType)
+	  type(aType),
+	  queueImpure(0)
 {
 }
 
@@ -1345,12 +1512,50 @@ string MaxMinAggNode::internalPrint(NodePrinter& printer) const
 	return "MaxMinAggNode";
 }
 
+AggNode* MaxMinAggNode::pass2(thread_db* tdbb, CompilerScratch* csb)
+{
+	AggNode::pass2(tdbb, csb);
+
+	// We need the queue of values for sliding window frames.
+	queueImpure = csb->allocImpure<SlidingQueue*>();
+
+	return this;
+}
+
 void MaxMinAggNode::aggInit(thread_db* tdbb, Request* request) const
 {
 	AggNode::aggInit(tdbb, request);
 
 	impure_value_ex* impure = request->getImpure<impure_value_ex>(impureOffset);
 	impure->vlu_desc.dsc_dtype = 0;
+
+	SlidingQueue*& queue = *request->getImpure<SlidingQueue*>(queueImpure);
+	delete queue;
+	queue = NULL;
+}
+
+void MaxMinAggNode::aggInitSliding(thread_db* tdbb, Request* request) const
+{
+	AggNode::aggInit(tdbb, request);
+
+	impure_value_ex* impure = request->getImpure<impure_value_ex>(impureOffset);
+	impure->vlu_desc.dsc_dtype = 0;
+
+	SlidingQueue*& queue = *request->getImpure<SlidingQueue*>(queueImpure);
+
+	if (queue)
+		queue->clear();
+	else
+		queue = FB_NEW_POOL(*request->req_pool) SlidingQueue(*request->req_pool);
+}
+
+void MaxMinAggNode::aggFinish(thread_db* tdbb, Request* request) const
+{
+	AggNode::aggFinish(tdbb, request);
+
+	SlidingQueue*& queue = *request->getImpure<SlidingQueue*>(queueImpure);
+	delete queue;
+	queue = NULL;
 }
 
 void MaxMinAggNode::aggPass(thread_db* tdbb, Request* request, dsc* desc) const
@@ -1358,6 +1563,11 @@ void MaxMinAggNode::aggPass(thread_db* tdbb, Request* request, dsc* desc) const
 	impure_value_ex* impure = request->getImpure<impure_value_ex>(impureOffset);
 	++impure->vlux_count;
 
+	SlidingQueue* const queue = *request->getImpure<SlidingQueue*>(queueImpure);
+
+	if (queue)
+		queue->push(tdbb, desc, type);
+
 	if (!impure->vlu_desc.dsc_dtype)
 	{
 		EVL_make_value(tdbb, desc, impure);
@@ -1370,6 +1580,29 @@ void MaxMinAggNode::aggPass(thread_db* tdbb, Request* request, dsc* desc) const
 		EVL_make_value(tdbb, desc, impure);
 }
 
+bool MaxMinAggNode::aggRemove(thread_db* tdbb, Request* request, dsc* /*desc*/) const
+{
+	SlidingQueue* const queue = *request->getImpure<SlidingQueue*>(queueImpure);
+
+	if (!queue)
+		return false;
+
+	impure_value_ex* impure = request->getImpure<impure_value_ex>(impureOffset);
+	--impure->vlux_count;
+
+	if (queue->remove())
+	{
+		const dsc* const result = queue->getResult();
+
+		if (result)
+			EVL_make_value(tdbb, result, impure);
+		else
+			impure->vlu_desc.dsc_dtype = 0;
+	}
+
+	return true;
+}
+
 dsc* MaxMinAggNode::aggExecute(thread_db* /*tdbb*/, Request* request) const
 {
 	impure_value_ex* impure = request->getImpure<impure_value_ex>(impureOffset);
@@ -44,7 +44,7 @@ public:
 
 	virtual unsigned getCapabilities() const
 	{
-		return CAP_RESPECTS_WINDOW_FRAME | CAP_WANTS_AGG_CALLS;
+		return CAP_RESPECTS_WINDOW_FRAME | CAP_WANTS_AGG_CALLS | CAP_REMOVES_VALUES;
 	}
 
 	virtual Firebird::string internalPrint(NodePrinter& printer) const;
@@ -55,6 +55,7 @@ public:
 
 	virtual void aggInit(thread_db* tdbb, Request* request) const;
 	virtual void aggPass(thread_db* tdbb, Request* request, dsc* desc) const;
+	virtual bool aggRemove(thread_db* tdbb, Request* request, dsc* desc) const;
 	virtual dsc* aggExecute(thread_db* tdbb, Request* request) const;
 
 protected:
@@ -111,7 +112,7 @@ public:
 
 	virtual unsigned getCapabilities() const
 	{
-		return CAP_RESPECTS_WINDOW_FRAME | CAP_WANTS_AGG_CALLS;
+		return CAP_RESPECTS_WINDOW_FRAME | CAP_WANTS_AGG_CALLS | CAP_REMOVES_VALUES;
 	}
 
 	virtual Firebird::string internalPrint(NodePrinter& printer) const;
@@ -122,6 +123,7 @@ public:
 
 	virtual void aggInit(thread_db* tdbb, Request* request) const;
 	virtual void aggPass(thread_db* tdbb, Request* request, dsc* desc) const;
+	virtual bool aggRemove(thread_db* tdbb, Request* request, dsc* desc) const;
 	virtual dsc* aggExecute(thread_db* tdbb, Request* request) const;
 
 protected:
@@ -142,7 +144,7 @@ public:
 
 	virtual unsigned getCapabilities() const
 	{
-		return CAP_RESPECTS_WINDOW_FRAME | CAP_WANTS_AGG_CALLS;
+		return CAP_RESPECTS_WINDOW_FRAME | CAP_WANTS_AGG_CALLS | CAP_REMOVES_VALUES;
 	}
 
 	virtual Firebird::string internalPrint(NodePrinter& printer) const;
@@ -152,6 +154,7 @@ public:
 
 	virtual void aggInit(thread_db* tdbb, Request* request) const;
 	virtual void aggPass(thread_db* tdbb, Request* request, dsc* desc) const;
+	virtual bool aggRemove(thread_db* tdbb, Request* request, dsc* desc) const;
 	virtual dsc* aggExecute(thread_db* tdbb, Request* request) const;
 
 protected:
@@ -173,23 +176,33 @@ public:
 
 	virtual unsigned getCapabilities() const
 	{
-		return CAP_RESPECTS_WINDOW_FRAME | CAP_WANTS_AGG_CALLS;
+		return CAP_RESPECTS_WINDOW_FRAME | CAP_WANTS_AGG_CALLS | CAP_REMOVES_VALUES;
 	}
 
 	virtual Firebird::string internalPrint(NodePrinter& printer) const;
 	virtual void make(DsqlCompilerScratch* dsqlScratch, dsc* desc);
 	virtual void getDesc(thread_db* tdbb, CompilerScratch* csb, dsc* desc);
 	virtual ValueExprNode* copy(thread_db* tdbb, NodeCopier& copier) const;
+	virtual AggNode* pass2(thread_db* tdbb, CompilerScratch* csb);
 
 	virtual void aggInit(thread_db* tdbb, Request* request) const;
+	virtual void aggInitSliding(thread_db* tdbb, Request* request) const;
+	virtual void aggFinish(thread_db* tdbb, Request* request) const;
 	virtual void aggPass(thread_db* tdbb, Request* request, dsc* desc) const;
+	virtual bool aggRemove(thread_db* tdbb, Request* request, dsc* desc) const;
 	virtual dsc* aggExecute(thread_db* tdbb, Request* request) const;
 
 protected:
 	virtual AggNode* dsqlCopy(DsqlCompilerScratch* dsqlScratch) /*const*/;
 
+private:
+	class SlidingQueue;
+
 public:
 	const MaxMinType type;
+
+private:
+	ULONG queueImpure;
 };
 
 class StdDevAggNode final : public AggNode
@@ -1563,6 +1563,7 @@ public:
 				const Firebird::string* aExternalFile = NULL)
 		: RelationNode(p, aDsqlNode),
 		  externalFile(aExternalFile),
+		  externalFormat(NULL),
 		  relationType(rel_persistent)
 	{
 	}
@@ -1583,6 +1584,7 @@ private:
 
 public:
 	const Firebird::string* externalFile;
+	const Firebird::string* externalFormat;
 	Nullable<rel_t> relationType;
 	bool preserveRowsOpt;
 	bool deleteRowsOpt;
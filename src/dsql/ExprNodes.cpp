@@ -13057,6 +13057,27 @@ dsc* UdfCallNode::execute(thread_db* tdbb, Request* request) const
 
 		FUN_evaluate(tdbb, function, args->items, value, *impureArea->temp);
 	}
+	else if (impureArea->batchOutMsg)
+	{
+		const ULONG inMsgLength = function->getInputFormat() ? function->getInputFormat()->fmt_length : 0;
+		UCHAR* const inMsg = FB_ALIGN(impure + sizeof(impure_value), FB_ALIGNMENT);
+		UCHAR* const outMsg = FB_ALIGN(inMsg + inMsgLength, FB_ALIGNMENT);
+
+		function->fun_external->makeOutput(tdbb, impureArea->batchOutMsg, outMsg);
+
+		const dsc* fmtDesc = function->getOutputFormat()->fmt_desc.begin();
+		const ULONG nullOffset = (IPTR) fmtDesc[1].dsc_address;
+
+		if (*reinterpret_cast<SSHORT*>(outMsg + nullOffset))
+			request->req_flags |= req_null;
+		else
+		{
+			request->req_flags &= ~req_null;
+
+			value->vlu_desc = *fmtDesc;
+			value->vlu_desc.dsc_address = outMsg + (IPTR) fmtDesc[0].dsc_address;
+		}
+	}
 	else
 	{
 		const_cast<Function*>(function.getObject())->checkReload(tdbb);
@@ -13068,32 +13089,7 @@ dsc* UdfCallNode::execute(thread_db* tdbb, Request* request) const
 		UCHAR* const inMsg = FB_ALIGN(impure + sizeof(impure_value), FB_ALIGNMENT);
 		UCHAR* const outMsg = FB_ALIGN(inMsg + inMsgLength, FB_ALIGNMENT);
 
-		if (function->fun_inputs != 0)
-		{
-			const dsc* fmtDesc = function->getInputFormat()->fmt_desc.begin();
-
-			for (auto& source : args->items)
-			{
-				const ULONG argOffset = (IPTR) fmtDesc[0].dsc_address;
-				const ULONG nullOffset = (IPTR) fmtDesc[1].dsc_address;
-
-				dsc argDesc = fmtDesc[0];
-				argDesc.dsc_address = inMsg + argOffset;
-
-				SSHORT* const nullPtr = reinterpret_cast<SSHORT*>(inMsg + nullOffset);
-
-				dsc* const srcDesc = EVL_expr(tdbb, request, source);
-				if (srcDesc && !(request->req_flags & req_null))
-				{
-					*nullPtr = 0;
-					MOV_move(tdbb, srcDesc, &argDesc);
-				}
-				else
-					*nullPtr = -1;
-
-				fmtDesc += 2;
-			}
-		}
+		makeInput(tdbb, request, inMsg);
 
 		jrd_tra* transaction = request->req_transaction;
 
@@ -13187,6 +13183,98 @@ dsc* UdfCallNode::execute(thread_db* tdbb, Request* request) const
 	return (request->req_flags & req_null) ? NULL : &value->vlu_desc;
 }
 
+// Check if the function may be executed by BatchedCallStream. Its result should
+// depend on arguments only, as it's computed before the row is consumed.
+bool UdfCallNode::isBatchable() const
+{
+	return function->fun_external && function->fun_external->isBatchable() &&
+		function->fun_deterministic && !(nodFlags & FLAG_INVARIANT);
+}
+
+// Check if nothing prevents the batched execution at the moment.
+bool UdfCallNode::canExecuteBatch(thread_db* tdbb) const
+{
+	const auto attachment = tdbb->getAttachment();
+
+	// Tracing and profiling need separate calls
+	return function->isImplemented() && function->isDefined() &&
+		!(function->flags & Routine::FLAG_RELOAD) &&
+		!attachment->att_trace_manager->needs(ITraceFactory::TRACE_EVENT_FUNC_EXECUTE) &&
+		!attachment->isProfilerActive();
+}
+
+ULONG UdfCallNode::getBatchInputLength() const
+{
+	return function->fun_external->getInputLength();
+}
+
+ULONG UdfCallNode::getBatchOutputLength() const
+{
+	return function->fun_external->getOutputLength();
+}
+
+// Evaluate arguments of the current row into the external input message.
+void UdfCallNode::makeBatchInput(thread_db* tdbb, Request* request, UCHAR* inMsg) const
+{
+	UCHAR* const impure = request->getImpure<UCHAR>(impureOffset);
+	UCHAR* const intMsg = FB_ALIGN(impure + sizeof(impure_value), FB_ALIGNMENT);
+
+	makeInput(tdbb, request, intMsg);
+	function->fun_external->makeInput(tdbb, intMsg, inMsg);
+}
+
+void UdfCallNode::executeBatch(thread_db* tdbb, unsigned count, UCHAR* inMsgs, UCHAR* outMsgs) const
+{
+	const auto attachment = tdbb->getAttachment();
+
+	AutoSetRestore<USHORT> autoOriginalTimeZone(
+		&attachment->att_original_timezone, attachment->att_current_timezone);
+
+	const ULONG outLength = getBatchOutputLength();
+
+	for (unsigned i = 0; i < count; ++i)
+		function->fun_external->initOutput(tdbb, outMsgs + i * outLength);
+
+	function->fun_external->executeBatch(tdbb, count, inMsgs, outMsgs);
+}
+
+// Make execute() return the result from the external output message, or evaluate normally if NULL.
+void UdfCallNode::setBatchResult(Request* request, const UCHAR* outMsg) const
+{
+	request->getImpure<Impure>(impureOffset)->batchOutMsg = outMsg;
+}
+
+// Evaluate arguments into the internal input message.
+void UdfCallNode::makeInput(thread_db* tdbb, Request* request, UCHAR* inMsg) const
+{
+	if (function->fun_inputs == 0)
+		return;
+
+	const dsc* fmtDesc = function->getInputFormat()->fmt_desc.begin();
+
+	for (auto& source : args->items)
+	{
+		const ULONG argOffset = (IPTR) fmtDesc[0].dsc_address;
+		const ULONG nullOffset = (IPTR) fmtDesc[1].dsc_address;
+
+		dsc argDesc = fmtDesc[0];
+		argDesc.dsc_address = inMsg + argOffset;
+
+		SSHORT* const nullPtr = reinterpret_cast<SSHORT*>(inMsg + nullOffset);
+
+		dsc* const srcDesc = EVL_expr(tdbb, request, source);
+		if (srcDesc && !(request->req_flags & req_null))
+		{
+			*nullPtr = 0;
+			MOV_move(tdbb, srcDesc, &argDesc);
+		}
+		else
+			*nullPtr = -1;
+
+		fmtDesc += 2;
+	}
+}
+
 ValueExprNode* UdfCallNode::dsqlPass(DsqlCompilerScratch* dsqlScratch)
 {
 	UdfCallNode* node = FB_NEW_POOL(dsqlScratch->getPool()) UdfCallNode(dsqlScratch->getPool(), name,
@@ -2106,6 +2106,7 @@ private:
 	{
 		impure_value value;	// must be first
 		Firebird::Array<UCHAR>* temp;
+		const UCHAR* batchOutMsg;	// result of the current row computed by BatchedCallStream
 	};
 
 public:
@@ -2139,6 +2140,18 @@ public:
 	virtual ValueExprNode* pass2(thread_db* tdbb, CompilerScratch* csb);
 	virtual dsc* execute(thread_db* tdbb, Request* request) const;
 
+	// Execution of an external function for many rows at once
+	bool isBatchable() const;
+	bool canExecuteBatch(thread_db* tdbb) const;
+	ULONG getBatchInputLength() const;
+	ULONG getBatchOutputLength() const;
+	void makeBatchInput(thread_db* tdbb, Request* request, UCHAR* inMsg) const;
+	void executeBatch(thread_db* tdbb, unsigned count, UCHAR* inMsgs, UCHAR* outMsgs) const;
+	void setBatchResult(Request* request, const UCHAR* outMsg) const;
+
+private:
+	void makeInput(thread_db* tdbb, Request* request, UCHAR* inMsg) const;
+
 public:
 	QualifiedName name;
 	NestConst<ValueListNode> args;
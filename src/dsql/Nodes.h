@@ -920,6 +920,8 @@ public:
 	static const unsigned CAP_WANTS_AGG_CALLS		= 0x04;
 	// wants winPass call in a window
 	static const unsigned CAP_WANTS_WIN_PASS_CALL	= 0x08;
+	// may remove values leaving a sliding window frame (aggRemove)
+	static const unsigned CAP_REMOVES_VALUES		= 0x10;
 
 protected:
 	struct AggInfo
@@ -1069,10 +1071,24 @@ public:
 	virtual bool aggPass(thread_db* tdbb, Request* request) const;
 	virtual dsc* execute(thread_db* tdbb, Request* request) const;
 
+	// Sliding window frame: values leave the frame in the same order they were passed.
+	// aggRemove returns false when aggregation should be started again.
+	virtual void aggInitSliding(thread_db* tdbb, Request* request) const
+	{
+		aggInit(tdbb, request);
+	}
+
+	bool aggRemove(thread_db* tdbb, Request* request) const;
+
 	virtual unsigned getCapabilities() const = 0;
 	virtual void aggPass(thread_db* tdbb, Request* request, dsc* desc) const = 0;
 	virtual dsc* aggExecute(thread_db* tdbb, Request* request) const = 0;
 
+	virtual bool aggRemove(thread_db* /*tdbb*/, Request* /*request*/, dsc* /*desc*/) const
+	{
+		return false;
+	}
+
 	virtual AggNode* dsqlPass(DsqlCompilerScratch* dsqlScratch);
 
 protected:
@@ -34,6 +34,7 @@
 #include "../jrd/tra.h"
 #include "../jrd/Coercion.h"
 #include "../jrd/Function.h"
+#include "../jrd/PsqlCode.h"
 #include "../jrd/optimizer/Optimizer.h"
 #include "../jrd/RecordSourceNodes.h"
 #include "../jrd/VirtualTable.h"
@@ -830,6 +831,8 @@ CompoundStmtNode* CompoundStmtNode::pass2(thread_db* tdbb, CompilerScratch* csb)
 
 	impureOffset = csb->allocImpure<impure_state>();
 
+	psqlCode = PsqlCode::compile(tdbb, csb, this);
+
 	for (NestConst<StmtNode>* i = statements.begin(); i != statements.end(); ++i)
 	{
 		if (!nodeIs<AssignmentNode>(i->getObject()))
@@ -845,6 +848,12 @@ const StmtNode* CompoundStmtNode::execute(thread_db* tdbb, Request* request, Exe
 {
 	const NestConst<StmtNode>* end = statements.end();
 
+	if (psqlCode && request->req_operation == Request::req_evaluate &&
+		!request->req_attachment->isProfilerActive())
+	{
+		return psqlCode->execute(tdbb, request);
+	}
+
 	if (onlyAssignments && !request->req_attachment->isProfilerActive())
 	{
 		if (request->req_operation == Request::req_evaluate)
@@ -3413,6 +3422,13 @@ DmlNode* ExecStatementNode::parse(thread_db* tdbb, MemoryPool& pool, CompilerScr
 						node->dataSource = PAR_parse_value(tdbb, csb);
 						break;
 
+					case blr_exec_stmt_data_srcs:
+					{
+						const USHORT count = csb->csb_blr_reader.getWord();
+						node->dataSources = PAR_args(tdbb, csb, count, count);
+						break;
+					}
+
 					case blr_exec_stmt_user:
 						node->userName = PAR_parse_value(tdbb, csb);
 						break;
@@ -3498,6 +3514,10 @@ DmlNode* ExecStatementNode::parse(thread_db* tdbb, MemoryPool& pool, CompilerScr
 					break;
 			}
 
+			// Rows of several data sources can't be assigned to a singleton
+			if (node->dataSources && node->outputs && !node->innerStmt)
+				PAR_syntax_error(csb, "FOR EXECUTE STATEMENT with several data sources");
+
 			break;
 		}
 
@@ -3562,7 +3582,20 @@ StmtNode* ExecStatementNode::dsqlPass(DsqlCompilerScratch* dsqlScratch)
 
 	// Process various optional arguments.
 
-	node->dataSource = doDsqlPass(dsqlScratch, dataSource);
+	if (dataSources && dataSources->items.getCount() == 1)
+		node->dataSource = doDsqlPass(dsqlScratch, dataSources->items[0]);
+	else
+	{
+		node->dataSource = doDsqlPass(dsqlScratch, dataSource);
+		node->dataSources = doDsqlPass(dsqlScratch, dataSources);
+	}
+
+	if (node->dataSources && node->outputs && !node->innerStmt)
+	{
+		ERRD_post(Arg::Gds(isc_sqlerr) << Arg::Num(-104) <<
+				  Arg::Gds(isc_eds_multi_src_singleton));
+	}
+
 	node->userName = doDsqlPass(dsqlScratch, userName);
 	node->password = doDsqlPass(dsqlScratch, password);
 	node->role = doDsqlPass(dsqlScratch, role);
@@ -3580,6 +3613,7 @@ string ExecStatementNode::internalPrint(NodePrinter& printer) const
 	NODE_PRINT(printer, dsqlLabelNumber);
 	NODE_PRINT(printer, sql);
 	NODE_PRINT(printer, dataSource);
+	NODE_PRINT(printer, dataSources);
 	NODE_PRINT(printer, userName);
 	NODE_PRINT(printer, password);
 	NODE_PRINT(printer, role);
@@ -3602,7 +3636,7 @@ void ExecStatementNode::genBlr(DsqlCompilerScratch* dsqlScratch)
 	}
 
 	// If no new features of EXECUTE STATEMENT are used, lets generate old BLR.
-	if (!dataSource && !userName && !password && !role && !useCallerPrivs && !inputs &&
+	if (!dataSource && !dataSources && !userName && !password && !role && !useCallerPrivs && !inputs &&
 		 traScope == EDS::traNotSet)
 	{
 		if (outputs)
@@ -3659,6 +3693,16 @@ void ExecStatementNode::genBlr(DsqlCompilerScratch* dsqlScratch)
 
 		// External data source, user, password and role.
 		genOptionalExpr(dsqlScratch, blr_exec_stmt_data_src, dataSource);
+
+		if (dataSources)
+		{
+			dsqlScratch->appendUChar(blr_exec_stmt_data_srcs);
+			dsqlScratch->appendUShort(dataSources->items.getCount());
+
+			for (FB_SIZE_T i = 0; i < dataSources->items.getCount(); ++i)
+				GEN_expr(dsqlScratch, dataSources->items[i]);
+		}
+
 		genOptionalExpr(dsqlScratch, blr_exec_stmt_user, userName);
 		genOptionalExpr(dsqlScratch, blr_exec_stmt_pwd, password);
 		genOptionalExpr(dsqlScratch, blr_exec_stmt_role, role);
@@ -3731,6 +3775,7 @@ ExecStatementNode* ExecStatementNode::pass1(thread_db* tdbb, CompilerScratch* cs
 {
 	doPass1(tdbb, csb, sql.getAddress());
 	doPass1(tdbb, csb, dataSource.getAddress());
+	doPass1(tdbb, csb, dataSources.getAddress());
 	doPass1(tdbb, csb, userName.getAddress());
 	doPass1(tdbb, csb, password.getAddress());
 	doPass1(tdbb, csb, role.getAddress());
@@ -3744,6 +3789,7 @@ ExecStatementNode* ExecStatementNode::pass2(thread_db* tdbb, CompilerScratch* cs
 {
 	ExprNode::doPass2(tdbb, csb, sql.getAddress());
 	ExprNode::doPass2(tdbb, csb, dataSource.getAddress());
+	ExprNode::doPass2(tdbb, csb, dataSources.getAddress());
 	ExprNode::doPass2(tdbb, csb, userName.getAddress());
 	ExprNode::doPass2(tdbb, csb, password.getAddress());
 	ExprNode::doPass2(tdbb, csb, role.getAddress());
@@ -3761,13 +3807,23 @@ ExecStatementNode* ExecStatementNode::pass2(thread_db* tdbb, CompilerScratch* cs
 		}
 	}
 
-	impureOffset = csb->allocImpure<EDS::Statement*>();
+	if (dataSources)
+	{
+		// a statement per data source
+		impureOffset = csb->allocImpure(alignof(EDS::Statement*),
+			sizeof(EDS::Statement*) * dataSources->items.getCount());
+	}
+	else
+		impureOffset = csb->allocImpure<EDS::Statement*>();
 
 	return this;
 }
 
 const StmtNode* ExecStatementNode::execute(thread_db* tdbb, Request* request, ExeState* /*exeState*/) const
 {
+	if (dataSources)
+		return executeAsync(tdbb, request);
+
 	EDS::Statement** stmtPtr = request->getImpure<EDS::Statement*>(impureOffset);
 	EDS::Statement* stmt = *stmtPtr;
 
@@ -3848,6 +3904,127 @@ const StmtNode* ExecStatementNode::execute(thread_db* tdbb, Request* request, Ex
 	return parentStmt;
 }
 
+// Execute the statement on all data sources at once and return rows of all
+// of them in the order they arrive.
+const StmtNode* ExecStatementNode::executeAsync(thread_db* tdbb, Request* request) const
+{
+	EDS::Statement** const stmts = request->getImpure<EDS::Statement*>(impureOffset);
+	const FB_SIZE_T count = dataSources->items.getCount();
+
+	if (request->req_operation == Request::req_evaluate)
+	{
+		string sSql;
+		getString(tdbb, request, sql, sSql, true);
+
+		string sUser;
+		getString(tdbb, request, userName, sUser);
+
+		string sPwd;
+		getString(tdbb, request, password, sPwd);
+
+		string sRole;
+		getString(tdbb, request, role, sRole);
+
+		RefPtr<EDS::AsyncEvent> event(FB_NEW EDS::AsyncEvent);
+
+		const MetaName* const* inpNames = inputNames ? inputNames->begin() : NULL;
+		const TimeoutTimer* timer = tdbb->getTimeoutTimer();
+
+		for (FB_SIZE_T i = 0; i < count; i++)
+		{
+			fb_assert(!stmts[i]);
+
+			string sDataSrc;
+			getString(tdbb, request, dataSources->items[i], sDataSrc);
+
+			EDS::Connection* conn = EDS::Manager::getConnection(tdbb, sDataSrc, sUser, sPwd, sRole, traScope);
+
+			if (conn->isCurrent())
+				ERR_post(Arg::Gds(isc_eds_multi_src_current));
+
+			EDS::Statement* stmt = conn->createStatement(sSql);
+			stmt->bindToRequest(request, &stmts[i]);
+			stmt->setCallerPrivileges(useCallerPrivs);
+
+			EDS::Transaction* tran = EDS::Transaction::getTransaction(tdbb, stmt->getConnection(), traScope);
+
+			stmt->prepare(tdbb, tran, sSql, inputNames != NULL);
+
+			if (timer)
+				stmt->setTimeout(tdbb, timer->timeToExpire());
+
+			stmt->openAsync(tdbb, tran, inpNames, inputs, excessInputs, event);
+		}
+
+		request->req_operation = Request::req_return;
+	}  // Request::req_evaluate
+
+	if (request->req_operation == Request::req_return || request->req_operation == Request::req_sync)
+	{
+		while (true)
+		{
+			EDS::AsyncEvent* event = NULL;
+
+			for (FB_SIZE_T i = 0; i < count && !event; i++)
+			{
+				if (stmts[i])
+					event = stmts[i]->getAsyncEvent();
+			}
+
+			if (!event)
+				break;
+
+			EDS::Statement* const stmt = event->getReady();
+
+			if (!stmt)
+			{
+				event->wait(tdbb);
+				JRD_reschedule(tdbb, true);
+				continue;
+			}
+
+			switch (stmt->fetchAsync(tdbb, outputs))
+			{
+				case EDS::Statement::asyncRow:
+					fb_assert(innerStmt);
+					request->req_operation = Request::req_evaluate;
+					return innerStmt;
+
+				case EDS::Statement::asyncEnd:
+					stmt->close(tdbb);
+					break;
+
+				case EDS::Statement::asyncWait:
+					fb_assert(false);
+					break;
+			}
+		}
+
+		request->req_operation = Request::req_return;
+	}
+
+	if (request->req_operation == Request::req_unwind)
+	{
+		const LabelNode* label = nodeAs<LabelNode>(parentStmt.getObject());
+
+		if (label && request->req_label == label->labelNumber &&
+			(request->req_flags & req_continue_loop))
+		{
+			request->req_flags &= ~req_continue_loop;
+			request->req_operation = Request::req_sync;
+			return this;
+		}
+	}
+
+	for (FB_SIZE_T i = 0; i < count; i++)
+	{
+		if (stmts[i])
+			stmts[i]->close(tdbb);
+	}
+
+	return parentStmt;
+}
+
 void ExecStatementNode::getString(thread_db* tdbb, Request* request, const ValueExprNode* node,
 	string& str, bool useAttCS) const
 {
@@ -5358,14 +5535,18 @@ LabelNode* LabelNode::pass1(thread_db* tdbb, CompilerScratch* csb)
 LabelNode* LabelNode::pass2(thread_db* tdbb, CompilerScratch* csb)
 {
 	doPass2(tdbb, csb, statement.getAddress(), this);
+	psqlCode = PsqlCode::compile(tdbb, csb, this);
 	return this;
 }
 
-const StmtNode* LabelNode::execute(thread_db* /*tdbb*/, Request* request, ExeState* /*exeState*/) const
+const StmtNode* LabelNode::execute(thread_db* tdbb, Request* request, ExeState* /*exeState*/) const
 {
 	switch (request->req_operation)
 	{
 		case Request::req_evaluate:
+			if (psqlCode && !request->req_attachment->isProfilerActive())
+				return psqlCode->execute(tdbb, request);
+
 			return statement;
 
 		case Request::req_unwind:
@@ -42,6 +42,7 @@ class RecordBuffer;
 class RelationSourceNode;
 class SelectNode;
 class GeneratorItem;
+class PsqlCode;
 
 
 class ExceptionItem : public Firebird::PermanentStorage, public Printable
@@ -188,6 +189,7 @@ public:
 	explicit CompoundStmtNode(MemoryPool& pool)
 		: TypedNode<StmtNode, StmtNode::TYPE_COMPOUND_STMT>(pool),
 		  statements(pool),
+		  psqlCode(NULL),
 		  onlyAssignments(false)
 	{
 	}
@@ -210,6 +212,7 @@ public:
 
 public:
 	Firebird::Array<NestConst<StmtNode> > statements;
+	PsqlCode* psqlCode;
 	bool onlyAssignments;
 };
 
@@ -654,6 +657,7 @@ public:
 		  dsqlLabelName(NULL),
 		  sql(NULL),
 		  dataSource(NULL),
+		  dataSources(NULL),
 		  userName(NULL),
 		  password(NULL),
 		  role(NULL),
@@ -684,10 +688,13 @@ private:
 	void getString(thread_db* tdbb, Request* request, const ValueExprNode* node,
 		Firebird::string& str, bool useAttCS = false) const;
 
+	const StmtNode* executeAsync(thread_db* tdbb, Request* request) const;
+
 public:
 	MetaName* dsqlLabelName;
 	NestConst<ValueExprNode> sql;
 	NestConst<ValueExprNode> dataSource;
+	NestConst<ValueListNode> dataSources;	// several data sources executed asynchronously
 	NestConst<ValueExprNode> userName;
 	NestConst<ValueExprNode> password;
 	NestConst<ValueExprNode> role;
@@ -968,6 +975,7 @@ public:
 	explicit LabelNode(MemoryPool& pool)
 		: TypedNode<StmtNode, StmtNode::TYPE_LABEL>(pool),
 		  statement(NULL),
+		  psqlCode(NULL),
 		  labelNumber(0)
 	{
 	}
@@ -984,6 +992,7 @@ public:
 
 public:
 	NestConst<StmtNode> statement;
+	PsqlCode* psqlCode;
 	USHORT labelNumber;
 };
 
@@ -689,6 +689,7 @@ using namespace Firebird;
 // tokens added for Firebird 5.0
 
 %token <metaNamePtr> LOCKED
+%token <metaNamePtr> RDB_RESET_STATEMENT_STATISTICS
 %token <metaNamePtr> TARGET
 %token <metaNamePtr> TIMEZONE_NAME
 %token <metaNamePtr> UNICODE_CHAR
@@ -2223,13 +2224,17 @@ page_noise
 
 %type <createRelationNode> table_clause
 table_clause
-	: simple_table_name external_file
+	: simple_table_name external_file external_format
 			{
+				if ($3 && !$2)
+					yyabandon(YYPOSNARG(3), -104, Arg::Gds(isc_ext_format_err) << "USING");
+
 				$<createRelationNode>$ = newNode<CreateRelationNode>($1, $2);
+				$<createRelationNode>$->externalFormat = $3;
 			}
-		'(' table_elements($3) ')' table_attributes($3)
+		'(' table_elements($4) ')' table_attributes($4)
 			{
-				$$ = $3;
+				$$ = $4;
 			}
 	;
 
@@ -2304,6 +2309,12 @@ external_file
 	| EXTERNAL utf_string			{ $$ = $2; }
 	;
 
+%type <stringPtr> external_format
+external_format
+	: /* nothing */					{ $$ = NULL; }
+	| USING utf_string				{ $$ = $2; }
+	;
+
 %type table_elements(<createRelationNode>)
 table_elements($createRelationNode)
 	: table_element($createRelationNode)
@@ -3452,10 +3463,13 @@ exec_stmt_options_list($execStatementNode)
 
 %type exec_stmt_option(<execStatementNode>)
 exec_stmt_option($execStatementNode)
-	: ON EXTERNAL DATA SOURCE value
-		{ setClause($execStatementNode->dataSource, "EXTERNAL DATA SOURCE", $5); }
+	: ON EXTERNAL DATA SOURCE value_list
+		{ setClause($execStatementNode->dataSources, "EXTERNAL DATA SOURCE", $5); }
 	| ON EXTERNAL value
-		{ setClause($execStatementNode->dataSource, "EXTERNAL DATA SOURCE", $3); }
+		{
+			setClause($execStatementNode->dataSources, "EXTERNAL DATA SOURCE",
+				newNode<ValueListNode>($3));
+		}
 	| AS USER value
 		{ setClause($execStatementNode->userName, "USER", $3); }
 	| PASSWORD value
@@ -8239,6 +8253,7 @@ system_function_std_syntax
 	| RAND
 	| RDB_GET_CONTEXT
 	| RDB_GET_TRANSACTION_CN
+	| RDB_RESET_STATEMENT_STATISTICS
 	| RDB_ROLE_IN_USE
 	| RDB_SET_CONTEXT
 	| REPLACE
@@ -3171,7 +3171,7 @@ namespace Firebird
 		}
 	};
 
-#define FIREBIRD_ICLIENT_BLOCK_VERSION 4u
+#define FIREBIRD_ICLIENT_BLOCK_VERSION 5u
 
 	class IClientBlock : public IReferenceCounted
 	{
@@ -3184,6 +3184,7 @@ namespace Firebird
 			void (CLOOP_CARG *putData)(IClientBlock* self, IStatus* status, unsigned length, const void* data) CLOOP_NOEXCEPT;
 			ICryptKey* (CLOOP_CARG *newKey)(IClientBlock* self, IStatus* status) CLOOP_NOEXCEPT;
 			IAuthBlock* (CLOOP_CARG *getAuthBlock)(IClientBlock* self, IStatus* status) CLOOP_NOEXCEPT;
+			const char* (CLOOP_CARG *getTarget)(IClientBlock* self) CLOOP_NOEXCEPT;
 		};
 
 	protected:
@@ -3245,6 +3246,16 @@ namespace Firebird
 			StatusType::checkException(status);
 			return ret;
 		}
+
+		const char* getTarget()
+		{
+			if (cloopVTable->version < 5)
+			{
+				return 0;
+			}
+			const char* ret = static_cast<VTable*>(this->cloopVTable)->getTarget(this);
+			return ret;
+		}
 	};
 
 #define FIREBIRD_ISERVER_VERSION 6u
@@ -4215,7 +4226,7 @@ namespace Firebird
 		}
 	};
 
-#define FIREBIRD_IEXTERNAL_FUNCTION_VERSION 3u
+#define FIREBIRD_IEXTERNAL_FUNCTION_VERSION 4u
 
 	class IExternalFunction : public IDisposable
 	{
@@ -4224,6 +4235,7 @@ namespace Firebird
 		{
 			void (CLOOP_CARG *getCharSet)(IExternalFunction* self, IStatus* status, IExternalContext* context, char* name, unsigned nameSize) CLOOP_NOEXCEPT;
 			void (CLOOP_CARG *execute)(IExternalFunction* self, IStatus* status, IExternalContext* context, void* inMsg, void* outMsg) CLOOP_NOEXCEPT;
+			void (CLOOP_CARG *executeBatch)(IExternalFunction* self, IStatus* status, IExternalContext* context, unsigned count, void* inMsgs, unsigned inMsgLength, void* outMsgs, unsigned outMsgLength) CLOOP_NOEXCEPT;
 		};
 
 	protected:
@@ -4252,6 +4264,19 @@ namespace Firebird
 			static_cast<VTable*>(this->cloopVTable)->execute(this, status, context, inMsg, outMsg);
 			StatusType::checkException(status);
 		}
+
+		template <typename StatusType> void executeBatch(StatusType* status, IExternalContext* context, unsigned count, void* inMsgs, unsigned inMsgLength, void* outMsgs, unsigned outMsgLength)
+		{
+			if (cloopVTable->version < 4)
+			{
+				StatusType::setVersionError(status, "IExternalFunction", cloopVTable->version, 4);
+				StatusType::checkException(status);
+				return;
+			}
+			StatusType::clearException(status);
+			static_cast<VTable*>(this->cloopVTable)->executeBatch(this, status, context, count, inMsgs, inMsgLength, outMsgs, outMsgLength);
+			StatusType::checkException(status);
+		}
 	};
 
 #define FIREBIRD_IEXTERNAL_PROCEDURE_VERSION 3u
@@ -12695,6 +12720,7 @@ namespace Firebird
 					this->putData = &Name::cloopputDataDispatcher;
 					this->newKey = &Name::cloopnewKeyDispatcher;
 					this->getAuthBlock = &Name::cloopgetAuthBlockDispatcher;
+					this->getTarget = &Name::cloopgetTargetDispatcher;
 				}
 			} vTable;
 
@@ -12784,6 +12810,19 @@ namespace Firebird
 			}
 		}
 
+		static const char* CLOOP_CARG cloopgetTargetDispatcher(IClientBlock* self) CLOOP_NOEXCEPT
+		{
+			try
+			{
+				return static_cast<Name*>(self)->Name::getTarget();
+			}
+			catch (...)
+			{
+				StatusType::catchException(0);
+				return static_cast<const char*>(0);
+			}
+		}
+
 		static void CLOOP_CARG cloopaddRefDispatcher(IReferenceCounted* self) CLOOP_NOEXCEPT
 		{
 			try
@@ -12829,6 +12868,7 @@ namespace Firebird
 		virtual void putData(StatusType* status, unsigned length, const void* data) = 0;
 		virtual ICryptKey* newKey(StatusType* status) = 0;
 		virtual IAuthBlock* getAuthBlock(StatusType* status) = 0;
+		virtual const char* getTarget() = 0;
 	};
 
 	template <typename Name, typename StatusType, typename Base>
@@ -14950,6 +14990,7 @@ namespace Firebird
 					this->dispose = &Name::cloopdisposeDispatcher;
 					this->getCharSet = &Name::cloopgetCharSetDispatcher;
 					this->execute = &Name::cloopexecuteDispatcher;
+					this->executeBatch = &Name::cloopexecuteBatchDispatcher;
 				}
 			} vTable;
 
@@ -14984,6 +15025,20 @@ namespace Firebird
 			}
 		}
 
+		static void CLOOP_CARG cloopexecuteBatchDispatcher(IExternalFunction* self, IStatus* status, IExternalContext* context, unsigned count, void* inMsgs, unsigned inMsgLength, void* outMsgs, unsigned outMsgLength) CLOOP_NOEXCEPT
+		{
+			StatusType status2(status);
+
+			try
+			{
+				static_cast<Name*>(self)->Name::executeBatch(&status2, context, count, inMsgs, inMsgLength, outMsgs, outMsgLength);
+			}
+			catch (...)
+			{
+				StatusType::catchException(&status2);
+			}
+		}
+
 		static void CLOOP_CARG cloopdisposeDispatcher(IDisposable* self) CLOOP_NOEXCEPT
 		{
 			try
@@ -15012,6 +15067,7 @@ namespace Firebird
 
 		virtual void getCharSet(StatusType* status, IExternalContext* context, char* name, unsigned nameSize) = 0;
 		virtual void execute(StatusType* status, IExternalContext* context, void* inMsg, void* outMsg) = 0;
+		virtual void executeBatch(StatusType* status, IExternalContext* context, unsigned count, void* inMsgs, unsigned inMsgLength, void* outMsgs, unsigned outMsgLength) = 0;
 	};
 
 	template <typename Name, typename StatusType, typename Base>
@@ -261,6 +261,18 @@ public:
 		char* /*name*/, unsigned /*nameSize*/)
 	{
 	}
+
+	// Functions may override it to process many rows at once
+	void executeBatch(StatusType* status, IExternalContext* context, unsigned count,
+		void* inMsgs, unsigned inMsgLength, void* outMsgs, unsigned outMsgLength)
+	{
+		for (unsigned i = 0; i < count; ++i)
+		{
+			static_cast<This*>(this)->execute(status, context,
+				static_cast<unsigned char*>(inMsgs) + i * inMsgLength,
+				static_cast<unsigned char*>(outMsgs) + i * outMsgLength);
+		}
+	}
 };
 
 
@@ -388,6 +388,7 @@
 #define blr_exec_stmt_out_params	(unsigned char) 13	// output parameters
 #define blr_exec_stmt_role			(unsigned char) 14
 #define blr_exec_stmt_in_excess		(unsigned char) 15  // excess input params numbers
+#define blr_exec_stmt_data_srcs		(unsigned char) 16	// several data sources executed asynchronously
 
 #define blr_stmt_expr				(unsigned char) 190
 #define blr_derived_expr			(unsigned char) 191
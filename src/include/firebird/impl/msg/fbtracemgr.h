@@ -38,3 +38,6 @@ FB_IMPL_MSG(FBTRACEMGR, 37, trace_switch_user_only, -901, "00", "000", "switch \
 FB_IMPL_MSG(FBTRACEMGR, 38, trace_switch_param_miss, -901, "00", "000", "mandatory parameter \"@1\" for switch \"@2\" is missing")
 FB_IMPL_MSG(FBTRACEMGR, 39, trace_param_act_notcompat, -901, "00", "000", "parameter \"@1\" is incompatible with action \"@2\"")
 FB_IMPL_MSG(FBTRACEMGR, 40, trace_mandatory_switch_miss, -901, "00", "000", "mandatory switch \"@1\" is missing")
+FB_IMPL_MSG_NO_SYMBOL(FBTRACEMGR, 41, "  -D[ECODE]  <string>                   Decode binary trace log file")
+FB_IMPL_MSG_NO_SYMBOL(FBTRACEMGR, 42, "  fbtracemgr -DECODE trace.bin")
+FB_IMPL_MSG(FBTRACEMGR, 43, trace_bad_log, -901, "00", "000", "invalid record at offset @1 of binary trace log \"@2\"")
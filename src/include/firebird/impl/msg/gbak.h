@@ -405,3 +405,5 @@ FB_IMPL_MSG_NO_SYMBOL(GBAK, 406, "    @1PAR(ALLEL)           parallel workers")
 FB_IMPL_MSG_SYMBOL(GBAK, 407, gbak_missing_prl_wrks, "parallel workers parameter missing")
 FB_IMPL_MSG_SYMBOL(GBAK, 408, gbak_inv_prl_wrks, "expected parallel workers, encountered \"@1\"")
 FB_IMPL_MSG_NO_SYMBOL(GBAK, 409, "    @1D(IRECT_IO)          direct IO for backup file(s)")
+FB_IMPL_MSG_NO_SYMBOL(GBAK, 410, "Checksum mismatch in compressed block @1 of backup file")
+FB_IMPL_MSG_NO_SYMBOL(GBAK, 411, "Invalid header of compressed block @1 in backup file")
@@ -60,3 +60,11 @@ FB_IMPL_MSG_NO_SYMBOL(GSTAT, 59, "Gstat execution time @1")
 FB_IMPL_MSG_NO_SYMBOL(GSTAT, 60, "Gstat completion time @1")
 FB_IMPL_MSG_NO_SYMBOL(GSTAT, 61, "    Expected page inventory page @1")
 FB_IMPL_MSG_NO_SYMBOL(GSTAT, 62, "Generator pages: total @1, encrypted @2, non-crypted @3")
+FB_IMPL_MSG_NO_SYMBOL(GSTAT, 63, "    -par    number of parallel workers reading pages")
+FB_IMPL_MSG_NO_SYMBOL(GSTAT, 64, "    -sa     analyze given percent of data and index leaf pages")
+FB_IMPL_MSG_NO_SYMBOL(GSTAT, 65, "    -di     direct IO for database file(s)")
+FB_IMPL_MSG_NO_SYMBOL(GSTAT, 66, "parallel workers parameter missing")
+FB_IMPL_MSG_NO_SYMBOL(GSTAT, 67, "expected parallel workers (1 - 64), encountered \"@1\"")
+FB_IMPL_MSG_NO_SYMBOL(GSTAT, 68, "sample percent parameter missing")
+FB_IMPL_MSG_NO_SYMBOL(GSTAT, 69, "expected sample percent (1 - 100), encountered \"@1\"")
+FB_IMPL_MSG_NO_SYMBOL(GSTAT, 70, "Sampling @1% of data pages and index leaf pages, statistics are extrapolated")
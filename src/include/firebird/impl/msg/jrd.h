@@ -961,3 +961,7 @@ FB_IMPL_MSG(JRD, 959, quoted_str_miss, -901, "22", "024", "Missing terminating q
 FB_IMPL_MSG(JRD, 960, wrong_shmem_ver, -902, "08", "006", "@1: inconsistent shared memory type/version; found @2, expected @3")
 FB_IMPL_MSG(JRD, 961, wrong_shmem_bitness, -902, "08", "006", "@1-bit engine can't open database already opened by @2-bit engine")
 FB_IMPL_MSG(JRD, 962, wrong_proc_plan, -281, "HY", "000", "Procedures cannot specify access type other than NATURAL in the plan")
+FB_IMPL_MSG(JRD, 963, ext_format_err, -901, "42", "000", "Invalid external file format specification: @1")
+FB_IMPL_MSG(JRD, 964, ext_format_data, -901, "22", "000", "Malformed record in external file @1 at offset @2")
+FB_IMPL_MSG(JRD, 965, eds_multi_src_singleton, -901, "42", "000", "EXECUTE STATEMENT with several data sources can't be a singleton, use FOR EXECUTE STATEMENT")
+FB_IMPL_MSG(JRD, 966, eds_multi_src_current, -901, "42", "000", "Current connection can't be used by EXECUTE STATEMENT with several data sources")
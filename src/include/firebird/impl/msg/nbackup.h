@@ -86,3 +86,9 @@ FB_IMPL_MSG(NBACKUP, 85, nbackup_clean_hist_misuse, -901, "00", "000", "Switch -
 FB_IMPL_MSG(NBACKUP, 86, nbackup_clean_hist_missed, -901, "00", "000", "-KEEP can be used only with -CLEAN_HISTORY")
 FB_IMPL_MSG(NBACKUP, 87, nbackup_keep_hist_missed, -901, "00", "000", "-KEEP is required with -CLEAN_HISTORY")
 FB_IMPL_MSG(NBACKUP, 88, nbackup_second_keep_switch, -901, "00", "000", "-KEEP can be used one time only")
+FB_IMPL_MSG_NO_SYMBOL(NBACKUP, 89, "  -ZIP                                   Compress backup file with built-in zlib compression")
+FB_IMPL_MSG_NO_SYMBOL(NBACKUP, 90, "  -PAR(ALLEL) <n>                        Number of threads to compress or decompress backup file")
+FB_IMPL_MSG(NBACKUP, 91, nbackup_zip_misuse, -901, "00", "000", "Switch -ZIP can be used only with -BACKUP")
+FB_IMPL_MSG(NBACKUP, 92, nbackup_zip_unavailable, -901, "00", "000", "Compression library is not available")
+FB_IMPL_MSG(NBACKUP, 93, nbackup_zip_err, -901, "00", "000", "Error @1 processing block @2 of compressed backup file: @3")
+FB_IMPL_MSG(NBACKUP, 94, nbackup_zip_checksum, -901, "00", "000", "Checksum mismatch in block @1 of backup file: @2")
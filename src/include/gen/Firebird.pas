@@ -443,6 +443,7 @@ type
 	IClientBlock_putDataPtr = procedure(this: IClientBlock; status: IStatus; length: Cardinal; data: Pointer); cdecl;
 	IClientBlock_newKeyPtr = function(this: IClientBlock; status: IStatus): ICryptKey; cdecl;
 	IClientBlock_getAuthBlockPtr = function(this: IClientBlock; status: IStatus): IAuthBlock; cdecl;
+	IClientBlock_getTargetPtr = function(this: IClientBlock): PAnsiChar; cdecl;
 	IServer_authenticatePtr = function(this: IServer; status: IStatus; sBlock: IServerBlock; writerInterface: IWriter): Integer; cdecl;
 	IServer_setDbCryptCallbackPtr = procedure(this: IServer; status: IStatus; cryptCallback: ICryptKeyCallback); cdecl;
 	IClient_authenticatePtr = function(this: IClient; status: IStatus; cBlock: IClientBlock): Integer; cdecl;
@@ -512,6 +513,7 @@ type
 	IExternalResultSet_fetchPtr = function(this: IExternalResultSet; status: IStatus): Boolean; cdecl;
 	IExternalFunction_getCharSetPtr = procedure(this: IExternalFunction; status: IStatus; context: IExternalContext; name: PAnsiChar; nameSize: Cardinal); cdecl;
 	IExternalFunction_executePtr = procedure(this: IExternalFunction; status: IStatus; context: IExternalContext; inMsg: Pointer; outMsg: Pointer); cdecl;
+	IExternalFunction_executeBatchPtr = procedure(this: IExternalFunction; status: IStatus; context: IExternalContext; count: Cardinal; inMsgs: Pointer; inMsgLength: Cardinal; outMsgs: Pointer; outMsgLength: Cardinal); cdecl;
 	IExternalProcedure_getCharSetPtr = procedure(this: IExternalProcedure; status: IStatus; context: IExternalContext; name: PAnsiChar; nameSize: Cardinal); cdecl;
 	IExternalProcedure_openPtr = function(this: IExternalProcedure; status: IStatus; context: IExternalContext; inMsg: Pointer; outMsg: Pointer): IExternalResultSet; cdecl;
 	IExternalTrigger_getCharSetPtr = procedure(this: IExternalTrigger; status: IStatus; context: IExternalContext; name: PAnsiChar; nameSize: Cardinal); cdecl;
@@ -2024,10 +2026,11 @@ type
 		putData: IClientBlock_putDataPtr;
 		newKey: IClientBlock_newKeyPtr;
 		getAuthBlock: IClientBlock_getAuthBlockPtr;
+		getTarget: IClientBlock_getTargetPtr;
 	end;
 
 	IClientBlock = class(IReferenceCounted)
-		const VERSION = 4;
+		const VERSION = 5;
 
 		function getLogin(): PAnsiChar;
 		function getPassword(): PAnsiChar;
@@ -2035,6 +2038,7 @@ type
 		procedure putData(status: IStatus; length: Cardinal; data: Pointer);
 		function newKey(status: IStatus): ICryptKey;
 		function getAuthBlock(status: IStatus): IAuthBlock;
+		function getTarget(): PAnsiChar;
 	end;
 
 	IClientBlockImpl = class(IClientBlock)
@@ -2048,6 +2052,7 @@ type
 		procedure putData(status: IStatus; length: Cardinal; data: Pointer); virtual; abstract;
 		function newKey(status: IStatus): ICryptKey; virtual; abstract;
 		function getAuthBlock(status: IStatus): IAuthBlock; virtual; abstract;
+		function getTarget(): PAnsiChar; virtual; abstract;
 	end;
 
 	ServerVTable = class(AuthVTable)
@@ -2514,13 +2519,15 @@ type
 	ExternalFunctionVTable = class(DisposableVTable)
 		getCharSet: IExternalFunction_getCharSetPtr;
 		execute: IExternalFunction_executePtr;
+		executeBatch: IExternalFunction_executeBatchPtr;
 	end;
 
 	IExternalFunction = class(IDisposable)
-		const VERSION = 3;
+		const VERSION = 4;
 
 		procedure getCharSet(status: IStatus; context: IExternalContext; name: PAnsiChar; nameSize: Cardinal);
 		procedure execute(status: IStatus; context: IExternalContext; inMsg: Pointer; outMsg: Pointer);
+		procedure executeBatch(status: IStatus; context: IExternalContext; count: Cardinal; inMsgs: Pointer; inMsgLength: Cardinal; outMsgs: Pointer; outMsgLength: Cardinal);
 	end;
 
 	IExternalFunctionImpl = class(IExternalFunction)
@@ -2529,6 +2536,7 @@ type
 		procedure dispose(); virtual; abstract;
 		procedure getCharSet(status: IStatus; context: IExternalContext; name: PAnsiChar; nameSize: Cardinal); virtual; abstract;
 		procedure execute(status: IStatus; context: IExternalContext; inMsg: Pointer; outMsg: Pointer); virtual; abstract;
+		procedure executeBatch(status: IStatus; context: IExternalContext; count: Cardinal; inMsgs: Pointer; inMsgLength: Cardinal; outMsgs: Pointer; outMsgLength: Cardinal); virtual; abstract;
 	end;
 
 	ExternalProcedureVTable = class(DisposableVTable)
@@ -5302,6 +5310,10 @@ const
 	 isc_wrong_shmem_ver = 335545280;
 	 isc_wrong_shmem_bitness = 335545281;
 	 isc_wrong_proc_plan = 335545282;
+	 isc_ext_format_err = 335545283;
+	 isc_ext_format_data = 335545284;
+	 isc_eds_multi_src_singleton = 335545285;
+	 isc_eds_multi_src_current = 335545286;
 	 isc_gfix_db_name = 335740929;
 	 isc_gfix_invalid_sw = 335740930;
 	 isc_gfix_incmp_sw = 335740932;
@@ -5788,6 +5800,10 @@ const
 	 isc_nbackup_clean_hist_missed = 337117270;
 	 isc_nbackup_keep_hist_missed = 337117271;
 	 isc_nbackup_second_keep_switch = 337117272;
+	 isc_nbackup_zip_misuse = 337117275;
+	 isc_nbackup_zip_unavailable = 337117276;
+	 isc_nbackup_zip_err = 337117277;
+	 isc_nbackup_zip_checksum = 337117278;
 	 isc_trace_conflict_acts = 337182750;
 	 isc_trace_act_notfound = 337182751;
 	 isc_trace_switch_once = 337182752;
@@ -5799,6 +5815,7 @@ const
 	 isc_trace_switch_param_miss = 337182758;
 	 isc_trace_param_act_notcompat = 337182759;
 	 isc_trace_mandatory_switch_miss = 337182760;
+	 isc_trace_bad_log = 337182763;
 implementation
 
 procedure IReferenceCounted.addRef();
@@ -7406,6 +7423,16 @@ begin
 	FbException.checkException(status);
 end;
 
+function IClientBlock.getTarget(): PAnsiChar;
+begin
+	if (vTable.version < 5) then begin
+		Result := nil;
+	end
+	else begin
+		Result := ClientBlockVTable(vTable).getTarget(Self);
+	end;
+end;
+
 function IServer.authenticate(status: IStatus; sBlock: IServerBlock; writerInterface: IWriter): Integer;
 begin
 	Result := ServerVTable(vTable).authenticate(Self, status, sBlock, writerInterface);
@@ -7833,6 +7860,17 @@ begin
 	FbException.checkException(status);
 end;
 
+procedure IExternalFunction.executeBatch(status: IStatus; context: IExternalContext; count: Cardinal; inMsgs: Pointer; inMsgLength: Cardinal; outMsgs: Pointer; outMsgLength: Cardinal);
+begin
+	if (vTable.version < 4) then begin
+		FbException.setVersionError(status, 'IExternalFunction', vTable.version, 4);
+	end
+	else begin
+		ExternalFunctionVTable(vTable).executeBatch(Self, status, context, count, inMsgs, inMsgLength, outMsgs, outMsgLength);
+	end;
+	FbException.checkException(status);
+end;
+
 procedure IExternalProcedure.getCharSet(status: IStatus; context: IExternalContext; name: PAnsiChar; nameSize: Cardinal);
 begin
 	ExternalProcedureVTable(vTable).getCharSet(Self, status, context, name, nameSize);
@@ -11981,6 +12019,15 @@ begin
 	end
 end;
 
+function IClientBlockImpl_getTargetDispatcher(this: IClientBlock): PAnsiChar; cdecl;
+begin
+	try
+		Result := IClientBlockImpl(this).getTarget();
+	except
+		on e: Exception do FbException.catchException(nil, e);
+	end
+end;
+
 var
 	IClientBlockImpl_vTable: ClientBlockVTable;
 
@@ -13052,6 +13099,15 @@ begin
 	end
 end;
 
+procedure IExternalFunctionImpl_executeBatchDispatcher(this: IExternalFunction; status: IStatus; context: IExternalContext; count: Cardinal; inMsgs: Pointer; inMsgLength: Cardinal; outMsgs: Pointer; outMsgLength: Cardinal); cdecl;
+begin
+	try
+		IExternalFunctionImpl(this).executeBatch(status, context, count, inMsgs, inMsgLength, outMsgs, outMsgLength);
+	except
+		on e: Exception do FbException.catchException(status, e);
+	end
+end;
+
 var
 	IExternalFunctionImpl_vTable: ExternalFunctionVTable;
 
@@ -16339,7 +16395,7 @@ initialization
 	IServerBlockImpl_vTable.newKey := @IServerBlockImpl_newKeyDispatcher;
 
 	IClientBlockImpl_vTable := ClientBlockVTable.create;
-	IClientBlockImpl_vTable.version := 4;
+	IClientBlockImpl_vTable.version := 5;
 	IClientBlockImpl_vTable.addRef := @IClientBlockImpl_addRefDispatcher;
 	IClientBlockImpl_vTable.release := @IClientBlockImpl_releaseDispatcher;
 	IClientBlockImpl_vTable.getLogin := @IClientBlockImpl_getLoginDispatcher;
@@ -16348,6 +16404,7 @@ initialization
 	IClientBlockImpl_vTable.putData := @IClientBlockImpl_putDataDispatcher;
 	IClientBlockImpl_vTable.newKey := @IClientBlockImpl_newKeyDispatcher;
 	IClientBlockImpl_vTable.getAuthBlock := @IClientBlockImpl_getAuthBlockDispatcher;
+	IClientBlockImpl_vTable.getTarget := @IClientBlockImpl_getTargetDispatcher;
 
 	IServerImpl_vTable := ServerVTable.create;
 	IServerImpl_vTable.version := 6;
@@ -16501,10 +16558,11 @@ initialization
 	IExternalResultSetImpl_vTable.fetch := @IExternalResultSetImpl_fetchDispatcher;
 
 	IExternalFunctionImpl_vTable := ExternalFunctionVTable.create;
-	IExternalFunctionImpl_vTable.version := 3;
+	IExternalFunctionImpl_vTable.version := 4;
 	IExternalFunctionImpl_vTable.dispose := @IExternalFunctionImpl_disposeDispatcher;
 	IExternalFunctionImpl_vTable.getCharSet := @IExternalFunctionImpl_getCharSetDispatcher;
 	IExternalFunctionImpl_vTable.execute := @IExternalFunctionImpl_executeDispatcher;
+	IExternalFunctionImpl_vTable.executeBatch := @IExternalFunctionImpl_executeBatchDispatcher;
 
 	IExternalProcedureImpl_vTable := ExternalProcedureVTable.create;
 	IExternalProcedureImpl_vTable.version := 3;
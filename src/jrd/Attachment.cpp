@@ -251,6 +251,7 @@ Jrd::Attachment::Attachment(MemoryPool* pool, Database* dbb, JProvider* provider
 	  att_udf_pointers(*pool),
 	  att_ext_connection(NULL),
 	  att_ext_parent(NULL),
+	  att_ext_async(NULL),
 	  att_ext_call_depth(0),
 	  att_trace_manager(FB_NEW_POOL(*att_pool) TraceManager(this)),
 	  att_bindings(*pool),
@@ -262,6 +263,7 @@ Jrd::Attachment::Attachment(MemoryPool* pool, Database* dbb, JProvider* provider
 	  att_utility(UTIL_NONE),
 	  att_procedures(*pool),
 	  att_functions(*pool),
+	  att_shared_formats(*pool),
 	  att_generators(*pool),
 	  att_internal(*pool),
 	  att_dyn_req(*pool),
@@ -290,6 +292,9 @@ Jrd::Attachment::~Attachment()
 	for (unsigned n = 0; n < att_batches.getCount(); ++n)
 		att_batches[n]->resetHandle();
 
+	if (att_shared_formats.hasData())
+		att_database->dbb_format_cache->release(att_shared_formats);
+
 	for (Function** iter = att_functions.begin(); iter < att_functions.end(); ++iter)
 	{
 		Function* const function = *iter;
@@ -620,6 +625,9 @@ void Jrd::Attachment::signalCancel()
 	if (att_ext_connection && att_ext_connection->isConnected())
 		att_ext_connection->cancelExecution(false);
 
+	if (att_ext_async)
+		att_ext_async->cancel(false);
+
 	LCK_cancel_wait(this);
 }
 
@@ -633,6 +641,9 @@ void Jrd::Attachment::signalShutdown(ISC_STATUS code)
 	if (att_ext_connection && att_ext_connection->isConnected())
 		att_ext_connection->cancelExecution(true);
 
+	if (att_ext_async)
+		att_ext_async->cancel(true);
+
 	LCK_cancel_wait(this);
 }
 
@@ -925,6 +936,11 @@ void Jrd::Attachment::releaseRelations(thread_db* tdbb)
 			}
 		}
 	}
+
+	// Relations don't refer to the shared formats anymore
+
+	if (att_shared_formats.hasData())
+		att_database->dbb_format_cache->release(att_shared_formats);
 }
 
 int Jrd::Attachment::blockingAstShutdown(void* ast_object)
@@ -977,7 +993,13 @@ int Jrd::Attachment::blockingAstMonitor(void* ast_object)
 
 		AsyncContextHolder tdbb(dbb, FB_FUNCTION, attachment->att_monitor_lock);
 
-		if (const auto generation = Monitoring::checkGeneration(dbb, attachment))
+		auto generation = Monitoring::checkGeneration(dbb, attachment);
+		const bool refresh = !generation && Monitoring::checkRefresh(dbb, attachment);
+
+		if (refresh)
+			generation = attachment->att_monitor_generation;
+
+		if (generation || refresh)
 		{
 			try
 			{
@@ -54,6 +54,7 @@
 
 namespace EDS {
 	class Connection;
+	class AsyncEvent;
 }
 
 namespace Replication
@@ -580,6 +581,7 @@ public:
 	Lock*		att_cancel_lock;			// Lock to cancel the active request
 	Lock*		att_monitor_lock;			// Lock for monitoring purposes
 	ULONG		att_monitor_generation;		// Monitoring state generation
+	SINT64		att_monitor_time;			// Time of the last monitoring state dump
 	Lock*		att_profiler_listener_lock;	// Lock for remote profiler listener
 	const ULONG	att_lock_owner_id;			// ID for the lock manager
 	SLONG		att_lock_owner_handle;		// Handle for the lock manager
@@ -626,6 +628,7 @@ public:
 
 	EDS::Connection* att_ext_connection;	// external connection executed by this attachment
 	EDS::Connection* att_ext_parent;		// external connection, parent of this attachment
+	EDS::AsyncEvent* att_ext_async;			// external statements executed asynchronously and waited for
 	ULONG att_ext_call_depth;				// external connection call depth, 0 for user attachment
 	TraceManager* att_trace_manager;		// Trace API manager
 
@@ -650,6 +653,7 @@ public:
 	TrigVector*						att_triggers[DB_TRIGGER_MAX];
 	TrigVector*						att_ddl_triggers;
 	Firebird::Array<Function*>		att_functions;			// User defined functions
+	Firebird::SortedArray<Format*>	att_shared_formats;		// formats held in the database FormatCache
 	GeneratorFinder					att_generators;
 
 	Firebird::Array<Statement*>	att_internal;			// internal statements
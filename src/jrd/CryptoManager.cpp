@@ -275,6 +275,7 @@ namespace Jrd {
 		  checkFactory(NULL),
 		  dbb(*tdbb->getDatabase()),
 		  cryptAtt(NULL),
+		  cryptWorkers(NULL),
 		  slowIO(0),
 		  crypt(false),
 		  process(false),
@@ -291,6 +292,7 @@ namespace Jrd {
 		if (cryptThreadId)
 			Thread::waitForCompletion(cryptThreadId);
 
+		delete cryptWorkers;
 		delete stateLock;
 		delete threadLock;
 		delete checkFactory;
@@ -302,6 +304,9 @@ namespace Jrd {
 	{
 		terminateCryptThread(tdbb, false);
 
+		delete cryptWorkers;
+		cryptWorkers = NULL;
+
 		if (cryptPlugin)
 		{
 			PluginManagerInterfacePtr()->releasePlugin(cryptPlugin);
@@ -1167,7 +1172,8 @@ namespace Jrd {
 		return SUCCESS_ALL;
 	}
 
-	bool CryptoManager::write(thread_db* tdbb, FbStatusVector* sv, Ods::pag* page, IOCallback* io)
+	bool CryptoManager::write(thread_db* tdbb, FbStatusVector* sv, Ods::pag* page, IOCallback* io,
+		Ods::pag* crypted)
 	{
 		// Code calling us is not ready to process exceptions correctly
 		// Therefore use old (status vector based) method
@@ -1179,7 +1185,7 @@ namespace Jrd {
 
 			// Page is never going to be encrypted. No locks needed.
 			if (!Ods::pag_crypt_page[page->pag_type])
-				return internalWrite(tdbb, sv, page, io) == SUCCESS_ALL;
+				return internalWrite(tdbb, sv, page, io, crypted) == SUCCESS_ALL;
 
 			// Normal case (almost always get here)
 			// Take shared lock on crypto manager and write data
@@ -1187,7 +1193,7 @@ namespace Jrd {
 			{
 				BarSync::IoGuard ioGuard(tdbb, sync);
 				if (!slowIO)
-					return internalWrite(tdbb, sv, page, io) == SUCCESS_ALL;
+					return internalWrite(tdbb, sv, page, io, crypted) == SUCCESS_ALL;
 			}
 
 			// Have to use slow method - see full comments in read() function
@@ -1195,7 +1201,7 @@ namespace Jrd {
 			lockGuard.lock();
 			for (SINT64 previous = slowIO; ; previous = slowIO)
 			{
-				switch (internalWrite(tdbb, sv, page, io))
+				switch (internalWrite(tdbb, sv, page, io, crypted))
 				{
 				case SUCCESS_ALL:
 					if (!slowIO)
@@ -1228,7 +1234,7 @@ namespace Jrd {
 	}
 
 	CryptoManager::IoResult CryptoManager::internalWrite(thread_db* tdbb, FbStatusVector* sv,
-		Ods::pag* page, IOCallback* io)
+		Ods::pag* page, IOCallback* io, Ods::pag* crypted)
 	{
 		Buffer to;
 		Ods::pag* dest = page;
@@ -1243,19 +1249,28 @@ namespace Jrd {
 				return FAILED_CRYPT;
 			}
 
-			FbLocalStatus ls;
-			to[0] = page[0];
-			cryptPlugin->encrypt(&ls, dbb.dbb_page_size - sizeof(Ods::pag),
-				&page[1], &to[1]);
-			if (ls->getState() & IStatus::STATE_ERRORS)
+			if (crypted)
 			{
-				ERR_post_nothrow(&ls, sv);
-				return FAILED_CRYPT;
+				// Page body was encrypted in advance by prepareWrite()
+				dest = crypted;
+			}
+			else
+			{
+				FbLocalStatus ls;
+				cryptPlugin->encrypt(&ls, dbb.dbb_page_size - sizeof(Ods::pag),
+					&page[1], &to[1]);
+				if (ls->getState() & IStatus::STATE_ERRORS)
+				{
+					ERR_post_nothrow(&ls, sv);
+					return FAILED_CRYPT;
+				}
+
+				dest = to;							// Choose correct destination
 			}
 
-			to->pag_flags |= Ods::crypted_page;		// Mark page that is going to be written as encrypted
+			dest[0] = page[0];						// Header is never encrypted
+			dest->pag_flags |= Ods::crypted_page;	// Mark page that is going to be written as encrypted
 			page->pag_flags |= Ods::crypted_page;	// Set the mark for page in cache as well
-			dest = to;								// Choose correct destination
 		}
 		else
 		{
@@ -1271,6 +1286,189 @@ namespace Jrd {
 		return SUCCESS_ALL;
 	}
 
+	void CryptoManager::prepareWrite(thread_db* tdbb, unsigned count, Ods::pag* const* pages,
+		UCHAR* buffers, Ods::pag** crypted)
+	{
+		unsigned toCrypt = 0;
+
+		for (unsigned i = 0; i < count; i++)
+		{
+			crypted[i] = NULL;
+
+			if (crypt && cryptPlugin && Ods::pag_crypt_page[pages[i]->pag_type])
+			{
+				crypted[i] = reinterpret_cast<Ods::pag*>(buffers + i * dbb.dbb_page_size);
+				toCrypt++;
+			}
+		}
+
+		if (toCrypt < 2)
+		{
+			for (unsigned i = 0; i < count; i++)
+				crypted[i] = NULL;
+
+			return;
+		}
+
+		// Keep the crypt state stable while encrypting. If it's changed
+		// later, write() notices that and ignores the prepared images.
+		BarSync::IoGuard ioGuard(tdbb, sync);
+
+		if (!cryptWorkers)
+		{
+			MutexLockGuard guard(cryptThreadMtx, FB_FUNCTION);
+
+			const int workers = dbb.dbb_config->getParallelWorkers();
+
+			if (!cryptWorkers && workers > 1)
+				cryptWorkers = FB_NEW_POOL(getPool()) CryptWorkers(getPool(), this, workers - 1);
+		}
+
+		if (slowIO || !crypt || !cryptWorkers || !cryptWorkers->encrypt(count, pages, crypted))
+		{
+			for (unsigned i = 0; i < count; i++)
+				crypted[i] = NULL;
+		}
+	}
+
+	bool CryptoManager::canPrepareWrite() const
+	{
+		return crypt && dbb.dbb_config->getParallelWorkers() > 1;
+	}
+
+	bool CryptoManager::encryptPage(Ods::pag* page, Ods::pag* to)
+	{
+		FbLocalStatus ls;
+		cryptPlugin->encrypt(&ls, dbb.dbb_page_size - sizeof(Ods::pag), &page[1], &to[1]);
+
+		return !(ls->getState() & IStatus::STATE_ERRORS);
+	}
+
+	CryptoManager::CryptWorkers::CryptWorkers(MemoryPool& pool, CryptoManager* cm, unsigned count)
+		: cryptoManager(cm),
+		  threads(pool),
+		  batchPages(NULL),
+		  batchCrypted(NULL),
+		  batchCount(0),
+		  next(0),
+		  done(0),
+		  stop(false)
+	{
+		try
+		{
+			for (unsigned i = 0; i < count; i++)
+			{
+				Thread::Handle handle;
+				Thread::start(workerThread, this, THREAD_medium, &handle);
+				threads.add(handle);
+			}
+		}
+		catch (const Exception&)
+		{
+			stopWorkers();
+			throw;
+		}
+	}
+
+	CryptoManager::CryptWorkers::~CryptWorkers()
+	{
+		stopWorkers();
+	}
+
+	void CryptoManager::CryptWorkers::stopWorkers()
+	{
+		{	// scope
+			MutexLockGuard guard(mutex, FB_FUNCTION);
+			stop = true;
+			workCond.notifyAll();
+		}
+
+		for (FB_SIZE_T i = 0; i < threads.getCount(); i++)
+			Thread::waitForCompletion(threads[i]);
+
+		threads.clear();
+	}
+
+	bool CryptoManager::CryptWorkers::encrypt(unsigned count, Ods::pag* const* pages, Ods::pag** crypted)
+	{
+		// Concurrent batch is encrypted by the calling thread alone
+		if (!batchMutex.tryEnter(FB_FUNCTION))
+			return false;
+
+		{	// scope
+			MutexLockGuard guard(mutex, FB_FUNCTION);
+
+			batchPages = pages;
+			batchCrypted = crypted;
+			batchCount = count;
+			next = done = 0;
+
+			workCond.notifyAll();
+		}
+
+		while (encryptNext())
+			;
+
+		{	// scope
+			MutexLockGuard guard(mutex, FB_FUNCTION);
+
+			while (done < batchCount)
+				doneCond.wait(mutex);
+
+			batchCount = 0;
+		}
+
+		batchMutex.leave();
+		return true;
+	}
+
+	bool CryptoManager::CryptWorkers::encryptNext()
+	{
+		unsigned n;
+
+		{	// scope
+			MutexLockGuard guard(mutex, FB_FUNCTION);
+
+			if (next >= batchCount)
+				return false;
+
+			n = next++;
+		}
+
+		if (batchCrypted[n] && !cryptoManager->encryptPage(batchPages[n], batchCrypted[n]))
+			batchCrypted[n] = NULL;		// write() will repeat it and report the error
+
+		MutexLockGuard guard(mutex, FB_FUNCTION);
+
+		if (++done == batchCount)
+			doneCond.notifyAll();
+
+		return true;
+	}
+
+	THREAD_ENTRY_DECLARE CryptoManager::CryptWorkers::workerThread(THREAD_ENTRY_PARAM arg)
+	{
+		static_cast<CryptWorkers*>(arg)->worker();
+		return 0;
+	}
+
+	void CryptoManager::CryptWorkers::worker()
+	{
+		MutexLockGuard guard(mutex, FB_FUNCTION);
+
+		while (!stop)
+		{
+			if (next < batchCount)
+			{
+				MutexUnlockGuard unlock(mutex, FB_FUNCTION);
+				encryptNext();
+				continue;
+			}
+
+			workCond.wait(mutex);
+		}
+	}
+
 	int CryptoManager::blockingAstChangeCryptState(void* object)
 	{
 		((CryptoManager*) object)->blockingAstChangeCryptState();
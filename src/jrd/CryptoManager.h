@@ -290,7 +290,15 @@ public:
 	};
 
 	bool read(thread_db* tdbb, FbStatusVector* sv, Ods::pag* page, IOCallback* io);
-	bool write(thread_db* tdbb, FbStatusVector* sv, Ods::pag* page, IOCallback* io);
+	bool write(thread_db* tdbb, FbStatusVector* sv, Ods::pag* page, IOCallback* io,
+		Ods::pag* crypted = NULL);
+
+	// Encrypt a batch of pages to be written, spreading the work among worker threads.
+	// Images are placed into the given (page aligned) buffers, crypted[i] is set to NULL
+	// when page i is not encrypted in advance - write() will take care about it.
+	void prepareWrite(thread_db* tdbb, unsigned count, Ods::pag* const* pages,
+		UCHAR* buffers, Ods::pag** crypted);
+	bool canPrepareWrite() const;
 
 	void cryptThread();
 
@@ -305,7 +313,8 @@ public:
 private:
 	enum IoResult {SUCCESS_ALL, FAILED_CRYPT, FAILED_IO};
 	IoResult internalRead(thread_db* tdbb, FbStatusVector* sv, Ods::pag* page, IOCallback* io);
-	IoResult internalWrite(thread_db* tdbb, FbStatusVector* sv, Ods::pag* page, IOCallback* io);
+	IoResult internalWrite(thread_db* tdbb, FbStatusVector* sv, Ods::pag* page, IOCallback* io,
+		Ods::pag* crypted);
 
 	class Buffer
 	{
@@ -324,6 +333,34 @@ private:
 		char buf[MAX_PAGE_SIZE + PAGE_ALIGNMENT - 1];
 	};
 
+	// Threads encrypting pages of a batch together with the thread requesting it
+	class CryptWorkers
+	{
+	public:
+		CryptWorkers(Firebird::MemoryPool& pool, CryptoManager* cm, unsigned count);
+		~CryptWorkers();
+
+		// Returns false if workers are busy with another batch
+		bool encrypt(unsigned count, Ods::pag* const* pages, Ods::pag** crypted);
+
+	private:
+		static THREAD_ENTRY_DECLARE workerThread(THREAD_ENTRY_PARAM arg);
+		void worker();
+		void stopWorkers();
+		bool encryptNext();
+
+		CryptoManager* const cryptoManager;
+		Firebird::Mutex mutex, batchMutex;
+		Firebird::Condition workCond, doneCond;
+		Firebird::HalfStaticArray<Thread::Handle, 8> threads;
+		Ods::pag* const* batchPages;
+		Ods::pag** batchCrypted;
+		unsigned batchCount, next, done;
+		bool stop;
+	};
+
+	bool encryptPage(Ods::pag* page, Ods::pag* to);
+
 	class DbInfo;
 	friend class DbInfo;
 
@@ -384,6 +421,7 @@ private:
 	Lock* stateLock;
 	Lock* threadLock;
 	Attachment* cryptAtt;
+	CryptWorkers* cryptWorkers;
 
 	// This counter works only in a case when database encryption is changed.
 	// Traditional processing of AST can not be used for crypto manager.
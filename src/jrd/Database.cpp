@@ -38,6 +38,7 @@
 #include "../jrd/tpc_proto.h"
 #include "../jrd/lck_proto.h"
 #include "../jrd/CryptoManager.h"
+#include "../jrd/StatementStats.h"
 #include "../jrd/os/pio_proto.h"
 #include "../common/os/os_utils.h"
 //#include "../dsql/Parser.h"
@@ -160,8 +161,10 @@ namespace Jrd
 
 		delete dbb_tip_cache;
 		delete dbb_monitoring_data;
+		delete dbb_stmt_stats;
 		delete dbb_backup_manager;
 		delete dbb_crypto_manager;
+		delete dbb_format_cache;
 	}
 
 	void Database::deletePool(MemoryPool* pool)
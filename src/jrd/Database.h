@@ -62,6 +62,7 @@
 #include "../jrd/ods.h"
 #include "../jrd/sbm.h"
 #include "../jrd/flu.h"
+#include "../jrd/FormatCache.h"
 #include "../jrd/RuntimeStatistics.h"
 #include "../jrd/event_proto.h"
 #include "../jrd/ExtEngineManager.h"
@@ -87,6 +88,7 @@ class TipCache;
 class BackupManager;
 class ExternalFileDirectoryList;
 class MonitoringData;
+class StatementStats;
 class GarbageCollector;
 class CryptoManager;
 class KeywordsMap;
@@ -457,6 +459,7 @@ public:
 	BlobFilter*	dbb_blob_filters;		// known blob filters
 
 	MonitoringData*			dbb_monitoring_data;	// monitoring data
+	StatementStats*			dbb_stmt_stats;			// aggregated statements statistics
 
 private:
 	Firebird::string dbb_file_id;		// system-wide unique file ID
@@ -511,6 +514,8 @@ public:
 	Firebird::Semaphore dbb_gc_init;	// Event for initialization garbage collector
 	ThreadFinishSync<Database*> dbb_gc_fini;	// Sync for finalization garbage collector
 
+	FormatCache*	dbb_format_cache;	// relation formats shared by attachments (SuperServer only)
+
 	Firebird::MemoryStats dbb_memory_stats;
 	RuntimeStatistics dbb_stats;
 	mutable Firebird::Mutex dbb_stats_mutex;
@@ -594,6 +599,7 @@ private:
 	Database(MemoryPool* p, Firebird::IPluginConfig* pConf, bool shared)
 	:	dbb_permanent(p),
 		dbb_page_manager(this, *p),
+		dbb_stmt_stats(NULL),
 		dbb_file_id(*p),
 		dbb_modules(*p),
 		dbb_extManager(nullptr),
@@ -607,6 +613,7 @@ private:
 		dbb_pools(*p, 4),
 		dbb_sort_buffers(*p),
 		dbb_gc_fini(*p, garbage_collector, THREAD_medium),
+		dbb_format_cache(shared ? FB_NEW_POOL(*p) FormatCache(*p) : NULL),
 		dbb_stats(*p),
 		dbb_lock_owner_id(getLockOwnerId()),
 		dbb_tip_cache(NULL),
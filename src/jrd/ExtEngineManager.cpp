@@ -714,14 +714,32 @@ void* ExtEngineManager::ExternalContextImpl::setInfo(int code, void* value)
 
 ExtEngineManager::Function::Function(thread_db* tdbb, ExtEngineManager* aExtManager,
 		IExternalEngine* aEngine, RoutineMetadata* aMetadata, IExternalFunction* aFunction,
-		const Jrd::Function* aUdf)
+		const Jrd::Function* aUdf, const Format* aExtInputFormat, const Format* aExtOutputFormat)
 	: extManager(aExtManager),
 	  engine(aEngine),
 	  metadata(aMetadata),
 	  function(aFunction),
 	  udf(aUdf),
-	  database(tdbb->getDatabase())
+	  database(tdbb->getDatabase()),
+	  extInputFormat(aExtInputFormat),
+	  extOutputFormat(aExtOutputFormat),
+	  batchable(true)
 {
+	// See IntMessageNode and InitParameterNode for what the function request does with parameters
+	const Array<NestConst<Parameter> >* const fields[] = {&udf->getInputFields(), &udf->getOutputFields()};
+
+	for (const auto list : fields)
+	{
+		for (const auto& param : *list)
+		{
+			if (!param->prm_nullable ||
+				(param->prm_mechanism != prm_mech_type_of &&
+					!fb_utils::implicit_domain(param->prm_field_source.c_str())))
+			{
+				batchable = false;
+			}
+		}
+	}
 }
 
 
@@ -749,6 +767,129 @@ void ExtEngineManager::Function::execute(thread_db* tdbb, UCHAR* inMsg, UCHAR* o
 }
 
 
+ULONG ExtEngineManager::Function::getInputLength() const
+{
+	return extInputFormat ? FB_ALIGN(extInputFormat->fmt_length, FB_ALIGNMENT) : 0;
+}
+
+
+ULONG ExtEngineManager::Function::getOutputLength() const
+{
+	return FB_ALIGN(extOutputFormat->fmt_length, FB_ALIGNMENT);
+}
+
+
+// Convert the internal input message into the one requested by the external function.
+void ExtEngineManager::Function::makeInput(thread_db* tdbb, const UCHAR* intMsg, UCHAR* extMsg) const
+{
+	if (!extInputFormat)
+		return;
+
+	const Format* const intFormat = udf->getInputFormat();
+
+	memset(extMsg, 0, extInputFormat->fmt_length);
+
+	// Iterate over the format items, except the EOF item.
+	for (USHORT i = 0; i < (extInputFormat->fmt_count / 2) * 2; i += 2)
+	{
+		const SSHORT* const fromNull = reinterpret_cast<const SSHORT*>(
+			intMsg + (IPTR) intFormat->fmt_desc[i + 1].dsc_address);
+		SSHORT* const toNull = reinterpret_cast<SSHORT*>(
+			extMsg + (IPTR) extInputFormat->fmt_desc[i + 1].dsc_address);
+
+		if (*fromNull)
+		{
+			*toNull = -1;
+			continue;
+		}
+
+		dsc from = intFormat->fmt_desc[i];
+		from.dsc_address = const_cast<UCHAR*>(intMsg) + (IPTR) from.dsc_address;
+
+		dsc to = extInputFormat->fmt_desc[i];
+		to.dsc_address = extMsg + (IPTR) to.dsc_address;
+
+		MOV_move(tdbb, &from, &to);
+		*toNull = 0;
+	}
+}
+
+
+// Initialize the output parameters with NULL. Batchable functions have no default values.
+void ExtEngineManager::Function::initOutput(thread_db* /*tdbb*/, UCHAR* extMsg) const
+{
+	memset(extMsg, 0, extOutputFormat->fmt_length);
+
+	for (USHORT i = 0; i < (extOutputFormat->fmt_count / 2) * 2; i += 2)
+		*reinterpret_cast<SSHORT*>(extMsg + (IPTR) extOutputFormat->fmt_desc[i + 1].dsc_address) = -1;
+}
+
+
+// Convert the output message of the external function into the internal one.
+void ExtEngineManager::Function::makeOutput(thread_db* tdbb, const UCHAR* extMsg, UCHAR* intMsg) const
+{
+	const Format* const intFormat = udf->getOutputFormat();
+
+	for (USHORT i = 0; i < (extOutputFormat->fmt_count / 2) * 2; i += 2)
+	{
+		const SSHORT* const fromNull = reinterpret_cast<const SSHORT*>(
+			extMsg + (IPTR) extOutputFormat->fmt_desc[i + 1].dsc_address);
+		SSHORT* const toNull = reinterpret_cast<SSHORT*>(
+			intMsg + (IPTR) intFormat->fmt_desc[i + 1].dsc_address);
+
+		if (*fromNull)
+		{
+			*toNull = -1;
+			continue;
+		}
+
+		dsc from = extOutputFormat->fmt_desc[i];
+		from.dsc_address = const_cast<UCHAR*>(extMsg) + (IPTR) from.dsc_address;
+
+		dsc to = intFormat->fmt_desc[i];
+		to.dsc_address = intMsg + (IPTR) to.dsc_address;
+
+		MOV_move(tdbb, &from, &to);
+		*toNull = 0;
+	}
+}
+
+
+// Execute the function for many rows with a single engine checkout.
+void ExtEngineManager::Function::executeBatch(thread_db* tdbb, unsigned count,
+	UCHAR* inMsgs, UCHAR* outMsgs) const
+{
+	const ULONG inLength = getInputLength();
+	const ULONG outLength = getOutputLength();
+
+	EngineAttachmentInfo* attInfo = extManager->getEngineAttachment(tdbb, engine);
+	const MetaString& userName = udf->invoker ? udf->invoker->getUserName() : "";
+	ContextManager<IExternalFunction> ctxManager(tdbb, attInfo, function,
+		(udf->getName().package.isEmpty() ?
+			CallerName(obj_udf, udf->getName().identifier, userName) :
+			CallerName(obj_package_header, udf->getName().package, userName)));
+
+	EngineCheckout cout(tdbb, FB_FUNCTION, checkoutType(attInfo->engine));
+
+	FbLocalStatus status;
+
+	// Engines built with older headers don't know about batches
+	if (function->cloopVTable->version >= IExternalFunction::VERSION)
+	{
+		function->executeBatch(&status, attInfo->context, count, inMsgs, inLength, outMsgs, outLength);
+		status.check();
+		return;
+	}
+
+	for (unsigned i = 0; i < count; ++i)
+	{
+		function->execute(&status, attInfo->context,
+			(inLength ? inMsgs + i * inLength : NULL), outMsgs + i * outLength);
+		status.check();
+	}
+}
+
+
 //---------------------
 
 
@@ -1354,7 +1495,7 @@ void ExtEngineManager::makeFunction(thread_db* tdbb, CompilerScratch* csb, Jrd::
 	try
 	{
 		udf->fun_external = FB_NEW_POOL(pool) Function(tdbb, this, attInfo->engine,
-			metadata.release(), externalFunction, udf);
+			metadata.release(), externalFunction, udf, extInputFormat, extOutputFormat);
 
 		MemoryPool& csbPool = csb->csb_pool;
 
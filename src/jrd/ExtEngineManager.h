@@ -216,11 +216,30 @@ public:
 			Firebird::IExternalEngine* aEngine,
 			RoutineMetadata* aMetadata,
 			Firebird::IExternalFunction* aFunction,
-			const Jrd::Function* aUdf);
+			const Jrd::Function* aUdf,
+			const Format* aExtInputFormat,
+			const Format* aExtOutputFormat);
 		~Function();
 
 		void execute(thread_db* tdbb, UCHAR* inMsg, UCHAR* outMsg) const;
 
+		// Batched execution bypasses the function request, so it's allowed
+		// only if there are no domains to validate or default values to apply
+		bool isBatchable() const
+		{
+			return batchable;
+		}
+
+		// Distance between adjacent messages of a batch
+		ULONG getInputLength() const;
+		ULONG getOutputLength() const;
+
+		void makeInput(thread_db* tdbb, const UCHAR* intMsg, UCHAR* extMsg) const;
+		void initOutput(thread_db* tdbb, UCHAR* extMsg) const;
+		void makeOutput(thread_db* tdbb, const UCHAR* extMsg, UCHAR* intMsg) const;
+
+		void executeBatch(thread_db* tdbb, unsigned count, UCHAR* inMsgs, UCHAR* outMsgs) const;
+
 	private:
 		ExtEngineManager* extManager;
 		Firebird::IExternalEngine* engine;
@@ -228,6 +247,9 @@ public:
 		Firebird::IExternalFunction* function;
 		const Jrd::Function* udf;
 		Database* database;
+		const Format* extInputFormat;
+		const Format* extOutputFormat;
+		bool batchable;
 	};
 
 	class ResultSet;
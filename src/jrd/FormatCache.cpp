@@ -0,0 +1,152 @@
+/*
+ *  The contents of this file are subject to the Initial
+ *  Developer's Public License Version 1.0 (the "License");
+ *  you may not use this file except in compliance with the
+ *  License. You may obtain a copy of the License at
+ *  http://www.ibphoenix.com/main.nfs?a=ibphoenix&page=ibp_idpl.
+ *
+ *  Software distributed under the License is distributed AS IS,
+ *  WITHOUT WARRANTY OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing rights
+ *  and limitations under the License.
+ *
+ *  The Original Code was created by the Firebird development team
+ *  for the Firebird Open Source RDBMS project.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+ */
+
+#include "firebird.h"
+#include "../jrd/FormatCache.h"
+#include "../jrd/val.h"
+
+using namespace Firebird;
+
+namespace Jrd {
+
+
+FormatCache::~FormatCache()
+{
+	// No attachments are left, free all the formats
+
+	FormatsMap::Accessor accessor(&m_formats);
+	for (bool found = accessor.getFirst(); found; found = accessor.getNext())
+		delete accessor.current()->second;
+
+	for (Format** format = m_purged.begin(); format != m_purged.end(); ++format)
+		delete *format;
+}
+
+
+Format* FormatCache::lookup(FormatList& holder, USHORT relId, USHORT number)
+{
+	MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+	Format* format = NULL;
+	if (m_formats.get(makeKey(relId, number), format))
+		addRef(holder, format);
+
+	return format;
+}
+
+
+Format* FormatCache::publish(FormatList& holder, USHORT relId, Format* format)
+{
+	// Format must be allocated from the cache pool. If another attachment
+	// has published the same format meanwhile, use its copy instead.
+
+	MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+	Format** const existing = m_formats.getOrPut(makeKey(relId, format->fmt_version));
+
+	if (*existing)
+	{
+		delete format;
+		format = *existing;
+	}
+	else
+		*existing = format;
+
+	addRef(holder, format);
+	return format;
+}
+
+
+void FormatCache::release(FormatList& holder)
+{
+	MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+	for (Format** format = holder.begin(); format != holder.end(); ++format)
+	{
+		ULONG* const refs = m_refs.get(*format);
+		fb_assert(refs && *refs);
+
+		if (refs && --*refs)
+			continue;
+
+		m_refs.remove(*format);
+
+		// Published format stays cached until it's purged
+
+		FB_SIZE_T pos;
+		if (m_purged.find(*format, pos))
+		{
+			m_purged.remove(pos);
+			delete *format;
+		}
+	}
+
+	holder.clear();
+}
+
+
+void FormatCache::purge(USHORT relId, USHORT fromNumber)
+{
+	MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+	HalfStaticArray<ULONG, 16> keys;
+	const ULONG lower = makeKey(relId, fromNumber);
+	const ULONG upper = makeKey(relId, MAX_USHORT);
+
+	FormatsMap::Accessor accessor(&m_formats);
+	for (bool found = accessor.getFirst(); found; found = accessor.getNext())
+	{
+		const ULONG key = accessor.current()->first;
+
+		if (key >= lower && key <= upper)
+			keys.add(key);
+	}
+
+	for (const ULONG* key = keys.begin(); key != keys.end(); ++key)
+	{
+		Format* format = NULL;
+		m_formats.get(*key, format);
+		m_formats.remove(*key);
+
+		// Attachments still holding the format free it on release
+
+		if (m_refs.get(format))
+			m_purged.add(format);
+		else
+			delete format;
+	}
+}
+
+
+// Register the reference to the format unless the holder has it already.
+// Called with the mutex locked.
+
+void FormatCache::addRef(FormatList& holder, Format* format)
+{
+	FB_SIZE_T pos;
+	if (holder.find(format, pos))
+		return;
+
+	holder.insert(pos, format);
+
+	ULONG* const refs = m_refs.getOrPut(format);
+	++*refs;
+}
+
+} // namespace Jrd
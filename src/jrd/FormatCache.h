@@ -0,0 +1,86 @@
+/*
+ *  The contents of this file are subject to the Initial
+ *  Developer's Public License Version 1.0 (the "License");
+ *  you may not use this file except in compliance with the
+ *  License. You may obtain a copy of the License at
+ *  http://www.ibphoenix.com/main.nfs?a=ibphoenix&page=ibp_idpl.
+ *
+ *  Software distributed under the License is distributed AS IS,
+ *  WITHOUT WARRANTY OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing rights
+ *  and limitations under the License.
+ *
+ *  The Original Code was created by the Firebird development team
+ *  for the Firebird Open Source RDBMS project.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+ */
+
+#ifndef JRD_FORMAT_CACHE_H
+#define JRD_FORMAT_CACHE_H
+
+#include "firebird.h"
+#include "../common/classes/alloc.h"
+#include "../common/classes/GenericMap.h"
+#include "../common/classes/array.h"
+#include "../common/classes/locks.h"
+
+
+namespace Jrd {
+
+class Format;
+
+// Database-wide cache of relation record formats, used when the Database
+// object is shared among connections. A format stored in RDB$FORMATS never
+// changes, so once published it may be linked into the relation blocks of
+// any attachment instead of being read and parsed again. Entries are purged
+// when the relation is dropped or when DDL is about to store a format under
+// a number that was used before.
+//
+// Every attachment holds a reference to the formats it has linked, see
+// Attachment::att_shared_formats, and releases them with its relations.
+// Purged format is freed when the last reference to it is released.
+
+class FormatCache
+{
+public:
+	typedef Firebird::SortedArray<Format*> FormatList;
+
+	explicit FormatCache(MemoryPool& p)
+		: m_pool(p), m_formats(p), m_refs(p), m_purged(p)
+	{}
+
+	~FormatCache();
+
+	MemoryPool& getPool() const
+	{
+		return m_pool;
+	}
+
+	Format* lookup(FormatList& holder, USHORT relId, USHORT number);
+	Format* publish(FormatList& holder, USHORT relId, Format* format);
+	void release(FormatList& holder);
+	void purge(USHORT relId, USHORT fromNumber = 0);
+
+private:
+	static ULONG makeKey(USHORT relId, USHORT number)
+	{
+		return ((ULONG) relId << 16) | number;
+	}
+
+	void addRef(FormatList& holder, Format* format);
+
+	typedef Firebird::GenericMap<Firebird::Pair<Firebird::NonPooled<ULONG, Format*> > > FormatsMap;
+	typedef Firebird::GenericMap<Firebird::Pair<Firebird::NonPooled<Format*, ULONG> > > RefsMap;
+
+	MemoryPool& m_pool;
+	Firebird::Mutex m_mutex;
+	FormatsMap m_formats;		// published formats by relation id and format number
+	RefsMap m_refs;				// number of attachments holding the format
+	FormatList m_purged;		// purged formats still held by attachments
+};
+
+} // namespace Jrd
+
+#endif // JRD_FORMAT_CACHE_H
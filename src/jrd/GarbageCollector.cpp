@@ -32,6 +32,13 @@ namespace Jrd {
 
 void GarbageCollector::RelationData::clear()
 {
+	PageTranMap::Accessor pages(&m_pages);
+
+	Firebird::AtomicCounter::counter_type count = 0;
+	for (bool next = pages.getFirst(); next; next = pages.getNext())
+		count++;
+
+	m_backlog.exchangeAdd(-count);
 	m_pages.clear();
 }
 
@@ -58,6 +65,7 @@ TraNumber GarbageCollector::RelationData::addPage(const ULONG pageno, const TraN
 		return findTran;
 
 	m_pages.add(PageTran(pageno, tranid));
+	++m_backlog;
 	return tranid;
 }
 
@@ -71,10 +79,14 @@ void GarbageCollector::RelationData::swept(const TraNumber oldest_snapshot, Page
 	{
 		if (pages.current().tranid < oldest_snapshot)
 		{
+			// pages passed to the caller remain in backlog until processed
 			if (bm)
 			{
 				PBM_SET(&m_pool, bm, pages.current().pageno);
 			}
+			else
+				--m_backlog;
+
 			next = pages.fastRemove();
 		}
 		else
@@ -207,7 +219,7 @@ GarbageCollector::RelationData* GarbageCollector::getRelData(Sync &sync, const U
 		sync.lock(SYNC_EXCLUSIVE);
 		if (!m_relations.find(relID, pos))
 		{
-			m_relations.insert(pos, FB_NEW_POOL(m_pool) RelationData(m_pool, relID));
+			m_relations.insert(pos, FB_NEW_POOL(m_pool) RelationData(m_pool, relID, m_backlog));
 		}
 		sync.downgrade(SYNC_SHARED);
 	}
@@ -27,6 +27,7 @@
 #include "../common/classes/array.h"
 #include "../common/classes/GenericMap.h"
 #include "../common/classes/SyncObject.h"
+#include "../common/classes/fb_atomic.h"
 #include "../jrd/sbm.h"
 
 
@@ -49,6 +50,19 @@ public:
 	void removeRelation(const USHORT relID);
 	void sweptRelation(const TraNumber oldest_snapshot, const USHORT relID);
 
+	// Pages returned by getPages() are counted in backlog until reported
+	// as processed (or skipped) by the caller
+	void pagesProcessed(const ULONG count)
+	{
+		m_backlog.exchangeAdd(-(Firebird::AtomicCounter::counter_type) count);
+	}
+
+	ULONG getBacklog() const
+	{
+		const Firebird::AtomicCounter::counter_type backlog = m_backlog.value();
+		return backlog > 0 ? (ULONG) backlog : 0;
+	}
+
 private:
 	struct PageTran
 	{
@@ -76,8 +90,8 @@ private:
 	class RelationData
 	{
 	public:
-		explicit RelationData(MemoryPool& p, USHORT relID)
-			: m_pool(p), m_pages(p), m_relID(relID)
+		explicit RelationData(MemoryPool& p, USHORT relID, Firebird::AtomicCounter& backlog)
+			: m_pool(p), m_pages(p), m_relID(relID), m_backlog(backlog)
 		{}
 
 		~RelationData()
@@ -105,6 +119,7 @@ private:
 		Firebird::SyncObject m_sync;
 		PageTranMap m_pages;
 		USHORT m_relID;
+		Firebird::AtomicCounter& m_backlog;
 	};
 
 	typedef	Firebird::SortedArray<
@@ -119,6 +134,7 @@ private:
 	Firebird::SyncObject m_sync;
 	RelGarbageArray m_relations;
 	USHORT m_nextRelID;
+	Firebird::AtomicCounter m_backlog;		// number of pages to be garbage collected
 };
 
 } // namespace Jrd
@@ -42,6 +42,7 @@
 #include "../jrd/pag_proto.h"
 #include "../jrd/cvt_proto.h"
 #include "../jrd/CryptoManager.h"
+#include "../jrd/GarbageCollector.h"
 #include "../jrd/Relation.h"
 #include "../jrd/RecordBuffer.h"
 #include "../jrd/Monitoring.h"
@@ -64,8 +65,9 @@ namespace
 	class DumpWriter : public SnapshotData::DumpRecord::Writer
 	{
 	public:
-		DumpWriter(MonitoringData* data, AttNumber att_id, const char* user_name, ULONG generation)
-			: dump(data), offset(dump->setup(att_id, user_name, generation))
+		DumpWriter(MonitoringData* data, AttNumber att_id, const char* user_name,
+				   ULONG generation, SINT64 timestamp)
+			: dump(data), offset(dump->setup(att_id, user_name, generation, timestamp))
 		{
 			fb_assert(offset);
 		}
@@ -247,12 +249,14 @@ void MonitoringData::release()
 }
 
 
-void MonitoringData::enumerate(const char* userName, ULONG generation, SessionList& sessions)
+void MonitoringData::enumerate(const char* userName, ULONG generation, SINT64 threshold,
+	SessionList& sessions)
 {
 	const bool init = sessions.isEmpty();
 
-	// When initializing, collect all sessions older than the given generation.
-	// Otherwise, remove sessions that have updated their generation.
+	// When initializing, collect all sessions older than the given generation
+	// (or dumped before the given time, if it's specified).
+	// Otherwise, remove sessions that have updated their data.
 
 	for (ULONG offset = alignOffset(sizeof(Header)); offset < m_sharedMemory->getHeader()->used;)
 	{
@@ -262,12 +266,15 @@ void MonitoringData::enumerate(const char* userName, ULONG generation, SessionLi
 
 		if (!userName || !strcmp(element->userName, userName)) // permitted
 		{
+			const bool actual = threshold ?
+				(element->timestamp >= threshold) : (element->generation >= generation);
+
 			if (init)
 			{
-				if (element->generation < generation)
+				if (!actual)
 					sessions.add(element->attId);
 			}
-			else if (element->generation >= generation)
+			else if (actual)
 				sessions.findAndRemove(element->attId);
 		}
 
@@ -299,7 +306,7 @@ void MonitoringData::read(const char* userName, TempSpace& temp)
 }
 
 
-ULONG MonitoringData::setup(AttNumber att_id, const char* userName, ULONG generation)
+ULONG MonitoringData::setup(AttNumber att_id, const char* userName, ULONG generation, SINT64 timestamp)
 {
 	const ULONG offset = alignOffset(m_sharedMemory->getHeader()->used);
 	const ULONG delta = offset + sizeof(Element) - m_sharedMemory->getHeader()->used;
@@ -314,6 +321,7 @@ ULONG MonitoringData::setup(AttNumber att_id, const char* userName, ULONG genera
 	snprintf(element->userName, sizeof(element->userName), "%s", userName);
 	element->generation = generation;
 	element->length = 0;
+	element->timestamp = timestamp;
 	m_sharedMemory->getHeader()->used += delta;
 	return offset;
 }
@@ -424,20 +432,71 @@ MonitoringSnapshot* MonitoringSnapshot::create(thread_db* tdbb)
 	const auto transaction = tdbb->getTransaction();
 	fb_assert(transaction);
 
+	const bool databaseOnly = isDatabaseOnly(tdbb);
+
+	if (transaction->tra_mon_snapshot &&
+		transaction->tra_mon_snapshot->m_databaseOnly && !databaseOnly)
+	{
+		// Snapshot collected for MON$DATABASE only is not enough, replace it
+		delete transaction->tra_mon_snapshot;
+		transaction->tra_mon_snapshot = nullptr;
+	}
+
 	if (!transaction->tra_mon_snapshot)
 	{
 		// Create a database snapshot and store it
 		// in the transaction block
 		MemoryPool& pool = *transaction->tra_pool;
-		transaction->tra_mon_snapshot = FB_NEW_POOL(pool) MonitoringSnapshot(tdbb, pool);
+		transaction->tra_mon_snapshot = FB_NEW_POOL(pool) MonitoringSnapshot(tdbb, pool, databaseOnly);
 	}
 
 	return transaction->tra_mon_snapshot;
 }
 
 
-MonitoringSnapshot::MonitoringSnapshot(thread_db* tdbb, MemoryPool& pool)
-	: SnapshotData(pool)
+bool MonitoringSnapshot::isDatabaseOnly(thread_db* tdbb)
+{
+	// Check whether the current statement reads MON$DATABASE and no other
+	// monitoring table. Such snapshot doesn't need data of other attachments.
+
+	const auto request = tdbb->getRequest();
+	if (!request)
+		return false;
+
+	bool found = false;
+
+	for (const auto& resource : request->getStatement()->resources)
+	{
+		if (resource.rsc_type != Resource::rsc_relation)
+			continue;
+
+		switch (resource.rsc_id)
+		{
+		case rel_mon_database:
+			found = true;
+			break;
+
+		case rel_mon_attachments:
+		case rel_mon_transactions:
+		case rel_mon_statements:
+		case rel_mon_calls:
+		case rel_mon_io_stats:
+		case rel_mon_rec_stats:
+		case rel_mon_ctx_vars:
+		case rel_mon_mem_usage:
+		case rel_mon_tab_stats:
+		case rel_mon_compiled_statements:
+			return false;
+		}
+	}
+
+	return found;
+}
+
+
+MonitoringSnapshot::MonitoringSnapshot(thread_db* tdbb, MemoryPool& pool, bool databaseOnly)
+	: SnapshotData(pool),
+	  m_databaseOnly(databaseOnly)
 {
 	PAG_header(tdbb, true);
 
@@ -461,62 +520,73 @@ MonitoringSnapshot::MonitoringSnapshot(thread_db* tdbb, MemoryPool& pool)
 	const auto mem_usage_buffer = allocBuffer(tdbb, pool, rel_mon_mem_usage);
 	const auto tab_stat_buffer = allocBuffer(tdbb, pool, rel_mon_tab_stats);
 
-	// Increment the global monitor generation
-
-	const auto generation = dbb->newMonitorGeneration();
-
-	// Dump state of our own attachment
-
-	Monitoring::dumpAttachment(tdbb, attachment, generation);
-
-	// Enumerate active sessions and ensure they have dumped their state.
-	// Check that by comparing the session generation with the current one.
-
 	const auto locksmith = attachment->locksmith(tdbb, MONITOR_ANY_ATTACHMENT);
 	const auto userName = attachment->getEffectiveUserName();
 	const auto userNamePtr = locksmith ? nullptr : userName.c_str();
 
-	Lock temp_lock(tdbb, sizeof(AttNumber), LCK_monitor), *lock = &temp_lock;
 	MonitoringData::SessionList sessions(pool);
 
-	do
+	if (!databaseOnly)
 	{
-		ThreadStatusGuard tempStatus(tdbb);
+		// In the incremental mode, data published not earlier than the refresh
+		// interval ago is used as is, otherwise increment the global monitor
+		// generation to make every session dump its state.
 
-		{ // scope for the guard
+		const auto refreshInterval = dbb->dbb_config->getMonitoringRefreshInterval();
+		const SINT64 threshold = (refreshInterval > 0) ? time(NULL) - refreshInterval : 0;
 
-			MonitoringData::Guard guard(dbb->dbb_monitoring_data);
-			dbb->dbb_monitoring_data->enumerate(userNamePtr, generation, sessions);
-		}
+		const auto generation = threshold ?
+			dbb->getMonitorGeneration() : dbb->newMonitorGeneration();
 
-		if (!sessions.hasData())
-			break;
+		// Dump state of our own attachment
 
-		const auto attId = sessions.pop();
-		fb_assert(attId != selfAttId);
-		lock->setKey(attId);
+		Monitoring::dumpAttachment(tdbb, attachment, generation);
 
-		// Try getting an exclusive lock first.
-		// Success means session is dead and must be garbage collected.
+		// Enumerate active sessions and ensure they have dumped their state.
+		// Check that by comparing the session generation (or dump time)
+		// with the current one.
 
-		if (LCK_lock(tdbb, lock, LCK_EX, LCK_NO_WAIT))
+		Lock temp_lock(tdbb, sizeof(AttNumber), LCK_monitor), *lock = &temp_lock;
+
+		do
 		{
-			LCK_release(tdbb, lock);
-			dbb->dbb_monitoring_data->cleanup(attId);
-			continue;
-		}
+			ThreadStatusGuard tempStatus(tdbb);
 
-		// Ping the session via AST to dump its state
+			{ // scope for the guard
 
-		if (!LCK_lock(tdbb, lock, LCK_SR, LCK_WAIT))
-		{
-			fb_assert(false);
-			ERR_punt();
-		}
+				MonitoringData::Guard guard(dbb->dbb_monitoring_data);
+				dbb->dbb_monitoring_data->enumerate(userNamePtr, generation, threshold, sessions);
+			}
 
-		LCK_release(tdbb, lock);
+			if (!sessions.hasData())
+				break;
 
-	} while (sessions.hasData());
+			const auto attId = sessions.pop();
+			fb_assert(attId != selfAttId);
+			lock->setKey(attId);
+
+			// Try getting an exclusive lock first.
+			// Success means session is dead and must be garbage collected.
+
+			if (LCK_lock(tdbb, lock, LCK_EX, LCK_NO_WAIT))
+			{
+				LCK_release(tdbb, lock);
+				dbb->dbb_monitoring_data->cleanup(attId);
+				continue;
+			}
+
+			// Ping the session via AST to dump its state
+
+			if (!LCK_lock(tdbb, lock, LCK_SR, LCK_WAIT))
+			{
+				fb_assert(false);
+				ERR_punt();
+			}
+
+			LCK_release(tdbb, lock);
+
+		} while (sessions.hasData());
+	}
 
 	// Collect monitoring data. Start by gathering database-level info,
 	// it goes directly to the temporary space (as it's not stored in the shared dump).
@@ -533,8 +603,8 @@ MonitoringSnapshot::MonitoringSnapshot(thread_db* tdbb, MemoryPool& pool)
 
 	// Read the dump into a temporary space
 
-	{ // scope for the guard
-
+	if (!databaseOnly)
+	{
 		MonitoringData::Guard guard(dbb->dbb_monitoring_data);
 
 		dbb->dbb_monitoring_data->read(userNamePtr, temp_space);
@@ -938,6 +1008,10 @@ void Monitoring::putDatabase(thread_db* tdbb, SnapshotData::DumpRecord& record)
 
 	record.storeInteger(f_mon_db_repl_mode, dbb->dbb_replica_mode);
 
+	// background garbage collector backlog (data pages)
+	if (const auto gc = dbb->dbb_garbage_collector)
+		record.storeInteger(f_mon_db_gc_backlog, gc->getBacklog());
+
 	// statistics
 	const int stat_id = fb_utils::genUniqueId();
 	record.storeGlobalId(f_mon_db_stat_id, getGlobalId(stat_id));
@@ -1434,6 +1508,11 @@ void Monitoring::checkState(thread_db* tdbb)
 		// Dump attachment state
 		dumpAttachment(tdbb, attachment, generation);
 	}
+	else if (checkRefresh(dbb, attachment))
+	{
+		// Refresh the published state in the incremental mode
+		dumpAttachment(tdbb, attachment, attachment->att_monitor_generation);
+	}
 
 	if (attachment->att_flags & ATT_monitor_disabled)
 	{
@@ -1460,11 +1539,12 @@ void Monitoring::dumpAttachment(thread_db* tdbb, Attachment* attachment, ULONG g
 	fb_assert(dbb->dbb_monitoring_data);
 
 	attachment->att_monitor_generation = generation;
+	const SINT64 timestamp = attachment->att_monitor_time = time(NULL);
 
 	MonitoringData::Guard guard(dbb->dbb_monitoring_data);
 	dbb->dbb_monitoring_data->cleanup(attId);
 
-	DumpWriter writer(dbb->dbb_monitoring_data, attId, userName.c_str(), generation);
+	DumpWriter writer(dbb->dbb_monitoring_data, attId, userName.c_str(), generation, timestamp);
 	SnapshotData::DumpRecord record(pool, writer);
 
 	putAttachment(record, attachment);
@@ -1541,7 +1621,7 @@ void Monitoring::publishAttachment(thread_db* tdbb)
 		dbb->getMonitorGeneration();
 
 	MonitoringData::Guard guard(dbb->dbb_monitoring_data);
-	dbb->dbb_monitoring_data->setup(attachment->att_attachment_id, userName, generation);
+	dbb->dbb_monitoring_data->setup(attachment->att_attachment_id, userName, generation, 0);
 
 	attachment->att_flags |= ATT_monitor_init;
 }
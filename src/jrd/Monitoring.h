@@ -246,7 +246,7 @@ struct MonitoringHeader : public Firebird::MemoryHeader
 
 class MonitoringData final : public Firebird::PermanentStorage, public Firebird::IpcObject
 {
-	static const USHORT MONITOR_VERSION = 6;
+	static const USHORT MONITOR_VERSION = 7;
 	static const ULONG DEFAULT_SIZE = 1048576;
 
 	typedef MonitoringHeader Header;
@@ -257,6 +257,7 @@ class MonitoringData final : public Firebird::PermanentStorage, public Firebird:
 		TEXT userName[USERNAME_LENGTH + 1];
 		ULONG generation;
 		ULONG length;
+		SINT64 timestamp;		// time of the dump, zero if not dumped yet
 	};
 
 	static ULONG alignOffset(ULONG absoluteOffset);
@@ -332,9 +333,9 @@ public:
 	void acquire();
 	void release();
 
-	void enumerate(const char*, ULONG, SessionList&);
+	void enumerate(const char*, ULONG, SINT64, SessionList&);
 	void read(const char*, TempSpace&);
-	ULONG setup(AttNumber, const char*, ULONG);
+	ULONG setup(AttNumber, const char*, ULONG, SINT64);
 	void write(ULONG, ULONG, const void*);
 
 	void cleanup(AttNumber);
@@ -373,7 +374,12 @@ public:
 	static MonitoringSnapshot* create(thread_db* tdbb);
 
 protected:
-	MonitoringSnapshot(thread_db* tdbb, MemoryPool& pool);
+	MonitoringSnapshot(thread_db* tdbb, MemoryPool& pool, bool databaseOnly);
+
+private:
+	static bool isDatabaseOnly(thread_db* tdbb);
+
+	const bool m_databaseOnly;	// only MON$DATABASE is collected
 };
 
 
@@ -392,6 +398,16 @@ public:
 		return 0;
 	}
 
+	// In the incremental mode, the attachment re-publishes its state
+	// once the refresh interval has elapsed since the previous dump
+	static bool checkRefresh(const Database* dbb, const Attachment* attachment)
+	{
+		const auto refreshInterval = dbb->dbb_config->getMonitoringRefreshInterval();
+
+		return (refreshInterval > 0 &&
+			time(NULL) - attachment->att_monitor_time >= refreshInterval);
+	}
+
 	static void checkState(thread_db* tdbb);
 	static SnapshotData* getSnapshot(thread_db* tdbb);
 
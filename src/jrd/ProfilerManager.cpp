@@ -337,11 +337,14 @@ void ProfilerPackage::startSessionFunction(ThrowStatusExceptionWrapper* /*status
 		Nullable<SLONG>() : Nullable<SLONG>(in->flushInterval));
 	const PathName pluginName(in->pluginName.str, in->pluginNameNull ? 0 : in->pluginName.length);
 	const string pluginOptions(in->pluginOptions.str, in->pluginOptionsNull ? 0 : in->pluginOptions.length);
+	const Nullable<SLONG> samplingInterval(in->samplingIntervalNull ?
+		Nullable<SLONG>() : Nullable<SLONG>(in->samplingInterval));
 
 	const auto profilerManager = attachment->getProfilerManager(tdbb);
 
 	out->sessionIdNull = FB_FALSE;
-	out->sessionId = profilerManager->startSession(tdbb, flushInterval, pluginName, description, pluginOptions);
+	out->sessionId = profilerManager->startSession(tdbb, flushInterval, pluginName, description, pluginOptions,
+		samplingInterval);
 }
 
 
@@ -367,6 +370,7 @@ ProfilerManager::ProfilerManager(thread_db* tdbb)
 ProfilerManager::~ProfilerManager()
 {
 	flushTimer->stop();
+	stopSampling();
 }
 
 ProfilerManager* ProfilerManager::create(thread_db* tdbb)
@@ -397,11 +401,15 @@ int ProfilerManager::blockingAst(void* astObject)
 }
 
 SINT64 ProfilerManager::startSession(thread_db* tdbb, Nullable<SLONG> flushInterval,
-	const PathName& pluginName, const string& description, const string& options)
+	const PathName& pluginName, const string& description, const string& options,
+	Nullable<SLONG> samplingInterval)
 {
 	if (flushInterval.isAssigned())
 		checkFlushInterval(flushInterval.value);
 
+	if (samplingInterval.isAssigned())
+		checkSamplingInterval(samplingInterval.value);
+
 	AutoSetRestore<bool> pauseProfiler(&paused, true);
 
 	const auto attachment = tdbb->getAttachment();
@@ -415,6 +423,8 @@ SINT64 ProfilerManager::startSession(thread_db* tdbb, Nullable<SLONG> flushInter
 		currentSession = nullptr;
 	}
 
+	stopSampling();
+
 	auto pluginPtr = activePlugins.get(pluginName);
 
 	AutoPlugin<IProfilerPlugin> plugin;
@@ -456,6 +466,14 @@ SINT64 ProfilerManager::startSession(thread_db* tdbb, Nullable<SLONG> flushInter
 	currentSession->plugin = std::move(plugin);
 	currentSession->flags = currentSession->pluginSession->getFlags();
 
+	if (samplingInterval.isAssigned())
+	{
+		samplingTicks = fb_utils::query_performance_frequency() * samplingInterval.value / 1000;
+
+		samplingTimer = FB_NEW SamplingTimer((unsigned) samplingInterval.value);
+		samplingTimer->start();
+	}
+
 	paused = false;
 
 	if (flushInterval.isAssigned())
@@ -602,6 +620,56 @@ void ProfilerManager::afterRecordSourceGetRecord(Request* request, const RecordS
 	}
 }
 
+// Account a sample for the current PSQL line and the record sources being
+// opened or fetched by the request and its callers. Every sample adds a hit
+// taking the sampling interval to the same statistics the instrumented mode
+// collects, so counters show the number of samples and times are estimations.
+void ProfilerManager::takeSample(Request* request)
+{
+	samplingTimer->clear();
+
+	Stats stats(samplingTicks);
+
+	for (; request && !request->hasInternalStatement(); request = request->req_caller)
+	{
+		const auto profileRequestId = getRequest(request, IProfilerSession::FLAG_AFTER_EVENTS);
+
+		if (!profileRequestId)
+			return;
+
+		if (const auto node = request->req_profiler_node)
+		{
+			currentSession->pluginSession->afterPsqlLineColumn(profileRequestId,
+				node->line, node->column, &stats);
+		}
+
+		if (!request->req_profiler_frame)
+			continue;
+
+		const auto profileStatement = getStatement(request);
+
+		for (auto frame = request->req_profiler_frame; frame; frame = frame->prior)
+		{
+			const auto rsb = frame->rsb;
+			const auto sequencePtr = profileStatement->recSourceSequence.get(rsb->getRecSourceProfileId());
+
+			if (!sequencePtr)
+				continue;
+
+			if (frame->open)
+			{
+				currentSession->pluginSession->afterRecordSourceOpen(
+					profileRequestId, rsb->getCursorProfileId(), *sequencePtr, &stats);
+			}
+			else
+			{
+				currentSession->pluginSession->afterRecordSourceGetRecord(
+					profileRequestId, rsb->getCursorProfileId(), *sequencePtr, &stats);
+			}
+		}
+	}
+}
+
 void ProfilerManager::cancelSession()
 {
 	if (currentSession)
@@ -611,6 +679,8 @@ void ProfilerManager::cancelSession()
 		currentSession->pluginSession->cancel(&status);
 		currentSession = nullptr;
 	}
+
+	stopSampling();
 }
 
 void ProfilerManager::finishSession(thread_db* tdbb, bool flushData)
@@ -625,6 +695,8 @@ void ProfilerManager::finishSession(thread_db* tdbb, bool flushData)
 		currentSession = nullptr;
 	}
 
+	stopSampling();
+
 	if (flushData)
 		flush();
 }
@@ -659,6 +731,7 @@ void ProfilerManager::setFlushInterval(SLONG interval)
 void ProfilerManager::discard()
 {
 	currentSession = nullptr;
+	stopSampling();
 	activePlugins.clear();
 }
 
@@ -696,6 +769,15 @@ void ProfilerManager::updateFlushTimer(bool canStopTimer)
 		flushTimer->stop();
 }
 
+void ProfilerManager::stopSampling()
+{
+	if (samplingTimer)
+	{
+		samplingTimer->stop();
+		samplingTimer = nullptr;
+	}
+}
+
 ProfilerManager::Statement* ProfilerManager::getStatement(Request* request)
 {
 	if (!isActive())
@@ -786,6 +868,54 @@ SINT64 ProfilerManager::getRequest(Request* request, unsigned flags)
 //--------------------------------------
 
 
+void ProfilerManager::SamplingTimer::handler()
+{
+	MutexLockGuard guard(mutex, FB_FUNCTION);
+
+	if (!active)
+		return;
+
+	due.store(true, std::memory_order_relaxed);
+
+	LocalStatus ls;
+	CheckStatusWrapper s(&ls);
+	TimerInterfacePtr()->start(&s, this, (ISC_UINT64) interval * 1000);
+	check(&s);
+}
+
+void ProfilerManager::SamplingTimer::start()
+{
+	MutexLockGuard guard(mutex, FB_FUNCTION);
+
+	if (active)
+		return;
+
+	active = true;
+
+	LocalStatus ls;
+	CheckStatusWrapper s(&ls);
+	TimerInterfacePtr()->start(&s, this, (ISC_UINT64) interval * 1000);
+	check(&s);
+}
+
+void ProfilerManager::SamplingTimer::stop()
+{
+	MutexLockGuard guard(mutex, FB_FUNCTION);
+
+	if (!active)
+		return;
+
+	active = false;
+
+	LocalStatus ls;
+	CheckStatusWrapper s(&ls);
+	TimerInterfacePtr()->stop(&s, this);
+}
+
+
+//--------------------------------------
+
+
 ProfilerIpc::ProfilerIpc(thread_db* tdbb, MemoryPool& pool, AttNumber aAttachmentId)
 	: attachmentId(aAttachmentId)
 {
@@ -1086,6 +1216,8 @@ void ProfilerListener::processCommand(thread_db* tdbb)
 				in->pluginNameNull ? 0 : in->pluginName.length);
 			const string pluginOptions(in->pluginOptions.str,
 				in->pluginOptionsNull ? 0 : in->pluginOptions.length);
+			const Nullable<SLONG> samplingInterval(in->samplingIntervalNull ?
+				Nullable<SLONG>() : Nullable<SLONG>(in->samplingInterval));
 
 			const auto out = reinterpret_cast<ProfilerPackage::StartSessionOutput::Type*>(header->buffer);
 			static_assert(sizeof(*out) <= sizeof(header->buffer), "Buffer size too small");
@@ -1093,7 +1225,7 @@ void ProfilerListener::processCommand(thread_db* tdbb)
 
 			out->sessionIdNull = FB_FALSE;
 			out->sessionId = profilerManager->startSession(tdbb, flushInterval,
-				pluginName, description, pluginOptions);
+				pluginName, description, pluginOptions, samplingInterval);
 
 			break;
 		}
@@ -1232,6 +1364,7 @@ ProfilerPackage::ProfilerPackage(MemoryPool& pool)
 						{blr_internal_info, blr_literal, blr_long, 0, INFO_TYPE_CONNECTION_ID, 0, 0, 0}},
 					{"PLUGIN_NAME", fld_file_name2, true, "null", {blr_null}},
 					{"PLUGIN_OPTIONS", fld_short_description, true, "null", {blr_null}},
+					{"SAMPLING_INTERVAL", fld_stmt_timeout, true, "null", {blr_null}},
 				},
 				{fld_prof_ses_id, false}
 			)
@@ -31,6 +31,7 @@
 #include "../common/classes/RefCounted.h"
 #include "../common/classes/TimerImpl.h"
 #include "../jrd/SystemPackages.h"
+#include <atomic>
 
 namespace Jrd {
 
@@ -102,6 +103,40 @@ private:
 		unsigned flags = 0;
 	};
 
+	// Raises the "sample is due" flag periodically, the sample itself is taken
+	// by the attachment thread when it checks the flag.
+	class SamplingTimer final :
+		public Firebird::RefCntIface<Firebird::ITimerImpl<SamplingTimer, Firebird::CheckStatusWrapper>>
+	{
+	public:
+		explicit SamplingTimer(unsigned aInterval)
+			: interval(aInterval)
+		{
+		}
+
+		// ITimer implementation
+		void handler();
+
+		void start();
+		void stop();
+
+		bool isDue() const
+		{
+			return due.load(std::memory_order_relaxed);
+		}
+
+		void clear()
+		{
+			due.store(false, std::memory_order_relaxed);
+		}
+
+	private:
+		Firebird::Mutex mutex;
+		const unsigned interval;	// milliseconds
+		std::atomic<bool> due = false;
+		bool active = false;
+	};
+
 private:
 	ProfilerManager(thread_db* tdbb);
 
@@ -118,7 +153,8 @@ public:
 
 public:
 	SINT64 startSession(thread_db* tdbb, Nullable<SLONG> flushInterval,
-		const Firebird::PathName& pluginName, const Firebird::string& description, const Firebird::string& options);
+		const Firebird::PathName& pluginName, const Firebird::string& description, const Firebird::string& options,
+		Nullable<SLONG> samplingInterval);
 
 	void prepareRecSource(thread_db* tdbb, Request* request, const RecordSource* rsb);
 	void onRequestFinish(Request* request, Stats& stats);
@@ -129,11 +165,23 @@ public:
 	void beforeRecordSourceGetRecord(Request* request, const RecordSource* rsb);
 	void afterRecordSourceGetRecord(Request* request, const RecordSource* rsb, Stats& stats);
 
+	void takeSample(Request* request);
+
 	bool isActive() const
 	{
 		return currentSession && !paused;
 	}
 
+	bool isSampling() const
+	{
+		return samplingTimer.hasData();
+	}
+
+	bool isSampleDue() const
+	{
+		return samplingTimer->isDue();
+	}
+
 	static void checkFlushInterval(SLONG interval)
 	{
 		if (interval < 0)
@@ -145,6 +193,17 @@ public:
 		}
 	}
 
+	static void checkSamplingInterval(SLONG interval)
+	{
+		if (interval <= 0)
+		{
+			Firebird::status_exception::raise(
+				Firebird::Arg::Gds(isc_not_valid_for_var) <<
+				"SAMPLING_INTERVAL" <<
+				Firebird::Arg::Num(interval));
+		}
+	}
+
 private:
 	void cancelSession();
 	void finishSession(thread_db* tdbb, bool flushData);
@@ -155,6 +214,7 @@ private:
 	void flush(bool updateTimer = true);
 
 	void updateFlushTimer(bool canStopTimer = true);
+	void stopSampling();
 
 	Statement* getStatement(Request* request);
 	SINT64 getRequest(Request* request, unsigned flags);
@@ -164,6 +224,8 @@ private:
 	Firebird::LeftPooledMap<Firebird::PathName, Firebird::AutoPlugin<Firebird::IProfilerPlugin>> activePlugins;
 	Firebird::AutoPtr<Session> currentSession;
 	Firebird::RefPtr<Firebird::TimerImpl> flushTimer;
+	Firebird::RefPtr<SamplingTimer> samplingTimer;
+	SINT64 samplingTicks = 0;		// sampling interval in performance counter ticks
 	unsigned currentFlushInterval = 0;
 	bool paused = false;
 };
@@ -251,6 +313,7 @@ private:
 		(FB_BIGINT, attachmentId)
 		(FB_INTL_VARCHAR(255, CS_METADATA), pluginName)
 		(FB_INTL_VARCHAR(255, CS_METADATA), pluginOptions)
+		(FB_INTEGER, samplingInterval)
 	);
 
 	FB_MESSAGE(StartSessionOutput, Firebird::ThrowStatusExceptionWrapper,
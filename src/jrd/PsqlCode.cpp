@@ -0,0 +1,697 @@
+/*
+ *  The contents of this file are subject to the Initial
+ *  Developer's Public License Version 1.0 (the "License");
+ *  you may not use this file except in compliance with the
+ *  License. You may obtain a copy of the License at
+ *  http://www.ibphoenix.com/main.nfs?a=ibphoenix&page=ibp_idpl.
+ *
+ *  Software distributed under the License is distributed AS IS,
+ *  WITHOUT WARRANTY OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing rights
+ *  and limitations under the License.
+ *
+ *  The Original Code was created by the Firebird development team
+ *  for the Firebird Open Source RDBMS project.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+ */
+
+#include "firebird.h"
+#include "../jrd/PsqlCode.h"
+#include "../jrd/jrd.h"
+#include "../jrd/req.h"
+#include "../jrd/exe.h"
+#include "../dsql/StmtNodes.h"
+#include "../dsql/ExprNodes.h"
+#include "../dsql/BoolNodes.h"
+#include "../jrd/RecordSourceNodes.h"
+#include "../jrd/evl_proto.h"
+#include "../jrd/exe_proto.h"
+#include "../jrd/mov_proto.h"
+#include "../jrd/err_proto.h"
+
+using namespace Firebird;
+using namespace Jrd;
+
+
+namespace
+{
+	const USHORT MAX_REGISTERS = MAX_USHORT;
+
+	bool isIntegerDesc(const dsc& desc)
+	{
+		switch (desc.dsc_dtype)
+		{
+			case dtype_short:
+			case dtype_long:
+			case dtype_int64:
+				return desc.dsc_scale == 0;
+		}
+
+		return false;
+	}
+
+	// Overflow checks are the same as in ArithmeticNode::add2() and multiply2()
+
+	SINT64 addInt64(SINT64 i1, SINT64 i2)
+	{
+		const SINT64 result = (SINT64) ((FB_UINT64) i1 + (FB_UINT64) i2);
+
+		if ((i1 ^ i2) >= 0 && (i1 ^ result) < 0)
+			ERR_post(Arg::Gds(isc_exception_integer_overflow));
+
+		return result;
+	}
+
+	SINT64 subtractInt64(SINT64 i1, SINT64 i2)
+	{
+		const SINT64 result = (SINT64) ((FB_UINT64) i1 - (FB_UINT64) i2);
+
+		if ((i1 ^ i2) < 0 && (i1 ^ result) < 0)
+			ERR_post(Arg::Gds(isc_exception_integer_overflow));
+
+		return result;
+	}
+
+	SINT64 multiplyInt64(SINT64 i1, SINT64 i2)
+	{
+		const FB_UINT64 u1 = (i1 >= 0) ? i1 : -i1;
+		const FB_UINT64 u2 = (i2 >= 0) ? i2 : -i2;
+		const FB_UINT64 u_limit = ((i1 ^ i2) >= 0) ? MAX_SINT64 : (FB_UINT64) MAX_SINT64 + 1;
+
+		if (u1 != 0 && (u_limit / u1) < u2)
+			ERR_post(Arg::Gds(isc_exception_integer_overflow));
+
+		return (SINT64) ((FB_UINT64) i1 * (FB_UINT64) i2);
+	}
+}
+
+
+namespace Jrd {
+
+class PsqlCodeCompiler
+{
+public:
+	PsqlCodeCompiler(thread_db* aTdbb, PsqlCode* aCode)
+		: tdbb(aTdbb), code(aCode), labels(*aTdbb->getDefaultPool()),
+		  nested(*aTdbb->getDefaultPool()), registers(0)
+	{}
+
+	bool compileStatement(const StmtNode* node);
+
+	void finish()
+	{
+		emit(PsqlCode::OP_END, NULL);
+	}
+
+	USHORT getRegisterCount() const
+	{
+		return registers;
+	}
+
+	void dropNested();
+
+private:
+	struct Label
+	{
+		explicit Label(MemoryPool& p)
+			: leaves(p)
+		{}
+
+		USHORT number = 0;
+		ULONG continueTarget = MAX_ULONG;
+		Array<ULONG> leaves;
+	};
+
+	ULONG emit(PsqlCode::Op op, const StmtNode* stmt)
+	{
+		PsqlCode::Instruction& instruction = code->code.add();
+		memset(&instruction, 0, sizeof(instruction));
+		instruction.op = op;
+		instruction.stmt = stmt;
+		return code->code.getCount() - 1;
+	}
+
+	PsqlCode::Instruction& at(ULONG pc)
+	{
+		return code->code[pc];
+	}
+
+	ULONG here() const
+	{
+		return code->code.getCount();
+	}
+
+	bool newRegister(USHORT& reg)
+	{
+		if (registers == MAX_REGISTERS)
+			return false;
+
+		reg = registers++;
+		return true;
+	}
+
+	bool isNativeInteger(const ValueExprNode* node) const;
+	bool compileInteger(const ValueExprNode* node, const StmtNode* stmt, USHORT& reg);
+	bool compileCondition(const BoolExprNode* node, const StmtNode* stmt, USHORT& reg);
+
+	thread_db* tdbb;
+	PsqlCode* code;
+	ObjectsArray<Label> labels;
+	Array<PsqlCode**> nested;
+	USHORT registers;
+};
+
+
+// Check if the expression may be computed with registers
+bool PsqlCodeCompiler::isNativeInteger(const ValueExprNode* node) const
+{
+	if (const auto varNode = nodeAs<VariableNode>(node))
+		return !varNode->outerDecl && isIntegerDesc(varNode->varDecl->varDesc);
+
+	if (const auto literal = nodeAs<LiteralNode>(node))
+		return isIntegerDesc(literal->litDesc);
+
+	if (const auto arithmetic = nodeAs<ArithmeticNode>(node))
+	{
+		const USHORT inexact = ExprNode::FLAG_DATE | ExprNode::FLAG_DECFLOAT |
+			ExprNode::FLAG_INT128 | ExprNode::FLAG_DOUBLE;
+
+		switch (arithmetic->blrOp)
+		{
+			case blr_add:
+			case blr_subtract:
+			case blr_multiply:
+				return !arithmetic->dialect1 && !(arithmetic->nodFlags & inexact) &&
+					arithmetic->nodScale == 0 &&
+					isNativeInteger(arithmetic->arg1) && isNativeInteger(arithmetic->arg2);
+		}
+	}
+
+	return false;
+}
+
+bool PsqlCodeCompiler::compileInteger(const ValueExprNode* node, const StmtNode* stmt, USHORT& reg)
+{
+	if (const auto varNode = nodeAs<VariableNode>(node))
+	{
+		if (!newRegister(reg))
+			return false;
+
+		PsqlCode::Instruction& instruction = at(emit(PsqlCode::OP_LOAD_VAR, stmt));
+		instruction.result = reg;
+		instruction.node = varNode;
+		return true;
+	}
+
+	if (const auto literal = nodeAs<LiteralNode>(node))
+	{
+		if (!newRegister(reg))
+			return false;
+
+		PsqlCode::Instruction& instruction = at(emit(PsqlCode::OP_CONST, stmt));
+		instruction.result = reg;
+		instruction.constant = MOV_get_int64(tdbb, &literal->litDesc, 0);
+		return true;
+	}
+
+	const auto arithmetic = nodeAs<ArithmeticNode>(node);
+	fb_assert(arithmetic);
+
+	USHORT arg1, arg2;
+
+	if (!compileInteger(arithmetic->arg1, stmt, arg1) ||
+		!compileInteger(arithmetic->arg2, stmt, arg2) ||
+		!newRegister(reg))
+	{
+		return false;
+	}
+
+	const PsqlCode::Op op =
+		arithmetic->blrOp == blr_add ? PsqlCode::OP_ADD :
+		arithmetic->blrOp == blr_subtract ? PsqlCode::OP_SUBTRACT :
+		PsqlCode::OP_MULTIPLY;
+
+	PsqlCode::Instruction& instruction = at(emit(op, stmt));
+	instruction.result = reg;
+	instruction.arg1 = arg1;
+	instruction.arg2 = arg2;
+	return true;
+}
+
+bool PsqlCodeCompiler::compileCondition(const BoolExprNode* node, const StmtNode* stmt, USHORT& reg)
+{
+	const auto comparative = nodeAs<ComparativeBoolNode>(node);
+
+	if (comparative && !comparative->arg3 &&
+		isNativeInteger(comparative->arg1) && isNativeInteger(comparative->arg2))
+	{
+		PsqlCode::Op op;
+
+		switch (comparative->blrOp)
+		{
+			case blr_eql:
+				op = PsqlCode::OP_EQL;
+				break;
+			case blr_neq:
+				op = PsqlCode::OP_NEQ;
+				break;
+			case blr_lss:
+				op = PsqlCode::OP_LSS;
+				break;
+			case blr_leq:
+				op = PsqlCode::OP_LEQ;
+				break;
+			case blr_gtr:
+				op = PsqlCode::OP_GTR;
+				break;
+			case blr_geq:
+				op = PsqlCode::OP_GEQ;
+				break;
+			default:
+				op = PsqlCode::OP_END;
+				break;
+		}
+
+		if (op != PsqlCode::OP_END)
+		{
+			USHORT arg1, arg2;
+
+			if (!compileInteger(comparative->arg1, stmt, arg1) ||
+				!compileInteger(comparative->arg2, stmt, arg2) ||
+				!newRegister(reg))
+			{
+				return false;
+			}
+
+			PsqlCode::Instruction& instruction = at(emit(op, stmt));
+			instruction.result = reg;
+			instruction.arg1 = arg1;
+			instruction.arg2 = arg2;
+			return true;
+		}
+	}
+
+	if (!newRegister(reg))
+		return false;
+
+	PsqlCode::Instruction& instruction = at(emit(PsqlCode::OP_EVAL_BOOL, stmt));
+	instruction.result = reg;
+	instruction.node = node;
+	return true;
+}
+
+bool PsqlCodeCompiler::compileStatement(const StmtNode* node)
+{
+	if (const auto assignment = nodeAs<AssignmentNode>(node))
+	{
+		if (!isNativeInteger(assignment->asgnFrom))
+		{
+			emit(PsqlCode::OP_ASSIGN, node);
+			return true;
+		}
+
+		USHORT reg;
+		if (!compileInteger(assignment->asgnFrom, node, reg))
+			return false;
+
+		PsqlCode::Instruction& instruction = at(emit(PsqlCode::OP_ASSIGN_INT, node));
+		instruction.arg1 = reg;
+
+		// Store into a plain integer variable directly
+		const auto target = nodeAs<VariableNode>(assignment->asgnTo);
+
+		if (target && !target->outerDecl && !target->varInfo &&
+			!assignment->missing && !assignment->missing2 &&
+			isIntegerDesc(target->varDecl->varDesc))
+		{
+			instruction.node = target;
+		}
+
+		return true;
+	}
+
+	if (const auto compound = nodeAs<CompoundStmtNode>(node))
+	{
+		for (const auto& statement : compound->statements)
+		{
+			if (!compileStatement(statement))
+				return false;
+		}
+
+		if (compound != code->root)
+			nested.add(const_cast<PsqlCode**>(&compound->psqlCode));
+
+		return true;
+	}
+
+	if (const auto ifNode = nodeAs<IfNode>(node))
+	{
+		USHORT reg;
+		if (!compileCondition(ifNode->condition, node, reg))
+			return false;
+
+		const ULONG jumpFalse = emit(PsqlCode::OP_JUMP_FALSE, node);
+		at(jumpFalse).arg1 = reg;
+
+		if (!compileStatement(ifNode->trueAction))
+			return false;
+
+		if (ifNode->falseAction)
+		{
+			const ULONG jump = emit(PsqlCode::OP_JUMP, node);
+			at(jumpFalse).target = here();
+
+			if (!compileStatement(ifNode->falseAction))
+				return false;
+
+			at(jump).target = here();
+		}
+		else
+			at(jumpFalse).target = here();
+
+		return true;
+	}
+
+	if (const auto label = nodeAs<LabelNode>(node))
+	{
+		labels.add().number = label->labelNumber;
+
+		if (!compileStatement(label->statement))
+			return false;
+
+		// LEAVE jumps right after the labeled statement
+		Label& info = labels[labels.getCount() - 1];
+		for (const auto leave : info.leaves)
+			at(leave).target = here();
+
+		labels.remove(labels.getCount() - 1);
+
+		if (label != code->root)
+			nested.add(const_cast<PsqlCode**>(&label->psqlCode));
+
+		return true;
+	}
+
+	if (const auto loop = nodeAs<LoopNode>(node))
+	{
+		const ULONG start = here();
+		const auto label = nodeAs<LabelNode>(loop->parentStmt.getObject());
+
+		// CONTINUE restarts the loop belonging to the label
+		if (label && labels.hasData() && labels[labels.getCount() - 1].number == label->labelNumber)
+			labels[labels.getCount() - 1].continueTarget = start;
+
+		if (!compileStatement(loop->statement))
+			return false;
+
+		at(emit(PsqlCode::OP_LOOP, node)).target = start;
+		return true;
+	}
+
+	if (const auto continueLeave = nodeAs<ContinueLeaveNode>(node))
+	{
+		for (FB_SIZE_T i = labels.getCount(); i--; )
+		{
+			Label& info = labels[i];
+
+			if (info.number != continueLeave->labelNumber)
+				continue;
+
+			if (continueLeave->blrOp == blr_leave)
+				info.leaves.add(emit(PsqlCode::OP_JUMP, node));
+			else
+			{
+				if (info.continueTarget == MAX_ULONG)
+					return false;
+
+				at(emit(PsqlCode::OP_LOOP, node)).target = info.continueTarget;
+			}
+
+			return true;
+		}
+
+		// Label is outside, let the tree walker unwind to it
+		PsqlCode::Instruction& instruction = at(emit(PsqlCode::OP_UNWIND, node));
+		instruction.arg1 = continueLeave->labelNumber;
+		instruction.arg2 = continueLeave->blrOp;
+		return true;
+	}
+
+	return false;
+}
+
+// Code of nested statements is not used anymore
+void PsqlCodeCompiler::dropNested()
+{
+	for (const auto ptr : nested)
+	{
+		delete *ptr;
+		*ptr = NULL;
+	}
+}
+
+
+PsqlCode* PsqlCode::compile(thread_db* tdbb, CompilerScratch* csb, StmtNode* node)
+{
+	MemoryPool& pool = *tdbb->getDefaultPool();
+	AutoPtr<PsqlCode> code(FB_NEW_POOL(pool) PsqlCode(pool, node));
+
+	PsqlCodeCompiler compiler(tdbb, code);
+
+	if (!compiler.compileStatement(node))
+		return NULL;
+
+	compiler.finish();
+	compiler.dropNested();
+
+	const USHORT count = MAX(compiler.getRegisterCount(), 1);
+	code->impureOffset = csb->allocImpure(alignof(Register), count * sizeof(Register));
+
+	return code.release();
+}
+
+const StmtNode* PsqlCode::execute(thread_db* tdbb, Request* request) const
+{
+	Register* const regs = request->getImpure<Register>(impureOffset);
+	const Instruction* const begin = code.begin();
+	const Instruction* ip = begin;
+
+	try
+	{
+		while (true)
+		{
+			switch (ip->op)
+			{
+				case OP_CONST:
+					regs[ip->result].value = ip->constant;
+					regs[ip->result].null = false;
+					break;
+
+				case OP_LOAD_VAR:
+					loadVariable(tdbb, request, ip, regs[ip->result]);
+					break;
+
+				case OP_EVAL_BOOL:
+					regs[ip->result].value = static_cast<const BoolExprNode*>(ip->node)->execute(tdbb, request);
+					regs[ip->result].null = false;
+					break;
+
+				case OP_ADD:
+				case OP_SUBTRACT:
+				case OP_MULTIPLY:
+				{
+					const Register& arg1 = regs[ip->arg1];
+					const Register& arg2 = regs[ip->arg2];
+					Register& result = regs[ip->result];
+
+					if ((result.null = (arg1.null || arg2.null)))
+						break;
+
+					result.value =
+						ip->op == OP_ADD ? addInt64(arg1.value, arg2.value) :
+						ip->op == OP_SUBTRACT ? subtractInt64(arg1.value, arg2.value) :
+						multiplyInt64(arg1.value, arg2.value);
+					break;
+				}
+
+				case OP_EQL:
+				case OP_NEQ:
+				case OP_LSS:
+				case OP_LEQ:
+				case OP_GTR:
+				case OP_GEQ:
+				{
+					const Register& arg1 = regs[ip->arg1];
+					const Register& arg2 = regs[ip->arg2];
+					Register& result = regs[ip->result];
+
+					// Unknown is as good as false for our jumps
+					result.null = false;
+
+					if (arg1.null || arg2.null)
+						result.value = false;
+					else
+					{
+						switch (ip->op)
+						{
+							case OP_EQL:
+								result.value = arg1.value == arg2.value;
+								break;
+							case OP_NEQ:
+								result.value = arg1.value != arg2.value;
+								break;
+							case OP_LSS:
+								result.value = arg1.value < arg2.value;
+								break;
+							case OP_LEQ:
+								result.value = arg1.value <= arg2.value;
+								break;
+							case OP_GTR:
+								result.value = arg1.value > arg2.value;
+								break;
+							default:
+								result.value = arg1.value >= arg2.value;
+								break;
+						}
+					}
+					break;
+				}
+
+				case OP_ASSIGN:
+					EXE_assignment(tdbb, static_cast<const AssignmentNode*>(ip->stmt));
+					break;
+
+				case OP_ASSIGN_INT:
+					assignInteger(tdbb, request, ip, regs[ip->arg1]);
+					break;
+
+				case OP_JUMP:
+					ip = begin + ip->target;
+					continue;
+
+				case OP_JUMP_FALSE:
+					if (regs[ip->arg1].null || !regs[ip->arg1].value)
+					{
+						ip = begin + ip->target;
+						continue;
+					}
+					break;
+
+				case OP_LOOP:
+					JRD_reschedule(tdbb);
+					ip = begin + ip->target;
+					continue;
+
+				case OP_UNWIND:
+					request->req_operation = Request::req_unwind;
+					request->req_label = ip->arg1;
+					request->req_flags |= (ip->arg2 == blr_continue_loop) ? req_continue_loop : req_leave;
+					return root->parentStmt;
+
+				case OP_END:
+					request->req_operation = Request::req_return;
+					return root->parentStmt;
+			}
+
+			++ip;
+		}
+	}
+	catch (const Exception&)
+	{
+		// Report the statement which failed, as the tree walker would do
+		if (ip->stmt && ip->stmt->hasLineColumn)
+		{
+			request->req_src_line = ip->stmt->line;
+			request->req_src_column = ip->stmt->column;
+		}
+
+		throw;
+	}
+}
+
+void PsqlCode::loadVariable(thread_db* tdbb, Request* request, const Instruction* ip, Register& reg)
+{
+	const auto varNode = static_cast<const VariableNode*>(ip->node);
+	impure_value* const varImpure = request->getImpure<impure_value>(varNode->varDecl->impureOffset);
+
+	// Let the node validate the value when it's read first time
+	if (!(varImpure->vlu_flags & VLU_checked))
+	{
+		const dsc* const desc = EVL_expr(tdbb, request, varNode);
+
+		if (!(reg.null = !desc))
+			reg.value = MOV_get_int64(tdbb, desc, 0);
+
+		return;
+	}
+
+	const dsc& desc = varImpure->vlu_desc;
+
+	if ((reg.null = (desc.dsc_flags & DSC_null)))
+		return;
+
+	switch (desc.dsc_dtype)
+	{
+		case dtype_short:
+			reg.value = *(SSHORT*) desc.dsc_address;
+			break;
+		case dtype_long:
+			reg.value = *(SLONG*) desc.dsc_address;
+			break;
+		case dtype_int64:
+			reg.value = *(SINT64*) desc.dsc_address;
+			break;
+		default:
+			reg.value = MOV_get_int64(tdbb, &desc, 0);
+			break;
+	}
+}
+
+void PsqlCode::assignInteger(thread_db* tdbb, Request* request, const Instruction* ip, const Register& reg)
+{
+	if (ip->node && !reg.null)
+	{
+		const auto varNode = static_cast<const VariableNode*>(ip->node);
+		impure_value* const varImpure = request->getImpure<impure_value>(varNode->varDecl->impureOffset);
+		dsc& desc = varImpure->vlu_desc;
+		bool done = true;
+
+		switch (desc.dsc_dtype)
+		{
+			case dtype_short:
+				if ((done = (reg.value >= MIN_SSHORT && reg.value <= MAX_SSHORT)))
+					*(SSHORT*) desc.dsc_address = (SSHORT) reg.value;
+				break;
+			case dtype_long:
+				if ((done = (reg.value >= MIN_SLONG && reg.value <= MAX_SLONG)))
+					*(SLONG*) desc.dsc_address = (SLONG) reg.value;
+				break;
+			case dtype_int64:
+				*(SINT64*) desc.dsc_address = reg.value;
+				break;
+			default:
+				done = false;
+				break;
+		}
+
+		if (done)
+		{
+			desc.dsc_flags &= ~DSC_null;
+			varImpure->vlu_flags |= VLU_checked;
+			return;
+		}
+	}
+
+	// Conversion errors and validation are left to the generic code
+	const auto assignment = static_cast<const AssignmentNode*>(ip->stmt);
+
+	SINT64 value = reg.value;
+	dsc desc;
+	desc.makeInt64(0, &value);
+
+	EXE_assignment(tdbb, assignment->asgnTo, &desc, reg.null, assignment->missing, assignment->missing2);
+}
+
+} // namespace Jrd
@@ -0,0 +1,114 @@
+/*
+ *  The contents of this file are subject to the Initial
+ *  Developer's Public License Version 1.0 (the "License");
+ *  you may not use this file except in compliance with the
+ *  License. You may obtain a copy of the License at
+ *  http://www.ibphoenix.com/main.nfs?a=ibphoenix&page=ibp_idpl.
+ *
+ *  Software distributed under the License is distributed AS IS,
+ *  WITHOUT WARRANTY OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing rights
+ *  and limitations under the License.
+ *
+ *  The Original Code was created by the Firebird development team
+ *  for the Firebird Open Source RDBMS project.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+ */
+
+#ifndef JRD_PSQL_CODE_H
+#define JRD_PSQL_CODE_H
+
+#include "firebird.h"
+#include "../common/classes/alloc.h"
+#include "../common/classes/array.h"
+#include "../common/dsc.h"
+
+namespace Jrd {
+
+class thread_db;
+class CompilerScratch;
+class Request;
+class StmtNode;
+class ExprNode;
+
+
+// Flat instruction array produced from a PSQL statement subtree.
+//
+// Supported are compound statements, IF, WHILE loops with labels, LEAVE and
+// CONTINUE, and assignments. Integer arithmetic and comparisons of local
+// variables and literals are executed natively using registers kept in the
+// request impure area; any other expression is evaluated by EVL_expr and
+// friends. If the subtree contains another statement, nothing is compiled
+// and the tree walker in EXE_looper executes it as usual.
+
+class PsqlCode : public Firebird::PermanentStorage
+{
+public:
+	enum Op : UCHAR
+	{
+		OP_CONST,		// result := constant
+		OP_LOAD_VAR,	// result := integer local variable
+		OP_EVAL_BOOL,	// result := boolean expression evaluated by the tree walker
+		OP_ADD,			// result := arg1 + arg2
+		OP_SUBTRACT,	// result := arg1 - arg2
+		OP_MULTIPLY,	// result := arg1 * arg2
+		OP_EQL,			// result := arg1 = arg2
+		OP_NEQ,			// result := arg1 <> arg2
+		OP_LSS,			// result := arg1 < arg2
+		OP_LEQ,			// result := arg1 <= arg2
+		OP_GTR,			// result := arg1 > arg2
+		OP_GEQ,			// result := arg1 >= arg2
+		OP_ASSIGN,		// assignment evaluated by the tree walker
+		OP_ASSIGN_INT,	// assign register arg1
+		OP_JUMP,		// go to target
+		OP_JUMP_FALSE,	// go to target unless register arg1 is true
+		OP_LOOP,		// go to target backwards, giving other threads a chance
+		OP_UNWIND,		// leave or continue a label outside of the code
+		OP_END
+	};
+
+	struct Instruction
+	{
+		Op op;
+		USHORT result;
+		USHORT arg1;
+		USHORT arg2;
+		ULONG target;
+		SINT64 constant;
+		const ExprNode* node;
+		const StmtNode* stmt;		// statement for error location
+	};
+
+	// Integer or boolean value
+	struct Register
+	{
+		SINT64 value;
+		bool null;
+	};
+
+	// Returns NULL if the statement can't be compiled
+	static PsqlCode* compile(thread_db* tdbb, CompilerScratch* csb, StmtNode* node);
+
+	// Executes the whole statement, returns the next node for EXE_looper
+	const StmtNode* execute(thread_db* tdbb, Request* request) const;
+
+private:
+	PsqlCode(MemoryPool& p, const StmtNode* aRoot)
+		: PermanentStorage(p), root(aRoot), code(p), impureOffset(0)
+	{}
+
+	static void loadVariable(thread_db* tdbb, Request* request, const Instruction* ip, Register& reg);
+	static void assignInteger(thread_db* tdbb, Request* request, const Instruction* ip, const Register& reg);
+
+	const StmtNode* root;
+	Firebird::Array<Instruction> code;
+	ULONG impureOffset;
+
+	friend class PsqlCodeCompiler;
+};
+
+} // namespace Jrd
+
+#endif // JRD_PSQL_CODE_H
@@ -31,6 +31,7 @@
 #include "../jrd/cmp_proto.h"
 #include "../common/dsc_proto.h"
 #include "../jrd/met_proto.h"
+#include "../jrd/mov_proto.h"
 #include "../jrd/par_proto.h"
 #include "../dsql/ddl_proto.h"
 #include "../dsql/gen_proto.h"
@@ -49,6 +50,8 @@ static void processSource(thread_db* tdbb, CompilerScratch* csb, RseNode* rse,
 static void processMap(thread_db* tdbb, CompilerScratch* csb, MapNode* map, Format** inputFormat);
 static void genDeliverUnmapped(CompilerScratch* csb, const BoolExprNodeStack& parentStack,
 	BoolExprNodeStack& deliverStack, MapNode* map, StreamType shellStream);
+static bool genPruneChecks(thread_db* tdbb, CompilerScratch* csb, RseNode* rse,
+	const BoolExprNodeStack& deliverStack, FB_SIZE_T arg, Union::PruneChecks& checks);
 static ValueExprNode* resolveUsingField(DsqlCompilerScratch* dsqlScratch, const MetaName& name,
 	ValueListNode* list, const FieldNode* flawedNode, const TEXT* side, dsql_ctx*& ctx);
 
@@ -1938,6 +1941,9 @@ RecordSource* UnionSourceNode::compile(thread_db* tdbb, Optimizer* opt, bool /*i
 	const auto csb = opt->getCompilerScratch();
 	HalfStaticArray<RecordSource*, OPT_STATIC_ITEMS> rsbs;
 
+	HalfStaticArray<NestConst<MapNode>, OPT_STATIC_ITEMS> rsbMaps;
+	Union::PruneChecks pruneChecks(*tdbb->getDefaultPool());
+
 	const ULONG baseImpure = csb->allocImpure(FB_ALIGNMENT, 0);
 
 	BoolExprNodeStack parentStack;
@@ -1957,9 +1963,21 @@ RecordSource* UnionSourceNode::compile(thread_db* tdbb, Optimizer* opt, bool /*i
 		// hvlad: don't do it for recursive unions else they will work wrong !
 		BoolExprNodeStack deliverStack;
 		if (!recursive)
+		{
 			genDeliverUnmapped(csb, parentStack, deliverStack, map, stream);
 
+			// Members which can't return rows (e.g. partitions of a view outside
+			// of the requested range) are not compiled at all, unless they are
+			// subject of an explicit plan. At least one member is kept.
+			if (!genPruneChecks(tdbb, csb, rse, deliverStack, rsbs.getCount(), pruneChecks) &&
+				!rse->rse_plan && (rsbs.hasData() || ptr + 1 != end))
+			{
+				continue;
+			}
+		}
+
 		rsbs.add(opt->compile(rse, &deliverStack));
+		rsbMaps.add(*ptr2);
 
 		// hvlad: activate recursive union itself after processing first (non-recursive)
 		// member to allow recursive members be optimized
@@ -1979,8 +1997,8 @@ RecordSource* UnionSourceNode::compile(thread_db* tdbb, Optimizer* opt, bool /*i
 			rsbs[0], rsbs[1], maps[0], maps[1], keyStreams, baseImpure);
 	}
 
-	return FB_NEW_POOL(*tdbb->getDefaultPool()) Union(csb, stream, clauses.getCount(), rsbs.begin(),
-		maps.begin(), keyStreams);
+	return FB_NEW_POOL(*tdbb->getDefaultPool()) Union(csb, stream, rsbs.getCount(), rsbs.begin(),
+		rsbMaps.begin(), keyStreams, &pruneChecks);
 }
 
 // Identify all of the streams for which a dbkey may need to be carried through a sort.
@@ -3814,6 +3832,185 @@ static void genDeliverUnmapped(CompilerScratch* csb,
 	}
 }
 
+// Collect comparisons of fields with literals, parameters and variables from the WHERE clause
+// of an union member and from the booleans delivered into it. Every pair of them bounding the
+// same field makes a check of the values which is evaluated when the union is opened, so the
+// member can be skipped if the bounds contradict each other. This gives partition pruning for
+// views which union tables partitioned by ranges or lists of values.
+// Returns false if the member can't return rows already because of literal values.
+static bool genPruneChecks(thread_db* tdbb, CompilerScratch* csb, RseNode* rse,
+	const BoolExprNodeStack& deliverStack, FB_SIZE_T arg, Union::PruneChecks& checks)
+{
+	struct Bound
+	{
+		const FieldNode* field;
+		UCHAR blrOp;	// field <blrOp> value
+		const ValueExprNode* value;
+	};
+
+	HalfStaticArray<Bound, OPT_STATIC_ITEMS> bounds;
+
+	const auto addBound = [&](ValueExprNode* arg1, UCHAR blrOp, ValueExprNode* arg2)
+	{
+		static const UCHAR reverseOps[][2] =
+		{
+			{blr_eql, blr_eql}, {blr_gtr, blr_lss}, {blr_geq, blr_leq},
+			{blr_lss, blr_gtr}, {blr_leq, blr_geq}
+		};
+
+		if (!nodeIs<FieldNode>(arg1))
+		{
+			std::swap(arg1, arg2);
+
+			for (const auto& ops : reverseOps)
+			{
+				if (ops[0] == blrOp)
+				{
+					blrOp = ops[1];
+					break;
+				}
+			}
+		}
+
+		const auto field = nodeAs<FieldNode>(arg1);
+		if (!field)
+			return;
+
+		// Strings are compared using collations, don't rely on them
+		dsc desc;
+		field->getDesc(tdbb, csb, &desc);
+
+		if (!desc.isNumeric() && !desc.isDateTime())
+			return;
+
+		const ValueExprNode* value = arg2;
+		if (const auto castNode = nodeAs<CastNode>(value))
+			value = castNode->source;
+
+		if (const auto literal = nodeAs<LiteralNode>(value))
+		{
+			if (literal->litDesc.isText() || literal->litDesc.isBlob())
+				return;
+		}
+		else if (!nodeIs<ParameterNode>(value) && !nodeIs<VariableNode>(value))
+			return;
+
+		bounds.add({field, blrOp, arg2});
+	};
+
+	BoolExprNodeStack conjuncts;
+
+	for (BoolExprNodeStack::const_iterator iter(deliverStack); iter.hasData(); ++iter)
+		conjuncts.push(iter.object());
+
+	if (rse->rse_boolean)
+		conjuncts.push(rse->rse_boolean.getObject());
+
+	while (conjuncts.hasData())
+	{
+		const auto boolean = conjuncts.pop();
+
+		const auto binaryNode = nodeAs<BinaryBoolNode>(boolean);
+		if (binaryNode && binaryNode->blrOp == blr_and)
+		{
+			conjuncts.push(binaryNode->arg1);
+			conjuncts.push(binaryNode->arg2);
+			continue;
+		}
+
+		const auto cmpNode = nodeAs<ComparativeBoolNode>(boolean);
+		if (!cmpNode)
+			continue;
+
+		switch (cmpNode->blrOp)
+		{
+			case blr_eql:
+			case blr_gtr:
+			case blr_geq:
+			case blr_lss:
+			case blr_leq:
+				addBound(cmpNode->arg1, cmpNode->blrOp, cmpNode->arg2);
+				break;
+
+			case blr_between:
+				if (nodeIs<FieldNode>(cmpNode->arg1))
+				{
+					addBound(cmpNode->arg1, blr_geq, cmpNode->arg2);
+					addBound(cmpNode->arg1, blr_leq, cmpNode->arg3);
+				}
+				break;
+		}
+	}
+
+	Union::PruneChecks newChecks;
+
+	for (FB_SIZE_T i = 0; i < bounds.getCount(); i++)
+	{
+		for (FB_SIZE_T j = i + 1; j < bounds.getCount(); j++)
+		{
+			const Bound* bound1 = &bounds[i];
+			const Bound* bound2 = &bounds[j];
+
+			if (bound1->field->fieldStream != bound2->field->fieldStream ||
+				bound1->field->fieldId != bound2->field->fieldId)
+			{
+				continue;
+			}
+
+			// Make a condition the values have to meet for both bounds to be satisfied
+
+			if (bound2->blrOp == blr_eql)
+				std::swap(bound1, bound2);
+
+			const bool isLower1 = (bound1->blrOp == blr_gtr || bound1->blrOp == blr_geq);
+			const bool isLower2 = (bound2->blrOp == blr_gtr || bound2->blrOp == blr_geq);
+			UCHAR blrOp;
+
+			if (bound1->blrOp == blr_eql)
+				blrOp = bound2->blrOp;
+			else if (isLower1 == isLower2)
+				continue;
+			else
+			{
+				if (!isLower1)
+					std::swap(bound1, bound2);
+
+				blrOp = (bound1->blrOp == blr_geq && bound2->blrOp == blr_leq) ? blr_leq : blr_lss;
+			}
+
+			const auto literal1 = nodeAs<LiteralNode>(bound1->value);
+			const auto literal2 = nodeAs<LiteralNode>(bound2->value);
+
+			if (literal1 && literal2)
+			{
+				int result;
+
+				try
+				{
+					result = MOV_compare(tdbb, &literal1->litDesc, &literal2->litDesc);
+				}
+				catch (const Exception&)
+				{
+					fb_utils::init_status(tdbb->tdbb_status_vector);
+					continue;
+				}
+
+				if (!Union::checkResult(blrOp, result))
+					return false;
+
+				continue;
+			}
+
+			newChecks.add({arg, blrOp, bound1->value, bound2->value});
+		}
+	}
+
+	for (const auto& check : newChecks)
+		checks.add(check);
+
+	return true;
+}
+
 // Resolve a field for JOIN USING purposes.
 static ValueExprNode* resolveUsingField(DsqlCompilerScratch* dsqlScratch, const MetaName& name,
 	ValueListNode* list, const FieldNode* flawedNode, const TEXT* side, dsql_ctx*& ctx)
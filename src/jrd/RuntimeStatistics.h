@@ -74,6 +74,8 @@ public:
 		RECORD_RPT_READS,
 		RECORD_IMGC,
 		RECORD_LAST_ITEM = RECORD_IMGC,
+		SORTS,
+		SORT_SPILLS,
 		TOTAL_ITEMS		// last
 	};
 
@@ -65,6 +65,305 @@ void UndoItem::release(jrd_tra* transaction)
 }
 
 
+// SpilledRecords implementation
+
+// Sequential reader of the record numbers of a run
+
+class SpilledRecords::Reader
+{
+public:
+	Reader(const SpilledRecords& owner, FB_SIZE_T block, FB_SIZE_T end)
+		: m_owner(owner), m_block(block), m_end(end), m_pos(0), m_count(0)
+	{}
+
+	bool next()
+	{
+		if (m_pos + 1 < m_count)
+		{
+			m_pos++;
+			return true;
+		}
+
+		if (m_block == m_end)
+			return false;
+
+		m_count = m_owner.readBlock(m_owner.m_blocks[m_block++], m_buffer);
+		m_pos = 0;
+		return (m_count != 0);
+	}
+
+	FB_UINT64 current() const
+	{
+		return m_buffer[m_pos];
+	}
+
+private:
+	const SpilledRecords& m_owner;
+	FB_SIZE_T m_block;
+	const FB_SIZE_T m_end;
+	ULONG m_pos;
+	ULONG m_count;
+	FB_UINT64 m_buffer[BLOCK_SIZE];
+};
+
+void SpilledRecords::spill(RecordBitmap* records)
+{
+	// Write the given record numbers as a new run.
+	// Numbers spilled before are not looked for, so runs may overlap.
+
+	Run run;
+	run.block = m_blocks.getCount();
+	run.count = 0;
+
+	FB_UINT64 buffer[BLOCK_SIZE];
+	ULONG count = 0;
+
+	RecordBitmap::Accessor accessor(records);
+
+	for (bool found = accessor.getFirst(); found; found = accessor.getNext())
+	{
+		buffer[count++] = accessor.current();
+
+		if (count == BLOCK_SIZE)
+		{
+			writeBlock(m_blocks, buffer, count);
+			run.count += count;
+			count = 0;
+		}
+	}
+
+	if (count)
+	{
+		writeBlock(m_blocks, buffer, count);
+		run.count += count;
+	}
+
+	if (!run.count)
+		return;
+
+	m_runs.add(run);
+
+	// Merge the runs of comparable length like a binary counter does. There are
+	// no more than log2(total count) runs to look through in test() then, and
+	// every number is rewritten no more than log2(total count) times.
+
+	while (m_runs.getCount() > 1 &&
+		m_runs[m_runs.getCount() - 2].count < m_runs.back().count * 2)
+	{
+		mergeLastRuns();
+	}
+}
+
+void SpilledRecords::mergeLastRuns()
+{
+	// Replace the last two runs with a single one, removing duplicates
+
+	Run& target = m_runs[m_runs.getCount() - 2];
+	const Run& source = m_runs.back();
+
+	Reader reader1(*this, target.block, source.block);
+	Reader reader2(*this, source.block, m_blocks.getCount());
+
+	Array<Block> merged(getPool());
+	FB_UINT64 buffer[BLOCK_SIZE];
+	ULONG count = 0;
+	FB_UINT64 total = 0;
+
+	bool found1 = reader1.next();
+	bool found2 = reader2.next();
+
+	while (found1 || found2)
+	{
+		FB_UINT64 number;
+
+		if (found1 && (!found2 || reader1.current() <= reader2.current()))
+		{
+			number = reader1.current();
+
+			if (found2 && reader2.current() == number)
+				found2 = reader2.next();
+
+			found1 = reader1.next();
+		}
+		else
+		{
+			number = reader2.current();
+			found2 = reader2.next();
+		}
+
+		buffer[count++] = number;
+
+		if (count == BLOCK_SIZE)
+		{
+			writeBlock(merged, buffer, count);
+			total += count;
+			count = 0;
+		}
+	}
+
+	if (count)
+	{
+		writeBlock(merged, buffer, count);
+		total += count;
+	}
+
+	for (FB_SIZE_T i = target.block; i < m_blocks.getCount(); i++)
+		m_space->releaseSpace(m_blocks[i].offset, m_blocks[i].count * sizeof(FB_UINT64));
+
+	m_blocks.shrink(target.block);
+	m_blocks.join(merged);
+
+	target.count = total;
+	m_runs.shrink(m_runs.getCount() - 1);
+}
+
+void SpilledRecords::load(RecordBitmap** records) const
+{
+	// Put all spilled record numbers back into the bitmap
+
+	FB_UINT64 buffer[BLOCK_SIZE];
+
+	for (const auto& block : m_blocks)
+	{
+		const ULONG count = readBlock(block, buffer);
+
+		for (ULONG i = 0; i < count; i++)
+			RBM_SET(&getPool(), records, buffer[i]);
+	}
+}
+
+FB_SIZE_T SpilledRecords::findBlock(FB_SIZE_T run, FB_UINT64 number) const
+{
+	// Find the block of the run which may contain the number
+
+	const FB_SIZE_T first = m_runs[run].block;
+	FB_SIZE_T lo = first;
+	FB_SIZE_T hi = (run + 1 < m_runs.getCount()) ? m_runs[run + 1].block : m_blocks.getCount();
+
+	while (lo < hi)
+	{
+		const FB_SIZE_T mid = (lo + hi) / 2;
+
+		if (m_blocks[mid].first <= number)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if (lo == first || number > m_blocks[lo - 1].last)
+		return m_blocks.getCount();
+
+	return lo - 1;
+}
+
+bool SpilledRecords::test(FB_UINT64 number) const
+{
+	FB_UINT64 buffer[BLOCK_SIZE];
+
+	for (FB_SIZE_T run = 0; run < m_runs.getCount(); run++)
+	{
+		const FB_SIZE_T block = findBlock(run, number);
+
+		if (block == m_blocks.getCount())
+			continue;
+
+		const ULONG count = readBlock(m_blocks[block], buffer);
+
+		if (std::binary_search(buffer, buffer + count, number))
+			return true;
+	}
+
+	return false;
+}
+
+bool SpilledRecords::remove(FB_UINT64 number)
+{
+	// Remove the number from every run containing it. The block is rewritten
+	// in place and its tail is released, empty blocks and runs are dropped.
+
+	FB_UINT64 buffer[BLOCK_SIZE];
+	bool found = false;
+
+	for (FB_SIZE_T run = 0; run < m_runs.getCount();)
+	{
+		const FB_SIZE_T pos = findBlock(run, number);
+
+		if (pos == m_blocks.getCount())
+		{
+			run++;
+			continue;
+		}
+
+		Block& block = m_blocks[pos];
+		const ULONG count = readBlock(block, buffer);
+		FB_UINT64* const end = buffer + count;
+		FB_UINT64* const ptr = std::lower_bound(buffer, end, number);
+
+		if (ptr == end || *ptr != number)
+		{
+			run++;
+			continue;
+		}
+
+		found = true;
+		memmove(ptr, ptr + 1, (end - ptr - 1) * sizeof(FB_UINT64));
+
+		block.count--;
+		m_space->releaseSpace(block.offset + block.count * sizeof(FB_UINT64), sizeof(FB_UINT64));
+
+		if (block.count)
+		{
+			block.first = buffer[0];
+			block.last = buffer[block.count - 1];
+			m_space->write(block.offset, buffer, block.count * sizeof(FB_UINT64));
+		}
+		else
+		{
+			m_blocks.remove(pos);
+
+			for (FB_SIZE_T next = run + 1; next < m_runs.getCount(); next++)
+				m_runs[next].block--;
+		}
+
+		if (--m_runs[run].count == 0)
+			m_runs.remove(run);
+		else
+			run++;
+	}
+
+	return found;
+}
+
+void SpilledRecords::release()
+{
+	for (const auto& block : m_blocks)
+		m_space->releaseSpace(block.offset, block.count * sizeof(FB_UINT64));
+
+	m_blocks.clear();
+	m_runs.clear();
+}
+
+ULONG SpilledRecords::readBlock(const Block& block, FB_UINT64* buffer) const
+{
+	m_space->read(block.offset, buffer, block.count * sizeof(FB_UINT64));
+	return block.count;
+}
+
+void SpilledRecords::writeBlock(Array<Block>& blocks, const FB_UINT64* buffer, ULONG count)
+{
+	const FB_SIZE_T length = count * sizeof(FB_UINT64);
+
+	Block block;
+	block.first = buffer[0];
+	block.last = buffer[count - 1];
+	block.offset = m_space->allocateSpace(length);
+	block.count = count;
+
+	m_space->write(block.offset, buffer, length);
+	blocks.add(block);
+}
+
+
 // VerbAction implementation
 
 void VerbAction::garbageCollectIdxLite(thread_db* tdbb, jrd_tra* transaction, SINT64 recordNumber,
@@ -168,7 +467,7 @@ void VerbAction::mergeTo(thread_db* tdbb, jrd_tra* transaction, VerbAction* next
 			{
 				const SINT64 recordNumber = item.generate(NULL, item);
 
-				if (nextAction && !(RecordBitmap::test(nextAction->vct_records, recordNumber)))
+				if (nextAction && !nextAction->test(transaction, recordNumber))
 				{
 					if (!nextAction->vct_undo)
 					{
@@ -246,6 +545,15 @@ void VerbAction::undo(thread_db* tdbb, jrd_tra* transaction, bool preserveLocks,
 	rpb.getWindow(tdbb).win_flags = 0;
 	rpb.rpb_transaction_nr = transaction->tra_number;
 
+	// Bring spilled records back for the time of undo, it also
+	// removes duplicates the runs might have between each other
+
+	if (vct_spill)
+	{
+		vct_spill->load(&vct_records);
+		vct_spill->release();
+	}
+
 	RecordBitmap::Accessor accessor(vct_records);
 	if (accessor.getFirst())
 	{
@@ -347,12 +655,44 @@ void VerbAction::undo(thread_db* tdbb, jrd_tra* transaction, bool preserveLocks,
 	release(transaction);
 }
 
+void VerbAction::spill(jrd_tra* transaction)
+{
+	// Move bitmap of modified records to the undo space
+
+	if (!vct_records)
+		return;
+
+	if (!vct_spill)
+	{
+		vct_spill = FB_NEW_POOL(*transaction->tra_pool)
+			SpilledRecords(*transaction->tra_pool, transaction->getUndoSpace());
+	}
+
+	vct_spill->spill(vct_records);
+
+	// Free the bitmap object itself, not only its containers
+	delete vct_records;
+	vct_records = NULL;
+
+	// Undo images are in the undo space already, drop the emptied tree of their
+	// references as well. The tree is normally empty here: undo data are merged
+	// into this savepoint only for records it has not seen, see mergeTo().
+	if (vct_undo && !vct_undo->getFirst())
+	{
+		delete vct_undo;
+		vct_undo = NULL;
+	}
+}
+
 void VerbAction::release(jrd_tra* transaction)
 {
 	// Release resources used by this verb action
 
 	RecordBitmap::reset(vct_records);
 
+	if (vct_spill)
+		vct_spill->release();
+
 	if (vct_undo)
 	{
 		if (vct_undo->getFirst())
@@ -404,6 +744,9 @@ void Savepoint::cleanupTempData()
 		{
 			RecordBitmap::reset(action->vct_records);
 
+			if (action->vct_spill)
+				action->vct_spill->release();
+
 			if (action->vct_undo)
 			{
 				if (action->vct_undo->getFirst())
@@ -477,19 +820,6 @@ Savepoint* Savepoint::rollforward(thread_db* tdbb, Savepoint* prior)
 
 	try
 	{
-		// If the current to-be-cleaned-up savepoint is very big, and the next
-		// level savepoint is the transaction level savepoint, then get rid of
-		// the transaction level savepoint now (instead of after making the
-		// transaction level savepoint very very big).
-
-		if (m_next && m_next->isRoot() && this->isLarge())
-		{
-			fb_assert(!m_next->m_next); // check that transaction savepoint is the last in list
-			// get rid of tx-level savepoint
-			m_next->rollforward(tdbb);
-			m_next = NULL;
-		}
-
 		// Cleanup/merge deferred work/event post
 
 		if (m_actions || (m_flags & SAV_force_dfw))
@@ -545,13 +875,11 @@ Savepoint* Savepoint::rollforward(thread_db* tdbb, Savepoint* prior)
 
 	// If the only remaining savepoint is the 'transaction-level' savepoint
 	// that was started by TRA_start, then check if it hasn't grown out of
-	// bounds yet.  If it has, then give up on this transaction-level savepoint.
+	// bounds yet.  If it has, then move its record bitmaps to the undo space.
 	if (m_next && m_next->isRoot() && m_next->isLarge())
 	{
 		fb_assert(!m_next->m_next); // check that transaction savepoint is the last in list
-		// get rid of tx-level savepoint
-		m_next->rollforward(tdbb);
-		m_next = NULL;
+		m_next->spill();
 	}
 
 	return release(prior);
@@ -592,6 +920,15 @@ bool Savepoint::isLarge() const
 	return false;
 }
 
+void Savepoint::spill()
+{
+	// Move record bitmaps of all tables changed under this savepoint to the undo space.
+	// Undo data is written there by UndoItem itself.
+
+	for (VerbAction* action = m_actions; action; action = action->vct_next)
+		action->spill(m_transaction);
+}
+
 Savepoint* Savepoint::release(Savepoint* prior)
 {
 	// Clear savepoint and prepare it for later reuse.
@@ -25,6 +25,8 @@
 #include "../jrd/Record.h"
 #include "../jrd/RecordNumber.h"
 
+class TempSpace;
+
 namespace Jrd
 {
 	class jrd_tra;
@@ -75,24 +77,94 @@ namespace Jrd
 
 	typedef Firebird::BePlusTree<UndoItem, SINT64, MemoryPool, UndoItem> UndoItemTree;
 
+	// Record numbers moved from the memory to the undo space.
+	// Every spill writes a sorted run of numbers split into blocks,
+	// only boundaries of the blocks are kept in memory. Runs are merged
+	// so that every run is at least twice as long as the next one.
+
+	class SpilledRecords : public Firebird::PermanentStorage
+	{
+		static const ULONG BLOCK_SIZE = 256;	// record numbers per block
+
+		struct Block
+		{
+			FB_UINT64 first;
+			FB_UINT64 last;
+			offset_t offset;
+			ULONG count;
+		};
+
+		struct Run
+		{
+			FB_SIZE_T block;	// first block of the run
+			FB_UINT64 count;	// record numbers in the run
+		};
+
+		class Reader;
+
+	public:
+		SpilledRecords(MemoryPool& pool, TempSpace* space)
+			: PermanentStorage(pool), m_space(space), m_blocks(pool), m_runs(pool)
+		{}
+
+		void spill(RecordBitmap* records);
+		void load(RecordBitmap** records) const;
+		bool test(FB_UINT64 number) const;
+		bool remove(FB_UINT64 number);
+		void release();
+
+		FB_SIZE_T getRunCount() const
+		{
+			return m_runs.getCount();
+		}
+
+	private:
+		FB_SIZE_T findBlock(FB_SIZE_T run, FB_UINT64 number) const;
+		void mergeLastRuns();
+		ULONG readBlock(const Block& block, FB_UINT64* buffer) const;
+		void writeBlock(Firebird::Array<Block>& blocks, const FB_UINT64* buffer, ULONG count);
+
+		TempSpace* const m_space;
+		Firebird::Array<Block> m_blocks;
+		Firebird::Array<Run> m_runs;
+	};
+
 	class VerbAction
 	{
 	public:
 		VerbAction()
-			: vct_next(NULL), vct_relation(NULL), vct_records(NULL), vct_undo(NULL)
+			: vct_next(NULL), vct_relation(NULL), vct_records(NULL), vct_undo(NULL), vct_spill(NULL)
 		{}
 
 		~VerbAction()
 		{
 			delete vct_records;
 			delete vct_undo;
+			delete vct_spill;
 		}
 
 		VerbAction* 	vct_next;		// Next action within verb
 		jrd_rel*		vct_relation;	// Relation involved
 		RecordBitmap*	vct_records;	// Record involved
 		UndoItemTree*	vct_undo;		// Data for undo records
+		SpilledRecords*	vct_spill;		// Records involved, moved to the undo space
+
+		bool test(jrd_tra* transaction, SINT64 recordNumber) const
+		{
+			return RecordBitmap::test(vct_records, recordNumber) ||
+				(vct_spill && vct_spill->test(recordNumber));
+		}
+
+		void clear(SINT64 recordNumber)
+		{
+			if (vct_records)
+				vct_records->clear(recordNumber);
+
+			if (vct_spill)
+				vct_spill->remove(recordNumber);
+		}
 
+		void spill(jrd_tra* transaction);
 		void mergeTo(thread_db* tdbb, jrd_tra* transaction, VerbAction* nextAction);
 		void undo(thread_db* tdbb, jrd_tra* transaction, bool preserveLocks,
 				  VerbAction* preserveAction);
@@ -107,9 +179,9 @@ namespace Jrd
 
 	class Savepoint
 	{
-		// Maximum size in bytes of transaction-level savepoint data.
-		// When transaction-level savepoint gets past this size we drop it and use GC
-		// mechanisms to clean out changes done in transaction
+		// Maximum size in bytes of transaction-level savepoint data kept in memory.
+		// When transaction-level savepoint gets past this size we move its record
+		// bitmaps to the undo space, so the changes can still be undone on rollback
 		static const U_IPTR SIZE_THRESHOLD = 1024 * 32;
 
 		// Savepoint flags
@@ -310,6 +382,7 @@ namespace Jrd
 		Savepoint& operator=(const Savepoint&);
 
 		bool isLarge() const;
+		void spill();
 		Savepoint* release(Savepoint* prior = NULL);
 
 		jrd_tra* const m_transaction; 	// transaction this savepoint belongs to
@@ -73,6 +73,7 @@ Statement::Statement(thread_db* tdbb, MemoryPool* p, CompilerScratch* csb)
 	  fors(*p),
 	  localTables(*p),
 	  invariants(*p),
+	  sqlHash(0),
 	  blr(*p),
 	  mapFieldInfo(*p)
 {
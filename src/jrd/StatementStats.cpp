@@ -0,0 +1,234 @@
+/*
+ *	PROGRAM:	JRD Access Method
+ *	MODULE:		StatementStats.cpp
+ *	DESCRIPTION:	Aggregated per-statement runtime statistics
+ *
+ *  The contents of this file are subject to the Initial
+ *  Developer's Public License Version 1.0 (the "License");
+ *  you may not use this file except in compliance with the
+ *  License. You may obtain a copy of the License at
+ *  http://www.ibphoenix.com/main.nfs?a=ibphoenix&page=ibp_idpl.
+ *
+ *  Software distributed under the License is distributed AS IS,
+ *  WITHOUT WARRANTY OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing rights
+ *  and limitations under the License.
+ *
+ *  The Original Code was created for the Firebird Open Source RDBMS project.
+ *
+ *  Copyright (c) 2026 Firebird Project and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+ *
+ */
+
+#include "firebird.h"
+#include "../jrd/StatementStats.h"
+#include "../jrd/jrd.h"
+#include "../jrd/req.h"
+#include "../jrd/Statement.h"
+#include "../common/utils_proto.h"
+
+using namespace Jrd;
+using namespace Firebird;
+
+
+namespace
+{
+	void getCounters(const RuntimeStatistics& stats, SINT64* counters)
+	{
+		counters[StatementStats::CNT_FETCHES] = stats.getValue(RuntimeStatistics::PAGE_FETCHES);
+		counters[StatementStats::CNT_READS] = stats.getValue(RuntimeStatistics::PAGE_READS);
+		counters[StatementStats::CNT_WRITES] = stats.getValue(RuntimeStatistics::PAGE_WRITES);
+		counters[StatementStats::CNT_RECORDS] =
+			stats.getValue(RuntimeStatistics::RECORD_SEQ_READS) +
+			stats.getValue(RuntimeStatistics::RECORD_IDX_READS) +
+			stats.getValue(RuntimeStatistics::RECORD_INSERTS) +
+			stats.getValue(RuntimeStatistics::RECORD_UPDATES) +
+			stats.getValue(RuntimeStatistics::RECORD_DELETES);
+		counters[StatementStats::CNT_SORTS] = stats.getValue(RuntimeStatistics::SORTS);
+		counters[StatementStats::CNT_SORT_SPILLS] = stats.getValue(RuntimeStatistics::SORT_SPILLS);
+	}
+
+	inline bool isSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+	}
+}
+
+
+StatementStats::StatementStats(MemoryPool& pool)
+	: m_pool(pool)
+{
+	for (unsigned i = 0; i < PARTITIONS; i++)
+		m_partitions[i] = FB_NEW_POOL(m_pool) Partition(m_pool);
+}
+
+StatementStats::~StatementStats()
+{
+	reset();
+
+	for (unsigned i = 0; i < PARTITIONS; i++)
+		delete m_partitions[i];
+}
+
+// Calculate (once per statement) hash of its SQL text
+FB_UINT64 StatementStats::getHash(const Statement* statement)
+{
+	if (!statement->sqlHash)
+		statement->sqlHash = hashText(*statement->sqlText);
+
+	return statement->sqlHash;
+}
+
+// FNV-1a hash of the SQL text with runs of whitespace collapsed, so differently
+// formatted copies of the same query share an entry. Never returns zero.
+FB_UINT64 StatementStats::hashText(const string& text)
+{
+	const char* p = text.begin();
+	const char* const end = text.end();
+
+	FB_UINT64 hash = FB_CONST64(0xCBF29CE484222325);
+	bool space = false;
+
+	while (p < end && isSpace(*p))
+		p++;
+
+	for (; p < end; p++)
+	{
+		if (isSpace(*p))
+		{
+			space = true;
+			continue;
+		}
+
+		if (space)
+		{
+			hash = (hash ^ ' ') * FB_CONST64(0x100000001B3);
+			space = false;
+		}
+
+		hash = (hash ^ (UCHAR) *p) * FB_CONST64(0x100000001B3);
+	}
+
+	if (!hash)
+		hash = 1;
+
+	return hash;
+}
+
+void StatementStats::start(Request* request)
+{
+	Origin& origin = request->req_stats_origin;
+
+	origin.ticks = fb_utils::query_performance_counter();
+	getCounters(request->req_stats, origin.counters);
+}
+
+void StatementStats::finish(Request* request)
+{
+	const Statement* const statement = request->getStatement();
+
+	if (!statement->sqlText || request->hasInternalStatement())
+		return;
+
+	const Origin& origin = request->req_stats_origin;
+
+	SINT64 counters[CNT_COUNT];
+	getCounters(request->req_stats, counters);
+
+	const SINT64 ticks = fb_utils::query_performance_counter() - origin.ticks;
+	const SINT64 frequency = fb_utils::query_performance_frequency();
+	const SINT64 time = (ticks / frequency) * 1000000 + (ticks % frequency) * 1000000 / frequency;
+
+	for (unsigned i = 0; i < CNT_COUNT; i++)
+		counters[i] -= origin.counters[i];
+
+	accumulate(getHash(statement), *statement->sqlText, time, counters);
+}
+
+// Add an execution taking given time (in microseconds) and counters to the entry
+void StatementStats::accumulate(FB_UINT64 hash, const string& sqlText, SINT64 time, const SINT64* counters)
+{
+	Partition* const partition = m_partitions[hash % PARTITIONS];
+
+	MutexLockGuard guard(partition->mutex, FB_FUNCTION);
+
+	Entry* entry;
+	if (!partition->entries.get(hash, entry))
+	{
+		// Keep memory usage bounded, the least executed statement gives its place
+		if (partition->entries.count() >= MAX_PARTITION_ENTRIES)
+			evict(partition);
+
+		entry = FB_NEW_POOL(m_pool) Entry(m_pool);
+		entry->hash = hash;
+		entry->sqlText = sqlText;
+		partition->entries.put(hash, entry);
+	}
+
+	entry->executions++;
+	entry->totalTime += time;
+
+	if (time > entry->maxTime)
+		entry->maxTime = time;
+
+	for (unsigned i = 0; i < CNT_COUNT; i++)
+		entry->counters[i] += counters[i];
+}
+
+// Remove the entry with the lowest number of executions from the full partition
+void StatementStats::evict(Partition* partition)
+{
+	Entry* victim = NULL;
+
+	EntryMap::Accessor accessor(&partition->entries);
+	for (bool found = accessor.getFirst(); found; found = accessor.getNext())
+	{
+		Entry* const entry = accessor.current()->second;
+
+		if (!victim || entry->executions < victim->executions)
+			victim = entry;
+	}
+
+	fb_assert(victim);
+
+	partition->entries.remove(victim->hash);
+	delete victim;
+}
+
+void StatementStats::getEntries(EntryList& entries) const
+{
+	for (unsigned i = 0; i < PARTITIONS; i++)
+	{
+		const Partition* const partition = m_partitions[i];
+		MutexLockGuard guard(partition->mutex, FB_FUNCTION);
+
+		EntryMap::ConstAccessor accessor(&partition->entries);
+		for (bool found = accessor.getFirst(); found; found = accessor.getNext())
+			entries.add(*accessor.current()->second);
+	}
+}
+
+SINT64 StatementStats::reset()
+{
+	SINT64 count = 0;
+
+	for (unsigned i = 0; i < PARTITIONS; i++)
+	{
+		Partition* const partition = m_partitions[i];
+		MutexLockGuard guard(partition->mutex, FB_FUNCTION);
+
+		EntryMap::Accessor accessor(&partition->entries);
+		for (bool found = accessor.getFirst(); found; found = accessor.getNext())
+		{
+			delete accessor.current()->second;
+			count++;
+		}
+
+		partition->entries.clear();
+	}
+
+	return count;
+}
@@ -0,0 +1,132 @@
+/*
+ *	PROGRAM:	JRD Access Method
+ *	MODULE:		StatementStats.h
+ *	DESCRIPTION:	Aggregated per-statement runtime statistics
+ *
+ *  The contents of this file are subject to the Initial
+ *  Developer's Public License Version 1.0 (the "License");
+ *  you may not use this file except in compliance with the
+ *  License. You may obtain a copy of the License at
+ *  http://www.ibphoenix.com/main.nfs?a=ibphoenix&page=ibp_idpl.
+ *
+ *  Software distributed under the License is distributed AS IS,
+ *  WITHOUT WARRANTY OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing rights
+ *  and limitations under the License.
+ *
+ *  The Original Code was created for the Firebird Open Source RDBMS project.
+ *
+ *  Copyright (c) 2026 Firebird Project and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+ *
+ */
+
+#ifndef JRD_STATEMENT_STATS_H
+#define JRD_STATEMENT_STATS_H
+
+#include "../common/classes/alloc.h"
+#include "../common/classes/fb_string.h"
+#include "../common/classes/GenericMap.h"
+#include "../common/classes/locks.h"
+#include "../common/classes/objects_array.h"
+
+namespace Jrd {
+
+class Request;
+class Statement;
+
+// Database-wide aggregation of runtime statistics of SQL statements.
+// Executions of statements with the same (whitespace-normalized) SQL text
+// are accumulated into a single entry when the request finishes.
+// Entries are spread over a few partitions with separate mutexes to keep
+// contention of concurrent attachments low. When a partition is full, its
+// least executed entry is evicted to make room for a new statement.
+
+class StatementStats
+{
+public:
+	enum Counter
+	{
+		CNT_FETCHES = 0,
+		CNT_READS,
+		CNT_WRITES,
+		CNT_RECORDS,
+		CNT_SORTS,
+		CNT_SORT_SPILLS,
+		CNT_COUNT		// last
+	};
+
+	// State of request counters taken when it's started
+	struct Origin
+	{
+		SINT64 ticks;
+		SINT64 counters[CNT_COUNT];
+	};
+
+	class Entry
+	{
+	public:
+		explicit Entry(MemoryPool& pool)
+			: hash(0), sqlText(pool), executions(0), totalTime(0), maxTime(0)
+		{
+			memset(counters, 0, sizeof(counters));
+		}
+
+		Entry(MemoryPool& pool, const Entry& other)
+			: hash(other.hash), sqlText(pool, other.sqlText), executions(other.executions),
+			  totalTime(other.totalTime), maxTime(other.maxTime)
+		{
+			memcpy(counters, other.counters, sizeof(counters));
+		}
+
+		FB_UINT64 hash;
+		Firebird::string sqlText;
+		SINT64 executions;
+		SINT64 totalTime;			// microseconds
+		SINT64 maxTime;				// microseconds
+		SINT64 counters[CNT_COUNT];
+	};
+
+	typedef Firebird::ObjectsArray<Entry> EntryList;
+
+	static const unsigned PARTITIONS = 16;
+	static const unsigned MAX_PARTITION_ENTRIES = 256;
+
+	explicit StatementStats(MemoryPool& pool);
+	~StatementStats();
+
+	static void start(Request* request);
+	void finish(Request* request);
+
+	static FB_UINT64 hashText(const Firebird::string& text);
+	void accumulate(FB_UINT64 hash, const Firebird::string& sqlText, SINT64 time, const SINT64* counters);
+
+	void getEntries(EntryList& entries) const;
+	SINT64 reset();
+
+private:
+
+	typedef Firebird::GenericMap<Firebird::Pair<Firebird::NonPooled<FB_UINT64, Entry*> > > EntryMap;
+
+	struct Partition
+	{
+		explicit Partition(MemoryPool& pool)
+			: entries(pool)
+		{}
+
+		mutable Firebird::Mutex mutex;
+		EntryMap entries;
+	};
+
+	static FB_UINT64 getHash(const Statement* statement);
+	void evict(Partition* partition);
+
+	MemoryPool& m_pool;
+	Partition* m_partitions[PARTITIONS];
+};
+
+} // namespace Jrd
+
+#endif // JRD_STATEMENT_STATS_H
@@ -0,0 +1,140 @@
+/*
+ *	PROGRAM:	JRD Access Method
+ *	MODULE:		StatementStatsTable.cpp
+ *	DESCRIPTION:	RDB$STATEMENT_STATISTICS virtual table
+ *
+ *  The contents of this file are subject to the Initial
+ *  Developer's Public License Version 1.0 (the "License");
+ *  you may not use this file except in compliance with the
+ *  License. You may obtain a copy of the License at
+ *  http://www.ibphoenix.com/main.nfs?a=ibphoenix&page=ibp_idpl.
+ *
+ *  Software distributed under the License is distributed AS IS,
+ *  WITHOUT WARRANTY OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing rights
+ *  and limitations under the License.
+ *
+ *  The Original Code was created for the Firebird Open Source RDBMS project.
+ *
+ *  Copyright (c) 2026 Firebird Project and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+ *
+ */
+
+#include "../jrd/StatementStatsTable.h"
+#include "../jrd/StatementStats.h"
+#include "../jrd/ini.h"
+#include "../jrd/ids.h"
+
+using namespace Jrd;
+using namespace Firebird;
+
+
+RecordBuffer* StatementStatsTable::getRecords(thread_db* tdbb, jrd_rel* relation)
+{
+	fb_assert(relation);
+	fb_assert(relation->rel_id == rel_stmt_stats);
+
+	auto recordBuffer = getData(relation);
+	if (recordBuffer)
+		return recordBuffer;
+
+	recordBuffer = allocBuffer(tdbb, *tdbb->getDefaultPool(), relation->rel_id);
+
+	// Statistics are aggregated over all users, so only those who
+	// may monitor any attachment are allowed to see them
+	const auto attachment = tdbb->getAttachment();
+	if (!attachment->locksmith(tdbb, MONITOR_ANY_ATTACHMENT))
+		return recordBuffer;
+
+	const auto stmtStats = tdbb->getDatabase()->dbb_stmt_stats;
+	if (!stmtStats)
+		return recordBuffer;
+
+	StatementStats::EntryList entries(*tdbb->getDefaultPool());
+	stmtStats->getEntries(entries);
+
+	const auto record = recordBuffer->getTempRecord();
+
+	for (const auto& entry : entries)
+	{
+		record->nullify();
+
+		const SINT64 hash = (SINT64) entry.hash;
+		putField(tdbb, record, DumpField(f_stmt_stats_hash, VALUE_INTEGER, sizeof(hash), &hash));
+		putField(tdbb, record,
+			DumpField(f_stmt_stats_sql_text, VALUE_STRING, entry.sqlText.length(), entry.sqlText.c_str()));
+		putField(tdbb, record,
+			DumpField(f_stmt_stats_executions, VALUE_INTEGER, sizeof(SINT64), &entry.executions));
+		putField(tdbb, record,
+			DumpField(f_stmt_stats_total_time, VALUE_INTEGER, sizeof(SINT64), &entry.totalTime));
+		putField(tdbb, record,
+			DumpField(f_stmt_stats_max_time, VALUE_INTEGER, sizeof(SINT64), &entry.maxTime));
+		putField(tdbb, record,
+			DumpField(f_stmt_stats_fetches, VALUE_INTEGER, sizeof(SINT64),
+				&entry.counters[StatementStats::CNT_FETCHES]));
+		putField(tdbb, record,
+			DumpField(f_stmt_stats_reads, VALUE_INTEGER, sizeof(SINT64),
+				&entry.counters[StatementStats::CNT_READS]));
+		putField(tdbb, record,
+			DumpField(f_stmt_stats_writes, VALUE_INTEGER, sizeof(SINT64),
+				&entry.counters[StatementStats::CNT_WRITES]));
+		putField(tdbb, record,
+			DumpField(f_stmt_stats_records, VALUE_INTEGER, sizeof(SINT64),
+				&entry.counters[StatementStats::CNT_RECORDS]));
+		putField(tdbb, record,
+			DumpField(f_stmt_stats_sorts, VALUE_INTEGER, sizeof(SINT64),
+				&entry.counters[StatementStats::CNT_SORTS]));
+		putField(tdbb, record,
+			DumpField(f_stmt_stats_sort_spills, VALUE_INTEGER, sizeof(SINT64),
+				&entry.counters[StatementStats::CNT_SORT_SPILLS]));
+
+		recordBuffer->store(record);
+	}
+
+	return recordBuffer;
+}
+
+
+//--------------------------------------
+
+
+void StatementStatsTableScan::close(thread_db* tdbb) const
+{
+	const auto request = tdbb->getRequest();
+	const auto impure = request->getImpure<Impure>(impureOffset);
+
+	delete impure->table;
+	impure->table = nullptr;
+
+	VirtualTableScan::close(tdbb);
+}
+
+const Format* StatementStatsTableScan::getFormat(thread_db* tdbb, jrd_rel* relation) const
+{
+	const auto records = getRecords(tdbb, relation);
+	return records->getFormat();
+}
+
+bool StatementStatsTableScan::retrieveRecord(thread_db* tdbb, jrd_rel* relation,
+	FB_UINT64 position, Record* record) const
+{
+	const auto records = getRecords(tdbb, relation);
+	return records->fetch(position, record);
+}
+
+RecordBuffer* StatementStatsTableScan::getRecords(thread_db* tdbb, jrd_rel* relation) const
+{
+	const auto request = tdbb->getRequest();
+	const auto impure = request->getImpure<Impure>(impureOffset);
+
+	if (!impure->table)
+	{
+		impure->table =
+			FB_NEW_POOL(*tdbb->getDefaultPool()) StatementStatsTable(*tdbb->getDefaultPool());
+	}
+
+	return impure->table->getRecords(tdbb, relation);
+}
@@ -60,6 +60,7 @@
 #include "../common/classes/FpeControl.h"
 #include "../jrd/extds/ExtDS.h"
 #include "../jrd/align.h"
+#include "../jrd/StatementStats.h"
 
 #include <functional>
 #include <cmath>
@@ -278,6 +279,7 @@ void makeOverlay(DataTypeUtilBase* dataTypeUtil, const SysFunction* function, ds
 void makePad(DataTypeUtilBase* dataTypeUtil, const SysFunction* function, dsc* result, int argsCount, const dsc** args);
 void makePi(DataTypeUtilBase* dataTypeUtil, const SysFunction* function, dsc* result, int argsCount, const dsc** args);
 void makeReplace(DataTypeUtilBase* dataTypeUtil, const SysFunction* function, dsc* result, int argsCount, const dsc** args);
+void makeResetStatementStats(DataTypeUtilBase* dataTypeUtil, const SysFunction* function, dsc* result, int argsCount, const dsc** args);
 void makeReverse(DataTypeUtilBase* dataTypeUtil, const SysFunction* function, dsc* result, int argsCount, const dsc** args);
 void makeRound(DataTypeUtilBase* dataTypeUtil, const SysFunction* function, dsc* result, int argsCount, const dsc** args);
 void makeRsaCrypt(DataTypeUtilBase* dataTypeUtil, const SysFunction* function, dsc* result, int argsCount, const dsc** args);
@@ -337,6 +339,7 @@ dsc* evlPosition(thread_db* tdbb, const SysFunction* function, const NestValueAr
 dsc* evlPower(thread_db* tdbb, const SysFunction* function, const NestValueArray& args, impure_value* impure);
 dsc* evlRand(thread_db* tdbb, const SysFunction* function, const NestValueArray& args, impure_value* impure);
 dsc* evlReplace(thread_db* tdbb, const SysFunction* function, const NestValueArray& args, impure_value* impure);
+dsc* evlResetStatementStats(thread_db* tdbb, const SysFunction* function, const NestValueArray& args, impure_value* impure);
 dsc* evlReverse(thread_db* tdbb, const SysFunction* function, const NestValueArray& args, impure_value* impure);
 dsc* evlRight(thread_db* tdbb, const SysFunction* function, const NestValueArray& args, impure_value* impure);
 dsc* evlRoleInUse(thread_db* tdbb, const SysFunction* function, const NestValueArray& args, impure_value* impure);
@@ -1785,6 +1788,13 @@ void makeReplace(DataTypeUtilBase* dataTypeUtil, const SysFunction* function, ds
 }
 
 
+void makeResetStatementStats(DataTypeUtilBase* /*dataTypeUtil*/, const SysFunction* /*function*/, dsc* result,
+	int /*argsCount*/, const dsc** /*args*/)
+{
+	result->makeInt64(0);
+}
+
+
 void makeReverse(DataTypeUtilBase*, const SysFunction* function, dsc* result,
 	int argsCount, const dsc** args)
 {
@@ -6198,6 +6208,24 @@ dsc* evlReplace(thread_db* tdbb, const SysFunction*, const NestValueArray& args,
 }
 
 
+dsc* evlResetStatementStats(thread_db* tdbb, const SysFunction*, const NestValueArray& args,
+	impure_value* impure)
+{
+	fb_assert(args.getCount() == 0);
+
+	const auto attachment = tdbb->getAttachment();
+
+	if (!attachment->locksmith(tdbb, MONITOR_ANY_ATTACHMENT))
+		status_exception::raise(Arg::Gds(isc_miss_prvlg) << "MONITOR_ANY_ATTACHMENT");
+
+	const auto stmtStats = tdbb->getDatabase()->dbb_stmt_stats;
+	impure->vlu_misc.vlu_int64 = stmtStats ? stmtStats->reset() : 0;
+	impure->vlu_desc.makeInt64(0, &impure->vlu_misc.vlu_int64);
+
+	return &impure->vlu_desc;
+}
+
+
 dsc* evlReverse(thread_db* tdbb, const SysFunction*, const NestValueArray& args,
 	impure_value* impure)
 {
@@ -6842,6 +6870,7 @@ const SysFunction SysFunction::functions[] =
 		{"RAND", 0, 0, NULL, makeDoubleResult, evlRand, NULL},
 		{RDB_GET_CONTEXT, 2, 2, setParamsGetSetContext, makeGetSetContext, evlGetContext, NULL},
 		{"RDB$GET_TRANSACTION_CN", 1, 1, setParamsInt64, makeGetTranCN, evlGetTranCN, NULL},
+		{"RDB$RESET_STATEMENT_STATISTICS", 0, 0, NULL, makeResetStatementStats, evlResetStatementStats, NULL},
 		{"RDB$ROLE_IN_USE", 1, 1, setParamsAsciiVal, makeBooleanResult, evlRoleInUse, NULL},
 		{RDB_SET_CONTEXT, 3, 3, setParamsGetSetContext, makeGetSetContext, evlSetContext, NULL},
 		{"RDB$SYSTEM_PRIVILEGE", 1, 1, NULL, makeBooleanResult, evlSystemPrivilege, NULL},
@@ -381,6 +381,20 @@ namespace Jrd
 					static_cast<typename Output::Type*>(outMsg));
 			}
 
+			void executeBatch(Firebird::ThrowStatusExceptionWrapper* status,
+				Firebird::IExternalContext* context, unsigned count,
+				void* inMsgs, unsigned inMsgLength, void* outMsgs, unsigned outMsgLength) override
+			{
+				Firebird::AutoSetRestore<bool> autoInSystemPackage(&attachment->att_in_system_routine, true);
+
+				for (unsigned i = 0; i < count; ++i)
+				{
+					ExecFunction(status, context,
+						reinterpret_cast<typename Input::Type*>(static_cast<UCHAR*>(inMsgs) + i * inMsgLength),
+						reinterpret_cast<typename Output::Type*>(static_cast<UCHAR*>(outMsgs) + i * outMsgLength));
+				}
+			}
+
 		private:
 			Attachment* attachment;
 		};
@@ -24,6 +24,7 @@
 
 #include "iberror.h"
 #include "../common/classes/TempFile.h"
+#include "../common/classes/zip.h"
 #include "../common/config/config.h"
 #include "../common/config/dir_list.h"
 #include "../common/gdsassert.h"
@@ -46,14 +47,39 @@ namespace
 {
 	const size_t MIN_TEMP_BLOCK_SIZE = 64 * 1024;
 
+	const FB_SIZE_T PACKED_PAGE_SIZE = 64 * 1024;	// divides MIN_TEMP_BLOCK_SIZE
+	const FB_SIZE_T PACKED_CACHE_PAGES = 16;				// minimal cache of compressed file
+	const FB_SIZE_T PACKED_CACHE_MAX_PAGES = 1024;		// limit of the cache growing with streams count
+
+#ifdef HAVE_ZLIB_H
+	InitInstance<ZLib> zlib;
+#endif
+
+	// Database of the current thread. Temporary space used outside of
+	// the engine context (e.g. by unit tests) isn't limited.
+	Database* getDatabase()
+	{
+		thread_db* const tdbb = JRD_get_thread_data();
+		return tdbb ? tdbb->getDatabase() : NULL;
+	}
+
 	class TempCacheLimitGuard
 	{
 	public:
 		explicit TempCacheLimitGuard(FB_SIZE_T size)
-			: m_dbb(GET_DBB()), m_size(size),
-			  m_guard(m_dbb->dbb_temp_cache_mutex, FB_FUNCTION)
+			: m_dbb(getDatabase()), m_size(size), m_allowed(true)
 		{
-			m_allowed = (m_dbb->dbb_temp_cache_size + size <= m_dbb->dbb_config->getTempCacheLimit());
+			if (m_dbb)
+			{
+				m_dbb->dbb_temp_cache_mutex.enter(FB_FUNCTION);
+				m_allowed = (m_dbb->dbb_temp_cache_size + size <= m_dbb->dbb_config->getTempCacheLimit());
+			}
+		}
+
+		~TempCacheLimitGuard()
+		{
+			if (m_dbb)
+				m_dbb->dbb_temp_cache_mutex.leave();
 		}
 
 		bool isAllowed() const
@@ -64,12 +90,35 @@ namespace
 		void increment()
 		{
 			fb_assert(m_allowed);
-			m_dbb->dbb_temp_cache_size += m_size;
+
+			if (m_dbb)
+				m_dbb->dbb_temp_cache_size += m_size;
+		}
+
+		// Account as much of the given size as the limit allows, by whole units
+		static FB_SIZE_T reserve(FB_SIZE_T size, FB_SIZE_T unit)
+		{
+			Database* const dbb = getDatabase();
+			if (!dbb)
+				return size;
+
+			MutexLockGuard guard(dbb->dbb_temp_cache_mutex, FB_FUNCTION);
+
+			const FB_UINT64 limit = dbb->dbb_config->getTempCacheLimit();
+			const FB_UINT64 available = (dbb->dbb_temp_cache_size < limit) ?
+				limit - dbb->dbb_temp_cache_size : 0;
+			const FB_SIZE_T reserved = (FB_SIZE_T) MIN(size, available / unit * unit);
+
+			dbb->dbb_temp_cache_size += reserved;
+			return reserved;
 		}
 
 		static void decrement(FB_SIZE_T size)
 		{
-			Database* const dbb = GET_DBB();
+			Database* const dbb = getDatabase();
+			if (!dbb || !size)
+				return;
+
 			MutexLockGuard guard(dbb->dbb_temp_cache_mutex, FB_FUNCTION);
 			dbb->dbb_temp_cache_size -= size;
 		}
@@ -77,7 +126,6 @@ namespace
 	private:
 		Database* const m_dbb;
 		FB_SIZE_T m_size;
-		MutexLockGuard m_guard;
 		bool m_allowed;
 	};
 }
@@ -130,6 +178,329 @@ FB_SIZE_T TempSpace::FileBlock::write(offset_t offset, const void* buffer, FB_SI
 	return file->write(offset, buffer, length);
 }
 
+//
+// Compressed on-disk block class
+//
+
+FB_SIZE_T TempSpace::PackedBlock::read(offset_t offset, void* buffer, FB_SIZE_T length)
+{
+	if (offset + length > size)
+	{
+		length = size - offset;
+	}
+	offset += seek;
+	return file->read(offset, buffer, length);
+}
+
+FB_SIZE_T TempSpace::PackedBlock::write(offset_t offset, const void* buffer, FB_SIZE_T length)
+{
+	if (offset + length > size)
+	{
+		length = size - offset;
+	}
+	offset += seek;
+	return file->write(offset, buffer, length);
+}
+
+//
+// Compressed temporary file class
+//
+
+TempSpace::PackedFile::PackedFile(MemoryPool& p, TempFile* f)
+	: pool(p), file(f), size(0), useCounter(0), cacheUsage(0),
+	  pages(p), freeSlots(p), buffers(p), packBuffer(p)
+{
+	fb_assert(file);
+
+	setCachePages(PACKED_CACHE_PAGES);
+}
+
+TempSpace::PackedFile::~PackedFile()
+{
+	for (auto& buffer : buffers)
+		delete[] buffer.data;
+
+	TempCacheLimitGuard::decrement(cacheUsage);
+
+	delete file;
+}
+
+//
+// Make the cache hold the given number of pages. Every stream read or written
+// sequentially needs its own page, otherwise streams interleaved by merge
+// evict each other pages and every page is decompressed many times.
+// Pages above the minimal cache are counted in TempCacheLimit, the cache
+// grows only as far as the limit allows.
+//
+
+void TempSpace::PackedFile::setCachePages(FB_SIZE_T count)
+{
+	count = MIN(MAX(count, PACKED_CACHE_PAGES), PACKED_CACHE_MAX_PAGES);
+
+	const FB_SIZE_T current = MAX(buffers.getCount(), PACKED_CACHE_PAGES);
+
+	if (count > current)
+	{
+		const FB_SIZE_T reserved =
+			TempCacheLimitGuard::reserve((count - current) * PACKED_PAGE_SIZE, PACKED_PAGE_SIZE);
+
+		cacheUsage += reserved;
+		count = current + reserved / PACKED_PAGE_SIZE;
+	}
+
+	while (buffers.getCount() < count)
+	{
+		Buffer& buffer = buffers.add();
+		buffer.page = MAX_UINT64;
+		buffer.lastUse = 0;
+		buffer.dirty = false;
+		buffer.data = NULL;
+	}
+
+	while (buffers.getCount() > count)
+	{
+		Buffer& buffer = buffers.back();
+
+		if (buffer.dirty)
+			store(&buffer);
+
+		delete[] buffer.data;
+		buffers.pop();
+
+		cacheUsage -= PACKED_PAGE_SIZE;
+		TempCacheLimitGuard::decrement(PACKED_PAGE_SIZE);
+	}
+}
+
+FB_SIZE_T TempSpace::PackedFile::read(offset_t offset, void* buffer, FB_SIZE_T length)
+{
+	fb_assert(offset + length <= size);
+
+	UCHAR* p = static_cast<UCHAR*>(buffer);
+	FB_SIZE_T l = length;
+
+	while (l)
+	{
+		const FB_SIZE_T pageOffset = offset % PACKED_PAGE_SIZE;
+		const FB_SIZE_T n = MIN(l, PACKED_PAGE_SIZE - pageOffset);
+
+		const Buffer* const cached = fetch(offset / PACKED_PAGE_SIZE, true);
+		memcpy(p, cached->data + pageOffset, n);
+
+		offset += n;
+		p += n;
+		l -= n;
+	}
+
+	return length;
+}
+
+FB_SIZE_T TempSpace::PackedFile::write(offset_t offset, const void* buffer, FB_SIZE_T length)
+{
+	fb_assert(offset + length <= size);
+
+	const UCHAR* p = static_cast<const UCHAR*>(buffer);
+	FB_SIZE_T l = length;
+
+	while (l)
+	{
+		const FB_SIZE_T pageOffset = offset % PACKED_PAGE_SIZE;
+		const FB_SIZE_T n = MIN(l, PACKED_PAGE_SIZE - pageOffset);
+
+		// Page being overwritten completely is not read from the file
+		Buffer* const cached = fetch(offset / PACKED_PAGE_SIZE, n != PACKED_PAGE_SIZE);
+		memcpy(cached->data + pageOffset, p, n);
+		cached->dirty = true;
+
+		offset += n;
+		p += n;
+		l -= n;
+	}
+
+	return length;
+}
+
+//
+// Return the cached page, evicting the least recently used one if necessary.
+// Modified pages are compressed and written to the file only when evicted.
+//
+
+TempSpace::PackedFile::Buffer* TempSpace::PackedFile::fetch(FB_UINT64 page, bool load)
+{
+	Buffer* victim = NULL;
+
+	for (auto& buffer : buffers)
+	{
+		if (buffer.page == page)
+		{
+			buffer.lastUse = ++useCounter;
+			return &buffer;
+		}
+
+		if (!victim || buffer.lastUse < victim->lastUse)
+			victim = &buffer;
+	}
+
+	if (victim->dirty)
+		store(victim);
+
+	if (!victim->data)
+		victim->data = FB_NEW_POOL(pool) UCHAR[PACKED_PAGE_SIZE];
+
+	victim->page = page;
+	victim->lastUse = ++useCounter;
+	victim->dirty = false;
+
+	if (load && page < pages.getCount() && pages[page].length)
+	{
+		const Page& stored = pages[page];
+
+		if (!stored.packed)
+		{
+			fb_assert(stored.length == PACKED_PAGE_SIZE);
+			file->read(stored.position, victim->data, PACKED_PAGE_SIZE);
+		}
+		else
+		{
+			UCHAR* const packed = packBuffer.getBuffer(stored.length);
+			file->read(stored.position, packed, stored.length);
+
+			bool unpacked = false;
+#ifdef HAVE_ZLIB_H
+			uLongf unpackedLength = PACKED_PAGE_SIZE;
+			unpacked = (zlib().uncompress(victim->data, &unpackedLength, packed, stored.length) == Z_OK &&
+				unpackedLength == PACKED_PAGE_SIZE);
+#endif
+			if (!unpacked)
+			{
+				victim->page = MAX_UINT64;
+				(Arg::Gds(isc_random) << "Cannot decompress temporary space page").raise();
+			}
+		}
+	}
+	else if (load)
+		memset(victim->data, 0, PACKED_PAGE_SIZE);
+
+	return victim;
+}
+
+//
+// Compress the cached page and write it to the file
+//
+
+void TempSpace::PackedFile::store(Buffer* buffer)
+{
+	fb_assert(buffer->dirty && buffer->data);
+
+	const UCHAR* data = buffer->data;
+	ULONG length = PACKED_PAGE_SIZE;
+	bool packed = false;
+
+#ifdef HAVE_ZLIB_H
+	uLongf packedLength = zlib().compressBound(PACKED_PAGE_SIZE);
+	UCHAR* const packedData = packBuffer.getBuffer(packedLength);
+
+	if (zlib().compress2(packedData, &packedLength, data, PACKED_PAGE_SIZE, Z_BEST_SPEED) == Z_OK &&
+		packedLength < PACKED_PAGE_SIZE)
+	{
+		data = packedData;
+		length = (ULONG) packedLength;
+		packed = true;
+	}
+#endif
+
+	while (buffer->page >= pages.getCount())
+	{
+		Page& page = pages.add();
+		page.position = 0;
+		page.length = page.capacity = 0;
+		page.packed = false;
+	}
+
+	Page& page = pages[buffer->page];
+
+	if (page.capacity < length)
+	{
+		if (page.capacity)
+			releaseSlot(page.position, page.capacity);
+
+		page.position = allocateSlot(length);
+		page.capacity = length;
+	}
+	else if (page.capacity > length)
+	{
+		releaseSlot(page.position + length, page.capacity - length);
+		page.capacity = length;
+	}
+
+	file->write(page.position, data, length);
+
+	page.length = length;
+	page.packed = packed;
+	buffer->dirty = false;
+}
+
+//
+// Take the head of the smallest free slot big enough, or append a new slot to the file
+//
+
+offset_t TempSpace::PackedFile::allocateSlot(ULONG length)
+{
+	FB_SIZE_T best = freeSlots.getCount();
+
+	for (FB_SIZE_T i = 0; i < freeSlots.getCount(); i++)
+	{
+		if (freeSlots[i].capacity >= length &&
+			(best == freeSlots.getCount() || freeSlots[i].capacity < freeSlots[best].capacity))
+		{
+			best = i;
+		}
+	}
+
+	if (best == freeSlots.getCount())
+		return file->getSize();
+
+	// Rest of the slot stays free, the order of slots is not changed
+
+	Slot& slot = freeSlots[best];
+	const offset_t position = slot.position;
+
+	if (slot.capacity == length)
+		freeSlots.remove(best);
+	else
+	{
+		slot.position += length;
+		slot.capacity -= length;
+	}
+
+	return position;
+}
+
+//
+// Return the slot to the list of free ones, merging it with adjacent free slots
+//
+
+void TempSpace::PackedFile::releaseSlot(offset_t position, offset_t capacity)
+{
+	FB_SIZE_T pos;
+	freeSlots.find(position, pos);
+
+	if (pos < freeSlots.getCount() && position + capacity == freeSlots[pos].position)
+	{
+		capacity += freeSlots[pos].capacity;
+		freeSlots.remove(pos);
+	}
+
+	if (pos && freeSlots[pos - 1].position + freeSlots[pos - 1].capacity == position)
+	{
+		freeSlots[pos - 1].capacity += capacity;
+		return;
+	}
+
+	const Slot slot = {position, capacity};
+	freeSlots.insert(pos, slot);
+}
+
 //
 // TempSpace::TempSpace
 //
@@ -139,7 +510,7 @@ FB_SIZE_T TempSpace::FileBlock::write(offset_t offset, const void* buffer, FB_SI
 TempSpace::TempSpace(MemoryPool& p, const PathName& prefix, bool dynamic)
 		: pool(p), filePrefix(p, prefix),
 		  logicalSize(0), physicalSize(0), localCacheUsage(0),
-		  head(NULL), tail(NULL), tempFiles(p),
+		  head(NULL), tail(NULL), tempFiles(p), packedFile(NULL), streamCount(0),
 		  initialBuffer(p), initiallyDynamic(dynamic),
 		  freeSegments(p)
 {
@@ -179,6 +550,8 @@ TempSpace::~TempSpace()
 
 	while (tempFiles.getCount())
 		delete tempFiles.pop();
+
+	delete packedFile;
 }
 
 //
@@ -335,16 +708,33 @@ void TempSpace::extend(FB_SIZE_T size)
 		// logical/physical size already increased while allocation has in fact failed.
 		if (!block)
 		{
-			// allocate block in the temp file
-			TempFile* const file = setupFile(size);
-			fb_assert(file);
-			if (tail && tail->sameFile(file))
+			PackedFile* const packed = setupPackedFile();
+
+			if (packed)
 			{
-				fb_assert(!initialSize);
-				tail->size += size;
-				return;
+				// allocate block in the compressed temp file
+				packed->extend(size);
+				if (tail && tail->sameFile(packed->getFile()))
+				{
+					fb_assert(!initialSize);
+					tail->size += size;
+					return;
+				}
+				block = FB_NEW_POOL(pool) PackedBlock(packed, tail, size);
+			}
+			else
+			{
+				// allocate block in the temp file
+				TempFile* const file = setupFile(size);
+				fb_assert(file);
+				if (tail && tail->sameFile(file))
+				{
+					fb_assert(!initialSize);
+					tail->size += size;
+					return;
+				}
+				block = FB_NEW_POOL(pool) FileBlock(file, tail, size);
 			}
-			block = FB_NEW_POOL(pool) FileBlock(file, tail, size);
 		}
 
 		// preserve the initial contents, if any
@@ -460,6 +850,53 @@ TempFile* TempSpace::setupFile(FB_SIZE_T size)
 	return NULL; // compiler silencer
 }
 
+//
+// TempSpace::setupPackedFile
+//
+// Returns the compressed temporary file, if compression is enabled
+//
+
+TempSpace::PackedFile* TempSpace::setupPackedFile()
+{
+	if (packedFile)
+		return packedFile;
+
+#ifdef HAVE_ZLIB_H
+	if (!GET_DBB()->dbb_config->getTempCompression() || !zlib())
+		return NULL;
+
+	StaticStatusVector status_vector;
+
+	for (FB_SIZE_T i = 0; i < tempDirs->getCount(); i++)
+	{
+		PathName directory = (*tempDirs)[i];
+		PathUtils::ensureSeparator(directory);
+
+		try
+		{
+			TempFile* const file = FB_NEW_POOL(pool) TempFile(pool, filePrefix, directory);
+			packedFile = FB_NEW_POOL(pool) PackedFile(pool, file);
+			packedFile->setCachePages(streamCount);
+		}
+		catch (const system_error& ex)
+		{
+			ex.stuffException(status_vector);
+			continue;
+		}
+
+		return packedFile;
+	}
+
+	// no room in all directories
+	Arg::Gds status(isc_out_of_temp_space);
+	status.append(Arg::StatusVector(status_vector.begin()));
+	iscLogStatus(NULL, status.value());
+	status.raise();
+#endif
+
+	return NULL;
+}
+
 //
 // TempSpace::allocateSpace
 //
@@ -620,9 +1057,27 @@ bool TempSpace::validate(offset_t& free) const
 	for (FB_SIZE_T i = 0; i < tempFiles.getCount(); i++)
 		disk += tempFiles[i]->getSize();
 
+	if (packedFile)
+		disk += packedFile->getSize();
+
 	return ((initialBuffer.getCount() + localCacheUsage + disk) == physicalSize);
 }
 
+//
+// TempSpace::setStreamCount
+//
+// Remember the number of streams accessed at once and let the compressed
+// file cache a page for each of them. Zero returns the cache to its minimum.
+//
+
+void TempSpace::setStreamCount(FB_SIZE_T count)
+{
+	streamCount = count;
+
+	if (packedFile)
+		packedFile->setCachePages(count);
+}
+
 
 //
 // TempSpace::allocateBatch
@@ -66,6 +66,89 @@ public:
 	ULONG allocateBatch(ULONG count, FB_SIZE_T minSize, FB_SIZE_T maxSize, Segments& segments);
 
 	bool validate(offset_t& freeSize) const;
+
+	// Number of sequential streams read or written at once, e.g. runs merged
+	// by sort. Compressed file caches a page per stream while the memory
+	// limit allows.
+	void setStreamCount(FB_SIZE_T count);
+
+	// Temporary file keeping the data compressed by fixed size pages.
+	// Pages are cached uncompressed: written pages are compressed once
+	// they leave the cache and stored pages are decompressed once
+	// while being read sequentially.
+	class PackedFile
+	{
+	public:
+		PackedFile(MemoryPool& pool, Firebird::TempFile* file);
+		~PackedFile();
+
+		FB_SIZE_T read(offset_t offset, void* buffer, FB_SIZE_T length);
+		FB_SIZE_T write(offset_t offset, const void* buffer, FB_SIZE_T length);
+
+		void extend(offset_t length)
+		{
+			size += length;
+		}
+
+		offset_t getSize() const
+		{
+			return size;
+		}
+
+		const Firebird::TempFile* getFile() const
+		{
+			return file;
+		}
+
+		void setCachePages(FB_SIZE_T count);
+
+	private:
+		// Location of the page in the file
+		struct Page
+		{
+			offset_t position;
+			ULONG length;		// stored length, zero if the page was never written
+			ULONG capacity;		// length of the slot in the file
+			bool packed;
+		};
+
+		// Unused slot in the file, adjacent slots are merged
+		struct Slot
+		{
+			offset_t position;
+			offset_t capacity;
+
+			static const offset_t& generate(const Slot& slot)
+			{
+				return slot.position;
+			}
+		};
+
+		// Uncompressed page in the cache
+		struct Buffer
+		{
+			FB_UINT64 page;
+			ULONG lastUse;
+			bool dirty;
+			UCHAR* data;
+		};
+
+		Buffer* fetch(FB_UINT64 page, bool load);
+		void store(Buffer* buffer);
+		offset_t allocateSlot(ULONG length);
+		void releaseSlot(offset_t position, offset_t capacity);
+
+		MemoryPool& pool;
+		Firebird::TempFile* const file;
+		offset_t size;
+		ULONG useCounter;
+		FB_SIZE_T cacheUsage;	// memory of pages above the minimal cache, see TempCacheLimit
+		Firebird::Array<Page> pages;
+		Firebird::SortedArray<Slot, Firebird::EmptyStorage<Slot>, offset_t, Slot> freeSlots;
+		Firebird::Array<Buffer> buffers;
+		Firebird::Array<UCHAR> packBuffer;
+	};
+
 private:
 
 	// Generic space block
@@ -173,8 +256,41 @@ private:
 		offset_t seek;
 	};
 
+	class PackedBlock : public Block
+	{
+	public:
+		PackedBlock(PackedFile* f, Block* tail, size_t length)
+			: Block(tail, length), file(f)
+		{
+			fb_assert(file);
+
+			// PackedBlock is created after the file was extended by length
+			seek = file->getSize() - length;
+		}
+
+		~PackedBlock() {}
+
+		FB_SIZE_T read(offset_t offset, void* buffer, FB_SIZE_T length);
+		FB_SIZE_T write(offset_t offset, const void* buffer, FB_SIZE_T length);
+
+		UCHAR* inMemory(offset_t /*offset*/, size_t /*a_size*/) const
+		{
+			return NULL;
+		}
+
+		bool sameFile(const Firebird::TempFile* aFile) const
+		{
+			return (aFile == this->file->getFile());
+		}
+
+	private:
+		PackedFile* file;
+		offset_t seek;
+	};
+
 	Block* findBlock(offset_t& offset) const;
 	Firebird::TempFile* setupFile(FB_SIZE_T size);
+	PackedFile* setupPackedFile();
 
 	UCHAR* findMemory(offset_t& begin, offset_t end, size_t size) const;
 
@@ -206,6 +322,8 @@ private:
 	Block* head;
 	Block* tail;
 	Firebird::Array<Firebird::TempFile*> tempFiles;
+	PackedFile* packedFile;
+	FB_SIZE_T streamCount;
 	Firebird::Array<UCHAR> initialBuffer;
 	bool initiallyDynamic;
 
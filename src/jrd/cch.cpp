@@ -2783,16 +2783,108 @@ extern "C" {
 // no such pages (i.e. all of not written yet pages have high precedence pages)
 // then write them all at last iteration (of course write_buffer will also check
 // for precedence before write).
+namespace {
+
+// Latched pages which are ready to be written by flushPages. When the database
+// is encrypted, pages of a batch are encrypted in parallel before writing.
+class FlushBatch
+{
+public:
+	FlushBatch(thread_db* tdbb, USHORT flush_flag)
+		: m_tdbb(tdbb),
+		  m_flushFlag(flush_flag),
+		  m_bdbs(*tdbb->getDefaultPool()),
+		  m_buffer(*tdbb->getDefaultPool()),
+		  m_enabled(tdbb->getDatabase()->dbb_crypto_manager->canPrepareWrite())
+	{
+	}
+
+	bool isEnabled() const
+	{
+		return m_enabled;
+	}
+
+	bool hasData() const
+	{
+		return m_bdbs.hasData();
+	}
+
+	void add(BufferDesc* bdb)
+	{
+		m_bdbs.add(bdb);
+
+		if (m_bdbs.getCount() >= MAX_BATCH)
+			write();
+	}
+
+	void write()
+	{
+		if (!m_bdbs.hasData())
+			return;
+
+		const auto dbb = m_tdbb->getDatabase();
+		const FB_SIZE_T count = m_bdbs.getCount();
+
+		Ods::pag* pages[MAX_BATCH];
+		Ods::pag* crypted[MAX_BATCH];
+
+		for (FB_SIZE_T i = 0; i < count; i++)
+			pages[i] = m_bdbs[i]->bdb_buffer;
+
+		UCHAR* const buffers = FB_ALIGN(m_buffer.getBuffer(count * dbb->dbb_page_size + PAGE_ALIGNMENT),
+			PAGE_ALIGNMENT);
+		dbb->dbb_crypto_manager->prepareWrite(m_tdbb, count, pages, buffers, crypted);
+
+		for (FB_SIZE_T i = 0; i < count; i++)
+		{
+			AutoSetRestore<Ods::pag*> autoCrypted(&m_bdbs[i]->bdb_crypted, crypted[i]);
+			writeBuffer(m_tdbb, m_bdbs[i], m_flushFlag);
+		}
+
+		m_bdbs.clear();
+	}
+
+	static void writeBuffer(thread_db* tdbb, BufferDesc* bdb, USHORT flush_flag)
+	{
+		const bool all_flag = (flush_flag & FLUSH_ALL) != 0;
+		const bool release_flag = (flush_flag & FLUSH_RLSE) != 0;
+		const bool write_thru = release_flag;
+
+		if (!all_flag || bdb->bdb_flags & (BDB_db_dirty | BDB_dirty))
+		{
+			if (!write_buffer(tdbb, bdb, bdb->bdb_page, write_thru, tdbb->tdbb_status_vector, true))
+				CCH_unwind(tdbb, true);
+		}
+
+		// release lock before losing control over bdb, it prevents
+		// concurrent operations on released lock
+		if (release_flag)
+			PAGE_LOCK_RELEASE(tdbb, bdb->bdb_bcb, bdb->bdb_lock);
+
+		bdb->release(tdbb, !release_flag && !(bdb->bdb_flags & BDB_dirty));
+	}
+
+private:
+	static const FB_SIZE_T MAX_BATCH = 64;
+
+	thread_db* const m_tdbb;
+	const USHORT m_flushFlag;
+	HalfStaticArray<BufferDesc*, MAX_BATCH> m_bdbs;
+	Array<UCHAR> m_buffer;
+	const bool m_enabled;
+};
+
+} // namespace
+
 static void flushPages(thread_db* tdbb, USHORT flush_flag, BufferDesc** begin, FB_SIZE_T count)
 {
-	FbStatusVector* const status = tdbb->tdbb_status_vector;
-	const bool all_flag = (flush_flag & FLUSH_ALL) != 0;
 	const bool release_flag = (flush_flag & FLUSH_RLSE) != 0;
-	const bool write_thru = release_flag;
+	const SyncType syncType = release_flag ? SYNC_EXCLUSIVE : SYNC_SHARED;
 
 	qsort(begin, count, sizeof(BufferDesc*), cmpBdbs);
 
 	MarkIterator<BufferDesc*> iter(begin, count);
+	FlushBatch batch(tdbb, flush_flag);
 
 	FB_SIZE_T written = 0;
 	bool writeAll = false;
@@ -2807,7 +2899,12 @@ static void flushPages(thread_db* tdbb, USHORT flush_flag, BufferDesc** begin, F
 			if (!bdb)
 				continue;
 
-			bdb->addRef(tdbb, release_flag ? SYNC_EXCLUSIVE : SYNC_SHARED);
+			// Never wait for a latch while holding latches of the batched pages
+			if (!batch.hasData() || !bdb->addRefConditional(tdbb, syncType))
+			{
+				batch.write();
+				bdb->addRef(tdbb, syncType);
+			}
 
 			BufferControl* bcb = bdb->bdb_bcb;
 			if (!writeAll)
@@ -2821,19 +2918,17 @@ static void flushPages(thread_db* tdbb, USHORT flush_flag, BufferDesc** begin, F
 						BUGCHECK(210);	// msg 210 page in use during flush
 				}
 
-				if (!all_flag || bdb->bdb_flags & (BDB_db_dirty | BDB_dirty))
+				// Page with no higher precedence pages can't get them while we
+				// hold its latch, so it's safe to delay its write. Others are
+				// written immediately as write_buffer() may wait for their higher pages.
+				if (batch.isEnabled() && !writeAll)
+					batch.add(bdb);
+				else
 				{
-					if (!write_buffer(tdbb, bdb, bdb->bdb_page, write_thru, status, true))
-						CCH_unwind(tdbb, true);
+					batch.write();
+					FlushBatch::writeBuffer(tdbb, bdb, flush_flag);
 				}
 
-				// release lock before losing control over bdb, it prevents
-				// concurrent operations on released lock
-				if (release_flag)
-					PAGE_LOCK_RELEASE(tdbb, bcb, bdb->bdb_lock);
-
-				bdb->release(tdbb, !release_flag && !(bdb->bdb_flags & BDB_dirty));
-
 				iter.mark();
 				found = true;
 				written++;
@@ -2844,6 +2939,8 @@ static void flushPages(thread_db* tdbb, USHORT flush_flag, BufferDesc** begin, F
 			}
 		}
 
+		batch.write();
+
 		if (!found)
 			writeAll = true;
 
@@ -4970,7 +5067,7 @@ static bool write_page(thread_db* tdbb, BufferDesc* bdb, FbStatusVector* const s
 				};
 
 				Pio io(pageSpace->file, bdb, inAst, isTempPage, pageSpace);
-				result = dbb->dbb_crypto_manager->write(tdbb, status, page, &io);
+				result = dbb->dbb_crypto_manager->write(tdbb, status, page, &io, bdb->bdb_crypted);
 				if (!result && (bdb->bdb_flags & BDB_io_error))
 				{
 					return false;
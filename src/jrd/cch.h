@@ -198,6 +198,7 @@ public:
 		QUE_INIT(bdb_dirty);
 		bdb_lru_chain = NULL;
 		bdb_buffer = NULL;
+		bdb_crypted = NULL;
 		bdb_incarnation = 0;
 		bdb_transactions = 0;
 		bdb_mark_transaction = 0;
@@ -243,6 +244,7 @@ public:
 	que			bdb_dirty;				// dirty pages LRU queue
 	BufferDesc*	bdb_lru_chain;			// pending LRU chain
 	Ods::pag*	bdb_buffer;				// Actual buffer
+	Ods::pag*	bdb_crypted;			// Buffer encrypted in advance by flushPages, if any
 	PageNumber	bdb_page;				// Database page number in buffer
 	ULONG		bdb_incarnation;
 	ULONG		bdb_transactions;		// vector of dirty flags to reduce commit overhead
@@ -901,6 +901,9 @@ void EXE_start(thread_db* tdbb, Request* request, jrd_tra* transaction)
 	request->req_records_affected.clear();
 
 	request->req_profiler_time = 0;
+	request->req_profiler_node = nullptr;
+	request->req_profiler_frame = nullptr;
+	StatementStats::start(request);
 
 	// Store request start time for timestamp work
 	request->validateTimeStamp();
@@ -999,6 +1002,9 @@ void EXE_unwind(thread_db* tdbb, Request* request)
 			ProfilerManager::Stats stats(request->req_profiler_time);
 			attachment->getProfilerManager(tdbb)->onRequestFinish(request, stats);
 		}
+
+		if (const auto stmtStats = tdbb->getDatabase()->dbb_stmt_stats)
+			stmtStats->finish(request);
 	}
 
 	request->req_sorts.unlinkAll();
@@ -1426,7 +1432,17 @@ const StmtNode* EXE_looper(thread_db* tdbb, Request* request, const StmtNode* no
 
 				if (attachment->isProfilerActive() && !request->hasInternalStatement())
 				{
-					if (node->hasLineColumn &&
+					const auto profilerManager = attachment->getProfilerManager(tdbb);
+
+					if (profilerManager->isSampling())
+					{
+						if (node->hasLineColumn && node->isProfileAware())
+							request->req_profiler_node = node;
+
+						if (profilerManager->isSampleDue())
+							profilerManager->takeSample(request);
+					}
+					else if (node->hasLineColumn &&
 						node->isProfileAware() &&
 						(!profileNode ||
 						 !(node->line == profileNode->line && node->column == profileNode->column)))
@@ -1435,7 +1451,7 @@ const StmtNode* EXE_looper(thread_db* tdbb, Request* request, const StmtNode* no
 
 						profileNode = node;
 
-						attachment->getProfilerManager(tdbb)->beforePsqlLineColumn(request,
+						profilerManager->beforePsqlLineColumn(request,
 							profileNode->line, profileNode->column);
 					}
 				}
@@ -1521,6 +1537,9 @@ const StmtNode* EXE_looper(thread_db* tdbb, Request* request, const StmtNode* no
 			ProfilerManager::Stats stats(request->req_profiler_time);
 			attachment->getProfilerManager(tdbb)->onRequestFinish(request, stats);
 		}
+
+		if (dbb->dbb_stmt_stats)
+			dbb->dbb_stmt_stats->finish(request);
 	}
 
 	request->req_next = node;
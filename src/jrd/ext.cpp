@@ -59,6 +59,8 @@
 #include "../common/classes/init.h"
 #include "../common/isc_f_proto.h"
 #include "../common/os/os_utils.h"
+#include "../common/Task.h"
+#include "../jrd/WorkerAttachment.h"
 
 #if defined _MSC_VER && _MSC_VER < 1400
 // NS: in VS2003 these only work with static CRT
@@ -155,9 +157,671 @@ namespace {
 
 		return ext_file->ext_ifi;
 	}
+
+	const ULONG DELIMITED_BUFFER_SIZE = 1024 * 1024;		// initial read buffer of delimited file
+	const ULONG DELIMITED_MAX_RECORD = 64 * 1024 * 1024;	// longest delimited record accepted
+	const ULONG CARDINALITY_SAMPLE = 64 * 1024;				// text sampled to estimate delimited file cardinality
+	const ULONG PARALLEL_CHUNK_SIZE = 4 * 1024 * 1024;		// text decoded per parallel worker at once
+	const ULONG PARALLEL_MAX_CHUNK = 256 * 1024 * 1024;		// text decoded by all workers at once, at most
+	const FB_UINT64 PARALLEL_MIN_FILE = 16 * 1024 * 1024;	// smaller files are decoded by the scan itself
+	const ULONG PARALLEL_RECORDS = 256;						// records handled by a work item
+
+	FB_UINT64 ext_file_size(ExternalFile* file)
+	{
+#ifdef WIN_NT
+		struct __stat64 statistics;
+		if (!_fstat64(_fileno(file->ext_ifi), &statistics))
+#else
+		struct STAT statistics;
+		if (!os_utils::fstat(fileno(file->ext_ifi), &statistics))
+#endif
+		{
+			return statistics.st_size;
+		}
+
+		return 0;
+	}
+
+	// Read the file into the given buffer starting from the given position.
+	// Returns the number of bytes read, it's less than length at the end of file.
+
+	ULONG ext_read(ExternalFile* file, FB_UINT64 position, UCHAR* buffer, ULONG length)
+	{
+		// reset both flags cause we are going to move the file pointer
+		file->ext_flags &= ~(EXT_last_write | EXT_last_read);
+
+		if (FSEEK64(file->ext_ifi, position, SEEK_SET) != 0)
+		{
+			ERR_post(Arg::Gds(isc_io_error) << STRINGIZE(FSEEK64) << Arg::Str(file->ext_filename) <<
+					 Arg::Gds(isc_io_open_err) << SYS_ERR(errno));
+		}
+
+		const size_t n = fread(buffer, 1, length, file->ext_ifi);
+
+		if (n < length && ferror(file->ext_ifi))
+		{
+			ERR_post(Arg::Gds(isc_io_error) << Arg::Str("fread") << Arg::Str(file->ext_filename) <<
+					 Arg::Gds(isc_io_read_err) << SYS_ERR(errno));
+		}
+
+		return (ULONG) n;
+	}
+
+	// Decode values of delimited record into the record image. Values are
+	// matched to the fields in order of their ids, empty unquoted value is NULL.
+
+	void decode_delimited(thread_db* tdbb, const jrd_rel* relation, const Format* format,
+		DelimitedRecord& rec, UCHAR* data)
+	{
+		memset(data, 0, format->fmt_length);
+
+		const vec<jrd_fld*>* const fields = relation->rel_fields;
+		FB_SIZE_T column = 0;
+
+		for (USHORT i = 0; i < format->fmt_count; ++i)
+		{
+			data[i >> 3] |= (1 << (i & 7));
+
+			const dsc& fmtDesc = format->fmt_desc[i];
+			const jrd_fld* const field = (i < fields->count()) ? (*fields)[i] : NULL;
+
+			if (!fmtDesc.dsc_length || !field || field->fld_computation)
+				continue;
+
+			if (column >= rec.values.getCount())
+				continue;
+
+			const DelimitedValue& value = rec.values[column++];
+
+			if (!value.length && !value.quoted)
+				continue;
+
+			if (value.length > MAX_USHORT)
+				ERR_post(Arg::Gds(isc_arith_except) << Arg::Gds(isc_string_truncation));
+
+			dsc from;
+			from.makeText((USHORT) value.length, fmtDesc.isText() ? fmtDesc.getTextType() : ttype_ascii,
+				rec.data.begin() + value.offset);
+
+			dsc to = fmtDesc;
+			to.dsc_address = data + (IPTR) fmtDesc.dsc_address;
+
+			MOV_move(tdbb, &from, &to);
+
+			const LiteralNode* const literal = nodeAs<LiteralNode>(field->fld_missing_value);
+
+			if (literal && !MOV_compare(tdbb, &literal->litDesc, &to))
+				continue;
+
+			data[i >> 3] &= ~(1 << (i & 7));
+		}
+	}
+
+	// Encode the record as a line of delimited text
+
+	void encode_delimited(thread_db* tdbb, const jrd_rel* relation, const Record* record,
+		const ExternalFormat& fmt, HalfStaticArray<UCHAR, BUFFER_MEDIUM>& line)
+	{
+		const Format* const format = record->getFormat();
+		const vec<jrd_fld*>* const fields = relation->rel_fields;
+		const UCHAR quote = fmt.fmt_quote;
+		const UCHAR escape = (fmt.fmt_escape != fmt.fmt_quote) ? fmt.fmt_escape : 0;
+
+		bool first = true;
+
+		for (USHORT i = 0; i < format->fmt_count; ++i)
+		{
+			const dsc& fmtDesc = format->fmt_desc[i];
+			const jrd_fld* const field = (i < fields->count()) ? (*fields)[i] : NULL;
+
+			if (!fmtDesc.dsc_length || !field || field->fld_computation)
+				continue;
+
+			if (!first)
+				line.add(fmt.fmt_delimiter);
+
+			first = false;
+
+			if (record->isNull(i))
+				continue;
+
+			dsc desc = fmtDesc;
+			desc.dsc_address = const_cast<UCHAR*>(record->getData()) + (IPTR) fmtDesc.dsc_address;
+
+			const string value = MOV_make_string2(tdbb, &desc,
+				desc.isText() ? desc.getTextType() : ttype_ascii, false);
+
+			// quote empty string to tell it from NULL
+
+			bool quoted = false;
+
+			if (quote)
+			{
+				quoted = value.isEmpty();
+
+				for (const char* p = value.begin(); !quoted && p < value.end(); ++p)
+				{
+					const UCHAR c = *p;
+					quoted = (c == fmt.fmt_delimiter || c == quote || c == '\r' || c == '\n');
+				}
+			}
+
+			if (quoted)
+				line.add(quote);
+
+			for (const char* p = value.begin(); p < value.end(); ++p)
+			{
+				const UCHAR c = *p;
+
+				if (quoted && c == quote)
+					line.add(quote);
+				else if (escape && (c == escape ||
+					(!quoted && (c == fmt.fmt_delimiter || c == '\r' || c == '\n'))))
+				{
+					line.add(escape);
+				}
+
+				line.add(c);
+			}
+
+			if (quoted)
+				line.add(quote);
+		}
+
+		line.add('\n');
+	}
+
+	// Read delimited file into the cursor buffer starting from the given position
+
+	void fill_buffer(ExternalFile* file, ExternalBatch* batch, FB_UINT64 position, ULONG size)
+	{
+		batch->bat_valid = false;
+
+		UCHAR* const buffer = batch->bat_text.getBuffer(size, false);
+		const ULONG length = ext_read(file, position, buffer, size);
+		batch->bat_text.shrink(length);
+
+		batch->bat_size = size;
+		batch->bat_offset = position;
+		batch->bat_changes = file->ext_changes;
+		batch->bat_eof = (length < size);
+		batch->bat_valid = true;
+	}
+
+	bool get_delimited(thread_db* tdbb, ExternalBatch* batch, record_param* rpb, FB_UINT64& position)
+	{
+		jrd_rel* const relation = rpb->rpb_relation;
+		ExternalFile* const file = relation->rel_file;
+		const ExternalFormat& fmt = file->ext_format;
+		Record* const record = rpb->rpb_record;
+
+		DelimitedRecord rec(*tdbb->getDefaultPool());
+
+		while (true)
+		{
+			if (!batch->bat_valid || batch->bat_changes != file->ext_changes ||
+				position < batch->bat_offset || position > batch->bat_offset + batch->bat_text.getCount())
+			{
+				fill_buffer(file, batch, position, DELIMITED_BUFFER_SIZE);
+			}
+
+			const ULONG skip = (ULONG) (position - batch->bat_offset);
+			const UCHAR* const start = batch->bat_text.begin() + skip;
+			const UCHAR* const end = batch->bat_text.end();
+			const bool eof = batch->bat_eof;
+
+			bool blank;
+			const ULONG length = EXT_parse_delimited(fmt, start, end, eof, &rec, blank);
+
+			if (length == DELIMITED_MALFORMED)
+			{
+				ERR_post(Arg::Gds(isc_ext_format_data) << Arg::Str(file->ext_filename) <<
+														  Arg::Int64(position));
+			}
+
+			if (!length)
+			{
+				if (eof)
+					return false;
+
+				// Record is cut by the buffer end, read it from its start
+				// or grow the buffer if the record doesn't fit it at all
+
+				ULONG size = batch->bat_size;
+
+				if (!skip)
+				{
+					if (size >= DELIMITED_MAX_RECORD)
+					{
+						ERR_post(Arg::Gds(isc_ext_format_data) << Arg::Str(file->ext_filename) <<
+																  Arg::Int64(position));
+					}
+
+					size *= 2;
+				}
+
+				fill_buffer(file, batch, position, size);
+				continue;
+			}
+
+			const bool header = (fmt.fmt_header && !position);
+			position += length;
+
+			if (header || blank)
+				continue;
+
+			decode_delimited(tdbb, relation, record->getFormat(), rec, record->getData());
+			return true;
+		}
+	}
+
+	// Distance between record images decoded ahead, aligned for their fields
+
+	inline ULONG batch_stride(const Format* format)
+	{
+		return FB_ALIGN(format->fmt_length, FB_DOUBLE_ALIGN);
+	}
+
+	// Decode records of delimited file chunk by parallel workers
+
+	class DelimitedScanTask : public Task
+	{
+	public:
+		struct Span
+		{
+			ULONG offset;
+			ULONG length;
+		};
+
+		DelimitedScanTask(thread_db* tdbb, MemoryPool* pool, jrd_rel* relation,
+				const Format* format, ExternalBatch* batch, const Span* spans, ULONG count) :
+			Task(),
+			m_pool(pool),
+			m_dbb(tdbb->getDatabase()),
+			m_relation(relation),
+			m_format(format),
+			m_batch(batch),
+			m_timeZone(tdbb->getAttachment()->att_current_timezone),
+			m_spans(spans),
+			m_count(count),
+			m_next(0),
+			m_items(*m_pool),
+			m_stop(false)
+		{
+			Attachment* const att = tdbb->getAttachment();
+
+			int workers = MIN(att->att_parallel_workers, (int) (count / PARALLEL_RECORDS + 1));
+			if (workers < 1)
+				workers = 1;
+
+			for (int i = 0; i < workers; i++)
+				m_items.add(FB_NEW_POOL(*m_pool) Item(this));
+
+			m_items[0]->m_ownAttach = false;
+			m_items[0]->m_attStable = att->getStable();
+		}
+
+		virtual ~DelimitedScanTask()
+		{
+			for (Item** p = m_items.begin(); p < m_items.end(); p++)
+				delete *p;
+		}
+
+		class Item : public Task::WorkItem
+		{
+		public:
+			Item(DelimitedScanTask* task) : Task::WorkItem(task),
+				m_inuse(false),
+				m_ownAttach(true),
+				m_first(0),
+				m_last(0)
+			{}
+
+			virtual ~Item()
+			{
+				if (!m_ownAttach || !m_attStable)
+					return;
+
+				FbLocalStatus status;
+				WorkerAttachment::releaseAttachment(&status, m_attStable);
+			}
+
+			DelimitedScanTask* getScanTask() const
+			{
+				return reinterpret_cast<DelimitedScanTask*> (m_task);
+			}
+
+			bool init(thread_db* tdbb)
+			{
+				FbStatusVector* status = tdbb->tdbb_status_vector;
+
+				Attachment* att = NULL;
+
+				if (m_ownAttach && !m_attStable.hasData())
+					m_attStable = WorkerAttachment::getAttachment(status, getScanTask()->m_dbb);
+
+				if (m_attStable)
+					att = m_attStable->getHandle();
+
+				if (!att)
+				{
+					Arg::Gds(isc_bad_db_handle).copyTo(status);
+					return false;
+				}
+
+				tdbb->setDatabase(att->att_database);
+				tdbb->setAttachment(att);
+
+				return true;
+			}
+
+			bool m_inuse;
+			bool m_ownAttach;
+			RefPtr<StableAttachmentPart> m_attStable;
+
+			// part of work: range of records to decode
+			ULONG m_first;
+			ULONG m_last;
+		};
+
+		bool handler(WorkItem& _item);
+		bool getWorkItem(WorkItem** pItem);
+
+		bool getResult(IStatus* status)
+		{
+			if (status)
+			{
+				status->init();
+				status->setErrors(m_status.getErrors());
+			}
+
+			return m_status.isSuccess();
+		}
+
+		int getMaxWorkers()
+		{
+			return m_items.getCount();
+		}
+
+	private:
+		void setError(IStatus* status, bool stopTask)
+		{
+			const bool copyStatus = (m_status.isSuccess() && status && status->getState() == IStatus::STATE_ERRORS);
+			if (!copyStatus && (!stopTask || m_stop))
+				return;
+
+			MutexLockGuard guard(m_mutex, FB_FUNCTION);
+			if (m_status.isSuccess() && copyStatus)
+				m_status.save(status);
+			if (stopTask)
+				m_stop = true;
+		}
+
+		MemoryPool* m_pool;
+		Database* m_dbb;
+		jrd_rel* const m_relation;
+		const Format* const m_format;
+		ExternalBatch* const m_batch;
+		const USHORT m_timeZone;		// session time zone of the user attachment
+		const Span* const m_spans;
+		const ULONG m_count;
+		ULONG m_next;
+		Mutex m_mutex;
+		HalfStaticArray<Item*, 8> m_items;
+		StatusHolder m_status;
+		volatile bool m_stop;
+	};
+
+	bool DelimitedScanTask::handler(WorkItem& _item)
+	{
+		Item* item = reinterpret_cast<Item*>(&_item);
+
+		ThreadContextHolder tdbb(NULL);
+
+		if (!item->init(tdbb))
+		{
+			setError(tdbb->tdbb_status_vector, true);
+			return false;
+		}
+
+		WorkerContextHolder wrkHolder(tdbb, FB_FUNCTION);
+
+		// Values depending on the time zone are decoded as in the user session
+		AutoSetRestore<USHORT> autoTimeZone(&tdbb->getAttachment()->att_current_timezone, m_timeZone);
+
+		try
+		{
+			const ExternalFormat& fmt = m_relation->rel_file->ext_format;
+			const UCHAR* const text = m_batch->bat_text.begin();
+			UCHAR* const records = m_batch->bat_records.begin();
+			const ULONG stride = batch_stride(m_format);
+
+			DelimitedRecord rec(*m_pool);
+
+			for (ULONG i = item->m_first; i < item->m_last && !m_stop; i++)
+			{
+				const Span& span = m_spans[i];
+				const UCHAR* const start = text + span.offset;
+
+				bool blank;
+				EXT_parse_delimited(fmt, start, start + span.length, true, &rec, blank);
+				decode_delimited(tdbb, m_relation, m_format, rec, records + i * stride);
+			}
+
+			return !m_stop;
+		}
+		catch (const Exception& ex)
+		{
+			ex.stuffException(tdbb->tdbb_status_vector);
+		}
+
+		setError(tdbb->tdbb_status_vector, true);
+		return false;
+	}
+
+	bool DelimitedScanTask::getWorkItem(WorkItem** pItem)
+	{
+		MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+		Item* item = reinterpret_cast<Item*> (*pItem);
+
+		if (item == NULL)
+		{
+			for (Item** p = m_items.begin(); p < m_items.end(); p++)
+				if (!(*p)->m_inuse)
+				{
+					(*p)->m_inuse = true;
+					*pItem = item = *p;
+					break;
+				}
+		}
+
+		if (!item)
+			return false;
+
+		if (!m_stop && m_next < m_count)
+		{
+			item->m_first = m_next;
+			item->m_last = MIN(m_next + PARALLEL_RECORDS, m_count);
+			m_next = item->m_last;
+			return true;
+		}
+
+		item->m_inuse = false;
+		return false;
+	}
+
+	// Read the next chunk of delimited file and decode its records in parallel.
+	// Returns false if there are no more records in the file.
+
+	bool fetch_batch(thread_db* tdbb, jrd_rel* relation, const Format* format,
+		ExternalBatch* batch, FB_UINT64& position)
+	{
+		Database* const dbb = tdbb->getDatabase();
+		Attachment* const att = tdbb->getAttachment();
+		ExternalFile* const file = relation->rel_file;
+		const ExternalFormat& fmt = file->ext_format;
+
+		batch->bat_count = batch->bat_next = 0;
+
+		HalfStaticArray<DelimitedScanTask::Span, 1024> spans;
+		const FB_UINT64 chunk = (FB_UINT64) PARALLEL_CHUNK_SIZE * att->att_parallel_workers;
+		ULONG size = (ULONG) MIN(chunk, PARALLEL_MAX_CHUNK);
+
+		while (spans.isEmpty() && !batch->bat_eof)
+		{
+			UCHAR* const text = batch->bat_text.getBuffer(size, false);
+			const ULONG length = ext_read(file, position, text, size);
+			const bool eof = (length < size);
+
+			const UCHAR* p = text;
+			const UCHAR* const end = text + length;
+
+			while (p < end)
+			{
+				bool blank;
+				const ULONG n = EXT_parse_delimited(fmt, p, end, eof, NULL, blank);
+
+				if (n == DELIMITED_MALFORMED)
+				{
+					ERR_post(Arg::Gds(isc_ext_format_data) << Arg::Str(file->ext_filename) <<
+															  Arg::Int64(position + (p - text)));
+				}
+
+				if (!n)
+					break;
+
+				if (!blank && !(fmt.fmt_header && !position && p == text))
+				{
+					DelimitedScanTask::Span& span = spans.add();
+					span.offset = p - text;
+					span.length = n;
+				}
+
+				p += n;
+			}
+
+			if (p == text && !eof)
+			{
+				// record doesn't fit the chunk, so it's longer than the chunk
+				// and the chunk should not grow past the longest record
+
+				if (size >= DELIMITED_MAX_RECORD)
+				{
+					ERR_post(Arg::Gds(isc_ext_format_data) << Arg::Str(file->ext_filename) <<
+															  Arg::Int64(position));
+				}
+
+				size *= 2;
+				continue;
+			}
+
+			position += p - text;
+			batch->bat_eof = eof;
+		}
+
+		if (spans.isEmpty())
+			return false;
+
+		batch->bat_records.getBuffer(spans.getCount() * batch_stride(format), false);
+
+		{	// scope
+			EngineCheckout cout(tdbb, FB_FUNCTION);
+
+			Coordinator coord(dbb->dbb_permanent);
+			DelimitedScanTask task(tdbb, dbb->dbb_permanent, relation, format, batch,
+				spans.begin(), spans.getCount());
+
+			FbLocalStatus local_status;
+			local_status->init();
+
+			coord.runSync(&task);
+
+			if (!task.getResult(&local_status))
+				local_status.raise();
+		}
+
+		batch->bat_count = spans.getCount();
+		return true;
+	}
 } // namespace
 
 
+ExternalBatch* EXT_batch(thread_db* tdbb, jrd_rel* relation, MemoryPool& pool)
+{
+/**************************************
+ *
+ *	E X T _ b a t c h
+ *
+ **************************************
+ *
+ * Functional description
+ *	Prepare the cursor state of delimited file
+ *	scan, with parallel decoding of a big file.
+ *	Return NULL if the file has native layout and
+ *	should be read record by record with EXT_get.
+ *
+ **************************************/
+	ExternalFile* const file = relation->rel_file;
+	fb_assert(file->ext_ifi);
+
+	if (!file->ext_format.fmt_delimited || !file->ext_ifi)
+		return NULL;
+
+	bool parallel = (tdbb->getAttachment()->att_parallel_workers > 1 &&
+		ext_file_size(file) >= PARALLEL_MIN_FILE);
+
+	// Workers have no transaction to create blobs in
+
+	if (parallel)
+	{
+		const Format* const format = MET_current(tdbb, relation);
+
+		for (USHORT i = 0; i < format->fmt_count; ++i)
+		{
+			if (DTYPE_IS_BLOB(format->fmt_desc[i].dsc_dtype))
+				parallel = false;
+		}
+	}
+
+	return FB_NEW_POOL(pool) ExternalBatch(pool, parallel);
+}
+
+
+bool EXT_batch_get(thread_db* tdbb, ExternalBatch* batch, record_param* rpb, FB_UINT64& position)
+{
+/**************************************
+ *
+ *	E X T _ b a t c h _ g e t
+ *
+ **************************************
+ *
+ * Functional description
+ *	Get the next record of delimited file, either
+ *	from the cursor read buffer or decoded ahead
+ *	by parallel workers.
+ *
+ **************************************/
+	if (!batch->bat_parallel)
+		return get_delimited(tdbb, batch, rpb, position);
+
+	Record* const record = rpb->rpb_record;
+	const Format* const format = record->getFormat();
+
+	if (batch->bat_next >= batch->bat_count)
+	{
+		if (batch->bat_eof || !fetch_batch(tdbb, rpb->rpb_relation, format, batch, position))
+			return false;
+	}
+
+	memcpy(record->getData(), batch->bat_records.begin() + batch->bat_next * batch_stride(format),
+		format->fmt_length);
+	batch->bat_next++;
+
+	return true;
+}
+
+
 double EXT_cardinality(thread_db* tdbb, jrd_rel* relation)
 {
 /**************************************
@@ -182,17 +846,36 @@ double EXT_cardinality(thread_db* tdbb, jrd_rel* relation)
 			must_close = true;
 		}
 
-		FB_UINT64 file_size = 0;
+		const FB_UINT64 file_size = ext_file_size(file);
 
-#ifdef WIN_NT
-		struct __stat64 statistics;
-		if (!_fstat64(_fileno(file->ext_ifi), &statistics))
-#else
-		struct STAT statistics;
-		if (!os_utils::fstat(fileno(file->ext_ifi), &statistics))
-#endif
+		// Estimate the number of delimited records from the average length
+		// of records met in the beginning of the file
+
+		ULONG sample_length = 0, sample_records = 0;
+
+		if (file->ext_format.fmt_delimited && file_size)
 		{
-			file_size = statistics.st_size;
+			HalfStaticArray<UCHAR, BUFFER_MEDIUM> sample;
+			const ULONG length = ext_read(file, 0, sample.getBuffer(CARDINALITY_SAMPLE), CARDINALITY_SAMPLE);
+			const bool eof = (length < CARDINALITY_SAMPLE);
+
+			const UCHAR* p = sample.begin();
+			const UCHAR* const end = p + length;
+
+			while (p < end)
+			{
+				bool blank;
+				const ULONG n = EXT_parse_delimited(file->ext_format, p, end, eof, NULL, blank);
+
+				if (!n || n == DELIMITED_MALFORMED)
+					break;
+
+				if (!blank)
+					sample_records++;
+
+				p += n;
+				sample_length += n;
+			}
 		}
 
 		if (must_close)
@@ -201,6 +884,19 @@ double EXT_cardinality(thread_db* tdbb, jrd_rel* relation)
 			file->ext_ifi = NULL;
 		}
 
+		if (file->ext_format.fmt_delimited)
+		{
+			if (!sample_records)
+				return file_size ? 1 : 0;
+
+			double records = (double) file_size * sample_records / sample_length;
+
+			if (file->ext_format.fmt_header)
+				records -= 1;
+
+			return MAX(records, 1);
+		}
+
 		const Format* const format = MET_current(tdbb, relation);
 		fb_assert(format && format->fmt_length);
 		const USHORT offset = (USHORT)(IPTR) format->fmt_desc[0].dsc_address;
@@ -234,8 +930,7 @@ void EXT_erase(record_param*, jrd_tra*)
 }
 
 
-// Third param is unused.
-ExternalFile* EXT_file(jrd_rel* relation, const TEXT* file_name) //, bid* description)
+ExternalFile* EXT_file(jrd_rel* relation, const TEXT* file_name, const TEXT* format)
 {
 /**************************************
  *
@@ -245,6 +940,8 @@ ExternalFile* EXT_file(jrd_rel* relation, const TEXT* file_name) //, bid* descri
  *
  * Functional description
  *	Create a file block for external file access.
+ *	Format is the record layout specification
+ *	stored in RDB$EXTERNAL_DESCRIPTION.
  *
  **************************************/
 	Database* dbb = GET_DBB();
@@ -309,6 +1006,9 @@ ExternalFile* EXT_file(jrd_rel* relation, const TEXT* file_name) //, bid* descri
 	strcpy(file->ext_filename, file_name);
 	file->ext_flags = 0;
 	file->ext_ifi = NULL;
+	file->ext_changes = 0;
+
+	EXT_format(&file->ext_format, format);
 
 	return file;
 }
@@ -335,6 +1035,8 @@ void EXT_fini(jrd_rel* relation, bool close_only)
 			file->ext_ifi = NULL;
 		}
 
+		file->ext_changes++;
+
 		// before zeroing out the rel_file we need to deallocate the memory
 		if (!close_only)
 		{
@@ -345,6 +1047,141 @@ void EXT_fini(jrd_rel* relation, bool close_only)
 }
 
 
+void EXT_format(ExternalFormat* format, const TEXT* spec)
+{
+/**************************************
+ *
+ *	E X T _ f o r m a t
+ *
+ **************************************
+ *
+ * Functional description
+ *	Parse the record layout of external file:
+ *
+ *	  FIXED | { DELIMITED | CSV | TSV } [ HEADER ]
+ *	    [ DELIMITER=<char> ] [ QUOTE=<char> ] [ ESCAPE=<char> ]
+ *
+ *	where <char> is a single character, TAB, SPACE
+ *	or NONE (for QUOTE and ESCAPE). ESCAPE defaults
+ *	to QUOTE. Empty specification means native
+ *	fixed-length records.
+ *
+ **************************************/
+	format->fmt_delimited = false;
+	format->fmt_header = false;
+	format->fmt_delimiter = ',';
+	format->fmt_quote = '"';
+	format->fmt_escape = '"';
+
+	if (!spec)
+		return;
+
+	bool first = true, escaped = false;
+	const char* p = spec;
+
+	while (true)
+	{
+		while (*p && isspace((UCHAR) *p))
+			p++;
+
+		if (!*p)
+			break;
+
+		const char* const start = p;
+		while (*p && !isspace((UCHAR) *p))
+			p++;
+
+		const string token(start, p - start);
+		string name(token), value;
+
+		const FB_SIZE_T pos = token.find('=');
+		if (pos != string::npos)
+		{
+			name = token.substr(0, pos);
+			value = token.substr(pos + 1);
+		}
+
+		name.upper();
+
+		if (first)
+		{
+			first = false;
+
+			if (name == "FIXED" && value.isEmpty())
+				continue;
+
+			if ((name == "DELIMITED" || name == "CSV") && value.isEmpty())
+			{
+				format->fmt_delimited = true;
+				continue;
+			}
+
+			if (name == "TSV" && value.isEmpty())
+			{
+				format->fmt_delimited = true;
+				format->fmt_delimiter = '\t';
+				continue;
+			}
+		}
+		else if (format->fmt_delimited)
+		{
+			if (name == "HEADER" && value.isEmpty())
+			{
+				format->fmt_header = true;
+				continue;
+			}
+
+			UCHAR* target = NULL;
+
+			if (name == "DELIMITER")
+				target = &format->fmt_delimiter;
+			else if (name == "QUOTE")
+				target = &format->fmt_quote;
+			else if (name == "ESCAPE")
+				target = &format->fmt_escape;
+
+			if (target)
+			{
+				string upper(value);
+				upper.upper();
+
+				if (value.length() == 1)
+					*target = value[0];
+				else if (upper == "TAB")
+					*target = '\t';
+				else if (upper == "SPACE")
+					*target = ' ';
+				else if (upper == "NONE" && target != &format->fmt_delimiter)
+					*target = 0;
+				else
+					target = NULL;
+			}
+
+			if (target && *target != '\r' && *target != '\n')
+			{
+				escaped = escaped || (target == &format->fmt_escape);
+				continue;
+			}
+		}
+
+		ERR_post(Arg::Gds(isc_ext_format_err) << Arg::Str(token));
+	}
+
+	// Without explicit ESCAPE only quote is doubled, QUOTE=NONE disables both
+
+	if (!escaped)
+		format->fmt_escape = format->fmt_quote;
+
+	// Delimiter should not be confused with quote or escape
+
+	if (format->fmt_delimited &&
+		(format->fmt_delimiter == format->fmt_quote || format->fmt_delimiter == format->fmt_escape))
+	{
+		ERR_post(Arg::Gds(isc_ext_format_err) << Arg::Str(spec));
+	}
+}
+
+
 bool EXT_get(thread_db* tdbb, record_param* rpb, FB_UINT64& position)
 {
 /**************************************
@@ -361,6 +1198,13 @@ bool EXT_get(thread_db* tdbb, record_param* rpb, FB_UINT64& position)
 	ExternalFile* const file = relation->rel_file;
 	fb_assert(file->ext_ifi);
 
+	if (file->ext_format.fmt_delimited && file->ext_ifi)
+	{
+		// delimited file is read through the cursor state, see EXT_batch
+		fb_assert(false);
+		return false;
+	}
+
 	Record* const record = rpb->rpb_record;
 	const Format* const format = record->getFormat();
 
@@ -484,6 +1328,130 @@ void EXT_open(Database* dbb, ExternalFile* file)
 }
 
 
+ULONG EXT_parse_delimited(const ExternalFormat& fmt, const UCHAR* const start, const UCHAR* const end,
+	bool eof, DelimitedRecord* rec, bool& blank)
+{
+/**************************************
+ *
+ *	E X T _ p a r s e _ d e l i m i t e d
+ *
+ **************************************
+ *
+ * Functional description
+ *	Parse one delimited record starting at start.
+ *	Return the number of bytes it takes including
+ *	the terminator, zero if the record is not
+ *	complete and more text may follow, or
+ *	DELIMITED_MALFORMED. Values are collected into
+ *	rec unless it's NULL. Blank is set for an
+ *	empty line.
+ *
+ **************************************/
+	const UCHAR delimiter = fmt.fmt_delimiter;
+	const UCHAR quote = fmt.fmt_quote;
+	const UCHAR escape = (fmt.fmt_escape != fmt.fmt_quote) ? fmt.fmt_escape : 0;
+
+	if (rec)
+	{
+		rec->data.clear();
+		rec->values.clear();
+	}
+
+	DelimitedValue value = {0, 0, false};
+	bool inQuotes = false;
+	blank = true;
+
+	const UCHAR* p = start;
+
+	while (p < end)
+	{
+		UCHAR c = *p++;
+
+		if (inQuotes && c == quote)
+		{
+			// doubled quote stands for itself
+
+			if (p == end && !eof)
+				return 0;
+
+			if (p == end || *p != quote)
+			{
+				inQuotes = false;
+				continue;
+			}
+
+			p++;
+		}
+		else if (escape && c == escape)
+		{
+			if (p == end)
+				return eof ? DELIMITED_MALFORMED : 0;
+
+			c = *p++;
+			blank = false;
+		}
+		else if (!inQuotes)
+		{
+			if (c == delimiter)
+			{
+				if (rec)
+				{
+					rec->values.add(value);
+					value.offset = rec->data.getCount();
+				}
+
+				value.length = 0;
+				value.quoted = false;
+				blank = false;
+				continue;
+			}
+
+			if (c == '\r' || c == '\n')
+			{
+				if (c == '\r')
+				{
+					if (p == end && !eof)
+						return 0;
+
+					if (p < end && *p == '\n')
+						p++;
+				}
+
+				if (rec && !blank)
+					rec->values.add(value);
+
+				return p - start;
+			}
+
+			if (quote && c == quote && !value.length && !value.quoted)
+			{
+				inQuotes = value.quoted = true;
+				blank = false;
+				continue;
+			}
+
+			blank = false;
+		}
+
+		if (rec)
+			rec->data.add(c);
+
+		value.length++;
+	}
+
+	if (!eof)
+		return 0;
+
+	if (inQuotes)
+		return DELIMITED_MALFORMED;
+
+	if (rec && !blank)
+		rec->values.add(value);
+
+	return p - start;
+}
+
+
 void EXT_store(thread_db* tdbb, record_param* rpb)
 {
 /**************************************
@@ -505,8 +1473,6 @@ void EXT_store(thread_db* tdbb, record_param* rpb)
 		ext_fopen(tdbb->getDatabase(), file);
 	}
 
-	// Loop thru fields setting missing fields to either blanks/zeros or the missing value
-
 	// check if file is read only if read only then post error we cannot write to this file
 	if (file->ext_flags & EXT_readonly)
 	{
@@ -523,35 +1489,55 @@ void EXT_store(thread_db* tdbb, record_param* rpb)
 		}
 	}
 
-	dsc desc;
-	vec<jrd_fld*>::iterator field_ptr = relation->rel_fields->begin();
-	Format::fmt_desc_const_iterator desc_ptr = format->fmt_desc.begin();
+	HalfStaticArray<UCHAR, BUFFER_MEDIUM> line;
+	const UCHAR* p;
+	ULONG l;
 
-	for (USHORT i = 0; i < format->fmt_count; ++i, ++field_ptr, ++desc_ptr)
+	if (file->ext_format.fmt_delimited)
 	{
-		const jrd_fld* field = *field_ptr;
-		if (field && !field->fld_computation && desc_ptr->dsc_length && record->isNull(i))
-		{
-			UCHAR* p = record->getData() + (IPTR) desc_ptr->dsc_address;
-			LiteralNode* literal = nodeAs<LiteralNode>(field->fld_missing_value);
+		// NULLs are stored as empty values, thus missing values are not applied
 
-			if (literal)
-			{
-				desc = *desc_ptr;
-				desc.dsc_address = p;
-				MOV_move(tdbb, &literal->litDesc, &desc);
-			}
-			else
+		encode_delimited(tdbb, relation, record, file->ext_format, line);
+		p = line.begin();
+		l = line.getCount();
+
+		// file grows, don't trust the cached end of it
+		file->ext_changes++;
+	}
+	else
+	{
+		// Loop thru fields setting missing fields to either blanks/zeros or the missing value
+
+		dsc desc;
+		vec<jrd_fld*>::iterator field_ptr = relation->rel_fields->begin();
+		Format::fmt_desc_const_iterator desc_ptr = format->fmt_desc.begin();
+
+		for (USHORT i = 0; i < format->fmt_count; ++i, ++field_ptr, ++desc_ptr)
+		{
+			const jrd_fld* field = *field_ptr;
+			if (field && !field->fld_computation && desc_ptr->dsc_length && record->isNull(i))
 			{
-				const UCHAR pad = (desc_ptr->dsc_dtype == dtype_text) ? ' ' : 0;
-				memset(p, pad, desc_ptr->dsc_length);
+				UCHAR* const data = record->getData() + (IPTR) desc_ptr->dsc_address;
+				LiteralNode* literal = nodeAs<LiteralNode>(field->fld_missing_value);
+
+				if (literal)
+				{
+					desc = *desc_ptr;
+					desc.dsc_address = data;
+					MOV_move(tdbb, &literal->litDesc, &desc);
+				}
+				else
+				{
+					const UCHAR pad = (desc_ptr->dsc_dtype == dtype_text) ? ' ' : 0;
+					memset(data, pad, desc_ptr->dsc_length);
+				}
 			}
 		}
-	}
 
-	const USHORT offset = (USHORT) (IPTR) format->fmt_desc[0].dsc_address;
-	const UCHAR* p = record->getData() + offset;
-	const ULONG l = record->getLength() - offset;
+		const USHORT offset = (USHORT) (IPTR) format->fmt_desc[0].dsc_address;
+		p = record->getData() + offset;
+		l = record->getLength() - offset;
+	}
 
 	// hvlad: fseek will flush file buffer and degrade performance, so don't
 	// call it if it is not necessary.	Note that we must flush file buffer if we
@@ -614,5 +1600,8 @@ void EXT_tra_detach(ExternalFile* file, jrd_tra*)
 	{
 		fclose(file->ext_ifi);
 		file->ext_ifi = NULL;
+
+		// file could be changed before it's opened again
+		file->ext_changes++;
 	}
 }
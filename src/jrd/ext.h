@@ -25,9 +25,42 @@
 #define JRD_EXT_H
 
 #include <stdio.h>
+#include "../common/classes/array.h"
 
 namespace Jrd {
 
+// Layout of records in the external file, see EXT_format
+
+struct ExternalFormat
+{
+	bool	fmt_delimited;		// delimited text instead of native fixed-length records
+	bool	fmt_header;			// first record contains column names and is skipped
+	UCHAR	fmt_delimiter;		// field delimiter
+	UCHAR	fmt_quote;			// quote character, zero if values are never quoted
+	UCHAR	fmt_escape;			// escape character, zero if none
+};
+
+// Field value of a delimited record, unquoted into DelimitedRecord::data
+
+struct DelimitedValue
+{
+	ULONG offset;
+	ULONG length;
+	bool quoted;
+};
+
+struct DelimitedRecord
+{
+	explicit DelimitedRecord(MemoryPool& p)
+		: data(p), values(p)
+	{}
+
+	Firebird::HalfStaticArray<UCHAR, BUFFER_MEDIUM> data;
+	Firebird::HalfStaticArray<DelimitedValue, 32> values;
+};
+
+const ULONG DELIMITED_MALFORMED = MAX_ULONG;	// EXT_parse_delimited() result for a broken record
+
 // External file access block
 
 class ExternalFile : public pool_alloc_rpt<SCHAR, type_ext>
@@ -36,6 +69,8 @@ public:
 	USHORT	ext_flags;			// Misc and cruddy flags
 	USHORT	ext_tra_cnt;		// How many transactions used the file
 	FILE*	ext_ifi;			// Internal file identifier
+	ExternalFormat ext_format;	// Record layout
+	ULONG	ext_changes;		// Bumped when the file is written or closed, invalidates read buffers
 	char	ext_filename[1];
 };
 
@@ -43,6 +78,29 @@ const int EXT_readonly		= 1;	// File could only be opened for read
 const int EXT_last_read		= 2;	// last operation was read
 const int EXT_last_write	= 4;	// last operation was write
 
+// Per-cursor state of delimited file scan: the read buffer, or records
+// decoded ahead of the scan by parallel workers
+
+class ExternalBatch : public pool_alloc<type_ext>
+{
+public:
+	ExternalBatch(MemoryPool& p, bool parallel)
+		: bat_text(p), bat_records(p), bat_count(0), bat_next(0), bat_eof(false),
+		  bat_parallel(parallel), bat_valid(false), bat_size(0), bat_offset(0), bat_changes(0)
+	{}
+
+	Firebird::Array<UCHAR> bat_text;		// raw text of the read buffer or current chunk
+	Firebird::Array<UCHAR> bat_records;		// decoded record images
+	ULONG	bat_count;			// number of decoded records
+	ULONG	bat_next;			// next record to return
+	bool	bat_eof;			// text ends at the end of file
+	const bool bat_parallel;	// records are decoded by parallel workers
+	bool	bat_valid;			// read buffer is valid
+	ULONG	bat_size;			// requested size of read buffer
+	FB_UINT64 bat_offset;		// file offset of read buffer
+	ULONG	bat_changes;		// ext_changes of the file when the buffer was read
+};
+
 } //namespace Jrd
 
 #endif // JRD_EXT_H
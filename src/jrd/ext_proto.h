@@ -25,7 +25,10 @@
 #define JRD_EXT_PROTO_H
 
 namespace Jrd {
+	class ExternalBatch;
 	class ExternalFile;
+	struct ExternalFormat;
+	struct DelimitedRecord;
 	class jrd_tra;
 	class RecordSource;
 	class jrd_rel;
@@ -33,14 +36,19 @@ namespace Jrd {
 	struct bid;
 }
 
+Jrd::ExternalBatch*	EXT_batch(Jrd::thread_db*, Jrd::jrd_rel*, MemoryPool&);
+bool	EXT_batch_get(Jrd::thread_db*, Jrd::ExternalBatch*, Jrd::record_param*, FB_UINT64&);
 double	EXT_cardinality(Jrd::thread_db*, Jrd::jrd_rel*);
 void	EXT_erase(Jrd::record_param*, Jrd::jrd_tra*);
-Jrd::ExternalFile*	EXT_file(Jrd::jrd_rel*, const TEXT*); //, Jrd::bid*);
+Jrd::ExternalFile*	EXT_file(Jrd::jrd_rel*, const TEXT*, const TEXT*);
 void	EXT_fini(Jrd::jrd_rel*, bool);
+void	EXT_format(Jrd::ExternalFormat*, const TEXT*);
 bool	EXT_get(Jrd::thread_db*, Jrd::record_param*, FB_UINT64&);
 void	EXT_modify(Jrd::record_param*, Jrd::record_param*, Jrd::jrd_tra*);
 
 void	EXT_open(Jrd::Database*, Jrd::ExternalFile*);
+ULONG	EXT_parse_delimited(const Jrd::ExternalFormat&, const UCHAR*, const UCHAR*, bool,
+	Jrd::DelimitedRecord*, bool&);
 void	EXT_store(Jrd::thread_db*, Jrd::record_param*);
 
 void EXT_tra_attach(Jrd::ExternalFile*, Jrd::jrd_tra*);
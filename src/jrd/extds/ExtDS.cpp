@@ -1710,7 +1710,8 @@ Statement::Statement(Connection& conn) :
 	m_in_buffer(getPool()),
 	m_out_buffer(getPool()),
 	m_inDescs(getPool()),
-	m_outDescs(getPool())
+	m_outDescs(getPool()),
+	m_async(NULL)
 {
 }
 
@@ -1835,6 +1836,8 @@ void Statement::close(thread_db* tdbb, bool invalidTran)
 	// we must stuff exception if and only if this is the first time it occurs
 	// once we stuff exception we must punt
 
+	stopAsync(tdbb);
+
 	const bool wasError = m_error;
 	bool doPunt = false;
 
@@ -1908,6 +1911,8 @@ void Statement::close(thread_db* tdbb, bool invalidTran)
 
 void Statement::deallocate(thread_db* tdbb)
 {
+	stopAsync(tdbb);
+
 	if (isAllocated())
 	{
 		try {
@@ -1922,6 +1927,264 @@ void Statement::deallocate(thread_db* tdbb)
 	fb_assert(!isAllocated());
 }
 
+void Statement::openAsync(thread_db* tdbb, Transaction* tran,
+	const MetaName* const* in_names, const ValueListNode* in_params, const ParamNumbers* in_excess,
+	AsyncEvent* event)
+{
+	fb_assert(isAllocated());
+	fb_assert(!m_error);
+	fb_assert(!m_active && !m_async);
+
+	// The background thread can't enter the engine on behalf of the current attachment
+	fb_assert(!m_connection.isCurrent());
+
+	m_singleton = false;
+	m_transaction = tran;
+
+	setInParams(tdbb, in_names, in_params, in_excess);
+
+	m_active = m_stmt_selectable;
+	m_fetched = false;
+	m_async = FB_NEW_POOL(getPool()) AsyncFetch(getPool(), event);
+	event->addConnection(&m_connection);
+
+	try
+	{
+		Thread::start(asyncThread, this, THREAD_medium, &m_async->thread);
+	}
+	catch (const Exception&)
+	{
+		event->removeConnection(&m_connection);
+		delete m_async;
+		m_async = NULL;
+		m_active = false;
+		throw;
+	}
+}
+
+Statement::AsyncResult Statement::fetchAsync(thread_db* tdbb, const ValueListNode* out_params)
+{
+	fb_assert(m_async);
+
+	{	// scope
+		MutexLockGuard guard(m_async->mutex, FB_FUNCTION);
+
+		if (m_async->rows.hasData())
+		{
+			if (m_async->rows.getCount() == ASYNC_PREFETCH_ROWS)
+				m_async->space.release();
+
+			m_async->current = m_async->rows[0];
+			m_async->rows.remove((FB_SIZE_T) 0);
+		}
+		else if (!m_async->finished)
+			return asyncWait;
+		else
+		{
+			guard.release();
+
+			if (m_async->thread)
+			{
+				Thread::waitForCompletion(m_async->thread);
+				m_async->thread = 0;
+			}
+
+			if (!m_async->status.isSuccess())
+			{
+				m_error = true;
+				m_async->status.raise();
+			}
+
+			return asyncEnd;
+		}
+	}
+
+	m_fetched = true;
+	getOutParams(tdbb, out_params);
+
+	return asyncRow;
+}
+
+THREAD_ENTRY_DECLARE Statement::asyncThread(THREAD_ENTRY_PARAM arg)
+{
+	static_cast<Statement*>(arg)->asyncRun();
+	return 0;
+}
+
+// Execute the statement and prefetch its rows. No attachment is set here,
+// so the provider calls leave nothing but the connection mutex. They are
+// cancelled through the connections registered in the event.
+void Statement::asyncRun()
+{
+	AsyncFetch* const async = m_async;
+	FbLocalStatus status;
+
+	try
+	{
+		ThreadContextHolder tdbb(&status);
+
+		if (!m_stmt_selectable)
+		{
+			doExecute(tdbb);
+
+			// outputs of an executable statement make a single row
+			if (m_outputs)
+			{
+				{	// scope
+					MutexLockGuard guard(async->mutex, FB_FUNCTION);
+					async->rows.add(m_out_buffer);
+				}
+
+				async->event->post(this);
+			}
+		}
+		else
+		{
+			doOpen(tdbb);
+
+			while (true)
+			{
+				bool full;
+				{	// scope
+					MutexLockGuard guard(async->mutex, FB_FUNCTION);
+
+					if (async->stop)
+						break;
+
+					full = (async->rows.getCount() >= ASYNC_PREFETCH_ROWS);
+				}
+
+				if (full)
+				{
+					async->space.enter();
+					continue;
+				}
+
+				if (!doFetch(tdbb))
+					break;
+
+				{	// scope
+					MutexLockGuard guard(async->mutex, FB_FUNCTION);
+					async->rows.add(m_out_buffer);
+				}
+
+				async->event->post(this);
+			}
+		}
+	}
+	catch (const Exception& ex)
+	{
+		ex.stuffException(&status);
+
+		MutexLockGuard guard(async->mutex, FB_FUNCTION);
+		async->status.save(&status);
+	}
+
+	{	// scope
+		MutexLockGuard guard(async->mutex, FB_FUNCTION);
+		async->finished = true;
+	}
+
+	async->event->post(this);
+}
+
+// Make the background thread finish and wait for it
+void Statement::stopAsync(thread_db* tdbb)
+{
+	if (!m_async)
+		return;
+
+	if (m_async->thread)
+	{
+		bool finished;
+		{	// scope
+			MutexLockGuard guard(m_async->mutex, FB_FUNCTION);
+			m_async->stop = true;
+			finished = m_async->finished;
+		}
+
+		m_async->space.release();
+
+		// Thread may be inside a long provider call, cancel it. The error is
+		// saved by the thread and ignored here.
+		if (!finished && m_connection.isConnected())
+			m_connection.cancelExecution(false);
+
+		EngineCheckout cout(tdbb, FB_FUNCTION, EngineCheckout::UNNECESSARY);
+		Thread::waitForCompletion(m_async->thread);
+	}
+
+	m_async->event->removeConnection(&m_connection);
+
+	delete m_async;
+	m_async = NULL;
+}
+
+
+void AsyncEvent::wait(thread_db* tdbb)
+{
+	// While the request waits here, cancellation of the attachment
+	// should reach the remote calls made by background threads
+	Attachment* const att = tdbb->getAttachment();
+	AsyncEvent* const saveAsync = att->att_ext_async;
+	att->att_ext_async = this;
+
+	{	// scope
+		EngineCheckout cout(tdbb, FB_FUNCTION);
+		m_sem.tryEnter(1);
+	}
+
+	att->att_ext_async = saveAsync;
+}
+
+void AsyncEvent::post(Statement* stmt)
+{
+	{	// scope
+		MutexLockGuard guard(m_mutex, FB_FUNCTION);
+		m_ready.add(stmt);
+	}
+
+	m_sem.release();
+}
+
+Statement* AsyncEvent::getReady()
+{
+	MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+	if (m_ready.isEmpty())
+		return NULL;
+
+	Statement* const stmt = m_ready[0];
+	m_ready.remove((FB_SIZE_T) 0);
+	return stmt;
+}
+
+void AsyncEvent::addConnection(Connection* conn)
+{
+	MutexLockGuard guard(m_mutex, FB_FUNCTION);
+	m_connections.add(conn);
+}
+
+void AsyncEvent::removeConnection(Connection* conn)
+{
+	MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+	FB_SIZE_T pos;
+	if (m_connections.find(conn, pos))
+		m_connections.remove(pos);
+}
+
+void AsyncEvent::cancel(bool forced)
+{
+	MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+	for (Connection** conn = m_connections.begin(); conn != m_connections.end(); ++conn)
+	{
+		if ((*conn)->isConnected())
+			(*conn)->cancelExecution(forced);
+	}
+}
+
 
 enum TokenType {ttNone, ttWhite, ttComment, ttBrokenComment, ttString, ttParamMark, ttIdent, ttOther};
 
@@ -2322,6 +2585,9 @@ void Statement::getOutParams(thread_db* tdbb, const ValueListNode* params)
 
 	const NestConst<ValueExprNode>* jrdVar = params->items.begin();
 
+	// Rows prefetched asynchronously are kept apart of the output buffer
+	UCHAR* const row = m_async ? m_async->current.begin() : m_out_buffer.begin();
+
 	for (FB_SIZE_T i = 0; i < count; ++i, ++jrdVar)
 	{
 		/*
@@ -2335,8 +2601,10 @@ void Statement::getOutParams(thread_db* tdbb, const ValueListNode* params)
 		*/
 
 		// build the src descriptor
-		dsc& src = m_outDescs[i * 2];
-		const dsc& null = m_outDescs[i * 2 + 1];
+		dsc src = m_outDescs[i * 2];
+		dsc null = m_outDescs[i * 2 + 1];
+		src.dsc_address = row + (src.dsc_address - m_out_buffer.begin());
+		null.dsc_address = row + (null.dsc_address - m_out_buffer.begin());
 		dsc* local = &src;
 		dsc localDsc;
 		bid localBlobID;
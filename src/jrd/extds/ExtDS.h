@@ -28,6 +28,10 @@
 #include "../../common/classes/objects_array.h"
 #include "../../common/classes/ClumpletWriter.h"
 #include "../../common/classes/locks.h"
+#include "../../common/classes/RefCounted.h"
+#include "../../common/classes/semaphore.h"
+#include "../../common/StatusHolder.h"
+#include "../../common/ThreadStart.h"
 #include "../../common/utils_proto.h"
 
 
@@ -578,6 +582,39 @@ protected:
 };
 
 
+class Statement;
+
+// Signalled by the background threads of statements executed asynchronously.
+// Shared by all statements of one EXECUTE STATEMENT with several data sources.
+// Keeps statements in the order their rows arrive.
+class AsyncEvent : public Firebird::RefCounted, public Firebird::GlobalStorage
+{
+public:
+	AsyncEvent()
+		: m_ready(getPool()), m_connections(getPool())
+	{}
+
+	// Wait until some statement has a row ready or is finished
+	void wait(Jrd::thread_db* tdbb);
+
+	// Statement has a row ready or is finished
+	void post(Statement* stmt);
+
+	// Statement to fetch from next, NULL if nothing arrived yet
+	Statement* getReady();
+
+	// Connections executing the statements, cancelled on behalf of the attachment
+	void addConnection(Connection* conn);
+	void removeConnection(Connection* conn);
+	void cancel(bool forced);
+
+private:
+	Firebird::Mutex m_mutex;
+	Firebird::Semaphore m_sem;
+	Firebird::Array<Statement*> m_ready;
+	Firebird::HalfStaticArray<Connection*, 8> m_connections;
+};
+
 typedef Firebird::Array<const Jrd::MetaName*> ParamNames;
 typedef Firebird::Array<USHORT> ParamNumbers;
 
@@ -611,6 +648,26 @@ public:
 	void close(Jrd::thread_db* tdbb, bool invalidTran = false);
 	void deallocate(Jrd::thread_db* tdbb);
 
+	// Asynchronous execution: input parameters are set by the caller, then
+	// the statement is executed and its rows are prefetched by a background
+	// thread which posts the event when a row is ready or it's finished.
+	// fetchAsync() is called once for every post of the statement.
+	enum AsyncResult
+	{
+		asyncWait,		// nothing is ready yet, wait for the event
+		asyncRow,		// a row is assigned to the output parameters
+		asyncEnd		// all rows are fetched or the statement is executed
+	};
+
+	void openAsync(Jrd::thread_db* tdbb, Transaction* tran,
+		const Jrd::MetaName* const* in_names, const Jrd::ValueListNode* in_params,
+		const ParamNumbers* in_excess, AsyncEvent* event);
+	AsyncResult fetchAsync(Jrd::thread_db* tdbb, const Jrd::ValueListNode* out_params);
+
+	bool isAsync() const { return m_async != NULL; }
+
+	AsyncEvent* getAsyncEvent() const { return m_async ? m_async->event.getPtr() : NULL; }
+
 	const Firebird::string& getSql() const { return m_sql; }
 
 	void setCallerPrivileges(bool use) { m_callerPrivileges = use; }
@@ -659,6 +716,32 @@ protected:
 	void preprocess(const Firebird::string& sql, Firebird::string& ret);
 	void clearNames();
 
+	// State of the asynchronous execution, see openAsync()
+	class AsyncFetch
+	{
+	public:
+		AsyncFetch(MemoryPool& pool, AsyncEvent* aEvent)
+			: event(aEvent), rows(pool), current(pool), thread(0), finished(false), stop(false)
+		{}
+
+		Firebird::RefPtr<AsyncEvent> event;
+		Firebird::Mutex mutex;
+		Firebird::Semaphore space;		// posted when the full queue gets a free place
+		Firebird::ObjectsArray<Firebird::UCharBuffer> rows;	// prefetched rows
+		Firebird::UCharBuffer current;	// row assigned to the output parameters
+		Firebird::StatusHolder status;	// error of the background thread
+		Thread::Handle thread;
+		bool finished;
+		bool stop;
+	};
+
+	// Max number of rows prefetched by the background thread
+	static const FB_SIZE_T ASYNC_PREFETCH_ROWS = 256;
+
+	static THREAD_ENTRY_DECLARE asyncThread(THREAD_ENTRY_PARAM arg);
+	void asyncRun();
+	void stopAsync(Jrd::thread_db* tdbb);
+
 
 	Provider	&m_provider;
 	Connection	&m_connection;
@@ -704,6 +787,9 @@ protected:
 	Firebird::UCharBuffer m_out_buffer;
 	Firebird::Array<dsc> m_inDescs;
 	Firebird::Array<dsc> m_outDescs;
+
+	// set in openAsync()
+	AsyncFetch* m_async;
 };
 
 
@@ -109,6 +109,11 @@ public:
 		return nullptr;
 	}
 
+	const char* getTarget() override
+	{
+		return nullptr;
+	}
+
 private:
 	const string& login;
 	const string& password;
@@ -1820,6 +1820,7 @@ JAttachment* JProvider::internalAttach(CheckStatusWrapper* user_status, const ch
 				dbb->dbb_backup_manager->initializeAlloc(tdbb);
 				dbb->dbb_crypto_manager = FB_NEW_POOL(*dbb->dbb_permanent) CryptoManager(tdbb);
 				dbb->dbb_monitoring_data = FB_NEW_POOL(*dbb->dbb_permanent) MonitoringData(dbb);
+				dbb->dbb_stmt_stats = FB_NEW_POOL(*dbb->dbb_permanent) StatementStats(*dbb->dbb_permanent);
 
 				PAG_init2(tdbb, 0);
 				PAG_header(tdbb, false);
@@ -3055,6 +3056,7 @@ JAttachment* JProvider::createDatabase(CheckStatusWrapper* user_status, const ch
 			dbb->dbb_backup_manager->dbCreating = true;
 			dbb->dbb_crypto_manager = FB_NEW_POOL(*dbb->dbb_permanent) CryptoManager(tdbb);
 			dbb->dbb_monitoring_data = FB_NEW_POOL(*dbb->dbb_permanent) MonitoringData(dbb);
+			dbb->dbb_stmt_stats = FB_NEW_POOL(*dbb->dbb_permanent) StatementStats(*dbb->dbb_permanent);
 
 			PAG_format_header(tdbb);
 			INI_init2(tdbb);
@@ -3502,6 +3504,10 @@ void JAttachment::internalDropDatabase(CheckStatusWrapper* user_status)
 					err = drop_files(shadow->sdw_file) || err;
 				}
 
+				// nbackup change map, if any
+				const PathName mapName(dbb->dbb_filename + Ods::CHANGE_MAP_SUFFIX);
+				unlink(mapName.c_str());
+
 				tdbb->setDatabase(NULL);
 				Database::destroy(dbb);
 
@@ -466,3 +466,18 @@ NAME("MON$COMPILED_STATEMENT_ID", nam_mon_cmp_stmt_id)
 NAME("RDB$SHORT_DESCRIPTION", nam_short_description)
 NAME("RDB$SECONDS_INTERVAL", nam_seconds_interval)
 NAME("RDB$PROFILE_SESSION_ID", nam_prof_ses_id)
+
+NAME("RDB$STATEMENT_STATISTICS", nam_stmt_stats)
+NAME("RDB$STATEMENT_HASH", nam_stmt_hash)
+NAME("RDB$SQL_TEXT", nam_sql_text)
+NAME("RDB$EXECUTIONS", nam_executions)
+NAME("RDB$TOTAL_TIME", nam_total_time)
+NAME("RDB$MAX_TIME", nam_max_time)
+NAME("RDB$PAGE_FETCHES", nam_page_fetches)
+NAME("RDB$PAGE_READS", nam_page_reads)
+NAME("RDB$PAGE_WRITES", nam_page_writes)
+NAME("RDB$RECORDS", nam_records)
+NAME("RDB$SORTS", nam_sorts)
+NAME("RDB$SORT_SPILLS", nam_sort_spills)
+
+NAME("MON$GC_BACKLOG", nam_mon_gc_backlog)
@@ -46,6 +46,7 @@
 #include "../common/os/isc_i_proto.h"
 #include "../jrd/CryptoManager.h"
 #include "../jrd/replication/Publisher.h"
+#include "../common/os/os_utils.h"
 
 #ifdef HAVE_SYS_TYPES_H
 #include <sys/types.h>
@@ -63,6 +64,10 @@
 #include <errno.h>
 #endif
 
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+
 #ifdef NBAK_DEBUG
 #include <stdarg.h>
 IMPLEMENT_TRACE_ROUTINE(nbak_trace, "NBAK")
@@ -214,6 +219,146 @@ void BackupManager::StateWriteGuard::releaseHeader()
 	}
 }
 
+/********************************** ChangeMap ***********************************/
+
+// Change map file keeps the highest SCN of every SCN page range changed since
+// cmh_start_scn. It's written synchronously and on byte basis, therefore raw
+// file IO is used here instead of PIO.
+
+namespace Jrd {
+
+class ChangeMap
+{
+public:
+	ChangeMap(MemoryPool& p, const PathName& name)
+		: fileName(p, name),
+#ifdef WIN_NT
+		  handle(INVALID_HANDLE_VALUE)
+#else
+		  handle(-1)
+#endif
+	{}
+
+	~ChangeMap()
+	{
+#ifdef WIN_NT
+		if (handle != INVALID_HANDLE_VALUE)
+			CloseHandle(handle);
+#else
+		if (handle >= 0)
+			close(handle);
+#endif
+	}
+
+	// Returns false if file doesn't exist and should not be created
+	bool open(bool create)
+	{
+#ifdef WIN_NT
+		handle = CreateFile(fileName.c_str(), GENERIC_READ | GENERIC_WRITE,
+			FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+			create ? OPEN_ALWAYS : OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_WRITE_THROUGH, 0);
+
+		if (handle == INVALID_HANDLE_VALUE)
+		{
+			const DWORD code = GetLastError();
+			if (!create && code == ERROR_FILE_NOT_FOUND)
+				return false;
+
+			error("CreateFile", isc_io_open_err, code);
+		}
+#else
+#ifdef O_DSYNC
+		const int flags = O_RDWR | O_DSYNC;
+#else
+		const int flags = O_RDWR | O_SYNC;
+#endif
+		handle = os_utils::open(fileName.c_str(), create ? flags | O_CREAT : flags, 0660);
+
+		if (handle < 0)
+		{
+			const int code = errno;
+			if (!create && code == ENOENT)
+				return false;
+
+			error("open", isc_io_open_err, code);
+		}
+#endif
+		return true;
+	}
+
+	// Returns false if file is shorter than requested
+	bool read(FB_UINT64 offset, void* buffer, ULONG length)
+	{
+#ifdef WIN_NT
+		OVERLAPPED overlapped;
+		memset(&overlapped, 0, sizeof(overlapped));
+		overlapped.Offset = (DWORD) offset;
+		overlapped.OffsetHigh = (DWORD) (offset >> 32);
+
+		DWORD actual = 0;
+		if (!ReadFile(handle, buffer, length, &actual, &overlapped))
+		{
+			const DWORD code = GetLastError();
+			if (code != ERROR_HANDLE_EOF)
+				error("ReadFile", isc_io_read_err, code);
+		}
+
+		return actual == length;
+#else
+		ssize_t actual;
+		while ((actual = pread(handle, buffer, length, offset)) < 0)
+		{
+			if (errno != EINTR)
+				error("pread", isc_io_read_err, errno);
+		}
+
+		return (ULONG) actual == length;
+#endif
+	}
+
+	void write(FB_UINT64 offset, const void* buffer, ULONG length)
+	{
+#ifdef WIN_NT
+		OVERLAPPED overlapped;
+		memset(&overlapped, 0, sizeof(overlapped));
+		overlapped.Offset = (DWORD) offset;
+		overlapped.OffsetHigh = (DWORD) (offset >> 32);
+
+		DWORD actual = 0;
+		if (!WriteFile(handle, buffer, length, &actual, &overlapped) || actual != length)
+			error("WriteFile", isc_io_write_err, GetLastError());
+#else
+		ssize_t actual;
+		while ((actual = pwrite(handle, buffer, length, offset)) != (ssize_t) length)
+		{
+			if (actual >= 0)
+				error("pwrite", isc_io_write_err, ENOSPC);
+
+			if (errno != EINTR)
+				error("pwrite", isc_io_write_err, errno);
+		}
+#endif
+	}
+
+private:
+	void error(const char* operation, ISC_STATUS code, ISC_STATUS osError)
+	{
+		ERR_post(Arg::Gds(isc_io_error) << operation << fileName <<
+				 Arg::Gds(code) << Arg::OsError(osError));
+	}
+
+	PathName fileName;
+#ifdef WIN_NT
+	HANDLE handle;
+#else
+	int handle;
+#endif
+};
+
+} // namespace Jrd
+
+
 /********************************** CORE LOGIC ********************************/
 
 void BackupManager::generateFilename()
@@ -280,6 +425,9 @@ void BackupManager::beginBackup(thread_db* tdbb)
 			"Cannot begin backup: please wait for crypt thread completion");
 	}
 
+	// Start new tracking cycle in change map
+	beginChangeMap(tdbb, header->hdr_header.pag_scn, header->hdr_header.pag_scn + 1);
+
 	try
 	{
 		// Create file
@@ -501,6 +649,7 @@ void BackupManager::endBackup(thread_db* tdbb, bool recover)
 		adjusted_scn =
 #endif
 					   ++current_scn;
+		setChangeMapSCN(tdbb, current_scn);
 		NBAK_TRACE(("New state is getting to become %d", backup_state));
 		CCH_MARK_MUST_WRITE(tdbb, &window);
 		// Generate new SCN
@@ -598,6 +747,7 @@ void BackupManager::endBackup(thread_db* tdbb, bool recover)
 		// Generate new SCN
 		header->hdr_header.pag_scn = ++current_scn;
 		NBAK_TRACE(("new SCN=%d is getting written to header", header->hdr_header.pag_scn));
+		setChangeMapSCN(tdbb, current_scn);
 
 		stateGuard.releaseHeader();
 		stateGuard.setSuccess();
@@ -891,6 +1041,175 @@ void BackupManager::flushDifference(thread_db* tdbb)
 	PIO_flush(tdbb, diff_file);
 }
 
+void BackupManager::openChangeMap(thread_db* tdbb)
+{
+	fb_assert(!change_map);
+
+	AutoPtr<ChangeMap> map(FB_NEW_POOL(*database->dbb_permanent)
+		ChangeMap(*database->dbb_permanent, database->dbb_filename + Ods::CHANGE_MAP_SUFFIX));
+
+	try
+	{
+		if (map->open(false))
+			change_map = map.release();
+	}
+	catch (const Exception& ex)
+	{
+		// Changes of this process would be missed, don't let the map mislead nbackup
+		logChangeMapError(tdbb, ex);
+		unlink((database->dbb_filename + Ods::CHANGE_MAP_SUFFIX).c_str());
+	}
+}
+
+void BackupManager::closeChangeMap()
+{
+	delete change_map;
+	change_map = NULL;
+}
+
+// Map is an optional optimization of nbackup, its IO errors are logged and
+// don't fail the database change
+void BackupManager::logChangeMapError(thread_db* tdbb, const Exception& ex)
+{
+	FbLocalStatus status;
+	ex.stuffException(&status);
+	fb_utils::init_status(tdbb->tdbb_status_vector);
+
+	string error;
+	error.printf("Database: %s\n\tChange map is invalidated, the next incremental backup will read the whole database",
+				 database->dbb_filename.c_str());
+	iscLogStatus(error.c_str(), &status);
+}
+
+// Called by master with state locked for write, no one else uses the map.
+// Missing map makes nbackup read all pages.
+void BackupManager::dropChangeMap(thread_db* tdbb)
+{
+	closeChangeMap();
+	unlink((database->dbb_filename + Ods::CHANGE_MAP_SUFFIX).c_str());
+}
+
+// Called by master with state locked for write before SCN is incremented by
+// beginBackup. Creates change map or continues tracking if it's consistent.
+// Backup continues without the map if it can't be written.
+void BackupManager::beginChangeMap(thread_db* tdbb, ULONG prev_scn, ULONG new_scn)
+{
+	if (!database->dbb_config->getNBackupChangeMap())
+	{
+		// Map is not maintained anymore, don't let it mislead nbackup
+		if (change_map)
+		{
+			try
+			{
+				Ods::change_map_header mapHeader;
+				memset(&mapHeader, 0, sizeof(mapHeader));
+				change_map->write(0, &mapHeader, sizeof(mapHeader));
+			}
+			catch (const Exception&)
+			{
+				fb_utils::init_status(tdbb->tdbb_status_vector);
+			}
+		}
+
+		dropChangeMap(tdbb);
+		return;
+	}
+
+	try
+	{
+		if (!change_map)
+		{
+			AutoPtr<ChangeMap> map(FB_NEW_POOL(*database->dbb_permanent)
+				ChangeMap(*database->dbb_permanent, database->dbb_filename + Ods::CHANGE_MAP_SUFFIX));
+			map->open(true);
+			change_map = map.release();
+		}
+
+		Ods::change_map_header mapHeader;
+		if (!change_map->read(0, &mapHeader, sizeof(mapHeader)) ||
+			memcmp(mapHeader.cmh_signature, Ods::CHANGE_MAP_SIGNATURE, sizeof(mapHeader.cmh_signature)) ||
+			mapHeader.cmh_version != Ods::CHANGE_MAP_VERSION ||
+			mapHeader.cmh_page_size != database->dbb_page_size ||
+			mapHeader.cmh_last_scn != prev_scn)
+		{
+			// New map or tracking was interrupted - start it from the scratch
+			NBAK_TRACE(("Change map is reset at SCN %d", new_scn));
+			memset(&mapHeader, 0, sizeof(mapHeader));
+			memcpy(mapHeader.cmh_signature, Ods::CHANGE_MAP_SIGNATURE, sizeof(mapHeader.cmh_signature));
+			mapHeader.cmh_version = Ods::CHANGE_MAP_VERSION;
+			mapHeader.cmh_page_size = database->dbb_page_size;
+			mapHeader.cmh_start_scn = new_scn;
+		}
+
+		mapHeader.cmh_last_scn = new_scn;
+		change_map->write(0, &mapHeader, sizeof(mapHeader));
+	}
+	catch (const Exception& ex)
+	{
+		logChangeMapError(tdbb, ex);
+		dropChangeMap(tdbb);
+	}
+}
+
+// Called by endBackup when SCN is incremented
+void BackupManager::setChangeMapSCN(thread_db* tdbb, ULONG scn)
+{
+	if (!change_map)
+		return;
+
+	try
+	{
+		Ods::change_map_header mapHeader;
+		if (change_map->read(0, &mapHeader, sizeof(mapHeader)) && mapHeader.cmh_last_scn == scn - 1)
+		{
+			mapHeader.cmh_last_scn = scn;
+			change_map->write(0, &mapHeader, sizeof(mapHeader));
+		}
+	}
+	catch (const Exception& ex)
+	{
+		logChangeMapError(tdbb, ex);
+		dropChangeMap(tdbb);
+	}
+}
+
+// Called on the first change of SCN page range at given SCN. The page is already
+// changed, thus failure to register it doesn't fail the change but invalidates
+// the map: tracking restarts at the next SCN and the next incremental backup
+// reads all SCN pages.
+void BackupManager::writeChangeMap(thread_db* tdbb, ULONG sequence, ULONG scn)
+{
+	try
+	{
+		change_map->write(Ods::CHANGE_MAP_DATA + (FB_UINT64) sequence * sizeof(ULONG), &scn, sizeof(scn));
+		return;
+	}
+	catch (const Exception& ex)
+	{
+		logChangeMapError(tdbb, ex);
+	}
+
+	try
+	{
+		Ods::change_map_header mapHeader;
+		if (change_map->read(0, &mapHeader, sizeof(mapHeader)) && mapHeader.cmh_start_scn <= scn)
+		{
+			NBAK_TRACE(("Change map is reset at SCN %d", scn + 1));
+			mapHeader.cmh_start_scn = scn + 1;
+			change_map->write(0, &mapHeader, sizeof(mapHeader));
+		}
+	}
+	catch (const Exception&)
+	{
+		fb_utils::init_status(tdbb->tdbb_status_vector);
+
+		// Header can't be fixed, remove the map file to not mislead nbackup.
+		// Other threads may use the open map, it's closed at the next SCN
+		// change and the next BEGIN BACKUP creates new file.
+		unlink((database->dbb_filename + Ods::CHANGE_MAP_SUFFIX).c_str());
+	}
+}
+
 void BackupManager::setForcedWrites(const bool forceWrite, const bool notUseFSCache)
 {
 	if (diff_file)
@@ -900,7 +1219,7 @@ void BackupManager::setForcedWrites(const bool forceWrite, const bool notUseFSCa
 BackupManager::BackupManager(thread_db* tdbb, Database* _database, int ini_state) :
 	dbCreating(false), database(_database), diff_file(NULL), alloc_table(NULL),
 	last_allocated_page(0), current_scn(0), diff_name(*_database->dbb_permanent),
-	explicit_diff_name(false), flushInProgress(false), shutDown(false), allocIsValid(false),
+	change_map(NULL), explicit_diff_name(false), flushInProgress(false), shutDown(false), allocIsValid(false),
 	master(false), stateBlocking(false),
 	stateLock(FB_NEW_POOL(*database->dbb_permanent) NBackupStateLock(tdbb, *database->dbb_permanent, this)),
 	allocLock(FB_NEW_POOL(*database->dbb_permanent) NBackupAllocLock(tdbb, *database->dbb_permanent, this))
@@ -925,6 +1244,7 @@ BackupManager::~BackupManager()
 	delete stateLock;
 	delete allocLock;
 	delete alloc_table;
+	delete change_map;
 	delete[] temp_buffers_space;
 }
 
@@ -1002,6 +1322,7 @@ bool BackupManager::actualizeState(thread_db* tdbb)
 	// Check is we missed lock/unlock cycle and need to invalidate
 	// our allocation table and file handle
 	const bool missed_cycle = (header->hdr_header.pag_scn - current_scn) > 1;
+	const bool scn_changed = (header->hdr_header.pag_scn != current_scn);
 	current_scn = header->hdr_header.pag_scn;
 
 	// Read difference file name from header clumplets
@@ -1046,6 +1367,14 @@ bool BackupManager::actualizeState(thread_db* tdbb)
 
 	if (new_backup_state != Ods::hdr_nbak_normal && !diff_file)
 		openDelta(tdbb);
+
+	// Change map could be created, recreated or dropped by master
+	if (scn_changed || !change_map)
+	{
+		closeChangeMap();
+		openChangeMap(tdbb);
+	}
+
 	// Adjust state at the very and to ensure proper error handling
 	backup_state = new_backup_state;
 
@@ -1057,6 +1386,7 @@ void BackupManager::shutdown(thread_db* tdbb)
 	shutDown = true;
 
 	closeDelta(tdbb);
+	closeChangeMap();
 	stateLock->shutdownLock(tdbb);
 	allocLock->shutdownLock(tdbb);
 }
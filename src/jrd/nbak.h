@@ -61,6 +61,7 @@ class Record;
 class thread_db;
 class Database;
 class jrd_file;
+class ChangeMap;
 
 class AllocItem
 {
@@ -458,6 +459,13 @@ public:
 
 	void shutdown(thread_db* tdbb);
 
+	// Register change of pages described by SCN page of given sequence
+	void markChanged(thread_db* tdbb, ULONG sequence, ULONG scn)
+	{
+		if (change_map)
+			writeChangeMap(tdbb, sequence, scn);
+	}
+
 	void beginFlush()
 	{
 		flushInProgress = true;
@@ -497,6 +505,7 @@ private:
 	ULONG *alloc_buffer, *empty_buffer, *spare_buffer;
 	ULONG current_scn;
 	Firebird::PathName diff_name;
+	ChangeMap* change_map;		// change map file, see Ods::change_map_header
 	bool explicit_diff_name;
 	bool flushInProgress;
 	bool shutDown;
@@ -514,6 +523,14 @@ private:
 	void generateFilename();
 	bool extendDatabase(thread_db* tdbb);
 
+	void openChangeMap(thread_db* tdbb);
+	void closeChangeMap();
+	void dropChangeMap(thread_db* tdbb);
+	void logChangeMapError(thread_db* tdbb, const Firebird::Exception& ex);
+	void beginChangeMap(thread_db* tdbb, ULONG prev_scn, ULONG new_scn);
+	void setChangeMapSCN(thread_db* tdbb, ULONG scn);
+	void writeChangeMap(thread_db* tdbb, ULONG sequence, ULONG scn);
+
 	void lockAllocWrite(thread_db* tdbb)
 	{
 		if (!allocLock->lockWrite(tdbb, LCK_WAIT))
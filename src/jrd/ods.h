@@ -629,6 +629,30 @@ static_assert(offsetof(struct scns_page, scn_pages) == 20, "scn_pages offset mis
 //    32768       261920            8187           8185
 //    65536       524064           16379          16377
 
+
+// Change map file. It is maintained by the engine next to the database file
+// when NBackupChangeMap setting is on. File contains greatest SCN of changed
+// pages for every range of pages described by one SCN page, thus incremental
+// backup may skip not changed ranges without reading its SCN pages. Vector
+// of SCN's starts at CHANGE_MAP_DATA offset, missing items are zero.
+
+const char CHANGE_MAP_SUFFIX[] = ".nbmap";
+const char CHANGE_MAP_SIGNATURE[4] = {'N', 'B', 'C', 'M'};
+const USHORT CHANGE_MAP_VERSION = 1;
+const ULONG CHANGE_MAP_DATA = 64;
+
+struct change_map_header
+{
+	char cmh_signature[4];		// CHANGE_MAP_SIGNATURE
+	USHORT cmh_version;			// CHANGE_MAP_VERSION
+	USHORT cmh_reserved;
+	ULONG cmh_page_size;		// Database page size
+	ULONG cmh_start_scn;		// All changes since this SCN are in the map
+	ULONG cmh_last_scn;			// Last SCN generated while the map was maintained
+};
+
+static_assert(sizeof(struct change_map_header) <= CHANGE_MAP_DATA, "struct change_map_header is too big");
+
 // Pointer Page
 
 struct pointer_page
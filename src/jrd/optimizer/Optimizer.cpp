@@ -85,6 +85,7 @@
 #include "../dsql/ExprNodes.h"
 #include "../dsql/StmtNodes.h"
 #include "../jrd/ConfigTable.h"
+#include "../jrd/StatementStatsTable.h"
 
 #include "../jrd/optimizer/Optimizer.h"
 
@@ -555,6 +556,77 @@ namespace
 		}
 	}
 
+
+	// Arguments of a batched function call should depend on the current row of the stream only
+
+	bool isBatchableArgument(const ValueExprNode* node, StreamType stream)
+	{
+		if (const auto fieldNode = nodeAs<FieldNode>(node))
+			return fieldNode->fieldStream == stream;
+
+		if (nodeIs<LiteralNode>(node))
+			return true;
+
+		if (const auto castNode = nodeAs<CastNode>(node))
+			return isBatchableArgument(castNode->source, stream);
+
+		if (const auto negateNode = nodeAs<NegateNode>(node))
+			return isBatchableArgument(negateNode->arg, stream);
+
+		if (const auto arithmeticNode = nodeAs<ArithmeticNode>(node))
+		{
+			return isBatchableArgument(arithmeticNode->arg1, stream) &&
+				isBatchableArgument(arithmeticNode->arg2, stream);
+		}
+
+		if (const auto concatNode = nodeAs<ConcatenateNode>(node))
+		{
+			return isBatchableArgument(concatNode->arg1, stream) &&
+				isBatchableArgument(concatNode->arg2, stream);
+		}
+
+		return false;
+	}
+
+	// Find external function calls the boolean evaluates for every row.
+	// Calls which may be skipped, e.g. the second argument of AND, are ignored.
+
+	void collectBatchedCalls(const ExprNode* node, StreamType stream,
+		Array<const UdfCallNode*>& calls)
+	{
+		if (!node)
+			return;
+
+		if (const auto udfNode = nodeAs<UdfCallNode>(node))
+		{
+			if (!udfNode->isBatchable())
+				return;
+
+			for (const auto arg : udfNode->args->items)
+			{
+				if (!isBatchableArgument(arg, stream))
+					return;
+			}
+
+			calls.add(udfNode);
+		}
+		else if (const auto binaryNode = nodeAs<BinaryBoolNode>(node))
+			collectBatchedCalls(binaryNode->arg1, stream, calls);
+		else if (const auto notNode = nodeAs<NotBoolNode>(node))
+			collectBatchedCalls(notNode->arg, stream, calls);
+		else if (const auto missingNode = nodeAs<MissingBoolNode>(node))
+			collectBatchedCalls(missingNode->arg, stream, calls);
+		else if (const auto castNode = nodeAs<CastNode>(node))
+			collectBatchedCalls(castNode->source, stream, calls);
+		else if (const auto cmpNode = nodeAs<ComparativeBoolNode>(node))
+		{
+			collectBatchedCalls(cmpNode->arg1, stream, calls);
+
+			if (!(cmpNode->nodFlags & ExprNode::FLAG_INVARIANT))
+				collectBatchedCalls(cmpNode->arg2, stream, calls);
+		}
+	}
+
 } // namespace
 
 
@@ -600,6 +672,7 @@ Optimizer::~Optimizer()
 RecordSource* Optimizer::compile(RseNode* subRse, BoolExprNodeStack* parentStack)
 {
 	Optimizer subOpt(tdbb, csb, subRse);
+	subOpt.parentFirstRows = parentFirstRows || rse->rse_first || favorFirstRows();
 	const auto rsb = subOpt.compile(parentStack);
 
 	if (parentStack && subOpt.isInnerJoin())
@@ -2748,6 +2821,10 @@ RecordSource* Optimizer::generateRetrieval(StreamType stream,
 			rsb = FB_NEW_POOL(getPool()) KeywordsTableScan(csb, alias, stream, relation);
 			break;
 
+		case rel_stmt_stats:
+			rsb = FB_NEW_POOL(getPool()) StatementStatsTableScan(csb, alias, stream, relation);
+			break;
+
 		default:
 			rsb = FB_NEW_POOL(getPool()) MonitoringTableScan(csb, alias, stream, relation);
 			break;
@@ -2874,7 +2951,45 @@ RecordSource* Optimizer::generateRetrieval(StreamType stream,
 		}
 	}
 
-	return boolean ? FB_NEW_POOL(getPool()) FilteredStream(csb, rsb, boolean, filterSelectivity) : rsb;
+	if (!boolean)
+		return rsb;
+
+	rsb = generateBatchedCalls(stream, rsb, boolean);
+
+	return FB_NEW_POOL(getPool()) FilteredStream(csb, rsb, boolean, filterSelectivity);
+}
+
+
+//
+// Read rows of the table ahead if external functions used in the boolean
+// may be executed for many rows at once
+//
+
+RecordSource* Optimizer::generateBatchedCalls(StreamType stream, RecordSource* rsb, BoolExprNode* boolean)
+{
+	const int batchSize = tdbb->getDatabase()->dbb_config->getExternalFunctionBatchSize();
+
+	// Locked rows must not be read ahead
+	if (batchSize < 2 || (rse->flags & RseNode::FLAG_WRITELOCK))
+		return rsb;
+
+	// Neither should rows be read ahead when only a few of them may be needed:
+	// FIRST / ROWS, EXISTS / IN and MIN / MAX retrieval favor the first rows
+	if (parentFirstRows || rse->rse_first || favorFirstRows())
+		return rsb;
+
+	const auto relation = csb->csb_rpt[stream].csb_relation;
+
+	if (!relation || relation->rel_file || relation->rel_view_rse || relation->isVirtual())
+		return rsb;
+
+	Array<const UdfCallNode*> calls;
+	collectBatchedCalls(boolean, stream, calls);
+
+	if (calls.isEmpty())
+		return rsb;
+
+	return FB_NEW_POOL(getPool()) BatchedCallStream(csb, rsb, stream, calls, batchSize);
 }
 
 
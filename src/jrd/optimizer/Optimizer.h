@@ -459,6 +459,9 @@ private:
 	RecordSource* applyLocalBoolean(RecordSource* rsb,
 									const StreamList& streams,
 									ConjunctIterator& iter);
+	RecordSource* generateBatchedCalls(StreamType stream,
+									   RecordSource* rsb,
+									   BoolExprNode* boolean);
 	void checkIndices();
 	void checkSorts();
 	unsigned distributeEqualities(BoolExprNodeStack& orgStack, unsigned baseCount);
@@ -493,6 +496,7 @@ private:
 	unsigned baseConjuncts = 0;				// number of conjuncts in our rse, next conjuncts are distributed parent
 	unsigned baseParentConjuncts = 0;		// number of conjuncts in our rse + distributed with parent, next are parent
 	unsigned baseMissingConjuncts = 0;		// number of conjuncts in our and parent rse, but without missing
+	bool parentFirstRows = false;			// parent rse needs only a few rows, see generateBatchedCalls
 
 	StreamList compileStreams, bedStreams, keyStreams, subStreams, outerStreams;
 	ConjunctList conjuncts;
@@ -2663,6 +2663,11 @@ void PAG_set_page_scn(thread_db* tdbb, win* window)
 	{
 		scns_page* page = (scns_page*) window->win_buffer;
 		page->scn_pages[scn_slot] = curr_scn;
+
+		// First change in the SCN range at current SCN
+		if (pageSpace->pageSpaceID == DB_PAGE_SPACE)
+			dbb->dbb_backup_manager->markChanged(tdbb, scn_seq, curr_scn);
+
 		return;
 	}
 
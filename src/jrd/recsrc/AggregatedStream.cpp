@@ -205,7 +205,7 @@ bool BaseAggWinStream<ThisType, NextType>::evaluateGroup(thread_db* tdbb) const
 // Initialize the aggregate record
 template <typename ThisType, typename NextType>
 void BaseAggWinStream<ThisType, NextType>::aggInit(thread_db* tdbb, Request* request,
-	const MapNode* map) const
+	const MapNode* map, bool sliding) const
 {
 	const NestConst<ValueExprNode>* const sourceEnd = map->sourceList.end();
 
@@ -217,7 +217,12 @@ void BaseAggWinStream<ThisType, NextType>::aggInit(thread_db* tdbb, Request* req
 		const AggNode* aggNode = nodeAs<AggNode>(*source);
 
 		if (aggNode)
-			aggNode->aggInit(tdbb, request);
+		{
+			if (sliding)
+				aggNode->aggInitSliding(tdbb, request);
+			else
+				aggNode->aggInit(tdbb, request);
+		}
 		else if (nodeIs<LiteralNode>(*source))
 			EXE_assignment(tdbb, *source, *target);
 	}
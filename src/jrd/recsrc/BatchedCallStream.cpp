@@ -0,0 +1,268 @@
+/*
+ *  The contents of this file are subject to the Initial
+ *  Developer's Public License Version 1.0 (the "License");
+ *  you may not use this file except in compliance with the
+ *  License. You may obtain a copy of the License at
+ *  http://www.ibphoenix.com/main.nfs?a=ibphoenix&page=ibp_idpl.
+ *
+ *  Software distributed under the License is distributed AS IS,
+ *  WITHOUT WARRANTY OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing rights
+ *  and limitations under the License.
+ *
+ *  The Original Code was created by the Firebird development team
+ *  for the Firebird Open Source RDBMS project.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+ */
+
+#include "firebird.h"
+#include "../jrd/jrd.h"
+#include "../jrd/req.h"
+#include "../dsql/ExprNodes.h"
+#include "../jrd/vio_proto.h"
+
+#include "RecordSource.h"
+
+using namespace Firebird;
+using namespace Jrd;
+
+// -----------------------------------------------
+// Data access: read-ahead for batched function calls
+// -----------------------------------------------
+
+BatchedCallStream::BatchedCallStream(CompilerScratch* csb, RecordSource* next, StreamType stream,
+									 const Array<const UdfCallNode*>& calls, ULONG batchSize)
+	: RecordSource(csb),
+	  m_next(next),
+	  m_stream(stream),
+	  m_calls(csb->csb_pool),
+	  m_batchSize(batchSize)
+{
+	fb_assert(m_next && calls.hasData());
+
+	m_calls.assign(calls);
+
+	m_impure = csb->allocImpure<Impure>();
+	m_cardinality = next->getCardinality();
+}
+
+void BatchedCallStream::internalOpen(thread_db* tdbb) const
+{
+	Request* const request = tdbb->getRequest();
+	Impure* const impure = request->getImpure<Impure>(m_impure);
+
+	impure->irsb_flags = irsb_open;
+
+	m_next->open(tdbb);
+
+	delete impure->irsb_batch;
+	MemoryPool& pool = *tdbb->getDefaultPool();
+	impure->irsb_batch = FB_NEW_POOL(pool) Batch(pool);
+
+	for (FB_SIZE_T i = 0; i < m_calls.getCount(); i++)
+	{
+		impure->irsb_batch->inMsgs.add();
+		impure->irsb_batch->outMsgs.add();
+	}
+
+	setResults(request, NULL);
+}
+
+void BatchedCallStream::close(thread_db* tdbb) const
+{
+	Request* const request = tdbb->getRequest();
+
+	invalidateRecords(request);
+
+	Impure* const impure = request->getImpure<Impure>(m_impure);
+
+	if (impure->irsb_flags & irsb_open)
+	{
+		impure->irsb_flags &= ~irsb_open;
+
+		setResults(request, NULL);
+
+		delete impure->irsb_batch;
+		impure->irsb_batch = NULL;
+
+		m_next->close(tdbb);
+	}
+}
+
+bool BatchedCallStream::internalGetRecord(thread_db* tdbb) const
+{
+	JRD_reschedule(tdbb);
+
+	Request* const request = tdbb->getRequest();
+	Impure* const impure = request->getImpure<Impure>(m_impure);
+
+	if (!(impure->irsb_flags & irsb_open))
+		return false;
+
+	Batch* const batch = impure->irsb_batch;
+
+	if (batch->position >= batch->count && !fetchBatch(tdbb, batch))
+	{
+		setResults(request, NULL);
+		return false;
+	}
+
+	// Restore the row as BufferedStream does. The table scan is already
+	// positioned elsewhere, so the record must be refetched before a change.
+
+	record_param* const rpb = &request->req_rpb[m_stream];
+	const Record* const record = batch->records[batch->position];
+
+	VIO_record(tdbb, rpb, record->getFormat(), tdbb->getDefaultPool());
+	rpb->rpb_record->copyFrom(record);
+
+	rpb->rpb_number.setValue(batch->numbers[batch->position]);
+	rpb->rpb_number.setValid(true);
+	rpb->rpb_transaction_nr = batch->transactions[batch->position];
+
+	rpb->rpb_runtime_flags &= ~RPB_CLEAR_FLAGS;
+	rpb->rpb_runtime_flags |= RPB_refetch;
+
+	setResults(request, batch);
+	batch->position++;
+
+	return true;
+}
+
+bool BatchedCallStream::refetchRecord(thread_db* tdbb) const
+{
+	// The record may have been changed, so evaluate the functions again
+	setResults(tdbb->getRequest(), NULL);
+
+	return m_next->refetchRecord(tdbb);
+}
+
+WriteLockResult BatchedCallStream::lockRecord(thread_db* tdbb, bool skipLocked) const
+{
+	return m_next->lockRecord(tdbb, skipLocked);
+}
+
+void BatchedCallStream::getChildren(Array<const RecordSource*>& children) const
+{
+	children.add(m_next);
+}
+
+void BatchedCallStream::print(thread_db* tdbb, string& plan, bool detailed, unsigned level, bool recurse) const
+{
+	if (detailed)
+	{
+		string extras;
+		extras.printf(" (batch size: %" ULONGFORMAT")", m_batchSize);
+
+		plan += printIndent(++level) + "Batched Function Calls" + extras;
+		printOptInfo(plan);
+	}
+
+	if (recurse)
+		m_next->print(tdbb, plan, detailed, level, recurse);
+}
+
+void BatchedCallStream::markRecursive()
+{
+	m_next->markRecursive();
+}
+
+void BatchedCallStream::findUsedStreams(StreamList& streams, bool expandAll) const
+{
+	m_next->findUsedStreams(streams, expandAll);
+}
+
+void BatchedCallStream::invalidateRecords(Request* request) const
+{
+	m_next->invalidateRecords(request);
+}
+
+void BatchedCallStream::nullRecords(thread_db* tdbb) const
+{
+	m_next->nullRecords(tdbb);
+}
+
+// Read the next rows and execute the functions for them
+bool BatchedCallStream::fetchBatch(thread_db* tdbb, Batch* batch) const
+{
+	Request* const request = tdbb->getRequest();
+	record_param* const rpb = &request->req_rpb[m_stream];
+	MemoryPool& pool = *tdbb->getDefaultPool();
+
+	batch->count = batch->position = 0;
+	batch->executed = true;
+
+	// If some function can't be batched now, rows are still read ahead
+	// but the functions are evaluated by the parent filter as usual
+	for (const auto call : m_calls)
+	{
+		if (!call->canExecuteBatch(tdbb))
+			batch->executed = false;
+	}
+
+	while (batch->count < m_batchSize && m_next->getRecord(tdbb))
+	{
+		const ULONG n = batch->count;
+
+		if (n < batch->records.getCount())
+		{
+			batch->records[n]->copyFrom(rpb->rpb_record);
+			batch->numbers[n] = rpb->rpb_number.getValue();
+			batch->transactions[n] = rpb->rpb_transaction_nr;
+		}
+		else
+		{
+			batch->records.add(FB_NEW_POOL(pool) Record(pool, rpb->rpb_record));
+			batch->numbers.add(rpb->rpb_number.getValue());
+			batch->transactions.add(rpb->rpb_transaction_nr);
+		}
+
+		if (batch->executed)
+		{
+			for (FB_SIZE_T i = 0; i < m_calls.getCount(); i++)
+			{
+				const UdfCallNode* const call = m_calls[i];
+				const ULONG inLength = call->getBatchInputLength();
+				const ULONG outLength = call->getBatchOutputLength();
+
+				UCHAR* const inMsgs = batch->inMsgs[i].getBuffer((n + 1) * inLength);
+				batch->outMsgs[i].getBuffer((n + 1) * outLength);
+
+				call->makeBatchInput(tdbb, request, inMsgs + n * inLength);
+			}
+		}
+
+		batch->count++;
+	}
+
+	if (!batch->count)
+		return false;
+
+	if (batch->executed)
+	{
+		for (FB_SIZE_T i = 0; i < m_calls.getCount(); i++)
+		{
+			m_calls[i]->executeBatch(tdbb, batch->count,
+				batch->inMsgs[i].begin(), batch->outMsgs[i].begin());
+		}
+	}
+
+	return true;
+}
+
+// Make the functions return results of the current row, or evaluate them as usual
+void BatchedCallStream::setResults(Request* request, const Batch* batch) const
+{
+	for (FB_SIZE_T i = 0; i < m_calls.getCount(); i++)
+	{
+		const UdfCallNode* const call = m_calls[i];
+		const UCHAR* outMsg = NULL;
+
+		if (batch && batch->executed)
+			outMsg = batch->outMsgs[i].begin() + batch->position * call->getBatchOutputLength();
+
+		call->setBatchResult(request, outMsg);
+	}
+}
@@ -55,6 +55,10 @@ void BitmapTableScan::internalOpen(thread_db* tdbb) const
 	impure->irsb_flags = irsb_open;
 	impure->irsb_bitmap = EVL_bitmap(tdbb, m_inversion, NULL);
 
+	// Bitmap is complete, compress dense ranges before walking it
+	if (impure->irsb_bitmap && *impure->irsb_bitmap)
+		(*impure->irsb_bitmap)->optimize();
+
 	record_param* const rpb = &request->req_rpb[m_stream];
 	RLCK_reserve_relation(tdbb, request->req_transaction, m_relation, false);
 
@@ -146,7 +146,7 @@ bool FullTableScan::internalGetRecord(thread_db* tdbb) const
 		return false;
 	}
 
-	if (VIO_next_record(tdbb, rpb, request->req_transaction, request->req_pool, DPM_next_all))
+	while (VIO_next_record(tdbb, rpb, request->req_transaction, request->req_pool, DPM_next_all))
 	{
 		if (impure->irsb_upper.isValid() && rpb->rpb_number > impure->irsb_upper)
 		{
@@ -155,6 +155,13 @@ bool FullTableScan::internalGetRecord(thread_db* tdbb) const
 		}
 
 		rpb->rpb_number.setValid(true);
+
+		if (m_filter && !m_filter->checkRecord(tdbb))
+		{
+			JRD_reschedule(tdbb);
+			continue;
+		}
+
 		return true;
 	}
 
@@ -22,6 +22,7 @@
 
 #include "firebird.h"
 #include "../common/classes/Aligner.h"
+#include "../common/classes/BloomFilter.h"
 #include "../common/classes/Hash.h"
 #include "../jrd/jrd.h"
 #include "../jrd/req.h"
@@ -304,6 +305,22 @@ HashJoin::HashJoin(thread_db* tdbb, CompilerScratch* csb, FB_SIZE_T count,
 	}
 
 	m_cardinality *= selectivity;
+
+	// Let the leading stream scan reject records not matching the inner streams.
+	// Keys are evaluated there before the booleans of the leading stream, so only
+	// plain fields are allowed: an expression could fail for a record which
+	// the booleans would reject.
+	bool plainKeys = true;
+	for (const auto key : *m_leader.keys)
+	{
+		if (!nodeIs<FieldNode>(key))
+		{
+			plainKeys = false;
+			break;
+		}
+	}
+
+	m_bloomPushed = plainKeys && m_leader.source->pushFilter(this);
 }
 
 void HashJoin::internalOpen(thread_db* tdbb) const
@@ -314,6 +331,7 @@ void HashJoin::internalOpen(thread_db* tdbb) const
 	impure->irsb_flags = irsb_open | irsb_mustread;
 
 	delete impure->irsb_hash_table;
+	delete impure->irsb_bloom_filter;
 	delete[] impure->irsb_leader_buffer;
 
 	MemoryPool& pool = *tdbb->getDefaultPool();
@@ -321,9 +339,13 @@ void HashJoin::internalOpen(thread_db* tdbb) const
 	const FB_SIZE_T argCount = m_args.getCount();
 
 	impure->irsb_hash_table = FB_NEW_POOL(pool) HashTable(pool, argCount);
+	impure->irsb_bloom_filter = NULL;
 	impure->irsb_leader_buffer = FB_NEW_POOL(pool) UCHAR[m_leader.totalKeyLength];
+	impure->irsb_leader_hashed = false;
 
 	UCharBuffer buffer(pool);
+	AutoPtr<BloomFilter> bloomFilter(m_bloomPushed ? FB_NEW_POOL(pool) BloomFilter(pool) : NULL);
+	Array<ULONG> hashes(pool);
 
 	for (FB_SIZE_T i = 0; i < argCount; i++)
 	{
@@ -335,14 +357,23 @@ void HashJoin::internalOpen(thread_db* tdbb) const
 		ULONG counter = 0;
 		UCHAR* const keyBuffer = buffer.getBuffer(m_args[i].totalKeyLength, false);
 
+		hashes.clear();
+
 		while (m_args[i].buffer->getRecord(tdbb))
 		{
 			const ULONG hash = computeHash(tdbb, request, m_args[i], keyBuffer);
 			impure->irsb_hash_table->put(i, hash, counter++);
+
+			if (bloomFilter)
+				hashes.add(hash);
 		}
+
+		if (bloomFilter)
+			bloomFilter->add(hashes);
 	}
 
 	impure->irsb_hash_table->sort();
+	impure->irsb_bloom_filter = bloomFilter.release();
 
 	m_leader.source->open(tdbb);
 }
@@ -361,6 +392,9 @@ void HashJoin::close(thread_db* tdbb) const
 		delete impure->irsb_hash_table;
 		impure->irsb_hash_table = NULL;
 
+		delete impure->irsb_bloom_filter;
+		impure->irsb_bloom_filter = NULL;
+
 		delete[] impure->irsb_leader_buffer;
 		impure->irsb_leader_buffer = NULL;
 
@@ -390,10 +424,16 @@ bool HashJoin::internalGetRecord(thread_db* tdbb) const
 			if (!m_leader.source->getRecord(tdbb))
 				return false;
 
-			// Compute and hash the comparison keys
+			// Compute and hash the comparison keys,
+			// unless it was already done by the pushed down filter
 
-			impure->irsb_leader_hash =
-				computeHash(tdbb, request, m_leader, impure->irsb_leader_buffer);
+			if (impure->irsb_leader_hashed)
+				impure->irsb_leader_hashed = false;
+			else
+			{
+				impure->irsb_leader_hash =
+					computeHash(tdbb, request, m_leader, impure->irsb_leader_buffer);
+			}
 
 			// Ensure the every inner stream having matches for this hash slot.
 			// Setup the hash table for the iteration through collisions.
@@ -601,6 +641,21 @@ ULONG HashJoin::computeHash(thread_db* tdbb,
 	return InternalHash::hash(sub.totalKeyLength, keyBuffer);
 }
 
+bool HashJoin::checkRecord(thread_db* tdbb) const
+{
+	Request* const request = tdbb->getRequest();
+	Impure* const impure = request->getImpure<Impure>(m_impure);
+
+	if (!(impure->irsb_flags & irsb_open) || !impure->irsb_bloom_filter)
+		return true;
+
+	impure->irsb_leader_hash =
+		computeHash(tdbb, request, m_leader, impure->irsb_leader_buffer);
+	impure->irsb_leader_hashed = true;
+
+	return impure->irsb_bloom_filter->check(impure->irsb_leader_hash);
+}
+
 bool HashJoin::fetchRecord(thread_db* tdbb, Impure* impure, FB_SIZE_T stream) const
 {
 	HashTable* const hashTable = impure->irsb_hash_table;
@@ -63,6 +63,20 @@ void RecordSource::open(thread_db* tdbb) const
 		attachment->getProfilerManager(tdbb) :
 		nullptr;
 
+	if (profilerManager && profilerManager->isSampling())
+	{
+		profilerManager->prepareRecSource(tdbb, request, this);
+
+		const ProfilerFrame frame = {this, true, request->req_profiler_frame};
+		AutoSetRestore<const ProfilerFrame*> autoFrame(&request->req_profiler_frame, &frame);
+
+		if (profilerManager->isSampleDue())
+			profilerManager->takeSample(request);
+
+		internalOpen(tdbb);
+		return;
+	}
+
 	const SINT64 lastPerfCounter = profilerManager ?
 		fb_utils::query_performance_counter() :
 		0;
@@ -92,6 +106,17 @@ bool RecordSource::getRecord(thread_db* tdbb) const
 		attachment->getProfilerManager(tdbb) :
 		nullptr;
 
+	if (profilerManager && profilerManager->isSampling())
+	{
+		const ProfilerFrame frame = {this, false, request->req_profiler_frame};
+		AutoSetRestore<const ProfilerFrame*> autoFrame(&request->req_profiler_frame, &frame);
+
+		if (profilerManager->isSampleDue())
+			profilerManager->takeSample(request);
+
+		return internalGetRecord(tdbb);
+	}
+
 	const SINT64 lastPerfCounter = profilerManager ?
 		fb_utils::query_performance_counter() :
 		0;
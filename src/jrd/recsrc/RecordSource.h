@@ -33,6 +33,11 @@
 #include "../jrd/evl_proto.h"
 #include "../jrd/vio_proto.h"
 
+namespace Firebird
+{
+	class BloomFilter;
+}
+
 namespace Jrd
 {
 	class thread_db;
@@ -40,10 +45,12 @@ namespace Jrd
 	class jrd_prc;
 	class AggNode;
 	class BoolExprNode;
+	class UdfCallNode;
 	class DeclareLocalTableNode;
 	class Sort;
 	class CompilerScratch;
 	class BtrPageGCLock;
+	class ExternalBatch;
 	struct index_desc;
 	struct record_param;
 	struct temporary_key;
@@ -53,6 +60,15 @@ namespace Jrd
 
 	enum JoinType { INNER_JOIN, OUTER_JOIN, SEMI_JOIN, ANTI_JOIN };
 
+	// Cheap check pushed down by the parent data source (e.g. hash join)
+	// into the table scan to reject records as early as possible
+
+	class RecordFilter
+	{
+	public:
+		virtual bool checkRecord(thread_db* tdbb) const = 0;
+	};
+
 	// Abstract base class
 
 	class RecordSource
@@ -79,6 +95,11 @@ namespace Jrd
 			fb_assert(false);
 		}
 
+		virtual bool pushFilter(const RecordFilter* /*filter*/)
+		{
+			return false;
+		}
+
 		virtual ~RecordSource();
 
 		static bool rejectDuplicate(const UCHAR* /*data1*/, const UCHAR* /*data2*/, void* /*userArg*/)
@@ -188,6 +209,15 @@ namespace Jrd
 		void print(thread_db* tdbb, Firebird::string& plan,
 				   bool detailed, unsigned level, bool recurse) const override;
 
+		bool pushFilter(const RecordFilter* filter) override
+		{
+			if (m_filter)
+				return false;
+
+			m_filter = filter;
+			return true;
+		}
+
 	protected:
 		void internalOpen(thread_db* tdbb) const override;
 		bool internalGetRecord(thread_db* tdbb) const override;
@@ -196,6 +226,7 @@ namespace Jrd
 		const Firebird::string m_alias;
 		jrd_rel* const m_relation;
 		Firebird::Array<DbKeyRangeNode*> m_dbkeyRanges;
+		const RecordFilter* m_filter = nullptr;
 	};
 
 	class BitmapTableScan final : public RecordStream
@@ -297,6 +328,7 @@ namespace Jrd
 		struct Impure : public RecordSource::Impure
 		{
 			FB_UINT64 irsb_position;
+			ExternalBatch* irsb_batch;
 		};
 
 	public:
@@ -566,6 +598,11 @@ namespace Jrd
 			m_ansiNot = ansiNot;
 		}
 
+		bool pushFilter(const RecordFilter* filter) override
+		{
+			return m_next->pushFilter(filter);
+		}
+
 	protected:
 		void internalOpen(thread_db* tdbb) const override;
 		bool internalGetRecord(thread_db* tdbb) const override;
@@ -594,6 +631,77 @@ namespace Jrd
 		}
 	};
 
+	// Reads rows of a table ahead to execute external functions of the parent
+	// filter for many rows at once, see UdfCallNode::executeBatch()
+
+	class BatchedCallStream : public RecordSource
+	{
+		struct Batch
+		{
+			explicit Batch(MemoryPool& p)
+				: records(p), numbers(p), transactions(p), inMsgs(p), outMsgs(p)
+			{}
+
+			~Batch()
+			{
+				for (auto record : records)
+					delete record;
+			}
+
+			Firebird::Array<Record*> records;
+			Firebird::Array<SINT64> numbers;
+			Firebird::Array<TraNumber> transactions;
+			Firebird::ObjectsArray<Firebird::Array<UCHAR> > inMsgs;		// per function
+			Firebird::ObjectsArray<Firebird::Array<UCHAR> > outMsgs;	// per function
+			ULONG count = 0;
+			ULONG position = 0;
+			bool executed = false;
+		};
+
+		struct Impure : public RecordSource::Impure
+		{
+			Batch* irsb_batch;
+		};
+
+	public:
+		BatchedCallStream(CompilerScratch* csb, RecordSource* next, StreamType stream,
+						  const Firebird::Array<const UdfCallNode*>& calls, ULONG batchSize);
+
+		void close(thread_db* tdbb) const override;
+
+		bool refetchRecord(thread_db* tdbb) const override;
+		WriteLockResult lockRecord(thread_db* tdbb, bool skipLocked) const override;
+
+		void getChildren(Firebird::Array<const RecordSource*>& children) const override;
+
+		void print(thread_db* tdbb, Firebird::string& plan,
+				   bool detailed, unsigned level, bool recurse) const override;
+
+		void markRecursive() override;
+		void invalidateRecords(Request* request) const override;
+
+		void findUsedStreams(StreamList& streams, bool expandAll = false) const override;
+		void nullRecords(thread_db* tdbb) const override;
+
+		bool pushFilter(const RecordFilter* filter) override
+		{
+			return m_next->pushFilter(filter);
+		}
+
+	protected:
+		void internalOpen(thread_db* tdbb) const override;
+		bool internalGetRecord(thread_db* tdbb) const override;
+
+	private:
+		bool fetchBatch(thread_db* tdbb, Batch* batch) const;
+		void setResults(Request* request, const Batch* batch) const;
+
+		NestConst<RecordSource> m_next;
+		const StreamType m_stream;
+		Firebird::Array<const UdfCallNode*> m_calls;
+		const ULONG m_batchSize;
+	};
+
 	class SortedStream : public RecordSource
 	{
 		struct Impure : public RecordSource::Impure
@@ -828,7 +936,8 @@ namespace Jrd
 
 		bool evaluateGroup(thread_db* tdbb) const;
 
-		void aggInit(thread_db* tdbb, Request* request, const MapNode* map) const;
+		void aggInit(thread_db* tdbb, Request* request, const MapNode* map,
+			bool sliding = false) const;
 		bool aggPass(thread_db* tdbb, Request* request,
 			const NestValueArray& sourceList, const NestValueArray& targetList) const;
 		void aggExecute(thread_db* tdbb, Request* request,
@@ -975,6 +1084,8 @@ namespace Jrd
 			SINT64 locateFrameRange(thread_db* tdbb, Request* request, Impure* impure,
 				const Frame* frame, const dsc* offsetDesc, SINT64 position) const;
 
+			bool aggRemove(thread_db* tdbb, Request* request) const;
+
 		private:
 			NestConst<SortNode> m_order;
 			const MapNode* m_windowMap;
@@ -984,6 +1095,7 @@ namespace Jrd
 			NestValueArray m_winPassSources, m_winPassTargets;
 			Exclusion m_exclusion;
 			UCHAR m_invariantOffsets;	// 0x1 | 0x2 bitmask
+			bool m_sliding;				// values may be removed from aggregation
 		};
 
 	public:
@@ -1160,7 +1272,7 @@ namespace Jrd
 		NestConst<RecordSource> m_arg2;
 	};
 
-	class HashJoin : public RecordSource
+	class HashJoin : public RecordSource, private RecordFilter
 	{
 		class HashTable;
 
@@ -1180,8 +1292,10 @@ namespace Jrd
 		struct Impure : public RecordSource::Impure
 		{
 			HashTable* irsb_hash_table;
+			Firebird::BloomFilter* irsb_bloom_filter;
 			UCHAR* irsb_leader_buffer;
 			ULONG irsb_leader_hash;
+			bool irsb_leader_hashed;
 		};
 
 	public:
@@ -1216,8 +1330,12 @@ namespace Jrd
 						  const SubStream& sub, UCHAR* buffer) const;
 		bool fetchRecord(thread_db* tdbb, Impure* impure, FB_SIZE_T stream) const;
 
+		// RecordFilter implementation
+		bool checkRecord(thread_db* tdbb) const override;
+
 		SubStream m_leader;
 		Firebird::Array<SubStream> m_args;
+		bool m_bloomPushed;
 	};
 
 	class MergeJoin : public RecordSource
@@ -1317,9 +1435,24 @@ namespace Jrd
 		};
 
 	public:
+		// Comparison of invariant values which must be true for a member of
+		// the union to return rows, e.g. a parameter against the boundaries
+		// of a partition. Checked when the member is about to be opened.
+		struct PruneCheck
+		{
+			FB_SIZE_T arg;
+			UCHAR blrOp;	// blr_eql, blr_lss, blr_leq, blr_gtr or blr_geq
+			const ValueExprNode* value1;
+			const ValueExprNode* value2;
+		};
+
+		typedef Firebird::Array<PruneCheck> PruneChecks;
+
 		Union(CompilerScratch* csb, StreamType stream,
 			  FB_SIZE_T argCount, RecordSource* const* args, NestConst<MapNode>* maps,
-			  const StreamList& streams);
+			  const StreamList& streams, const PruneChecks* pruneChecks = NULL);
+
+		static bool checkResult(UCHAR blrOp, int result);
 
 		void close(thread_db* tdbb) const override;
 
@@ -1340,9 +1473,13 @@ namespace Jrd
 		bool internalGetRecord(thread_db* tdbb) const override;
 
 	private:
+		bool isPruned(thread_db* tdbb, FB_SIZE_T arg) const;
+		void openArg(thread_db* tdbb, Impure* impure, FB_SIZE_T arg) const;
+
 		Firebird::Array<NestConst<RecordSource> > m_args;
 		Firebird::Array<NestConst<MapNode> > m_maps;
 		StreamList m_streams;
+		PruneChecks m_pruneChecks;
 	};
 
 	class RecursiveStream final : public RecordStream
@@ -21,7 +21,9 @@
 #include "../jrd/jrd.h"
 #include "../jrd/req.h"
 #include "../jrd/cmp_proto.h"
+#include "../jrd/evl_proto.h"
 #include "../jrd/exe_proto.h"
+#include "../jrd/mov_proto.h"
 #include "../jrd/vio_proto.h"
 
 #include "RecordSource.h"
@@ -35,9 +37,9 @@ using namespace Jrd;
 
 Union::Union(CompilerScratch* csb, StreamType stream,
 			 FB_SIZE_T argCount, RecordSource* const* args, NestConst<MapNode>* maps,
-			 const StreamList& streams)
+			 const StreamList& streams, const PruneChecks* pruneChecks)
 	: RecordStream(csb, stream), m_args(csb->csb_pool), m_maps(csb->csb_pool),
-	  m_streams(csb->csb_pool, streams)
+	  m_streams(csb->csb_pool, streams), m_pruneChecks(csb->csb_pool)
 {
 	fb_assert(argCount);
 
@@ -55,6 +57,9 @@ Union::Union(CompilerScratch* csb, StreamType stream,
 
 	for (FB_SIZE_T i = 0; i < argCount; i++)
 		m_maps[i] = maps[i];
+
+	if (pruneChecks)
+		m_pruneChecks.assign(*pruneChecks);
 }
 
 void Union::internalOpen(thread_db* tdbb) const
@@ -75,7 +80,7 @@ void Union::internalOpen(thread_db* tdbb) const
 		request->req_rpb[stream].rpb_number.setValue(BOF_NUMBER);
 	}
 
-	m_args[impure->irsb_count]->open(tdbb);
+	openArg(tdbb, impure, 0);
 }
 
 void Union::close(thread_db* tdbb) const
@@ -111,16 +116,19 @@ bool Union::internalGetRecord(thread_db* tdbb) const
 
 	// March thru the sub-streams looking for a record
 
-	while (!m_args[impure->irsb_count]->getRecord(tdbb))
+	while (true)
 	{
-		m_args[impure->irsb_count]->close(tdbb);
-		impure->irsb_count++;
 		if (impure->irsb_count >= m_args.getCount())
 		{
 			rpb->rpb_number.setValid(false);
 			return false;
 		}
-		m_args[impure->irsb_count]->open(tdbb);
+
+		if (m_args[impure->irsb_count]->getRecord(tdbb))
+			break;
+
+		m_args[impure->irsb_count]->close(tdbb);
+		openArg(tdbb, impure, impure->irsb_count + 1);
 	}
 
 	// We've got a record, map it into the target record
@@ -221,3 +229,80 @@ void Union::findUsedStreams(StreamList& streams, bool expandAll) const
 			m_args[i]->findUsedStreams(streams, true);
 	}
 }
+
+bool Union::checkResult(UCHAR blrOp, int result)
+{
+	switch (blrOp)
+	{
+		case blr_eql:
+			return result == 0;
+		case blr_lss:
+			return result < 0;
+		case blr_leq:
+			return result <= 0;
+		case blr_gtr:
+			return result > 0;
+		case blr_geq:
+			return result >= 0;
+		default:
+			fb_assert(false);
+	}
+
+	return true;
+}
+
+// Check if the sub-stream can't return rows for the current parameter values
+bool Union::isPruned(thread_db* tdbb, FB_SIZE_T arg) const
+{
+	Request* const request = tdbb->getRequest();
+
+	for (const auto& check : m_pruneChecks)
+	{
+		if (check.arg != arg)
+			continue;
+
+		// Comparison with NULL is never true
+		const dsc* const desc1 = EVL_expr(tdbb, request, check.value1);
+		if (!desc1)
+			return true;
+
+		const dsc* const desc2 = EVL_expr(tdbb, request, check.value2);
+		if (!desc2)
+			return true;
+
+		// Strings may be compared differently than they would be converted
+		// to the type of the field, don't rely on them
+		if (desc1->isText() || desc1->isBlob() || desc2->isText() || desc2->isBlob())
+			continue;
+
+		int result;
+
+		try
+		{
+			result = MOV_compare(tdbb, desc1, desc2);
+		}
+		catch (const Exception&)
+		{
+			// let the sub-stream report the error
+			fb_utils::init_status(tdbb->tdbb_status_vector);
+			continue;
+		}
+
+		if (!checkResult(check.blrOp, result))
+			return true;
+	}
+
+	return false;
+}
+
+// Open the first sub-stream starting from the given one which isn't pruned
+void Union::openArg(thread_db* tdbb, Impure* impure, FB_SIZE_T arg) const
+{
+	while (arg < m_args.getCount() && m_pruneChecks.hasData() && isPruned(tdbb, arg))
+		arg++;
+
+	impure->irsb_count = (USHORT) arg;
+
+	if (arg < m_args.getCount())
+		m_args[arg]->open(tdbb);
+}
@@ -448,7 +448,8 @@ WindowedStream::WindowStream::WindowStream(thread_db* tdbb, CompilerScratch* csb
 	  m_winPassSources(csb->csb_pool),
 	  m_winPassTargets(csb->csb_pool),
 	  m_exclusion(exclusion),
-	  m_invariantOffsets(0)
+	  m_invariantOffsets(0),
+	  m_sliding(false)
 {
 	// Separate nodes that requires the winPass call.
 
@@ -519,6 +520,24 @@ WindowedStream::WindowStream::WindowStream(thread_db* tdbb, CompilerScratch* csb
 		}
 	}
 
+	// When the frame start moves only forward, values of records leaving the frame
+	// may be removed from the aggregation instead of aggregating the whole frame again.
+
+	const Frame* const frame1 = m_frameExtent->frame1;
+
+	if (m_aggSources.hasData() &&
+		(m_order || m_frameExtent->unit == FrameExtent::Unit::ROWS) &&
+		(frame1->bound == Frame::Bound::CURRENT_ROW || (frame1->value && (m_invariantOffsets & 0x1))))
+	{
+		m_sliding = true;
+
+		for (const auto& source : m_aggSources)
+		{
+			if (!(nodeAs<AggNode>(source)->getCapabilities() & AggNode::CAP_REMOVES_VALUES))
+				m_sliding = false;
+		}
+	}
+
 	(void) m_exclusion;	// avoid warning
 }
 
@@ -784,12 +803,34 @@ bool WindowedStream::WindowStream::internalGetRecord(thread_db* tdbb) const
 			//
 			// This may be incompatible with some function like LIST, but currently LIST cannot
 			// be used in ordered windows anyway.
+			//
+			// Sliding frame moves only forward, records which left it are removed from the
+			// aggregation when they are still within the last window.
+
+			bool reuse = lastWindow.isValid() &&
+				impure->windowBlock.endPosition >= lastWindow.endPosition &&
+				(m_sliding ?
+					(impure->windowBlock.startPosition >= lastWindow.startPosition &&
+					 impure->windowBlock.startPosition <= lastWindow.endPosition) :
+					impure->windowBlock.startPosition <= lastWindow.startPosition);
 
-			if (!lastWindow.isValid() ||
-				impure->windowBlock.startPosition > lastWindow.startPosition ||
-				impure->windowBlock.endPosition < lastWindow.endPosition)
+			if (reuse && impure->windowBlock.startPosition > lastWindow.startPosition)
 			{
-				aggInit(tdbb, request, m_windowMap);
+				m_next->locate(tdbb, lastWindow.startPosition);
+				SINT64 pending = impure->windowBlock.startPosition - lastWindow.startPosition;
+
+				while (reuse && pending-- > 0)
+				{
+					if (!m_next->getRecord(tdbb))
+						fb_assert(false);
+
+					reuse = aggRemove(tdbb, request);
+				}
+			}
+
+			if (!reuse)
+			{
+				aggInit(tdbb, request, m_windowMap, m_sliding);
 				m_next->locate(tdbb, impure->windowBlock.startPosition);
 			}
 			else
@@ -1067,6 +1108,18 @@ SINT64 WindowedStream::WindowStream::locateFrameRange(thread_db* tdbb, Request*
 	return rangePos;
 }
 
+// Remove values of the current record from aggregation of the sliding frame.
+bool WindowedStream::WindowStream::aggRemove(thread_db* tdbb, Request* request) const
+{
+	for (const auto& source : m_aggSources)
+	{
+		if (!nodeAs<AggNode>(source)->aggRemove(tdbb, request))
+			return false;
+	}
+
+	return true;
+}
+
 // ------------------------------
 
 SlidingWindow::SlidingWindow(thread_db* aTdbb, const BaseBufferedStream* aStream,
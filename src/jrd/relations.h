@@ -501,6 +501,7 @@ RELATION(nam_mon_database, rel_mon_database, ODS_11_1, rel_virtual)
 	FIELD(f_mon_db_na, nam_mon_na, fld_att_id, 0, ODS_13_0)
 	FIELD(f_mon_db_ns, nam_mon_ns, fld_stmt_id, 0, ODS_13_0)
 	FIELD(f_mon_db_repl_mode, nam_mon_repl_mode, fld_repl_mode, 0, ODS_13_0)
+	FIELD(f_mon_db_gc_backlog, nam_mon_gc_backlog, fld_counter, 0, ODS_13_1)
 END_RELATION
 
 // Relation 34 (MON$ATTACHMENTS)
@@ -757,3 +758,18 @@ RELATION(nam_mon_compiled_statements, rel_mon_compiled_statements, ODS_13_1, rel
 	FIELD(f_mon_cmp_stmt_pkg_name, nam_mon_pkg_name, fld_pkg_name, 0, ODS_13_1)
 	FIELD(f_mon_cmp_stmt_stat_id, nam_mon_stat_id, fld_stat_id, 0, ODS_13_1)
 END_RELATION
+
+// Relation 56 (RDB$STATEMENT_STATISTICS)
+RELATION(nam_stmt_stats, rel_stmt_stats, ODS_13_1, rel_virtual)
+	FIELD(f_stmt_stats_hash, nam_stmt_hash, fld_counter, 0, ODS_13_1)
+	FIELD(f_stmt_stats_sql_text, nam_sql_text, fld_source, 0, ODS_13_1)
+	FIELD(f_stmt_stats_executions, nam_executions, fld_counter, 0, ODS_13_1)
+	FIELD(f_stmt_stats_total_time, nam_total_time, fld_counter, 0, ODS_13_1)
+	FIELD(f_stmt_stats_max_time, nam_max_time, fld_counter, 0, ODS_13_1)
+	FIELD(f_stmt_stats_fetches, nam_page_fetches, fld_counter, 0, ODS_13_1)
+	FIELD(f_stmt_stats_reads, nam_page_reads, fld_counter, 0, ODS_13_1)
+	FIELD(f_stmt_stats_writes, nam_page_writes, fld_counter, 0, ODS_13_1)
+	FIELD(f_stmt_stats_records, nam_records, fld_counter, 0, ODS_13_1)
+	FIELD(f_stmt_stats_sorts, nam_sorts, fld_counter, 0, ODS_13_1)
+	FIELD(f_stmt_stats_sort_spills, nam_sort_spills, fld_counter, 0, ODS_13_1)
+END_RELATION
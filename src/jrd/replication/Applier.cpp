@@ -584,12 +584,13 @@ void Applier::insertRecord(thread_db* tdbb, TraNumber traNum,
 		if (transaction->tra_save_point)
 		{
 			const auto action = transaction->tra_save_point->getAction(relation);
-			if (action && action->vct_records)
+			if (action)
 			{
+				// Record number may be already spilled into the undo space
 				const auto recno = rpb.rpb_number.getValue();
-				fb_assert(action->vct_records->test(recno));
+				fb_assert(action->test(transaction, recno));
 				fb_assert(!action->vct_undo || !action->vct_undo->locate(recno));
-				action->vct_records->clear(recno);
+				action->clear(recno);
 			}
 		}
 	}
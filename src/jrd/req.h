@@ -34,6 +34,7 @@
 #include "../jrd/Statement.h"
 #include "../jrd/Record.h"
 #include "../jrd/RecordNumber.h"
+#include "../jrd/StatementStats.h"
 #include "../common/classes/timestamp.h"
 #include "../common/TimeZoneUtil.h"
 
@@ -50,6 +51,7 @@ class ValueListNode;
 class jrd_tra;
 class Savepoint;
 class Cursor;
+class RecordSource;
 class thread_db;
 
 // record parameter block
@@ -162,6 +164,17 @@ private:
 	int modifiedRows;
 };
 
+// Record source being opened or fetched by a request, linked to the outer one.
+// Frames live on the C++ stack and are maintained only while the profiler
+// is in the sampling mode.
+
+struct ProfilerFrame
+{
+	const RecordSource* rsb;
+	bool open;
+	const ProfilerFrame* prior;
+};
+
 // request block
 
 class Request : public pool_alloc<type_req>
@@ -373,6 +386,9 @@ public:
 	RuntimeStatistics	req_base_stats;
 	AffectedRows req_records_affected;	// records affected by the last statement
 	FB_UINT64 req_profiler_time;		// profiler time
+	const StmtNode* req_profiler_node;	// current PSQL node, in the profiler sampling mode
+	const ProfilerFrame* req_profiler_frame;	// innermost record source, in the profiler sampling mode
+	StatementStats::Origin req_stats_origin;	// counters at request start, see StatementStats
 
 	const StmtNode*	req_next;			// next node for execution
 	EDS::Statement*	req_ext_stmt;		// head of list of active dynamic statements
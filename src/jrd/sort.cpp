@@ -322,6 +322,11 @@ void Sort::get(thread_db* tdbb, ULONG** record_address)
 		{
 			diddleKey((UCHAR*) record->sort_record_key, false, false);
 		}
+		else
+		{
+			// Final merge is done, release the page cache of its runs
+			m_space->setStreamCount(0);
+		}
 	}
 	catch (const BadAlloc&)
 	{
@@ -432,6 +437,8 @@ void Sort::sort(thread_db* tdbb)
 			diddleKey((UCHAR*) KEYOF(m_last_record), true, false);
 		}
 
+		tdbb->bumpStats(RuntimeStatistics::SORTS);
+
 		// If there aren't any runs, things fit nicely in memory. Just sort the mess
 		// and we're ready for output.
 		if (!m_runs)
@@ -442,6 +449,8 @@ void Sort::sort(thread_db* tdbb)
 			return;
 		}
 
+		tdbb->bumpStats(RuntimeStatistics::SORT_SPILLS);
+
 		// Write the last records as a run_control
 
 		putRun(tdbb);
@@ -479,6 +488,9 @@ void Sort::sort(thread_db* tdbb)
 			++run_count;
 		}
 
+		// All runs are read at once by the final merge
+		m_space->setStreamCount(run_count);
+
 		AutoPtr<run_merge_hdr*, ArrayDelete> streams(
 			FB_NEW_POOL(m_owner->getPool()) run_merge_hdr*[run_count]);
 
@@ -1545,6 +1557,9 @@ void Sort::mergeRuns(USHORT n)
 
 	fb_assert((n - 1) <= FB_NELEM(blks));	// stack var big enough?
 
+	// Merged runs are read while the new run is written
+	m_space->setStreamCount(n + 1);
+
 	m_longs -= SIZEOF_SR_BCKPTR_IN_LONGS;
 
 	// Make a pass thru the runs allocating buffer space, computing work file
@@ -1734,6 +1749,8 @@ void Sort::mergeRuns(USHORT n)
 	m_runs = run;
 	m_longs += SIZEOF_SR_BCKPTR_IN_LONGS;
 
+	m_space->setStreamCount(0);
+
 	CHECK_FILE(NULL);
 }
 
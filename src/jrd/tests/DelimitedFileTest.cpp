@@ -0,0 +1,151 @@
+#include "firebird.h"
+#include "boost/test/unit_test.hpp"
+#include "../jrd/tra.h"
+#include "../jrd/ext.h"
+#include "../jrd/ext_proto.h"
+#include <string.h>
+#include <string>
+
+using namespace Firebird;
+using namespace Jrd;
+
+static ULONG parse(const ExternalFormat& fmt, const char* text, bool eof, DelimitedRecord* rec, bool& blank)
+{
+	const UCHAR* const start = reinterpret_cast<const UCHAR*>(text);
+	return EXT_parse_delimited(fmt, start, start + strlen(text), eof, rec, blank);
+}
+
+static std::string valueOf(const DelimitedRecord& rec, FB_SIZE_T n)
+{
+	const DelimitedValue& value = rec.values[n];
+	return std::string(reinterpret_cast<const char*>(rec.data.begin()) + value.offset, value.length);
+}
+
+
+BOOST_AUTO_TEST_SUITE(EngineSuite)
+BOOST_AUTO_TEST_SUITE(DelimitedFileSuite)
+BOOST_AUTO_TEST_SUITE(DelimitedFileTests)
+
+BOOST_AUTO_TEST_CASE(FormatTest)
+{
+	ExternalFormat fmt;
+
+	EXT_format(&fmt, NULL);
+	BOOST_TEST(!fmt.fmt_delimited);
+
+	EXT_format(&fmt, "tsv header");
+	BOOST_TEST(fmt.fmt_delimited);
+	BOOST_TEST(fmt.fmt_header);
+	BOOST_TEST(fmt.fmt_delimiter == '\t');
+	BOOST_TEST(fmt.fmt_quote == '"');
+	BOOST_TEST(fmt.fmt_escape == '"');
+
+	// Escape follows quote unless it's given explicitly
+	EXT_format(&fmt, "CSV QUOTE=NONE");
+	BOOST_TEST(fmt.fmt_quote == 0);
+	BOOST_TEST(fmt.fmt_escape == 0);
+
+	EXT_format(&fmt, "CSV QUOTE=' DELIMITER=;");
+	BOOST_TEST(fmt.fmt_delimiter == ';');
+	BOOST_TEST(fmt.fmt_escape == '\'');
+
+	EXT_format(&fmt, "CSV ESCAPE=\\ QUOTE=NONE");
+	BOOST_TEST(fmt.fmt_quote == 0);
+	BOOST_TEST(fmt.fmt_escape == '\\');
+}
+
+BOOST_AUTO_TEST_CASE(PlainRecordTest)
+{
+	ExternalFormat fmt;
+	EXT_format(&fmt, "CSV");
+	DelimitedRecord rec(*getDefaultMemoryPool());
+	bool blank;
+
+	BOOST_TEST(parse(fmt, "a,bc,,d\nnext", false, &rec, blank) == 8u);
+	BOOST_TEST(!blank);
+	BOOST_TEST(rec.values.getCount() == 4u);
+	BOOST_TEST(valueOf(rec, 0) == "a");
+	BOOST_TEST(valueOf(rec, 1) == "bc");
+	BOOST_TEST(valueOf(rec, 2) == "");
+	BOOST_TEST(!rec.values[2].quoted);
+	BOOST_TEST(valueOf(rec, 3) == "d");
+
+	BOOST_TEST(parse(fmt, "a\r\nb", false, &rec, blank) == 3u);
+	BOOST_TEST(parse(fmt, "a\rb", false, &rec, blank) == 2u);
+
+	BOOST_TEST(parse(fmt, "\n", false, &rec, blank) == 1u);
+	BOOST_TEST(blank);
+	BOOST_TEST(rec.values.isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(IncompleteRecordTest)
+{
+	ExternalFormat fmt;
+	EXT_format(&fmt, "CSV");
+	DelimitedRecord rec(*getDefaultMemoryPool());
+	bool blank;
+
+	// More text may follow unless it's the end of file
+	BOOST_TEST(parse(fmt, "a,b", false, &rec, blank) == 0u);
+	BOOST_TEST(parse(fmt, "a,b", true, &rec, blank) == 3u);
+	BOOST_TEST(rec.values.getCount() == 2u);
+
+	// CR may be followed by LF
+	BOOST_TEST(parse(fmt, "a\r", false, &rec, blank) == 0u);
+	BOOST_TEST(parse(fmt, "a\r", true, &rec, blank) == 2u);
+
+	BOOST_TEST(parse(fmt, "\"a\n", false, &rec, blank) == 0u);
+	BOOST_TEST(parse(fmt, "\"a\n", true, &rec, blank) == DELIMITED_MALFORMED);
+
+	BOOST_TEST(parse(fmt, "\"a\"", false, NULL, blank) == 0u);
+	BOOST_TEST(parse(fmt, "\"a\"", true, NULL, blank) == 3u);
+}
+
+BOOST_AUTO_TEST_CASE(QuotedRecordTest)
+{
+	ExternalFormat fmt;
+	EXT_format(&fmt, "CSV");
+	DelimitedRecord rec(*getDefaultMemoryPool());
+	bool blank;
+
+	BOOST_TEST(parse(fmt, "\"x,\"\"y\"\"\",\"\",\"l1\nl2\"\n", true, &rec, blank) == 21u);
+	BOOST_TEST(rec.values.getCount() == 3u);
+	BOOST_TEST(valueOf(rec, 0) == "x,\"y\"");
+	BOOST_TEST(rec.values[0].quoted);
+	BOOST_TEST(valueOf(rec, 1) == "");
+	BOOST_TEST(rec.values[1].quoted);
+	BOOST_TEST(valueOf(rec, 2) == "l1\nl2");
+
+	// Quote in the middle of value is taken as is
+	BOOST_TEST(parse(fmt, "a\"b\n", true, &rec, blank) == 4u);
+	BOOST_TEST(valueOf(rec, 0) == "a\"b");
+}
+
+BOOST_AUTO_TEST_CASE(EscapedRecordTest)
+{
+	ExternalFormat fmt;
+	DelimitedRecord rec(*getDefaultMemoryPool());
+	bool blank;
+
+	EXT_format(&fmt, "CSV ESCAPE=\\");
+	BOOST_TEST(parse(fmt, "a\\,b,\"c\\\"d\"\n", true, &rec, blank) == 12u);
+	BOOST_TEST(rec.values.getCount() == 2u);
+	BOOST_TEST(valueOf(rec, 0) == "a,b");
+	BOOST_TEST(valueOf(rec, 1) == "c\"d");
+
+	BOOST_TEST(parse(fmt, "a\\", false, &rec, blank) == 0u);
+	BOOST_TEST(parse(fmt, "a\\", true, &rec, blank) == DELIMITED_MALFORMED);
+
+	// Neither quotes nor escapes
+	EXT_format(&fmt, "CSV QUOTE=NONE");
+	BOOST_TEST(parse(fmt, "\"a\"\"\",b\n", true, &rec, blank) == 8u);
+	BOOST_TEST(valueOf(rec, 0) == "\"a\"\"\"");
+	BOOST_TEST(!rec.values[0].quoted);
+	BOOST_TEST(valueOf(rec, 1) == "b");
+}
+
+BOOST_AUTO_TEST_SUITE_END()	// DelimitedFileTests
+
+
+BOOST_AUTO_TEST_SUITE_END()	// DelimitedFileSuite
+BOOST_AUTO_TEST_SUITE_END()	// EngineSuite
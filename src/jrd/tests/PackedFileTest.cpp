@@ -0,0 +1,209 @@
+#include "firebird.h"
+#include "boost/test/unit_test.hpp"
+#include "../jrd/tra.h"
+#include "../jrd/TempSpace.h"
+#include "../common/classes/TempFile.h"
+
+using namespace Firebird;
+using namespace Jrd;
+
+static const FB_SIZE_T PAGE_SIZE = 64 * 1024;
+
+// Incompressible bytes
+static void fillRandom(UCHAR* data, FB_SIZE_T length, ULONG seed)
+{
+	ULONG x = seed * 2654435761u + 1;
+
+	for (FB_SIZE_T i = 0; i < length; i++)
+	{
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		data[i] = (UCHAR) (x >> 24);
+	}
+}
+
+// Compressible by half
+static void fillHalf(UCHAR* data, FB_SIZE_T length, ULONG seed)
+{
+	fillRandom(data, length / 2, seed);
+	memset(data + length / 2, (UCHAR) seed, length - length / 2);
+}
+
+static TempSpace::PackedFile* createFile(offset_t size)
+{
+	MemoryPool& pool = *getDefaultMemoryPool();
+	TempFile* const file = FB_NEW_POOL(pool) TempFile(pool, "fb_test_", TempFile::getTempPath());
+	TempSpace::PackedFile* const packed = FB_NEW_POOL(pool) TempSpace::PackedFile(pool, file);
+	packed->extend(size);
+	return packed;
+}
+
+// Read pages of the given range to evict and store all modified pages
+static void flush(TempSpace::PackedFile* file, FB_UINT64 firstPage, FB_SIZE_T count)
+{
+	UCHAR byte;
+	for (FB_SIZE_T i = 0; i < count; i++)
+		file->read((firstPage + i) * PAGE_SIZE, &byte, 1);
+}
+
+
+BOOST_AUTO_TEST_SUITE(EngineSuite)
+BOOST_AUTO_TEST_SUITE(PackedFileSuite)
+BOOST_AUTO_TEST_SUITE(PackedFileTests)
+
+BOOST_AUTO_TEST_CASE(RoundTripTest)
+{
+	// Much more pages than cached, written and read by unaligned pieces
+	const FB_SIZE_T length = 40 * PAGE_SIZE + 1234;
+	Array<UCHAR> data, check;
+
+	fillHalf(data.getBuffer(length), length, 1);
+	AutoPtr<TempSpace::PackedFile> file(createFile(length));
+
+	for (FB_SIZE_T offset = 0; offset < length; offset += 9999)
+		file->write(offset, data.begin() + offset, MIN(9999u, length - offset));
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		UCHAR* const buffer = check.getBuffer(length);
+		memset(buffer, 0, length);
+
+		for (FB_SIZE_T offset = 0; offset < length; offset += 7777)
+			file->read(offset, buffer + offset, MIN(7777u, length - offset));
+
+		BOOST_TEST(memcmp(buffer, data.begin(), length) == 0);
+	}
+
+	// Overwrite the middle of the file with incompressible data
+	fillRandom(data.begin() + 3 * PAGE_SIZE + 100, 5 * PAGE_SIZE, 2);
+	file->write(3 * PAGE_SIZE + 100, data.begin() + 3 * PAGE_SIZE + 100, 5 * PAGE_SIZE);
+	flush(file, 20, 20);
+
+	file->read(0, check.begin(), length);
+	BOOST_TEST(memcmp(check.begin(), data.begin(), length) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(InterleavedStreamsTest)
+{
+	// Runs merged by sort are read interleaved, each stream sequentially
+	const FB_SIZE_T streams = 40;
+	const FB_SIZE_T streamLength = 2 * PAGE_SIZE;
+	const FB_SIZE_T piece = 4096;
+	const FB_SIZE_T length = streams * streamLength;
+
+	Array<UCHAR> data;
+	fillHalf(data.getBuffer(length), length, 3);
+
+	AutoPtr<TempSpace::PackedFile> file(createFile(length));
+	file->setCachePages(streams + 1);
+	file->write(0, data.begin(), length);
+
+	UCHAR buffer[piece];
+	bool matches = true;
+
+	for (FB_SIZE_T offset = 0; offset < streamLength; offset += piece)
+	{
+		for (FB_SIZE_T stream = 0; stream < streams; stream++)
+		{
+			const offset_t position = stream * streamLength + offset;
+			file->read(position, buffer, piece);
+			matches = matches && !memcmp(buffer, data.begin() + position, piece);
+		}
+	}
+
+	BOOST_TEST(matches);
+}
+
+BOOST_AUTO_TEST_CASE(ShrinkCacheTest)
+{
+	// Modified pages of the grown cache are stored when it shrinks
+	const FB_SIZE_T length = 100 * PAGE_SIZE;
+
+	Array<UCHAR> data, check;
+	fillHalf(data.getBuffer(length), length, 5);
+
+	AutoPtr<TempSpace::PackedFile> file(createFile(length));
+	file->setCachePages(100);
+	file->write(0, data.begin(), length);
+
+	file->setCachePages(0);
+
+	file->read(0, check.getBuffer(length), length);
+	BOOST_TEST(memcmp(check.begin(), data.begin(), length) == 0);
+
+	// And the cache may grow again
+	file->setCachePages(50);
+	file->read(0, check.begin(), length);
+	BOOST_TEST(memcmp(check.begin(), data.begin(), length) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(SlotReuseTest)
+{
+	const FB_SIZE_T pages = 64;
+	const FB_SIZE_T length = pages * PAGE_SIZE;
+	Array<UCHAR> data;
+	UCHAR* const buffer = data.getBuffer(PAGE_SIZE);
+
+	AutoPtr<TempSpace::PackedFile> file(createFile(length + 32 * PAGE_SIZE));
+
+	for (FB_SIZE_T page = 0; page < pages; page++)
+	{
+		fillHalf(buffer, PAGE_SIZE, page);
+		file->write(page * PAGE_SIZE, buffer, PAGE_SIZE);
+	}
+
+	flush(file, pages, 32);
+	const offset_t packedSize = file->getFile()->getSize();
+
+	// Pages grow, slots released by neighbours are merged and reused
+
+	for (FB_SIZE_T page = 0; page < pages; page++)
+	{
+		fillRandom(buffer, PAGE_SIZE, page);
+		file->write(page * PAGE_SIZE, buffer, PAGE_SIZE);
+	}
+
+	flush(file, pages, 32);
+	const offset_t grownSize = file->getFile()->getSize();
+
+	BOOST_TEST(grownSize - packedSize <= (offset_t) length * 3 / 4);
+
+	// Pages shrink and grow back in place
+
+	for (FB_SIZE_T page = 0; page < pages; page++)
+	{
+		fillHalf(buffer, PAGE_SIZE, page);
+		file->write(page * PAGE_SIZE, buffer, PAGE_SIZE);
+	}
+
+	flush(file, pages, 32);
+
+	for (FB_SIZE_T page = 0; page < pages; page++)
+	{
+		fillRandom(buffer, PAGE_SIZE, page);
+		file->write(page * PAGE_SIZE, buffer, PAGE_SIZE);
+	}
+
+	flush(file, pages, 32);
+	BOOST_TEST(file->getFile()->getSize() == grownSize);
+
+	bool matches = true;
+	Array<UCHAR> expected;
+	UCHAR* const page0 = expected.getBuffer(PAGE_SIZE);
+
+	for (FB_SIZE_T page = 0; page < pages; page++)
+	{
+		fillRandom(page0, PAGE_SIZE, page);
+		file->read(page * PAGE_SIZE, buffer, PAGE_SIZE);
+		matches = matches && !memcmp(buffer, page0, PAGE_SIZE);
+	}
+
+	BOOST_TEST(matches);
+}
+
+BOOST_AUTO_TEST_SUITE_END()	// PackedFileTests
+
+
+BOOST_AUTO_TEST_SUITE_END()	// PackedFileSuite
+BOOST_AUTO_TEST_SUITE_END()	// EngineSuite
@@ -0,0 +1,41 @@
+#include "firebird.h"
+#include "boost/test/unit_test.hpp"
+#include "../burp/BurpTasks.h"
+
+using namespace Burp;
+
+
+BOOST_AUTO_TEST_SUITE(EngineSuite)
+BOOST_AUTO_TEST_SUITE(RestoreIndexSuite)
+BOOST_AUTO_TEST_SUITE(RestoreIndexTests)
+
+BOOST_AUTO_TEST_CASE(ActiveIndexTest)
+{
+	// Active index of the backup is stored as deferred when att_index_inactive is read
+	BOOST_TEST(RestoreIndexTask::canActivate(DEFERRED_ACTIVE, false, false));
+
+	// Backups without att_index_inactive
+	BOOST_TEST(RestoreIndexTask::canActivate(FALSE, false, false));
+}
+
+BOOST_AUTO_TEST_CASE(InactiveIndexTest)
+{
+	// Index inactive in the source database or restore with -i
+	BOOST_TEST(!RestoreIndexTask::canActivate(TRUE, false, false));
+	BOOST_TEST(!RestoreIndexTask::canActivate(TRUE, true, false));
+	BOOST_TEST(!RestoreIndexTask::canActivate(TRUE, false, true));
+}
+
+BOOST_AUTO_TEST_CASE(FinalStepIndexTest)
+{
+	// Foreign key and expression indices are activated at the end of restore
+	BOOST_TEST(!RestoreIndexTask::canActivate(DEFERRED_ACTIVE, true, false));
+	BOOST_TEST(!RestoreIndexTask::canActivate(DEFERRED_ACTIVE, false, true));
+	BOOST_TEST(!RestoreIndexTask::canActivate(DEFERRED_ACTIVE, true, true));
+}
+
+BOOST_AUTO_TEST_SUITE_END()	// RestoreIndexTests
+
+
+BOOST_AUTO_TEST_SUITE_END()	// RestoreIndexSuite
+BOOST_AUTO_TEST_SUITE_END()	// EngineSuite
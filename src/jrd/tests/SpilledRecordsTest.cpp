@@ -0,0 +1,185 @@
+#include "firebird.h"
+#include "boost/test/unit_test.hpp"
+#include "../jrd/tra.h"
+#include "../jrd/TempSpace.h"
+#include <set>
+
+using namespace Firebird;
+using namespace Jrd;
+
+typedef std::set<FB_UINT64> NumberSet;
+
+static void fill(RecordBitmap** bitmap, NumberSet& reference, FB_UINT64 from, FB_UINT64 to, FB_UINT64 step)
+{
+	for (FB_UINT64 value = from; value < to; value += step)
+	{
+		RBM_SET(getDefaultMemoryPool(), bitmap, value);
+		reference.insert(value);
+	}
+}
+
+static bool matches(RecordBitmap* bitmap, const NumberSet& reference)
+{
+	NumberSet::const_iterator iter = reference.begin();
+
+	RecordBitmap::Accessor accessor(bitmap);
+	for (bool found = accessor.getFirst(); found; found = accessor.getNext())
+	{
+		if (iter == reference.end() || *iter != accessor.current())
+			return false;
+		++iter;
+	}
+
+	return iter == reference.end();
+}
+
+BOOST_AUTO_TEST_SUITE(EngineSuite)
+BOOST_AUTO_TEST_SUITE(SpilledRecordsSuite)
+
+
+BOOST_AUTO_TEST_SUITE(SpilledRecordsTests)
+
+BOOST_AUTO_TEST_CASE(SpillTestLoadTest)
+{
+	MemoryPool& pool = *getDefaultMemoryPool();
+	TempSpace space(pool, "fb_test_");
+	SpilledRecords spilled(pool, &space);
+	NumberSet reference;
+
+	RecordBitmap* bitmap = NULL;
+	fill(&bitmap, reference, 10, 100000, 7);
+	spilled.spill(bitmap);
+	delete bitmap;
+	bitmap = NULL;
+
+	BOOST_TEST(spilled.getRunCount() == 1u);
+	BOOST_TEST(spilled.test(10));
+	BOOST_TEST(spilled.test(10 + 7 * 1000));
+	BOOST_TEST(spilled.test(10 + 7 * 14284));
+	BOOST_TEST(!spilled.test(11));
+	BOOST_TEST(!spilled.test(9));
+	BOOST_TEST(!spilled.test(1000000));
+
+	spilled.load(&bitmap);
+	BOOST_TEST(matches(bitmap, reference));
+	delete bitmap;
+
+	spilled.release();
+	BOOST_TEST(spilled.getRunCount() == 0u);
+	BOOST_TEST(!spilled.test(10));
+}
+
+BOOST_AUTO_TEST_CASE(MergeRunsTest)
+{
+	MemoryPool& pool = *getDefaultMemoryPool();
+	TempSpace space(pool, "fb_test_");
+	SpilledRecords spilled(pool, &space);
+	NumberSet reference;
+
+	// Many small overlapping spills, as made by every statement of a large transaction
+	for (FB_UINT64 i = 0; i < 1000; i++)
+	{
+		RecordBitmap* bitmap = NULL;
+		fill(&bitmap, reference, i * 100, i * 100 + 300, 3);
+		spilled.spill(bitmap);
+		delete bitmap;
+
+		// Runs are merged, so there are about log2 of spills of them
+		BOOST_TEST(spilled.getRunCount() <= 11u);
+	}
+
+	for (FB_UINT64 value = 0; value < 100300; value++)
+		BOOST_TEST(spilled.test(value) == (reference.find(value) != reference.end()));
+
+	// Duplicates are removed by merges
+	RecordBitmap* bitmap = NULL;
+	spilled.load(&bitmap);
+	BOOST_TEST(matches(bitmap, reference));
+	delete bitmap;
+
+	spilled.release();
+}
+
+BOOST_AUTO_TEST_CASE(RemoveTest)
+{
+	MemoryPool& pool = *getDefaultMemoryPool();
+	TempSpace space(pool, "fb_test_");
+	SpilledRecords spilled(pool, &space);
+	NumberSet reference;
+
+	// Two overlapping runs
+	RecordBitmap* bitmap = NULL;
+	fill(&bitmap, reference, 0, 3000, 3);
+	spilled.spill(bitmap);
+	delete bitmap;
+
+	bitmap = NULL;
+	fill(&bitmap, reference, 1500, 1800, 1);
+	spilled.spill(bitmap);
+	delete bitmap;
+
+	BOOST_TEST(spilled.getRunCount() == 2u);
+
+	// Number of both runs
+	BOOST_TEST(spilled.remove(1503));
+	BOOST_TEST(!spilled.test(1503));
+	reference.erase(1503);
+
+	BOOST_TEST(spilled.remove(1501));
+	BOOST_TEST(!spilled.remove(1501));
+	BOOST_TEST(!spilled.remove(1));
+	BOOST_TEST(!spilled.remove(100000));
+	reference.erase(1501);
+
+	// Whole first block of the first run
+	for (FB_UINT64 value = 0; value < 3 * 256; value += 3)
+	{
+		BOOST_TEST(spilled.remove(value));
+		reference.erase(value);
+	}
+
+	// Whole second run
+	for (FB_UINT64 value = 1500; value < 1800; value++)
+	{
+		spilled.remove(value);
+		reference.erase(value);
+	}
+
+	BOOST_TEST(spilled.getRunCount() == 1u);
+
+	for (FB_UINT64 value = 0; value < 3000; value++)
+		BOOST_TEST(spilled.test(value) == (reference.find(value) != reference.end()));
+
+	// Runs are still merged correctly
+	bitmap = NULL;
+	fill(&bitmap, reference, 2000, 4000, 2);
+	spilled.spill(bitmap);
+	delete bitmap;
+
+	bitmap = NULL;
+	spilled.load(&bitmap);
+	BOOST_TEST(matches(bitmap, reference));
+	delete bitmap;
+
+	spilled.release();
+}
+
+BOOST_AUTO_TEST_CASE(EmptySpillTest)
+{
+	MemoryPool& pool = *getDefaultMemoryPool();
+	TempSpace space(pool, "fb_test_");
+	SpilledRecords spilled(pool, &space);
+
+	RecordBitmap bitmap(pool);
+	spilled.spill(&bitmap);
+	spilled.spill(NULL);
+
+	BOOST_TEST(spilled.getRunCount() == 0u);
+	BOOST_TEST(!spilled.test(0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()	// SpilledRecordsTests
+
+
+BOOST_AUTO_TEST_SUITE_END()	// SpilledRecordsSuite
+BOOST_AUTO_TEST_SUITE_END()	// EngineSuite
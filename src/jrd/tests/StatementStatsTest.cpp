@@ -0,0 +1,167 @@
+#include "firebird.h"
+#include "boost/test/unit_test.hpp"
+#include "../jrd/tra.h"
+#include "../jrd/StatementStats.h"
+
+using namespace Firebird;
+using namespace Jrd;
+
+static const StatementStats::Entry* findEntry(const StatementStats::EntryList& entries, FB_UINT64 hash)
+{
+	for (FB_SIZE_T i = 0; i < entries.getCount(); i++)
+	{
+		if (entries[i].hash == hash)
+			return &entries[i];
+	}
+
+	return NULL;
+}
+
+
+BOOST_AUTO_TEST_SUITE(EngineSuite)
+BOOST_AUTO_TEST_SUITE(StatementStatsSuite)
+BOOST_AUTO_TEST_SUITE(StatementStatsTests)
+
+BOOST_AUTO_TEST_CASE(HashTextTest)
+{
+	const FB_UINT64 hash = StatementStats::hashText("select 1 from rdb$database");
+
+	// Runs of whitespace are collapsed, leading and trailing ones are ignored
+	BOOST_TEST(StatementStats::hashText("select  1\r\n from\trdb$database") == hash);
+	BOOST_TEST(StatementStats::hashText("\n  select 1 from rdb$database  \n") == hash);
+
+	BOOST_TEST(StatementStats::hashText("select 1 from rdb$database") == hash);
+	BOOST_TEST(StatementStats::hashText("select 2 from rdb$database") != hash);
+	BOOST_TEST(StatementStats::hashText("SELECT 1 FROM RDB$DATABASE") != hash);
+	BOOST_TEST(StatementStats::hashText("select 1from rdb$database") != hash);
+
+	BOOST_TEST(StatementStats::hashText("") != 0u);
+	BOOST_TEST(StatementStats::hashText(" ") == StatementStats::hashText(""));
+}
+
+BOOST_AUTO_TEST_CASE(AccumulateTest)
+{
+	StatementStats stats(*getDefaultMemoryPool());
+
+	SINT64 counters[StatementStats::CNT_COUNT];
+	for (unsigned i = 0; i < StatementStats::CNT_COUNT; i++)
+		counters[i] = i + 1;
+
+	const string sql1("select * from t1"), sql2("select * from t2");
+	const FB_UINT64 hash1 = StatementStats::hashText(sql1), hash2 = StatementStats::hashText(sql2);
+
+	stats.accumulate(hash1, sql1, 100, counters);
+	stats.accumulate(hash1, sql1, 300, counters);
+	stats.accumulate(hash1, sql1, 200, counters);
+	stats.accumulate(hash2, sql2, 50, counters);
+
+	StatementStats::EntryList entries;
+	stats.getEntries(entries);
+	BOOST_TEST(entries.getCount() == 2u);
+
+	const StatementStats::Entry* const entry1 = findEntry(entries, hash1);
+	BOOST_TEST_REQUIRE(entry1);
+	BOOST_TEST((entry1->sqlText == sql1));
+	BOOST_TEST(entry1->executions == 3);
+	BOOST_TEST(entry1->totalTime == 600);
+	BOOST_TEST(entry1->maxTime == 300);
+
+	for (unsigned i = 0; i < StatementStats::CNT_COUNT; i++)
+		BOOST_TEST(entry1->counters[i] == 3 * (SINT64) (i + 1));
+
+	const StatementStats::Entry* const entry2 = findEntry(entries, hash2);
+	BOOST_TEST_REQUIRE(entry2);
+	BOOST_TEST(entry2->executions == 1);
+	BOOST_TEST(entry2->maxTime == 50);
+	BOOST_TEST(entry2->counters[StatementStats::CNT_SORTS] == counters[StatementStats::CNT_SORTS]);
+}
+
+BOOST_AUTO_TEST_CASE(ResetTest)
+{
+	StatementStats stats(*getDefaultMemoryPool());
+
+	SINT64 counters[StatementStats::CNT_COUNT] = {0};
+	stats.accumulate(1, "select 1 from rdb$database", 10, counters);
+	stats.accumulate(2, "select 2 from rdb$database", 10, counters);
+
+	BOOST_TEST(stats.reset() == 2);
+	BOOST_TEST(stats.reset() == 0);
+
+	StatementStats::EntryList entries;
+	stats.getEntries(entries);
+	BOOST_TEST(entries.isEmpty());
+
+	// Entry starts from scratch after reset
+	stats.accumulate(1, "select 1 from rdb$database", 20, counters);
+	entries.clear();
+	stats.getEntries(entries);
+	BOOST_TEST(entries.getCount() == 1u);
+	BOOST_TEST(entries[0].executions == 1);
+	BOOST_TEST(entries[0].totalTime == 20);
+}
+
+BOOST_AUTO_TEST_CASE(LimitTest)
+{
+	StatementStats stats(*getDefaultMemoryPool());
+	SINT64 counters[StatementStats::CNT_COUNT] = {0};
+
+	// Executed more times than the others, so never evicted
+	stats.accumulate(1, "select 1 from rdb$database", 1, counters);
+	stats.accumulate(1, "select 1 from rdb$database", 1, counters);
+
+	// Every partition is offered more statements than it keeps
+	const unsigned limit = StatementStats::PARTITIONS * StatementStats::MAX_PARTITION_ENTRIES;
+
+	for (FB_UINT64 hash = 2; hash <= limit + StatementStats::PARTITIONS * 10; hash++)
+		stats.accumulate(hash, "select 2 from rdb$database", 1, counters);
+
+	StatementStats::EntryList entries;
+	stats.getEntries(entries);
+	BOOST_TEST(entries.getCount() == limit);
+
+	// The most recent statement took the place of an older one
+	BOOST_TEST(findEntry(entries, limit + StatementStats::PARTITIONS * 10));
+
+	// Frequent statement is still accumulated
+	stats.accumulate(1, "select 1 from rdb$database", 1, counters);
+	entries.clear();
+	stats.getEntries(entries);
+	const StatementStats::Entry* const entry = findEntry(entries, 1);
+	BOOST_TEST_REQUIRE(entry);
+	BOOST_TEST(entry->executions == 3);
+
+	BOOST_TEST(stats.reset() == (SINT64) limit);
+}
+
+BOOST_AUTO_TEST_CASE(EvictionTest)
+{
+	StatementStats stats(*getDefaultMemoryPool());
+	SINT64 counters[StatementStats::CNT_COUNT] = {0};
+
+	// Fill a single partition, entries executed a different number of times
+	const FB_UINT64 step = StatementStats::PARTITIONS;
+	const FB_UINT64 count = StatementStats::MAX_PARTITION_ENTRIES;
+
+	for (FB_UINT64 i = 1; i <= count; i++)
+	{
+		for (FB_UINT64 n = (i == count / 2) ? 1 : 2; n; n--)
+			stats.accumulate(i * step, "select 1 from rdb$database", 1, counters);
+	}
+
+	// The least executed one gives its place
+	stats.accumulate((count + 1) * step, "select 2 from rdb$database", 1, counters);
+
+	StatementStats::EntryList entries;
+	stats.getEntries(entries);
+	BOOST_TEST(entries.getCount() == count);
+	BOOST_TEST(!findEntry(entries, count / 2 * step));
+	BOOST_TEST(findEntry(entries, (count + 1) * step));
+	BOOST_TEST(findEntry(entries, step));
+	BOOST_TEST(findEntry(entries, count * step));
+}
+
+BOOST_AUTO_TEST_SUITE_END()	// StatementStatsTests
+
+
+BOOST_AUTO_TEST_SUITE_END()	// StatementStatsSuite
+BOOST_AUTO_TEST_SUITE_END()	// EngineSuite
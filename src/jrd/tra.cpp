@@ -1406,7 +1406,7 @@ void TRA_rollback(thread_db* tdbb, jrd_tra* transaction, const bool retaining_fl
 			if (transaction->tra_save_point)
 			{
 				// We still can use the undo log for rollback, it wasn't reset because of
-				// no_auto_undo flag or being oversized
+				// no_auto_undo flag
 
 				fb_assert(transaction->tra_save_point->isRoot());
 
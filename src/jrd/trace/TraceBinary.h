@@ -0,0 +1,95 @@
+/*
+ *	PROGRAM:	Firebird Trace Services
+ *	MODULE:		TraceBinary.h
+ *	DESCRIPTION:	Binary trace log records
+ *
+ *  The contents of this file are subject to the Initial
+ *  Developer's Public License Version 1.0 (the "License");
+ *  you may not use this file except in compliance with the
+ *  License. You may obtain a copy of the License at
+ *  http://www.ibphoenix.com/main.nfs?a=ibphoenix&page=ibp_idpl.
+ *
+ *  Software distributed under the License is distributed AS IS,
+ *  WITHOUT WARRANTY OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing rights
+ *  and limitations under the License.
+ *
+ *  The Original Code was created for the Firebird Open Source RDBMS project.
+ *
+ *  Copyright (c) 2026 Firebird Project and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+ *
+ */
+
+#ifndef JRD_TRACE_BINARY_H
+#define JRD_TRACE_BINARY_H
+
+// Binary log format of the fbtrace plugin (binary_format = true).
+//
+// The log is a sequence of records, each one starts with RecordHeader and is
+// followed by "length" bytes of payload. Frequent events have fixed layouts,
+// descriptions of connections, transactions and statements are written once
+// when the object is registered by the plugin and referenced by ID later.
+// All other events are stored as formatted text. Records use native byte order,
+// the log is decoded by "fbtracemgr -decode" on a platform of the same kind.
+
+namespace Jrd {
+namespace TraceBinary {
+
+const ULONG RECORD_SIGNATURE = 0x52544246;	// "FBTR"
+
+enum RecordType
+{
+	REC_TEXT = 1,				// formatted text of an event
+	REC_DESCRIPTION = 2,		// DescriptionRecord + description text
+	REC_STATEMENT_FINISH = 3	// StatementFinishRecord + parameters text + tables text
+};
+
+enum DescriptionKind
+{
+	DESC_CONNECTION = 1,
+	DESC_TRANSACTION = 2,
+	DESC_STATEMENT = 3
+};
+
+struct RecordHeader
+{
+	ULONG signature;
+	USHORT type;
+	USHORT reserved;
+	ULONG length;			// length of the payload
+	ULONG processId;
+	SINT64 source;			// plugin instance which produced the record
+	ISC_TIMESTAMP stamp;
+};
+
+struct DescriptionRecord
+{
+	ULONG kind;
+	ULONG reserved;
+	SINT64 id;
+};
+
+struct StatementFinishRecord
+{
+	SINT64 connectionId;
+	SINT64 transactionId;	// zero if not in a transaction
+	SINT64 statementId;
+	SINT64 time;			// milliseconds
+	SINT64 recordsFetched;
+	SINT64 reads;
+	SINT64 writes;
+	SINT64 fetches;
+	SINT64 marks;
+	ULONG result;			// ntrace_result_t
+	ULONG paramsLength;
+	ULONG tablesLength;
+	ULONG reserved;
+};
+
+} // namespace TraceBinary
+} // namespace Jrd
+
+#endif // JRD_TRACE_BINARY_H
@@ -34,10 +34,20 @@
 #include "../../common/UtilSvc.h"
 #include "../common/classes/Switches.h"
 #include "../../jrd/trace/traceswi.h"
+#include "../../jrd/trace/TraceBinary.h"
 #include "../../jrd/trace/TraceService.h"
 #include "../common/classes/MsgPrint.h"
 #include "../common/classes/ClumpletReader.h"
 #include "../jrd/license.h"
+#include "../common/classes/GenericMap.h"
+#include "../common/classes/timestamp.h"
+#include "../common/os/os_utils.h"
+
+#ifdef WIN_NT
+#define NEWLINE "\r\n"
+#else
+#define NEWLINE "\n"
+#endif
 
 
 namespace
@@ -98,12 +108,23 @@ namespace
 		const int EXAMPLES[] = {22, 27};
 		const int NOTES[] = {28, 29};
 
+		// Added later, printed after the last action and the last example
+		const int LIST_USAGE = 10;
+		const int DECODE_USAGE = 41;
+		const int DECODE_EXAMPLE = 42;
+
 		for (int i = MAIN_USAGE[0]; i <= MAIN_USAGE[1]; ++i)
+		{
 			printMsg(i);
 
+			if (i == LIST_USAGE)
+				printMsg(DECODE_USAGE);
+		}
+
 		printf("\n");
 		for (int i = EXAMPLES[0]; i <= EXAMPLES[1]; ++i)
 			printMsg(i);
+		printMsg(DECODE_EXAMPLE);
 
 		printf("\n");
 		for (int i = NOTES[0]; i <= NOTES[1]; ++i)
@@ -111,6 +132,188 @@ namespace
 
 		exit(FINI_ERROR);
 	}
+
+	// Decode binary log of fbtrace plugin into the same text it writes in text mode
+	class BinaryLogDecoder
+	{
+	public:
+		explicit BinaryLogDecoder(const char* fileName)
+			: m_fileName(fileName),
+			  m_file(NULL),
+			  m_descriptions(*getDefaultMemoryPool())
+		{
+		}
+
+		~BinaryLogDecoder()
+		{
+			if (m_file)
+				fclose(m_file);
+		}
+
+		void run()
+		{
+			using namespace Jrd::TraceBinary;
+
+			m_file = os_utils::fopen(m_fileName, "rb");
+			if (!m_file)
+			{
+				(Arg::Gds(isc_io_error) << Arg::Str("fopen") << Arg::Str(m_fileName) <<
+					Arg::Gds(isc_io_open_err) << Arg::OsError()).raise();
+			}
+
+			RecordHeader header;
+			HalfStaticArray<char, 1024> payload;
+			SINT64 offset = 0;
+
+			while (fread(&header, sizeof(header), 1, m_file) == 1)
+			{
+				if (header.signature != RECORD_SIGNATURE ||
+					fread(payload.getBuffer(header.length), 1, header.length, m_file) != header.length)
+				{
+					(Arg::Gds(isc_trace_bad_log) << Arg::Num(offset) << Arg::Str(m_fileName)).raise();
+				}
+
+				switch (header.type)
+				{
+					case REC_TEXT:
+						fwrite(payload.begin(), 1, payload.getCount(), stdout);
+						break;
+
+					case REC_DESCRIPTION:
+					{
+						if (header.length < sizeof(DescriptionRecord))
+							(Arg::Gds(isc_trace_bad_log) << Arg::Num(offset) << Arg::Str(m_fileName)).raise();
+
+						DescriptionRecord desc;
+						memcpy(&desc, payload.begin(), sizeof(desc));
+
+						m_descriptions.put(makeKey(header, desc.kind, desc.id),
+							string(payload.begin() + sizeof(desc), header.length - sizeof(desc)));
+						break;
+					}
+
+					case REC_STATEMENT_FINISH:
+					{
+						StatementFinishRecord rec;
+						if (header.length < sizeof(rec))
+							(Arg::Gds(isc_trace_bad_log) << Arg::Num(offset) << Arg::Str(m_fileName)).raise();
+
+						memcpy(&rec, payload.begin(), sizeof(rec));
+
+						// check every length against the rest of payload, their sum may overflow
+						const ULONG textLength = header.length - sizeof(rec);
+
+						if (rec.paramsLength > textLength || rec.tablesLength != textLength - rec.paramsLength)
+							(Arg::Gds(isc_trace_bad_log) << Arg::Num(offset) << Arg::Str(m_fileName)).raise();
+
+						printStatementFinish(header, rec, payload.begin() + sizeof(rec));
+						break;
+					}
+
+					default:
+						// Unknown record, skip it
+						break;
+				}
+
+				offset += sizeof(header) + header.length;
+			}
+
+			if (!feof(m_file))
+			{
+				(Arg::Gds(isc_io_error) << Arg::Str("fread") << Arg::Str(m_fileName) <<
+					Arg::Gds(isc_io_read_err) << Arg::OsError()).raise();
+			}
+		}
+
+	private:
+		typedef GenericMap<Pair<Full<string, string> > > DescriptionsMap;
+
+		static string makeKey(const Jrd::TraceBinary::RecordHeader& header, ULONG kind, SINT64 id)
+		{
+			string key;
+			key.printf("%u:%" SQUADFORMAT":%u:%" SQUADFORMAT,
+				header.processId, header.source, kind, id);
+			return key;
+		}
+
+		void printDescription(const Jrd::TraceBinary::RecordHeader& header, ULONG kind, SINT64 id,
+			const char* unknownFormat)
+		{
+			const string* desc = m_descriptions.get(makeKey(header, kind, id));
+
+			if (desc)
+				fwrite(desc->c_str(), 1, desc->length(), stdout);
+			else
+				printf(unknownFormat, id);
+		}
+
+		void printStatementFinish(const Jrd::TraceBinary::RecordHeader& header,
+			const Jrd::TraceBinary::StatementFinishRecord& rec, const char* text)
+		{
+			using namespace Jrd::TraceBinary;
+
+			const char* eventType;
+			switch (rec.result)
+			{
+				case ITracePlugin::RESULT_SUCCESS:
+					eventType = "EXECUTE_STATEMENT_FINISH";
+					break;
+				case ITracePlugin::RESULT_FAILED:
+					eventType = "FAILED EXECUTE_STATEMENT_FINISH";
+					break;
+				case ITracePlugin::RESULT_UNAUTHORIZED:
+					eventType = "UNAUTHORIZED EXECUTE_STATEMENT_FINISH";
+					break;
+				default:
+					eventType = "Unknown event at executing statement";
+					break;
+			}
+
+			struct tm times;
+			int fractions;
+			TimeStamp(header.stamp).decode(&times, &fractions);
+
+			printf("%04d-%02d-%02dT%02d:%02d:%02d.%04d (%d:%p) %s" NEWLINE,
+				times.tm_year + 1900, times.tm_mon + 1, times.tm_mday, times.tm_hour,
+				times.tm_min, times.tm_sec, fractions, (int) header.processId,
+				(void*) (IPTR) header.source, eventType);
+
+			printDescription(header, DESC_CONNECTION, rec.connectionId,
+				"\t(ATT_%" SQUADFORMAT", <unknown>)" NEWLINE);
+
+			if (rec.transactionId)
+			{
+				printDescription(header, DESC_TRANSACTION, rec.transactionId,
+					"\t\t(TRA_%" SQUADFORMAT", <unknown>)" NEWLINE);
+			}
+
+			printDescription(header, DESC_STATEMENT, rec.statementId,
+				NEWLINE "Statement %" SQUADFORMAT", <unknown>:" NEWLINE);
+
+			fwrite(text, 1, rec.paramsLength, stdout);
+
+			printf("%" SQUADFORMAT" records fetched" NEWLINE, rec.recordsFetched);
+			printf("%7" SQUADFORMAT" ms", rec.time);
+
+			if (rec.reads)
+				printf(", %" SQUADFORMAT" read(s)", rec.reads);
+			if (rec.writes)
+				printf(", %" SQUADFORMAT" write(s)", rec.writes);
+			if (rec.fetches)
+				printf(", %" SQUADFORMAT" fetch(es)", rec.fetches);
+			if (rec.marks)
+				printf(", %" SQUADFORMAT" mark(s)", rec.marks);
+
+			printf(NEWLINE);
+
+			fwrite(text + rec.paramsLength, 1, rec.tablesLength, stdout);
+			printf(NEWLINE);
+		}
+
+		const char* m_fileName;
+		FILE* m_file;
+		DescriptionsMap m_descriptions;
+	};
 }
 
 
@@ -171,6 +374,31 @@ void fbtrace(UtilSvc* uSvc, TraceSvcIntf* traceSvc)
 			usage(uSvc, isc_trace_act_notfound);
 	}
 
+	if (action_sw->in_sw == IN_SW_TRACE_DECODE)
+	{
+		if (uSvc->isService())
+			usage(uSvc, isc_trace_switch_user_only, action_sw->in_sw_name);
+
+		const char* fileName = NULL;
+		for (int itr = 1; itr < argc; ++itr)
+		{
+			if (!argv[itr])
+				continue;
+
+			if (fileName)
+				usage(uSvc, isc_trace_switch_unknown, argv[itr]);
+
+			fileName = argv[itr];
+		}
+
+		if (!fileName)
+			usage(uSvc, isc_trace_param_val_miss, action_sw->in_sw_name);
+
+		BinaryLogDecoder decoder(fileName);
+		decoder.run();
+		return;
+	}
+
 	// search for action's parameters, set NULL into recognized argv
 	const Switches optSwitches(trace_option_in_sw_table, FB_NELEM(trace_option_in_sw_table),
 								false, true);
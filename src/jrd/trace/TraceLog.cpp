@@ -144,6 +144,14 @@ FB_SIZE_T TraceLog::write(const void* buf, FB_SIZE_T size)
 	if (!size)
 		return 0;
 
+	return writeRecords(buf, &size, 1) ? size : 0;
+}
+
+FB_SIZE_T TraceLog::writeRecords(const void* buf, const FB_SIZE_T* ends, FB_SIZE_T count)
+{
+	if (!count)
+		return 0;
+
 	fb_assert(!m_reader);
 
 	TraceLogGuard guard(this);
@@ -152,11 +160,12 @@ FB_SIZE_T TraceLog::write(const void* buf, FB_SIZE_T size)
 
 	// if reader already gone, don't write anything
 	if (header->flags & FLAG_DONE)
-		return size;
+		return count;
 
 	if (header->flags & FLAG_FULL)
 		return 0;
 
+	const FB_SIZE_T size = ends[count - 1];
 	const FB_SIZE_T msgLen = m_fullMsg.length();
 
 	if (header->allocated < header->maxSize && (size + msgLen) > getFree(false))
@@ -165,21 +174,32 @@ FB_SIZE_T TraceLog::write(const void* buf, FB_SIZE_T size)
 		header = m_sharedMemory->getHeader();
 	}
 
-	if (size + msgLen > getFree(true))	// log is full
+	// whole records which fit the log leaving the room for m_fullMsg
+	const FB_SIZE_T free = getFree(true);
+	FB_SIZE_T fit = count;
+
+	while (fit && ends[fit - 1] + msgLen > free)
+		fit--;
+
+	if (fit)
+		put(buf, ends[fit - 1]);
+
+	if (fit < count)	// log is full
 	{
 		header->flags |= FLAG_FULL;
 
-		if (!msgLen)
-			return 0;
-
-		// write m_fullMsg into log and return zero
-		buf = m_fullMsg.c_str();
-		size = msgLen;
+		if (msgLen)
+			put(m_fullMsg.c_str(), msgLen);
 	}
 
+	return fit;
+}
+
+void TraceLog::put(const void* buf, FB_SIZE_T size)
+{
+	TraceLogHeader* header = m_sharedMemory->getHeader();
 	char* data = reinterpret_cast<char*> (header);
 	const char* src = reinterpret_cast<const char*> (buf);
-	FB_SIZE_T writeCnt = 0;
 
 	if (header->writePos >= header->readPos)
 	{
@@ -190,7 +210,6 @@ FB_SIZE_T TraceLog::write(const void* buf, FB_SIZE_T size)
 		if (header->writePos == header->allocated)
 			header->writePos = sizeof(TraceLogHeader);
 
-		writeCnt += toWrite;
 		src += toWrite;
 		size -= toWrite;
 	}
@@ -201,17 +220,11 @@ FB_SIZE_T TraceLog::write(const void* buf, FB_SIZE_T size)
 		memcpy(data + header->writePos, src, toWrite);
 
 		header->writePos += toWrite;
-		writeCnt += toWrite;
 		src += toWrite;
 		size -= toWrite;
 	}
 
 	fb_assert(size == 0);
-
-	if (header->flags & FLAG_FULL)
-		return 0;
-
-	return writeCnt;
 }
 
 void TraceLog::extend(FB_SIZE_T size)
@@ -52,6 +52,9 @@ public:
 
 	FB_SIZE_T read(void* buf, FB_SIZE_T size);
 	FB_SIZE_T write(const void* buf, FB_SIZE_T size);
+	// write records placed one after another, ends are offsets past each record,
+	// returns number of records written, records which don't fit are dropped
+	FB_SIZE_T writeRecords(const void* buf, const FB_SIZE_T* ends, FB_SIZE_T count);
 
 	bool isFull();		// true if free space left is less than threshold
 	void setFullMsg(const char* str);
@@ -74,6 +77,7 @@ private:
 	FB_SIZE_T getUsed();	// available to read
 	FB_SIZE_T getFree(bool useMax);	// available for write
 	void extend(FB_SIZE_T size);
+	void put(const void* buf, FB_SIZE_T size);
 
 	Firebird::AutoPtr<Firebird::SharedMemory<TraceLogHeader> > m_sharedMemory;
 	bool m_reader;
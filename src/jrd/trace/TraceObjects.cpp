@@ -28,6 +28,7 @@
 #include "firebird.h"
 
 #include "../../common/classes/auto.h"
+#include "../../common/classes/TimerImpl.h"
 #include "../../common/utils_proto.h"
 #include "../../jrd/trace/TraceManager.h"
 #include "../../jrd/trace/TraceLog.h"
@@ -504,17 +505,46 @@ const char* TraceTriggerImpl::getRelationName()
 
 /// TraceLogWriterImpl
 
+// Records are accumulated in a per-writer buffer (writer is created per attachment
+// and trace session) and moved into the shared trace log by a timer thread or when
+// the buffer grows large, so the shared log mutex is taken once per batch instead
+// of once per event.
+
+const FB_SIZE_T TRACE_LOG_BUFFER_SIZE = 64 * 1024;
+const unsigned int TRACE_LOG_FLUSH_INTERVAL = 1;	// seconds
+
 class TraceLogWriterImpl final :
 	public RefCntIface<ITraceLogWriterImpl<TraceLogWriterImpl, CheckStatusWrapper> >
 {
 public:
 	TraceLogWriterImpl(const TraceSession& session) :
 		m_log(getPool(), session.ses_logfile, false),
-		m_sesId(session.ses_id)
+		m_sesId(session.ses_id),
+		m_buffer(getPool()),
+		m_flushBuffer(getPool()),
+		m_ends(getPool()),
+		m_flushEnds(getPool())
 	{
 		string s;
 		s.printf("\n--- Session %d is suspended as its log is full ---\n", session.ses_id);
 		m_log.setFullMsg(s.c_str());
+
+		m_timer = FB_NEW TimerImpl();
+		m_timer->setOnTimer(this, &TraceLogWriterImpl::onTimer);
+	}
+
+	~TraceLogWriterImpl()
+	{
+		m_timer->stop();
+
+		try
+		{
+			flush();
+		}
+		catch (const Exception& ex)
+		{
+			iscLogException("TraceLogWriter: cannot flush trace log", ex);
+		}
 	}
 
 	// TraceLogWriter implementation
@@ -522,33 +552,38 @@ public:
 	FB_SIZE_T write_s(CheckStatusWrapper* status, const void* buf, FB_SIZE_T size);
 
 private:
+	void flush();
+	void writeLog(const void* buf, const FB_SIZE_T* ends, FB_SIZE_T count);
+	void onTimer(TimerImpl*);
+
 	TraceLog m_log;
 	ULONG m_sesId;
+	Mutex m_bufferMutex;		// protects m_buffer and m_ends
+	Mutex m_flushMutex;			// serializes writes into m_log
+	UCharBuffer m_buffer;
+	UCharBuffer m_flushBuffer;
+	Array<FB_SIZE_T> m_ends;	// offsets past every record in m_buffer
+	Array<FB_SIZE_T> m_flushEnds;
+	RefPtr<TimerImpl> m_timer;
 };
 
 FB_SIZE_T TraceLogWriterImpl::write(const void* buf, FB_SIZE_T size)
 {
-	const FB_SIZE_T written = m_log.write(buf, size);
-	if (written == size)
-		return size;
+	bool startTimer, flushNow;
 
-	if (!m_log.isFull())
-		return written;
+	{	// scope
+		MutexLockGuard guard(m_bufferMutex, FB_FUNCTION);
 
-	ConfigStorage* storage = TraceManager::getStorage();
-	StorageGuard guard(storage);
+		startTimer = m_buffer.isEmpty();
+		m_buffer.add(static_cast<const UCHAR*>(buf), size);
+		m_ends.add(m_buffer.getCount());
+		flushNow = (m_buffer.getCount() >= TRACE_LOG_BUFFER_SIZE);
+	}
 
-	TraceSession session(*getDefaultMemoryPool());
-	session.ses_id = m_sesId;
-	if (storage->getSession(session, ConfigStorage::FLAGS))
-	{
-			if (!(session.ses_flags & trs_log_full))
-			{
-				// suspend session
-				session.ses_flags |= trs_log_full;
-			storage->updateFlags(session);
-			}
-		}
+	if (flushNow)
+		flush();
+	else if (startTimer)
+		m_timer->reset(TRACE_LOG_FLUSH_INTERVAL);
 
 	// report successful write
 	return size;
@@ -568,6 +603,68 @@ FB_SIZE_T TraceLogWriterImpl::write_s(CheckStatusWrapper* status, const void* bu
 	return 0;
 }
 
+void TraceLogWriterImpl::flush()
+{
+	MutexLockGuard flushGuard(m_flushMutex, FB_FUNCTION);
+
+	{	// scope
+		MutexLockGuard guard(m_bufferMutex, FB_FUNCTION);
+
+		if (m_buffer.isEmpty())
+			return;
+
+		m_flushBuffer.assign(m_buffer);
+		m_buffer.clear();
+		m_flushEnds.assign(m_ends);
+		m_ends.clear();
+	}
+
+	writeLog(m_flushBuffer.begin(), m_flushEnds.begin(), m_flushEnds.getCount());
+	m_flushBuffer.clear();
+	m_flushEnds.clear();
+}
+
+void TraceLogWriterImpl::writeLog(const void* buf, const FB_SIZE_T* ends, FB_SIZE_T count)
+{
+	// records which don't fit the log are dropped, but not the ones before them
+	const FB_SIZE_T written = m_log.writeRecords(buf, ends, count);
+	if (written == count)
+		return;
+
+	gds__log("Trace session %u: %u record(s) dropped as its log is full",
+		m_sesId, (unsigned) (count - written));
+
+	if (!m_log.isFull())
+		return;
+
+	ConfigStorage* storage = TraceManager::getStorage();
+	StorageGuard guard(storage);
+
+	TraceSession session(*getDefaultMemoryPool());
+	session.ses_id = m_sesId;
+	if (storage->getSession(session, ConfigStorage::FLAGS))
+	{
+		if (!(session.ses_flags & trs_log_full))
+		{
+			// suspend session
+			session.ses_flags |= trs_log_full;
+			storage->updateFlags(session);
+		}
+	}
+}
+
+void TraceLogWriterImpl::onTimer(TimerImpl*)
+{
+	try
+	{
+		flush();
+	}
+	catch (const Exception& ex)
+	{
+		iscLogException("TraceLogWriter: cannot flush trace log", ex);
+	}
+}
+
 
 /// TraceInitInfoImpl
 
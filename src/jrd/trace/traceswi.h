@@ -41,6 +41,7 @@ const int IN_SW_TRACE_FETCH_PWD		= 12;
 const int IN_SW_TRACE_TRUSTED_AUTH	= 13;
 const int IN_SW_TRACE_VERSION		= 14;
 const int IN_SW_TRACE_ROLE			= 15;
+const int IN_SW_TRACE_DECODE		= 16;
 
 
 // list of possible actions (services) for use with trace services
@@ -51,6 +52,7 @@ static const struct Switches::in_sw_tab_t trace_action_in_sw_table [] =
 	{IN_SW_TRACE_STOP,		isc_action_svc_trace_stop,		"STOP", 	0, 0, 0, false,	false,	0,	3, NULL},
 	{IN_SW_TRACE_START,		isc_action_svc_trace_start,		"START",	0, 0, 0, false,	false,	0,	3, NULL},
 	{IN_SW_TRACE_SUSPEND,	isc_action_svc_trace_suspend,	"SUSPEND",	0, 0, 0, false,	false,	0,	2, NULL},
+	{IN_SW_TRACE_DECODE,	0,								"DECODE",	0, 0, 0, false,	false,	0,	1, NULL},
 	{IN_SW_TRACE_VERSION,	0,								"Z",		0, 0, 0, false,	false, 0,	1, NULL},
 	{0,						0,								NULL,		0, 0, 0, false,	false, 0,	0, NULL}	// End of List
 };
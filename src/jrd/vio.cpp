@@ -5213,6 +5213,407 @@ void VIO_garbage_collect_idx(thread_db* tdbb, jrd_tra* transaction,
 	clearRecordStack(staying);
 }
 
+static void release_gc_pages(GarbageCollector* gc, PageBitmap*& bitmap)
+{
+/**************************************
+ *
+ *	r e l e a s e _ g c _ p a g e s
+ *
+ **************************************
+ *
+ * Functional description
+ *	Delete bitmap of data pages got from garbage collector,
+ *	removing pages left unprocessed from its backlog.
+ *
+ **************************************/
+	ULONG count = 0;
+	for (bool next = bitmap->getFirst(); next; next = bitmap->getNext())
+		count++;
+
+	gc->pagesProcessed(count);
+
+	delete bitmap;
+	bitmap = NULL;
+}
+
+
+static bool garbage_collect_page(thread_db* tdbb, record_param& rpb, jrd_tra* transaction,
+	ULONG dp_sequence)
+{
+/**************************************
+ *
+ *	g a r b a g e _ c o l l e c t _ p a g e
+ *
+ **************************************
+ *
+ * Functional description
+ *	Attempt to garbage collect all records on the data page.
+ *	Return false if garbage collection of the relation (or
+ *	at all) should be stopped.
+ *
+ **************************************/
+	Database* const dbb = tdbb->getDatabase();
+	jrd_rel* const relation = rpb.rpb_relation;
+
+	rpb.rpb_number.setValue(((SINT64) dp_sequence * dbb->dbb_max_records) - 1);
+	const RecordNumber last(rpb.rpb_number.getValue() + dbb->dbb_max_records);
+
+	while (VIO_next_record(tdbb, &rpb, transaction, NULL, DPM_next_data_page))
+	{
+		CCH_RELEASE(tdbb, &rpb.getWindow(tdbb));
+
+		if (!(dbb->dbb_flags & DBB_garbage_collector))
+			return false;
+
+		if (relation->rel_flags & (REL_deleting | REL_gc_disabled))
+			return false;
+
+		JRD_reschedule(tdbb);
+
+		if (rpb.rpb_number >= last)
+			break;
+
+		// Refresh our notion of the oldest transactions for
+		// efficient garbage collection. This is very cheap.
+
+		transaction->tra_oldest = dbb->dbb_oldest_transaction;
+		transaction->tra_oldest_active = dbb->dbb_oldest_snapshot;
+	}
+
+	return true;
+}
+
+
+namespace Jrd
+{
+
+// Garbage collection of several relations (or several parts of the same
+// relation) at once by the pool of parallel workers. The work is given out
+// by portions of data pages, round-robin through the relations.
+
+class GarbageCollectTask : public Task
+{
+public:
+	GarbageCollectTask(thread_db* tdbb, MemoryPool* pool, GarbageCollector* gc, int workers) : Task(),
+		m_pool(pool),
+		m_gc(gc),
+		m_dbb(tdbb->getDatabase()),
+		m_items(*m_pool),
+		m_relations(*m_pool),
+		m_stop(false),
+		m_nextRel(0)
+	{
+		Attachment* att = tdbb->getAttachment();
+
+		for (int i = 0; i < workers; i++)
+			m_items.add(FB_NEW_POOL(*m_pool) Item(this));
+
+		m_items[0]->m_ownAttach = false;
+		m_items[0]->m_attStable = att->getStable();
+		m_items[0]->m_tra = tdbb->getTransaction();
+	}
+
+	virtual ~GarbageCollectTask()
+	{
+		for (Item** p = m_items.begin(); p < m_items.end(); p++)
+			delete *p;
+
+		for (RelPages* rel = m_relations.begin(); rel < m_relations.end(); rel++)
+		{
+			if (rel->pages)
+				release_gc_pages(m_gc, rel->pages);
+		}
+	}
+
+	void addRelation(USHORT relID, PageBitmap* pages)
+	{
+		RelPages rel;
+		rel.relID = relID;
+		rel.pages = pages;
+		m_relations.add(rel);
+	}
+
+	FB_SIZE_T getRelationCount() const
+	{
+		return m_relations.getCount();
+	}
+
+	class Item : public Task::WorkItem
+	{
+	public:
+		Item(GarbageCollectTask* task) : Task::WorkItem(task),
+			m_inuse(false),
+			m_ownAttach(true),
+			m_tra(NULL),
+			m_relID(0),
+			m_pages(*task->m_pool)
+		{}
+
+		virtual ~Item()
+		{
+			if (!m_ownAttach || !m_attStable)
+				return;
+
+			Attachment* att = NULL;
+			{
+				AttSyncLockGuard guard(*m_attStable->getSync(), FB_FUNCTION);
+				att = m_attStable->getHandle();
+				if (!att)
+					return;
+				fb_assert(att->att_use_count > 0);
+
+				att->att_flags &= ~ATT_garbage_collector;
+			}
+
+			FbLocalStatus status;
+			if (m_tra)
+			{
+				BackgroundContextHolder tdbb(att->att_database, att, &status, FB_FUNCTION);
+				TRA_commit(tdbb, m_tra, false);
+			}
+			WorkerAttachment::releaseAttachment(&status, m_attStable);
+		}
+
+		GarbageCollectTask* getGCTask() const
+		{
+			return reinterpret_cast<GarbageCollectTask*> (m_task);
+		}
+
+		bool init(thread_db* tdbb)
+		{
+			FbStatusVector* status = tdbb->tdbb_status_vector;
+
+			Attachment* att = NULL;
+
+			if (m_ownAttach && !m_attStable.hasData())
+				m_attStable = WorkerAttachment::getAttachment(status, getGCTask()->m_dbb);
+
+			if (m_attStable)
+				att = m_attStable->getHandle();
+
+			if (!att)
+			{
+				Arg::Gds(isc_bad_db_handle).copyTo(status);
+				return false;
+			}
+
+			tdbb->setDatabase(att->att_database);
+			tdbb->setAttachment(att);
+
+			if (m_ownAttach && !m_tra)
+			{
+				try
+				{
+					WorkerContextHolder holder(tdbb, FB_FUNCTION);
+					att->att_flags |= ATT_garbage_collector;
+					m_tra = TRA_start(tdbb, sizeof(gc_tpb), gc_tpb);
+				}
+				catch(const Exception& ex)
+				{
+					ex.stuffException(tdbb->tdbb_status_vector);
+					return false;
+				}
+			}
+
+			tdbb->setTransaction(m_tra);
+			tdbb->markAsSweeper();
+
+			return true;
+		}
+
+		bool m_inuse;
+		bool m_ownAttach;
+		RefPtr<StableAttachmentPart> m_attStable;
+		jrd_tra* m_tra;
+
+		// part of work: relation and its data pages to work on
+		USHORT m_relID;
+		HalfStaticArray<ULONG, 64> m_pages;
+	};
+
+	bool handler(WorkItem& _item);
+
+	bool getWorkItem(WorkItem** pItem);
+	bool getResult(IStatus* status)
+	{
+		if (status)
+		{
+			status->init();
+			status->setErrors(m_status.getErrors());
+		}
+
+		return m_status.isSuccess();
+	}
+
+	int getMaxWorkers()
+	{
+		return m_items.getCount();
+	}
+
+private:
+	static const FB_SIZE_T PAGES_PER_ITEM = 64;
+
+	struct RelPages
+	{
+		USHORT relID;
+		PageBitmap* pages;
+	};
+
+	void setError(IStatus* status, bool stopTask)
+	{
+		const bool copyStatus = (m_status.isSuccess() && status && status->getState() == IStatus::STATE_ERRORS);
+		if (!copyStatus && (!stopTask || m_stop))
+			return;
+
+		MutexLockGuard guard(m_mutex, FB_FUNCTION);
+		if (m_status.isSuccess() && copyStatus)
+			m_status.save(status);
+		if (stopTask)
+			m_stop = true;
+	}
+
+	MemoryPool* m_pool;
+	GarbageCollector* m_gc;
+	Database* m_dbb;
+	Mutex m_mutex;
+	HalfStaticArray<Item*, 8> m_items;
+	HalfStaticArray<RelPages, 8> m_relations;
+	StatusHolder m_status;
+	volatile bool m_stop;
+	FB_SIZE_T m_nextRel;
+};
+
+
+bool GarbageCollectTask::handler(WorkItem& _item)
+{
+	Item* item = reinterpret_cast<Item*>(&_item);
+
+	ThreadContextHolder tdbb(NULL);
+
+	if (!item->init(tdbb))
+	{
+		// pages taken from the backlog are skipped
+		m_gc->pagesProcessed(item->m_pages.getCount());
+		item->m_pages.clear();
+
+		setError(tdbb->tdbb_status_vector, true);
+		return false;
+	}
+
+	WorkerContextHolder wrkHolder(tdbb, FB_FUNCTION);
+
+	record_param rpb;
+	rpb.getWindow(tdbb).win_flags = WIN_garbage_collector;
+	rpb.rpb_stream_flags = RPB_s_no_data | RPB_s_sweeper;
+
+	try
+	{
+		Database* const dbb = tdbb->getDatabase();
+		Attachment* const att = tdbb->getAttachment();
+		jrd_tra* const transaction = tdbb->getTransaction();
+
+		jrd_rel* const relation = MET_lookup_relation_id(tdbb, item->m_relID, false);
+
+		if (!relation || (relation->rel_flags & (REL_deleted | REL_deleting)))
+			m_gc->removeRelation(item->m_relID);
+		else
+		{
+			jrd_rel::GCShared gcGuard(tdbb, relation);
+
+			if (gcGuard.gcEnabled())
+			{
+				rpb.rpb_relation = relation;
+
+				for (const auto dp_sequence : item->m_pages)
+				{
+					if (m_stop || !garbage_collect_page(tdbb, rpb, transaction, dp_sequence))
+						break;
+				}
+
+				if (TipCache* cache = dbb->dbb_tip_cache)
+					cache->updateActiveSnapshots(tdbb, &att->att_active_snapshots);
+			}
+		}
+
+		delete rpb.rpb_record;
+
+		// processed or skipped
+		m_gc->pagesProcessed(item->m_pages.getCount());
+
+		if (!(dbb->dbb_flags & DBB_garbage_collector))
+			m_stop = true;
+
+		return !m_stop;
+	}
+	catch (const Exception& ex)
+	{
+		ex.stuffException(tdbb->tdbb_status_vector);
+
+		delete rpb.rpb_record;
+		m_gc->pagesProcessed(item->m_pages.getCount());
+	}
+
+	setError(tdbb->tdbb_status_vector, true);
+	return false;
+}
+
+bool GarbageCollectTask::getWorkItem(WorkItem** pItem)
+{
+	MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+	Item* item = reinterpret_cast<Item*> (*pItem);
+
+	if (item == NULL)
+	{
+		for (Item** p = m_items.begin(); p < m_items.end(); p++)
+			if (!(*p)->m_inuse)
+			{
+				(*p)->m_inuse = true;
+				*pItem = item = *p;
+				break;
+			}
+	}
+
+	if (!item)
+		return false;
+
+	item->m_pages.clear();
+
+	if (!m_stop)
+	{
+		for (FB_SIZE_T n = 0; n < m_relations.getCount(); n++)
+		{
+			RelPages& rel = m_relations[m_nextRel];
+			m_nextRel = (m_nextRel + 1) % m_relations.getCount();
+
+			if (!rel.pages)
+				continue;
+
+			while (item->m_pages.getCount() < PAGES_PER_ITEM && rel.pages->getFirst())
+			{
+				const ULONG dp_sequence = rel.pages->current();
+				rel.pages->clear(dp_sequence);
+				item->m_pages.add(dp_sequence);
+			}
+
+			if (!rel.pages->getFirst())
+				release_gc_pages(m_gc, rel.pages);
+
+			if (item->m_pages.hasData())
+			{
+				item->m_relID = rel.relID;
+				return true;
+			}
+		}
+	}
+
+	item->m_inuse = false;
+	return false;
+}
+
+} // namespace Jrd
+
+
 void Database::garbage_collector(Database* dbb)
 {
 /**************************************
@@ -5254,6 +5655,8 @@ void Database::garbage_collector(Database* dbb)
 		jrd_rel* relation = NULL;
 		jrd_tra* transaction = NULL;
 
+		const int parallelWorkers = Config::getParallelWorkers();
+
 		AutoPtr<GarbageCollector> gc(FB_NEW_POOL(*attachment->att_pool) GarbageCollector(
 			*attachment->att_pool, dbb));
 
@@ -5308,14 +5711,45 @@ void Database::garbage_collector(Database* dbb)
 				USHORT relID;
 				PageBitmap* gc_bitmap = NULL;
 
-				if ((dbb->dbb_flags & DBB_gc_pending) &&
+				if ((dbb->dbb_flags & DBB_gc_pending) && parallelWorkers > 1)
+				{
+					// Let the pool of workers handle all relations
+					// having garbage at once
+
+					if (!transaction)
+					{
+						transaction = TRA_start(tdbb, sizeof(gc_tpb), gc_tpb);
+						tdbb->setTransaction(transaction);
+					}
+
+					GarbageCollectTask task(tdbb, dbb->dbb_permanent, gc, parallelWorkers);
+
+					while ((gc_bitmap = gc->getPages(dbb->dbb_oldest_snapshot, relID)))
+						task.addRelation(relID, gc_bitmap);
+
+					if (task.getRelationCount())
+					{
+						found = flush = true;
+
+						{	// scope
+							EngineCheckout cout(tdbb, FB_FUNCTION);
+
+							Coordinator coord(dbb->dbb_permanent);
+							coord.runSync(&task);
+						}
+
+						FbLocalStatus local_status;
+						if (!task.getResult(&local_status))
+							iscDbLogStatus(dbb->dbb_filename.c_str(), &local_status);
+					}
+				}
+				else if ((dbb->dbb_flags & DBB_gc_pending) &&
 					(gc_bitmap = gc->getPages(dbb->dbb_oldest_snapshot, relID)))
 				{
 					relation = MET_lookup_relation_id(tdbb, relID, false);
 					if (!relation || (relation->rel_flags & (REL_deleted | REL_deleting)))
 					{
-						delete gc_bitmap;
-						gc_bitmap = NULL;
+						release_gc_pages(gc, gc_bitmap);
 						gc->removeRelation(relID);
 					}
 
@@ -5323,7 +5757,10 @@ void Database::garbage_collector(Database* dbb)
 					{
 						jrd_rel::GCShared gcGuard(tdbb, relation);
 						if (!gcGuard.gcEnabled())
+						{
+							release_gc_pages(gc, gc_bitmap);
 							continue;
+						}
 
 						rpb.rpb_relation = relation;
 
@@ -5341,6 +5778,7 @@ void Database::garbage_collector(Database* dbb)
 								break;
 
 							gc_bitmap->clear(dp_sequence);
+							gc->pagesProcessed(1);
 
 							if (!transaction)
 							{
@@ -5354,46 +5792,12 @@ void Database::garbage_collector(Database* dbb)
 							}
 
 							found = flush = true;
-							rpb.rpb_number.setValue(((SINT64) dp_sequence * dbb->dbb_max_records) - 1);
-							const RecordNumber last(rpb.rpb_number.getValue() + dbb->dbb_max_records);
 
 							// Attempt to garbage collect all records on the data page.
 
-							bool rel_exit = false;
-
-							while (VIO_next_record(tdbb, &rpb, transaction, NULL, DPM_next_data_page))
-							{
-								CCH_RELEASE(tdbb, &rpb.getWindow(tdbb));
-
-								if (!(dbb->dbb_flags & DBB_garbage_collector))
-								{
-									gc_exit = true;
-									break;
-								}
-
-								if (relation->rel_flags & REL_deleting)
-								{
-									rel_exit = true;
-									break;
-								}
-
-								if (relation->rel_flags & REL_gc_disabled)
-								{
-									rel_exit = true;
-									break;
-								}
-
-								JRD_reschedule(tdbb);
-
-								if (rpb.rpb_number >= last)
-									break;
-
-								// Refresh our notion of the oldest transactions for
-								// efficient garbage collection. This is very cheap.
-
-								transaction->tra_oldest = dbb->dbb_oldest_transaction;
-								transaction->tra_oldest_active = dbb->dbb_oldest_snapshot;
-							}
+							const bool rel_exit =
+								!garbage_collect_page(tdbb, rpb, transaction, dp_sequence);
+							gc_exit = !(dbb->dbb_flags & DBB_garbage_collector);
 
 							if (TipCache* cache = dbb->dbb_tip_cache)
 								cache->updateActiveSnapshots(tdbb, &attachment->att_active_snapshots);
@@ -5402,11 +5806,10 @@ void Database::garbage_collector(Database* dbb)
 								break;
 						}
 
+						release_gc_pages(gc, gc_bitmap);
+
 						if (gc_exit)
 							break;
-
-						delete gc_bitmap;
-						gc_bitmap = NULL;
 					}
 				}
 
@@ -5541,7 +5944,7 @@ static UndoDataRet get_undo_data(thread_db* tdbb, jrd_tra* transaction,
 	if (action)
 	{
 		const SINT64 recno = rpb->rpb_number.getValue();
-		if (!RecordBitmap::test(action->vct_records, recno))
+		if (!action->test(transaction, recno))
 			return udNone;
 
 		rpb->rpb_runtime_flags |= RPB_undo_read;
@@ -6918,7 +7321,7 @@ static void verb_post(thread_db* tdbb,
 
 	VerbAction* const action = transaction->tra_save_point->createAction(rpb->rpb_relation);
 
-	if (!RecordBitmap::test(action->vct_records, rpb->rpb_number.getValue()))
+	if (!action->test(transaction, rpb->rpb_number.getValue()))
 	{
 		RBM_SET(transaction->tra_pool, &action->vct_records, rpb->rpb_number.getValue());
 
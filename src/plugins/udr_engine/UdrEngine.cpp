@@ -311,6 +311,30 @@ public:
 			function->execute(status, context, inMsg, outMsg);
 	}
 
+	void executeBatch(ThrowStatusWrapper* status, IExternalContext* context, unsigned count,
+		void* inMsgs, unsigned inMsgLength, void* outMsgs, unsigned outMsgLength)
+	{
+		IExternalFunction* function = engine->getChild<IUdrFunctionFactory, IExternalFunction>(
+			status, children, this, context, engine->functions, moduleName);
+
+		if (!function)
+			return;
+
+		// Modules built with older headers don't know about batches
+		if (function->cloopVTable->version >= IExternalFunction::VERSION)
+		{
+			function->executeBatch(status, context, count, inMsgs, inMsgLength, outMsgs, outMsgLength);
+			return;
+		}
+
+		for (unsigned i = 0; i < count; ++i)
+		{
+			function->execute(status, context,
+				static_cast<UCHAR*>(inMsgs) + i * inMsgLength,
+				static_cast<UCHAR*>(outMsgs) + i * outMsgLength);
+		}
+	}
+
 public:
 	AutoPlugin<Engine> engine;
 	IRoutineMetadata* metadata;
@@ -9533,7 +9533,7 @@ ClntAuthBlock::ClntAuthBlock(const Firebird::PathName* fileName, Firebird::Clump
 	: pluginList(getPool()), serverPluginList(getPool()),
 	  cliUserName(getPool()), cliPassword(getPool()), cliOrigUserName(getPool()),
 	  dataForPlugin(getPool()), dataFromPlugin(getPool()),
-	  cryptKeys(getPool()), dpbConfig(getPool()), dpbPlugins(getPool()),
+	  cryptKeys(getPool()), dpbConfig(getPool()), dpbPlugins(getPool()), target(getPool()),
 	  createdInterface(nullptr),
 	  plugins(IPluginManager::TYPE_AUTH_CLIENT), authComplete(false), firstTime(true)
 {
@@ -9552,6 +9552,9 @@ ClntAuthBlock::ClntAuthBlock(const Firebird::PathName* fileName, Firebird::Clump
 			remAuthBlock.reset(FB_NEW RmtAuthBlock(plain));
 		}
 	}
+	if (fileName)
+		target = *fileName;
+
 	clntConfig = REMOTE_get_config(fileName, &dpbConfig);
 	resetClnt();
 }
@@ -9701,6 +9704,11 @@ IAuthBlock* ClntAuthBlock::getAuthBlock(CheckStatusWrapper* status)
 	return remAuthBlock;
 }
 
+const char* ClntAuthBlock::getTarget()
+{
+	return target.hasData() ? target.c_str() : NULL;
+}
+
 const unsigned char* ClntAuthBlock::getData(unsigned int* length)
 {
 	*length = (ULONG) dataForPlugin.getCount();
@@ -173,6 +173,9 @@ struct Rdb : public Firebird::GlobalStorage, public TypedHandle<rem_type_rdb>
 	PACKET			rdb_packet;				// Communication structure
 	USHORT			rdb_id;
 
+	// Attachment pooling, see AttachmentPoolSize in firebird.conf
+	Firebird::string	rdb_pool_key;		// empty if attachment can't be pooled
+
 private:
 	ThreadId		rdb_async_thread_id;	// Id of async thread (when active)
 
@@ -183,7 +186,7 @@ public:
 	Rdb() :
 		rdb_iface(NULL), rdb_port(0),
 		rdb_transactions(0), rdb_requests(0), rdb_events(0), rdb_sql_requests(0),
-		rdb_id(0), rdb_async_thread_id(0)
+		rdb_id(0), rdb_pool_key(getPool()), rdb_async_thread_id(0)
 	{
 	}
 
@@ -853,6 +856,7 @@ private:
 	Firebird::HalfStaticArray<InternalCryptKey*, 1> cryptKeys;		// Wire crypt keys that came from plugin(s) last time
 	Firebird::string dpbConfig;					// User's configuration parameters
 	Firebird::PathName dpbPlugins;				// User's plugin list
+	Firebird::PathName target;					// Connection string, as passed to plugins
 	Firebird::RefPtr<const Firebird::Config> clntConfig;	// Used to get plugins list and pass to port
 	Firebird::AutoPtr<RmtAuthBlock> remAuthBlock;	//Authentication block if present
 	unsigned nextKey;							// First key to be analyzed
@@ -915,6 +919,7 @@ public:
 	void putData(Firebird::CheckStatusWrapper* status, unsigned int length, const void* data);
 	Firebird::ICryptKey* newKey(Firebird::CheckStatusWrapper* status);
 	Firebird::IAuthBlock* getAuthBlock(Firebird::CheckStatusWrapper* status);
+	const char* getTarget();
 };
 
 // Representation of authentication data, visible for plugin
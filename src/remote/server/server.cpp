@@ -411,6 +411,126 @@ GlobalPtr<FailedLogins> remoteFailedLogins;
 bool server_shutdown = false;
 bool engine_shutdown = false;
 
+
+// Attachments detached by clients which had no active transactions and statements.
+// They are reset and may be taken by a client attaching the same database with
+// the same user, role and session settings, see make_pool_key(). Least recently
+// parked attachments are detached when the pool is full.
+class AttachmentPool
+{
+public:
+	explicit AttachmentPool(MemoryPool& p)
+		: entries(p)
+	{ }
+
+	~AttachmentPool()
+	{
+		clear();
+	}
+
+	ServAttachment get(const string& key)
+	{
+		while (true)
+		{
+			ServAttachment iface;
+
+			{	// scope
+				MutexLockGuard guard(mutex, FB_FUNCTION);
+
+				FB_SIZE_T pos = entries.getCount();
+				while (pos > 0 && entries[pos - 1].key != key)
+					pos--;
+
+				if (!pos)
+					return iface;
+
+				iface = entries[pos - 1].iface;
+				entries.remove(pos - 1);
+			}
+
+			// Attachment could be shut down while in the pool
+			LocalStatus ls;
+			CheckStatusWrapper status(&ls);
+
+			iface->ping(&status);
+
+			if (!(status.getState() & IStatus::STATE_ERRORS))
+				return iface;
+
+			status.init();
+			iface->detach(&status);
+		}
+	}
+
+	void put(const string& key, ServAttachment iface)
+	{
+		const FB_SIZE_T size = (FB_SIZE_T) MAX(Config::getAttachmentPoolSize(), 0);
+		AttachmentList extra;
+
+		{	// scope
+			MutexLockGuard guard(mutex, FB_FUNCTION);
+
+			Entry& entry = entries.add();
+			entry.key = key;
+			entry.iface = iface;
+
+			while (entries.getCount() > size)
+			{
+				extra.add(entries[0].iface);
+				entries.remove((FB_SIZE_T) 0);
+			}
+		}
+
+		detach(extra);
+	}
+
+	void clear()
+	{
+		AttachmentList all;
+
+		{	// scope
+			MutexLockGuard guard(mutex, FB_FUNCTION);
+
+			for (const auto& entry : entries)
+				all.add(entry.iface);
+
+			entries.clear();
+		}
+
+		detach(all);
+	}
+
+private:
+	typedef HalfStaticArray<ServAttachment, 4> AttachmentList;
+
+	struct Entry
+	{
+		explicit Entry(MemoryPool& p)
+			: key(p)
+		{ }
+
+		string key;
+		ServAttachment iface;
+	};
+
+	static void detach(AttachmentList& list)
+	{
+		LocalStatus ls;
+		CheckStatusWrapper status(&ls);
+
+		for (auto& iface : list)
+		{
+			iface->detach(&status);
+			status.init();
+		}
+	}
+
+	Mutex mutex;
+	ObjectsArray<Entry> entries;
+};
+
+GlobalPtr<AttachmentPool> attachmentPool;
+
 void loginFail(const string& login, const string& remId)
 {
 	// do not remove variables - both functions should be called
@@ -1189,6 +1309,8 @@ static void		release_request(Rrq*, bool rlsIface = false);
 static void		release_statement(Rsr**);
 static void		release_sql_request(Rsr*);
 static void		release_transaction(Rtr*);
+static bool		park_attachment(rem_port*);
+static void		make_pool_key(string&, const PathName&, ClumpletReader&);
 
 static void		send_error(rem_port* port, PACKET* apacket, ISC_STATUS errcode);
 static void		send_error(rem_port* port, PACKET* apacket, const Firebird::Arg::StatusVector&);
@@ -2487,9 +2609,22 @@ void DatabaseAuth::accept(PACKET* send, Auth::WriterImplementation* authBlock)
 
 	if (!(status_vector.getState() & Firebird::IStatus::STATE_ERRORS))
 	{
-		ServAttachment iface(operation == op_attach ?
-			provider->attachDatabase(&status_vector, dbName.c_str(), dl, dpb) :
-			provider->createDatabase(&status_vector, dbName.c_str(), dl, dpb));
+		string poolKey;
+		ServAttachment iface;
+
+		if (operation == op_attach && Config::getAttachmentPoolSize() > 0)
+		{
+			make_pool_key(poolKey, dbName, *pb);
+			if (poolKey.hasData())
+				iface = attachmentPool->get(poolKey);
+		}
+
+		if (!iface)
+		{
+			iface = operation == op_attach ?
+				provider->attachDatabase(&status_vector, dbName.c_str(), dl, dpb) :
+				provider->createDatabase(&status_vector, dbName.c_str(), dl, dpb);
+		}
 
 		if (!(status_vector.getState() & Firebird::IStatus::STATE_ERRORS))
 		{
@@ -2501,6 +2636,7 @@ void DatabaseAuth::accept(PACKET* send, Auth::WriterImplementation* authBlock)
 #endif
 			rdb->rdb_port = authPort;
 			rdb->rdb_iface = iface;
+			rdb->rdb_pool_key = poolKey;
 		}
 	}
 
@@ -3157,13 +3293,17 @@ ISC_STATUS rem_port::end_database(P_RLSE* /*release*/, PACKET* sendL)
 	CheckStatusWrapper status_vector(&ls);
 
 	Rdb* rdb = this->port_context;
+
 	if (bad_db(&status_vector, rdb))
 		return this->send_response(sendL, 0, 0, &status_vector, false);
 
-	rdb->rdb_iface->detach(&status_vector);
+	if (!park_attachment(this))
+	{
+		rdb->rdb_iface->detach(&status_vector);
 
-	if (status_vector.getState() & Firebird::IStatus::STATE_ERRORS)
-		return this->send_response(sendL, 0, 0, &status_vector, false);
+		if (status_vector.getState() & Firebird::IStatus::STATE_ERRORS)
+			return this->send_response(sendL, 0, 0, &status_vector, false);
+	}
 
 	port_flags |= PORT_detached;
 	if (port_async)
@@ -5905,6 +6045,130 @@ static void release_transaction( Rtr* transaction)
 }
 
 
+static void make_pool_key(string& key, const PathName& dbName, ClumpletReader& dpb)
+{
+/**************************************
+ *
+ *	m a k e _ p o o l _ k e y
+ *
+ **************************************
+ *
+ * Functional description
+ *	Build the key of attachment pool entries: the database name
+ *	and DPB items which define identity and session state of the
+ *	attachment (authenticated user, role, charset, etc). Description
+ *	of the client (address, process, host, etc) differs between
+ *	connections of the same application and is not a part of the key.
+ *	Key is left empty if DPB requests a special kind of attachment
+ *	which must not be pooled.
+ *
+ **************************************/
+	key.assign(dbName.c_str(), dbName.length());
+	key += '\0';
+
+	for (dpb.rewind(); !dpb.isEof(); dpb.moveNext())
+	{
+		const UCHAR tag = dpb.getClumpTag();
+
+		switch (tag)
+		{
+		case isc_dpb_auth_block:
+		case isc_dpb_sql_role_name:
+		case isc_dpb_lc_ctype:
+		case isc_dpb_lc_messages:
+		case isc_dpb_sql_dialect:
+		case isc_dpb_session_time_zone:
+		case isc_dpb_set_bind:
+		case isc_dpb_decfloat_round:
+		case isc_dpb_decfloat_traps:
+		case isc_dpb_no_db_triggers:
+		case isc_dpb_dbkey_scope:
+		case isc_dpb_no_garbage_collect:
+		case isc_dpb_ext_call_depth:
+		case isc_dpb_parallel_workers:
+		case isc_dpb_utf8_filename:
+			{
+				const ULONG length = dpb.getClumpLength();
+				key += (char) tag;
+				key.append((const char*) &length, sizeof(length));
+				key.append((const char*) dpb.getBytes(), length);
+			}
+			break;
+
+		case isc_dpb_address_path:
+		case isc_dpb_process_id:
+		case isc_dpb_process_name:
+		case isc_dpb_host_name:
+		case isc_dpb_os_user:
+		case isc_dpb_client_version:
+		case isc_dpb_remote_protocol:
+		case isc_dpb_org_filename:
+		case isc_dpb_specific_auth_data:
+		case isc_dpb_auth_plugin_list:
+		case isc_dpb_auth_plugin_name:
+		case isc_dpb_connect_timeout:
+		case isc_dpb_dummy_packet_interval:
+		case isc_dpb_nolinger:
+			break;
+
+		default:
+			key.erase();
+			return;
+		}
+	}
+}
+
+
+static bool park_attachment(rem_port* port)
+{
+/**************************************
+ *
+ *	p a r k _ a t t a c h m e n t
+ *
+ **************************************
+ *
+ * Functional description
+ *	Reset the attachment being detached by the client and
+ *	return it to the pool, if nothing depends on it. Next
+ *	attach with the same key takes it from the pool.
+ *
+ **************************************/
+	Rdb* const rdb = port->port_context;
+
+	if (!rdb || !rdb->rdb_iface || rdb->rdb_pool_key.isEmpty() || server_shutdown || engine_shutdown)
+		return false;
+
+	if (rdb->rdb_transactions || rdb->rdb_requests || rdb->rdb_sql_requests || rdb->rdb_events ||
+		(port->port_statement && port->port_statement->rsr_iface) || port->port_replicator)
+	{
+		return false;
+	}
+
+	LocalStatus ls;
+	CheckStatusWrapper status_vector(&ls);
+
+	rdb->rdb_iface->cancelOperation(&status_vector, fb_cancel_enable);
+	status_vector.init();
+
+	rdb->rdb_iface->execute(&status_vector, NULL, 0, "ALTER SESSION RESET", SQL_DIALECT_CURRENT,
+		NULL, NULL, NULL, NULL);
+
+	if (status_vector.getState() & IStatus::STATE_ERRORS)
+		return false;
+
+	ServAttachment iface;
+
+	{	// scope
+		RefMutexGuard portGuard(*port->port_cancel_sync, FB_FUNCTION);
+		iface = rdb->rdb_iface;
+		rdb->rdb_iface = NULL;
+	}
+
+	attachmentPool->put(rdb->rdb_pool_key, iface);
+	return true;
+}
+
+
 ISC_STATUS rem_port::seek_blob(P_SEEK* seek, PACKET* sendL)
 {
 /**************************************
@@ -7209,6 +7473,7 @@ static int shut_server(const int, const int, void*)
 static int pre_shutdown(const int, const int, void*)
 {
 	engine_shutdown = true;
+	attachmentPool->clear();
 	return 0;
 }
 
@@ -256,10 +256,8 @@ void TraceSvcUtil::runService(size_t spbSize, const UCHAR* spb)
 					p += sizeof(l);
 					if (l)
 					{
-						const char ch = p[l];
-						p[l] = 0;
-						fprintf(stdout, "%s", p);
-						p[l] = ch;
+						// output could be binary log, see binary_format in fbtrace.conf
+						fwrite(p, 1, l, stdout);
 						p += l;
 						dirty = true;
 					}
@@ -54,6 +54,10 @@
 #include "../common/StatusArg.h"
 #include "../common/classes/objects_array.h"
 #include "../common/os/os_utils.h"
+#include "../common/classes/condition.h"
+#include "../common/classes/locks.h"
+#include "../common/classes/zip.h"
+#include "../common/ThreadStart.h"
 
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>
@@ -268,6 +272,45 @@ struct inc_header
 	ULONG prev_scn;			// SCN of previous level backup
 };
 
+// Backup file created with -ZIP switch is a sequence of blocks, compressed
+// independently of each other. Uncompressed content of the blocks is exactly
+// the same as content of backup file created without -ZIP.
+
+const char zip_signature[4] = {'N','B','K','Z'};
+const USHORT ZIP_VERSION = 1;
+const ULONG ZIP_BLOCK_SIZE = 1024 * 1024;
+const ULONG ZIP_MAX_BLOCK_SIZE = 64 * 1024 * 1024;
+const int MAX_ZIP_THREADS = 64;
+
+struct zip_header
+{
+	char signature[4];		// 'NBKZ'
+	USHORT version;			// Compressed backup format version
+	USHORT reserved;
+	ULONG block_size;		// Max size of uncompressed data in the block
+};
+
+struct zip_block
+{
+	ULONG raw_length;		// Size of uncompressed data, zero marks end of backup
+	ULONG length;			// Size of data stored, equal to raw_length when data is not compressed
+	ULONG checksum;			// CRC32 of uncompressed data
+};
+
+#ifdef HAVE_ZLIB_H
+static InitInstance<ZLib> zlib;
+#endif
+
+static void checkCompression()
+{
+#ifdef HAVE_ZLIB_H
+	if (!zlib())
+		(Arg::Gds(isc_nbackup_zip_unavailable) << Arg::StatusVector(zlib().status)).raise();
+#else
+	Arg::Gds(isc_nbackup_zip_unavailable).raise();
+#endif
+}
+
 class NBackup
 {
 public:
@@ -275,12 +318,13 @@ public:
 
 	NBackup(UtilSvc* _uSvc, const PathName& _database, const string& _username, const string& _role,
 			const string& _password, bool _run_db_triggers, bool _direct_io, const string& _deco,
-			CLEAN_HISTORY_KIND cleanHistKind, int keepHistValue)
+			CLEAN_HISTORY_KIND cleanHistKind, int keepHistValue, bool zip, int parallel)
 	  : uSvc(_uSvc), newdb(0), trans(0), database(_database),
 		username(_username), role(_role), password(_password),
 		run_db_triggers(_run_db_triggers), direct_io(_direct_io),
 		dbase(INVALID_HANDLE_VALUE), backup(INVALID_HANDLE_VALUE),
 		decompress(_deco), m_cleanHistKind(cleanHistKind), m_keepHistValue(keepHistValue),
+		m_zip(zip), m_parallel(parallel),
 		childId(0), db_size_pages(0),
 		m_odsNumber(0), m_silent(false), m_printed(false), m_flash_map(false)
 	{
@@ -340,6 +384,12 @@ private:
 	string decompress;
 	const CLEAN_HISTORY_KIND m_cleanHistKind;
 	const int m_keepHistValue;
+	const bool m_zip;		// compress backup file
+	const int m_parallel;	// number of compression threads
+
+	class ZipStream;
+	AutoPtr<ZipStream> m_zipStream;
+	Array<UCHAR> m_backupPrefix;	// data read from backup file while looking for zip header
 #ifdef WIN_NT
 	HANDLE childId;
 	HANDLE childStdErr;
@@ -357,6 +407,10 @@ private:
 	void write_file(FILE_HANDLE &file, void *buffer, FB_SIZE_T bufsize);
 	void seek_file(FILE_HANDLE &file, SINT64 pos);
 
+	// Backup stream IO, handles compressed backup files
+	FB_SIZE_T read_backup(void* buffer, FB_SIZE_T bufsize);
+	void write_backup(void* buffer, FB_SIZE_T bufsize);
+
 	void pr_error(const ISC_STATUS* status, const char* operation);
 	void print_child_stderr();
 
@@ -368,6 +422,7 @@ private:
 	void detach_database();
 	string to_system(const PathName& from);
 	void cleanHistory();
+	bool load_change_map(ULONG page_size, ULONG scn, ULONG prev_scn, Array<ULONG>& changeMap);
 
 	// Create/open database and backup
 	void open_database_write(bool exclusive = false);
@@ -377,7 +432,9 @@ private:
 
 	void open_backup_scan();
 	void open_backup_decompress();
+	void open_backup_zip();
 	void create_backup();
+	void create_backup_zip();
 	void close_backup();
 };
 
@@ -474,6 +531,484 @@ void NBackup::seek_file(FILE_HANDLE &file, SINT64 pos)
 		Arg::OsError());
 }
 
+// Multi-threaded compression of backup file.
+// Backup stream is cut into blocks which are compressed (or decompressed and
+// verified) by worker threads while caller keeps reading database pages (or
+// writing restored ones). Backup file is written (or read) by a separate IO
+// thread. Blocks come to the IO thread (or to the caller on restore) in the
+// order of the stream.
+
+class NBackup::ZipStream
+{
+public:
+	ZipStream(NBackup* nbk, bool writing, ULONG blockSize, int workers);
+	~ZipStream();
+
+	void write(const void* buffer, FB_SIZE_T bufsize);
+	void finish();
+	FB_SIZE_T read(void* buffer, FB_SIZE_T bufsize);
+
+private:
+	enum BlockState { BLK_FREE, BLK_QUEUED, BLK_READY };
+
+	struct Block
+	{
+		explicit Block(MemoryPool& p)
+			: raw(p), packed(p), number(0), state(BLK_FREE)
+		{
+			memset(&header, 0, sizeof(header));
+		}
+
+		UCHAR* data()
+		{
+			return header.length == header.raw_length ? raw.begin() : packed.begin();
+		}
+
+		zip_block header;
+		Array<UCHAR> raw;
+		Array<UCHAR> packed;
+		FB_UINT64 number;
+		BlockState state;
+	};
+
+	static THREAD_ENTRY_DECLARE ioThread(THREAD_ENTRY_PARAM arg);
+	static THREAD_ENTRY_DECLARE workThread(THREAD_ENTRY_PARAM arg);
+
+	void writer();
+	void reader();
+	void worker();
+	void pack(Block* block);
+	void unpack(Block* block);
+
+	Block* getFree();
+	void putFree(Block* block);
+	void enqueue(Block* block);
+	void setError(const Exception& ex);
+	void checkError();
+	void join();
+
+	NBackup* const m_nbk;
+	const bool m_writing;
+	const ULONG m_blockSize;
+
+	Mutex m_mutex;
+	Condition m_cond;
+	ObjectsArray<Block> m_blocks;
+	HalfStaticArray<Block*, 16> m_free;		// blocks available for reuse
+	HalfStaticArray<Block*, 16> m_pending;	// blocks waiting for worker thread
+	HalfStaticArray<Block*, 16> m_ordered;	// blocks in order of stream
+	HalfStaticArray<Thread::Handle, 16> m_threads;
+
+	Block* m_current;			// block being filled or consumed by caller
+	FB_SIZE_T m_position;		// read position in current block
+	FB_UINT64 m_number;			// number of last block queued
+	bool m_eof;					// no more blocks will be queued
+	bool m_stop;				// threads should exit
+	bool m_failed;				// error happened in one of threads
+	StaticStatusVector m_status;
+};
+
+NBackup::ZipStream::ZipStream(NBackup* nbk, bool writing, ULONG blockSize, int workers)
+	: m_nbk(nbk), m_writing(writing), m_blockSize(blockSize), m_current(NULL),
+	  m_position(0), m_number(0), m_eof(false), m_stop(false), m_failed(false)
+{
+	checkCompression();
+
+#ifdef HAVE_ZLIB_H
+	const FB_SIZE_T packedSize = zlib().compressBound(m_blockSize);
+
+	// Every worker may process its block while IO thread and caller own one
+	// block each, plus some more to keep the pipeline busy
+	const int count = workers * 2 + 2;
+	for (int i = 0; i < count; i++)
+	{
+		Block& block = m_blocks.add();
+		block.raw.getBuffer(m_blockSize);
+		block.packed.getBuffer(packedSize);
+		m_free.add(&block);
+	}
+#endif
+
+	try
+	{
+		Thread::Handle handle;
+		Thread::start(ioThread, this, THREAD_medium, &handle);
+		m_threads.add(handle);
+
+		for (int i = 0; i < workers; i++)
+		{
+			Thread::start(workThread, this, THREAD_medium, &handle);
+			m_threads.add(handle);
+		}
+	}
+	catch (const Exception&)
+	{
+		{ // scope
+			MutexLockGuard guard(m_mutex, FB_FUNCTION);
+			m_stop = true;
+			m_cond.notifyAll();
+		}
+		join();
+		throw;
+	}
+}
+
+NBackup::ZipStream::~ZipStream()
+{
+	{ // scope
+		MutexLockGuard guard(m_mutex, FB_FUNCTION);
+		m_stop = true;
+		m_cond.notifyAll();
+	}
+	join();
+}
+
+void NBackup::ZipStream::join()
+{
+	for (auto& handle : m_threads)
+		Thread::waitForCompletion(handle);
+	m_threads.clear();
+}
+
+THREAD_ENTRY_DECLARE NBackup::ZipStream::ioThread(THREAD_ENTRY_PARAM arg)
+{
+	ZipStream* const zip = static_cast<ZipStream*>(arg);
+	try
+	{
+		if (zip->m_writing)
+			zip->writer();
+		else
+			zip->reader();
+	}
+	catch (const Exception& ex)
+	{
+		zip->setError(ex);
+	}
+
+	return 0;
+}
+
+THREAD_ENTRY_DECLARE NBackup::ZipStream::workThread(THREAD_ENTRY_PARAM arg)
+{
+	ZipStream* const zip = static_cast<ZipStream*>(arg);
+	try
+	{
+		zip->worker();
+	}
+	catch (const Exception& ex)
+	{
+		zip->setError(ex);
+	}
+
+	return 0;
+}
+
+void NBackup::ZipStream::setError(const Exception& ex)
+{
+	MutexLockGuard guard(m_mutex, FB_FUNCTION);
+	if (!m_failed)
+	{
+		ex.stuffException(m_status);
+		m_failed = true;
+	}
+	m_stop = true;
+	m_cond.notifyAll();
+}
+
+// Should be called with m_mutex locked
+void NBackup::ZipStream::checkError()
+{
+	if (m_failed)
+		status_exception::raise(m_status.begin());
+}
+
+NBackup::ZipStream::Block* NBackup::ZipStream::getFree()
+{
+	MutexLockGuard guard(m_mutex, FB_FUNCTION);
+	while (!m_stop && m_free.isEmpty())
+		m_cond.wait(m_mutex);
+
+	checkError();
+	if (m_stop)
+		return NULL;
+
+	Block* const block = m_free.pop();
+	memset(&block->header, 0, sizeof(block->header));
+	return block;
+}
+
+void NBackup::ZipStream::putFree(Block* block)
+{
+	MutexLockGuard guard(m_mutex, FB_FUNCTION);
+	block->state = BLK_FREE;
+	m_free.add(block);
+	m_cond.notifyAll();
+}
+
+void NBackup::ZipStream::enqueue(Block* block)
+{
+	MutexLockGuard guard(m_mutex, FB_FUNCTION);
+	checkError();
+	block->number = ++m_number;
+	block->state = BLK_QUEUED;
+	m_pending.add(block);
+	m_ordered.add(block);
+	m_cond.notifyAll();
+}
+
+void NBackup::ZipStream::worker()
+{
+	MutexLockGuard guard(m_mutex, FB_FUNCTION);
+	while (true)
+	{
+		while (!m_stop && m_pending.isEmpty())
+		{
+			if (m_eof)
+				return;
+			m_cond.wait(m_mutex);
+		}
+
+		if (m_stop)
+			return;
+
+		Block* const block = m_pending[0];
+		m_pending.remove((FB_SIZE_T) 0);
+
+		{ // scope
+			MutexUnlockGuard unguard(m_mutex, FB_FUNCTION);
+			if (m_writing)
+				pack(block);
+			else
+				unpack(block);
+		}
+
+		block->state = BLK_READY;
+		m_cond.notifyAll();
+	}
+}
+
+void NBackup::ZipStream::pack(Block* block)
+{
+#ifdef HAVE_ZLIB_H
+	zip_block& header = block->header;
+	header.checksum = zlib().crc32(0, block->raw.begin(), header.raw_length);
+
+	uLongf length = block->packed.getCount();
+	const int rc = zlib().compress2(block->packed.begin(), &length,
+		block->raw.begin(), header.raw_length, Z_DEFAULT_COMPRESSION);
+
+	if (rc != Z_OK)
+	{
+		status_exception::raise(Arg::Gds(isc_nbackup_zip_err) << Arg::Num(rc) <<
+			Arg::Num(block->number) << m_nbk->bakname.c_str());
+	}
+
+	// Incompressible data is stored as is
+	header.length = length < header.raw_length ? length : header.raw_length;
+#endif
+}
+
+void NBackup::ZipStream::unpack(Block* block)
+{
+#ifdef HAVE_ZLIB_H
+	const zip_block& header = block->header;
+	if (header.length != header.raw_length)
+	{
+		uLongf length = m_blockSize;
+		int rc = zlib().uncompress(block->raw.begin(), &length,
+			block->packed.begin(), header.length);
+
+		if (rc == Z_OK && length != header.raw_length)
+			rc = Z_DATA_ERROR;
+
+		if (rc != Z_OK)
+		{
+			status_exception::raise(Arg::Gds(isc_nbackup_zip_err) << Arg::Num(rc) <<
+				Arg::Num(block->number) << m_nbk->bakname.c_str());
+		}
+	}
+
+	if (zlib().crc32(0, block->raw.begin(), header.raw_length) != header.checksum)
+	{
+		status_exception::raise(Arg::Gds(isc_nbackup_zip_checksum) <<
+			Arg::Num(block->number) << m_nbk->bakname.c_str());
+	}
+#endif
+}
+
+void NBackup::ZipStream::writer()
+{
+	MutexLockGuard guard(m_mutex, FB_FUNCTION);
+	while (true)
+	{
+		while (!m_stop && (m_ordered.isEmpty() || m_ordered[0]->state != BLK_READY))
+		{
+			if (m_eof && m_ordered.isEmpty())
+				return;
+			m_cond.wait(m_mutex);
+		}
+
+		if (m_stop)
+			return;
+
+		Block* const block = m_ordered[0];
+		m_ordered.remove((FB_SIZE_T) 0);
+
+		{ // scope
+			MutexUnlockGuard unguard(m_mutex, FB_FUNCTION);
+			m_nbk->write_file(m_nbk->backup, &block->header, sizeof(block->header));
+			m_nbk->write_file(m_nbk->backup, block->data(), block->header.length);
+		}
+
+		block->state = BLK_FREE;
+		m_free.add(block);
+		m_cond.notifyAll();
+	}
+}
+
+void NBackup::ZipStream::reader()
+{
+	while (true)
+	{
+		zip_block header;
+		if (m_nbk->read_file(m_nbk->backup, &header, sizeof(header)) != sizeof(header))
+			status_exception::raise(Arg::Gds(isc_nbackup_err_eofbk) << m_nbk->bakname.c_str());
+
+		if (!header.raw_length)
+		{
+			MutexLockGuard guard(m_mutex, FB_FUNCTION);
+			m_eof = true;
+			m_cond.notifyAll();
+			return;
+		}
+
+		if (header.raw_length > m_blockSize || header.length > header.raw_length)
+			status_exception::raise(Arg::Gds(isc_nbackup_invalid_incbk) << m_nbk->bakname.c_str());
+
+		Block* const block = getFree();
+		if (!block)
+			return;
+
+		block->header = header;
+		if (m_nbk->read_file(m_nbk->backup, block->data(), header.length) != header.length)
+			status_exception::raise(Arg::Gds(isc_nbackup_err_eofbk) << m_nbk->bakname.c_str());
+
+		enqueue(block);
+	}
+}
+
+void NBackup::ZipStream::write(const void* buffer, FB_SIZE_T bufsize)
+{
+	const UCHAR* ptr = static_cast<const UCHAR*>(buffer);
+	while (bufsize)
+	{
+		if (!m_current)
+			m_current = getFree();
+
+		zip_block& header = m_current->header;
+		const FB_SIZE_T step = MIN(bufsize, m_blockSize - header.raw_length);
+		memcpy(m_current->raw.begin() + header.raw_length, ptr, step);
+		header.raw_length += step;
+		ptr += step;
+		bufsize -= step;
+
+		if (header.raw_length == m_blockSize)
+		{
+			enqueue(m_current);
+			m_current = NULL;
+		}
+	}
+}
+
+void NBackup::ZipStream::finish()
+{
+	if (m_current && m_current->header.raw_length)
+	{
+		enqueue(m_current);
+		m_current = NULL;
+	}
+
+	{ // scope
+		MutexLockGuard guard(m_mutex, FB_FUNCTION);
+		m_eof = true;
+		m_cond.notifyAll();
+	}
+	join();
+
+	checkError();
+
+	zip_block end;
+	memset(&end, 0, sizeof(end));
+	m_nbk->write_file(m_nbk->backup, &end, sizeof(end));
+}
+
+FB_SIZE_T NBackup::ZipStream::read(void* buffer, FB_SIZE_T bufsize)
+{
+	UCHAR* ptr = static_cast<UCHAR*>(buffer);
+	FB_SIZE_T done = 0;
+	while (bufsize)
+	{
+		if (m_current && m_position == m_current->header.raw_length)
+		{
+			putFree(m_current);
+			m_current = NULL;
+		}
+
+		if (!m_current)
+		{
+			MutexLockGuard guard(m_mutex, FB_FUNCTION);
+			while (m_ordered.isEmpty() || m_ordered[0]->state != BLK_READY)
+			{
+				checkError();
+				if (m_eof && m_ordered.isEmpty())
+					return done;
+				m_cond.wait(m_mutex);
+			}
+
+			m_current = m_ordered[0];
+			m_ordered.remove((FB_SIZE_T) 0);
+			m_position = 0;
+		}
+
+		const FB_SIZE_T step = MIN(bufsize, m_current->header.raw_length - m_position);
+		memcpy(ptr, m_current->raw.begin() + m_position, step);
+		m_position += step;
+		ptr += step;
+		bufsize -= step;
+		done += step;
+	}
+
+	return done;
+}
+
+
+FB_SIZE_T NBackup::read_backup(void* buffer, FB_SIZE_T bufsize)
+{
+	if (m_zipStream)
+		return m_zipStream->read(buffer, bufsize);
+
+	FB_SIZE_T done = 0;
+	if (m_backupPrefix.hasData())
+	{
+		done = MIN(bufsize, m_backupPrefix.getCount());
+		memcpy(buffer, m_backupPrefix.begin(), done);
+		m_backupPrefix.removeCount(0, done);
+
+		buffer = static_cast<UCHAR*>(buffer) + done;
+		bufsize -= done;
+	}
+
+	return done + read_file(backup, buffer, bufsize);
+}
+
+void NBackup::write_backup(void* buffer, FB_SIZE_T bufsize)
+{
+	if (m_zipStream)
+		m_zipStream->write(buffer, bufsize);
+	else
+		write_file(backup, buffer, bufsize);
+}
+
 void NBackup::open_database_write(bool exclusive)
 {
 #ifdef WIN_NT
@@ -609,6 +1144,7 @@ void NBackup::open_backup_scan()
 	if (decompress.hasData())
 	{
 		open_backup_decompress();
+		open_backup_zip();
 		return;
 	}
 
@@ -617,16 +1153,48 @@ void NBackup::open_backup_scan()
 	backup = CreateFile(nm.c_str(), GENERIC_READ, 0,
 		NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
 	if (backup != INVALID_HANDLE_VALUE)
+	{
+		open_backup_zip();
 		return;
+	}
 #else
 	backup = os_utils::open(nm.c_str(), O_RDONLY | O_LARGEFILE);
 	if (backup >= 0)
+	{
+		open_backup_zip();
 		return;
+	}
 #endif
 
 	status_exception::raise(Arg::Gds(isc_nbackup_err_openbk) << bakname.c_str() << Arg::OsError());
 }
 
+void NBackup::open_backup_zip()
+{
+	// Backup file may be read from the pipe, thus look at its beginning
+	// without seek and return data read to the callers of read_backup()
+	zip_header header;
+	const FB_SIZE_T bytesDone = read_file(backup, &header, sizeof(header));
+
+	if (bytesDone != sizeof(header) ||
+		memcmp(header.signature, zip_signature, sizeof(zip_signature)) != 0)
+	{
+		m_backupPrefix.assign(reinterpret_cast<UCHAR*>(&header), bytesDone);
+		return;
+	}
+
+	if (header.version != ZIP_VERSION)
+	{
+		status_exception::raise(Arg::Gds(isc_nbackup_unsupvers_incbk) <<
+			Arg::Num(header.version) << bakname.c_str());
+	}
+
+	if (!header.block_size || header.block_size > ZIP_MAX_BLOCK_SIZE)
+		status_exception::raise(Arg::Gds(isc_nbackup_invalid_incbk) << bakname.c_str());
+
+	m_zipStream = FB_NEW ZipStream(this, false, header.block_size, m_parallel);
+}
+
 void NBackup::open_backup_decompress()
 {
 	string command = decompress;
@@ -801,8 +1369,24 @@ void NBackup::create_backup()
 	status_exception::raise(Arg::Gds(isc_nbackup_err_createbk) << bakname.c_str() << Arg::OsError());
 }
 
+void NBackup::create_backup_zip()
+{
+	zip_header header;
+	memcpy(header.signature, zip_signature, sizeof(zip_signature));
+	header.version = ZIP_VERSION;
+	header.reserved = 0;
+	header.block_size = ZIP_BLOCK_SIZE;
+
+	write_file(backup, &header, sizeof(header));
+	m_zipStream = FB_NEW ZipStream(this, true, header.block_size, m_parallel);
+}
+
 void NBackup::close_backup()
 {
+	// Stop compression threads before backup file is closed
+	m_zipStream.reset();
+	m_backupPrefix.clear();
+
 	if (bakname == "stdout")
 		return;
 
@@ -1191,6 +1775,43 @@ void NBackup::unlock_database()
 	detach_database();
 }
 
+// Load change map maintained by engine (see NBackupChangeMap in firebird.conf).
+// Map is usable if it tracked all changes since prev_scn up to current scn.
+bool NBackup::load_change_map(ULONG page_size, ULONG scn, ULONG prev_scn, Array<ULONG>& changeMap)
+{
+	const PathName mapName(dbname + Ods::CHANGE_MAP_SUFFIX);
+	FILE* const file = os_utils::fopen(mapName.c_str(), "rb");
+	if (!file)
+		return false;
+
+	bool valid = false;
+	Ods::change_map_header mapHeader;
+
+	if (fread(&mapHeader, sizeof(mapHeader), 1, file) == 1 &&
+		memcmp(mapHeader.cmh_signature, Ods::CHANGE_MAP_SIGNATURE, sizeof(mapHeader.cmh_signature)) == 0 &&
+		mapHeader.cmh_version == Ods::CHANGE_MAP_VERSION &&
+		mapHeader.cmh_page_size == page_size &&
+		mapHeader.cmh_last_scn == scn &&
+		mapHeader.cmh_start_scn <= prev_scn + 1 &&
+		fseek(file, Ods::CHANGE_MAP_DATA, SEEK_SET) == 0)
+	{
+		// Ranges missing in the map were not changed since cmh_start_scn
+		ULONG buffer[1024];
+		size_t n;
+		while ((n = fread(buffer, sizeof(ULONG), FB_NELEM(buffer), file)) > 0)
+			changeMap.add(buffer, n);
+
+		valid = !ferror(file);
+	}
+
+	fclose(file);
+
+	if (!valid)
+		changeMap.clear();
+
+	return valid;
+}
+
 void NBackup::backup_database(int level, Guid& guid, const PathName& fname)
 {
 	bool database_locked = false;
@@ -1336,6 +1957,9 @@ void NBackup::backup_database(int level, Guid& guid, const PathName& fname)
 		create_backup();
 		delete_backup = true;
 
+		if (m_zip)
+			create_backup_zip();
+
 		open_database_scan();
 
 		// Read database header
@@ -1412,7 +2036,7 @@ void NBackup::backup_database(int level, Guid& guid, const PathName& fname)
 
 			memset(page_buff, 0, header->hdr_page_size);
 			memcpy(page_buff, &bh, sizeof(bh));
-			write_file(backup, page_buff, header->hdr_page_size);
+			write_backup(page_buff, header->hdr_page_size);
 			page_writes++;
 
 			seek_file(dbase, 0);
@@ -1427,6 +2051,12 @@ void NBackup::backup_database(int level, Guid& guid, const PathName& fname)
 		ULONG scnsSlot = 0;
 		const ULONG pagesPerSCN = Ods::pagesPerSCN(header->hdr_page_size);
 
+		// Change map allows to skip whole SCN page ranges not changed since
+		// previous level backup without reading their SCN pages
+		Array<ULONG> changeMap;
+		const bool useChangeMap = level > 0 && db_size_pages == 0 &&
+			load_change_map(header->hdr_page_size, backup_scn + 1, prev_scn, changeMap);
+
 		Array<UCHAR> unaligned_scns_buffer;
 		Ods::scns_page* scns = NULL, *scns_buf = NULL;
 		{ // scope
@@ -1444,7 +2074,7 @@ void NBackup::backup_database(int level, Guid& guid, const PathName& fname)
 
 			if (!level || page_buff->pag_scn > prev_scn)
 			{
-				write_file(backup, page_buff, header->hdr_page_size);
+				write_backup(page_buff, header->hdr_page_size);
 				page_writes++;
 			}
 
@@ -1479,6 +2109,29 @@ void NBackup::backup_database(int level, Guid& guid, const PathName& fname)
 				{
 					scnsSlot = 0;
 					scns = NULL;
+
+					if (useChangeMap)
+					{
+						const ULONG startPage = curPage;
+						ULONG seq;
+
+						while (curPage != lastPage && (seq = curPage / pagesPerSCN) &&
+							(seq >= changeMap.getCount() || changeMap[seq] <= prev_scn))
+						{
+							if (lastPage - curPage < pagesPerSCN)
+							{
+								// Next PIP page must be read to know where database ends
+								curPage = lastPage;
+								scnsSlot = curPage % pagesPerSCN;
+								break;
+							}
+
+							curPage += pagesPerSCN;
+						}
+
+						if (curPage != startPage)
+							seek_file(dbase, (SINT64) curPage * header->hdr_page_size);
+					}
 				}
 
 				fb_assert(scnsSlot < pagesPerSCN);
@@ -1532,6 +2185,9 @@ void NBackup::backup_database(int level, Guid& guid, const PathName& fname)
 				}
 			}
 		}
+		if (m_zipStream)
+			m_zipStream->finish();
+
 		close_database();
 		close_backup();
 
@@ -1738,7 +2394,7 @@ void NBackup::restore_database(const BackupFiles& files, bool repl_seq, bool inc
 			if (curLevel)
 			{
 				inc_header bakheader;
-				if (read_file(backup, &bakheader, sizeof(bakheader)) != sizeof(bakheader))
+				if (read_backup(&bakheader, sizeof(bakheader)) != sizeof(bakheader))
 					status_exception::raise(Arg::Gds(isc_nbackup_err_eofhdrbk) << bakname.c_str());
 				if (memcmp(bakheader.signature, backup_signature, sizeof(backup_signature)) != 0)
 					status_exception::raise(Arg::Gds(isc_nbackup_invalid_incbk) << bakname.c_str());
@@ -1763,7 +2419,7 @@ void NBackup::restore_database(const BackupFiles& files, bool repl_seq, bool inc
 				{
 					char char_buf[1024];
 					FB_SIZE_T step = left > sizeof(char_buf) ? sizeof(char_buf) : left;
-					if (read_file(backup, &char_buf, step) != step)
+					if (read_backup(&char_buf, step) != step)
 						status_exception::raise(Arg::Gds(isc_nbackup_err_eofhdrbk) << bakname.c_str());
 					left -= step;
 				}
@@ -1774,7 +2430,7 @@ void NBackup::restore_database(const BackupFiles& files, bool repl_seq, bool inc
 				const auto page_ptr = page_buffer.begin();
 				while (true)
 				{
-					const FB_SIZE_T bytesDone = read_file(backup, page_ptr, bakheader.page_size);
+					const FB_SIZE_T bytesDone = read_backup(page_ptr, bakheader.page_size);
 					if (bytesDone == 0)
 						break;
 					if (bytesDone != bakheader.page_size) {
@@ -1795,7 +2451,7 @@ void NBackup::restore_database(const BackupFiles& files, bool repl_seq, bool inc
 					char buffer[65536];
 					while (true)
 					{
-						const FB_SIZE_T bytesRead = read_file(backup, buffer, sizeof(buffer));
+						const FB_SIZE_T bytesRead = read_backup(buffer, sizeof(buffer));
 						if (bytesRead == 0)
 							break;
 						write_file(dbase, buffer, bytesRead);
@@ -1919,6 +2575,8 @@ void nbackup(UtilSvc* uSvc)
 	bool cleanHistory = false;
 	NBackup::CLEAN_HISTORY_KIND cleanHistKind = NBackup::CLEAN_HISTORY_KIND::NONE;
 	int keepHistValue = 0;
+	bool zip = false;
+	int parallel = 1;
 
 	const Switches switches(nbackup_action_in_sw_table, FB_NELEM(nbackup_action_in_sw_table),
 							false, true);
@@ -2133,6 +2791,19 @@ void nbackup(UtilSvc* uSvc)
 			}
 			break;
 
+		case IN_SW_NBK_ZIP:
+			zip = true;
+			break;
+
+		case IN_SW_NBK_PARALLEL:
+			if (++itr >= argc)
+				missingParameterForSwitch(uSvc, argv[itr - 1]);
+
+			parallel = atoi(argv[itr]);
+			if (parallel < 1 || parallel > MAX_ZIP_THREADS)
+				usage(uSvc, isc_nbackup_wrong_param, argv[itr - 1]);
+			break;
+
 		default:
 			usage(uSvc, isc_nbackup_unknown_switch, argv[itr]);
 			break;
@@ -2177,8 +2848,13 @@ void nbackup(UtilSvc* uSvc)
 		usage(uSvc, isc_nbackup_clean_hist_missed);
 	}
 
+	if (zip && op != nbBackup)
+	{
+		usage(uSvc, isc_nbackup_zip_misuse);
+	}
+
 	NBackup nbk(uSvc, database, username, role, password, run_db_triggers, direct_io,
-				decompress, cleanHistKind, keepHistValue);
+				decompress, cleanHistKind, keepHistValue, zip, parallel);
 	try
 	{
 		switch (op)
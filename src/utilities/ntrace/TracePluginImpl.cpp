@@ -234,17 +234,62 @@ void TracePluginImpl::logRecord(const char* action)
 	// TODO: implement adjusting of line breaks
 	// line.adjustLineBreaks();
 
+	if (config.binary_format)
+		logBinary(TraceBinary::REC_TEXT, record.c_str(), record.length());
+	else
+		writeLog(record.c_str(), record.length());
+
+	record = "";
+}
+
+void TracePluginImpl::writeLog(const void* buf, FB_SIZE_T size)
+{
 	LocalStatus ls;
 	CheckStatusWrapper status(&ls);
 
-	logWriter->write_s(&status, record.c_str(), record.length());
+	logWriter->write_s(&status, buf, size);
 
 	if (ls.getState() & IStatus::STATE_ERRORS && ls.getErrors()[1] == isc_interface_version_too_old)
-		logWriter->write(record.c_str(), record.length());
+		logWriter->write(buf, size);
 	else
 		check(&status);
+}
 
-	record = "";
+void TracePluginImpl::logBinary(TraceBinary::RecordType type, const void* data, ULONG length,
+	const string* text1, const string* text2)
+{
+	TraceBinary::RecordHeader header;
+	header.signature = TraceBinary::RECORD_SIGNATURE;
+	header.type = type;
+	header.reserved = 0;
+	header.length = length + (text1 ? text1->length() : 0) + (text2 ? text2->length() : 0);
+	header.processId = get_process_id();
+	header.source = (SINT64) (IPTR) this;
+	header.stamp = TimeStamp::getCurrentTimeStamp().value();
+
+	// Whole record is written at once, see logRecord()
+	HalfStaticArray<UCHAR, 1024> buffer;
+	buffer.add(reinterpret_cast<const UCHAR*>(&header), sizeof(header));
+	buffer.add(static_cast<const UCHAR*>(data), length);
+
+	if (text1)
+		buffer.add(reinterpret_cast<const UCHAR*>(text1->c_str()), text1->length());
+
+	if (text2)
+		buffer.add(reinterpret_cast<const UCHAR*>(text2->c_str()), text2->length());
+
+	writeLog(buffer.begin(), buffer.getCount());
+}
+
+void TracePluginImpl::logDescription(TraceBinary::DescriptionKind kind, SINT64 id,
+	const string& description)
+{
+	TraceBinary::DescriptionRecord desc;
+	desc.kind = kind;
+	desc.reserved = 0;
+	desc.id = id;
+
+	logBinary(TraceBinary::REC_DESCRIPTION, &desc, sizeof(desc), &description);
 }
 
 void TracePluginImpl::logRecordConn(const char* action, ITraceDatabaseConnection* connection)
@@ -1162,6 +1207,9 @@ void TracePluginImpl::register_connection(ITraceDatabaseConnection* connection)
 	}
 	conn_data.description->append(NEWLINE);
 
+	if (config.binary_format)
+		logDescription(TraceBinary::DESC_CONNECTION, conn_data.id, *conn_data.description);
+
 	// Adjust the list of connections
 	{
 		WriteLockGuard lock(connectionsLock, FB_FUNCTION);
@@ -1278,6 +1326,9 @@ void TracePluginImpl::register_transaction(ITraceTransaction* transaction)
 
 	trans_data.description->append(")" NEWLINE);
 
+	if (config.binary_format)
+		logDescription(TraceBinary::DESC_TRANSACTION, trans_data.id, *trans_data.description);
+
 	// Remember transaction
 	{
 		WriteLockGuard lock(transactionsLock, FB_FUNCTION);
@@ -1589,6 +1640,9 @@ void TracePluginImpl::register_sql_statement(ITraceSQLStatement* statement)
 		{
 			*stmt_data.description += NEWLINE;
 		}
+
+		if (config.binary_format && stmt_data.id)
+			logDescription(TraceBinary::DESC_STATEMENT, stmt_data.id, *stmt_data.description);
 	}
 	else
 	{
@@ -1666,6 +1720,9 @@ void TracePluginImpl::log_event_dsql_execute(ITraceDatabaseConnection* connectio
 	if (config.time_threshold && info && info->pin_time < config.time_threshold)
 		return;
 
+	if (info && config.binary_format && logStatementFinish(connection, transaction, statement, info, req_result))
+		return;
+
 	if (restart)
 	{
 		string temp;
@@ -1719,6 +1776,111 @@ void TracePluginImpl::log_event_dsql_execute(ITraceDatabaseConnection* connectio
 }
 
 
+bool TracePluginImpl::logStatementFinish(ITraceDatabaseConnection* connection,
+	ITraceTransaction* transaction, ITraceSQLStatement* statement,
+	const PerformanceInfo* info, unsigned req_result)
+{
+	const StmtNumber stmt_id = statement->getStmtID();
+	if (!stmt_id)
+		return false;
+
+	// Make sure descriptions of all involved objects are in the log already
+
+	bool found = false;
+	bool log = true;
+
+	for (int pass = 0; pass < 2 && !found; pass++)
+	{
+		if (pass)
+			register_sql_statement(statement);
+
+		ReadLockGuard lock(statementsLock, FB_FUNCTION);
+		StatementsTree::Accessor accessor(&statements);
+		if (accessor.locate(stmt_id))
+		{
+			found = true;
+			log = (accessor.current().description != NULL);
+		}
+	}
+
+	if (!found)
+		return false;
+
+	// Statement does not fall under filter criteria
+	if (!log)
+		return true;
+
+	TraNumber tra_id = 0;
+
+	if (transaction)
+	{
+		tra_id = transaction->getPreviousID();
+		if (!tra_id)
+			tra_id = transaction->getTransactionID();
+
+		bool registered;
+		{
+			ReadLockGuard lock(transactionsLock, FB_FUNCTION);
+			TransactionsTree::Accessor accessor(&transactions);
+			registered = accessor.locate(tra_id);
+		}
+
+		if (!registered)
+			register_transaction(transaction);
+	}
+
+	const AttNumber conn_id = connection->getConnectionID();
+	if (!conn_id)
+		return false;
+
+	bool registered;
+	{
+		ReadLockGuard lock(connectionsLock, FB_FUNCTION);
+		ConnectionsTree::Accessor accessor(&connections);
+		registered = accessor.locate(conn_id);
+	}
+
+	if (!registered)
+		register_connection(connection);
+
+	// Variable parts are formatted only when present
+
+	string params, tables;
+
+	ITraceParams* inputs = statement->getInputs();
+	if (inputs && inputs->getCount())
+	{
+		record.append(NEWLINE);
+		appendParams(inputs);
+		record.append(NEWLINE);
+		params = record;
+		record = "";
+	}
+
+	appendTableCounts(info);
+	tables = record;
+	record = "";
+
+	TraceBinary::StatementFinishRecord rec;
+	rec.connectionId = conn_id;
+	rec.transactionId = tra_id;
+	rec.statementId = stmt_id;
+	rec.time = info->pin_time;
+	rec.recordsFetched = info->pin_records_fetched;
+	rec.reads = info->pin_counters[PerformanceInfo::READS];
+	rec.writes = info->pin_counters[PerformanceInfo::WRITES];
+	rec.fetches = info->pin_counters[PerformanceInfo::FETCHES];
+	rec.marks = info->pin_counters[PerformanceInfo::MARKS];
+	rec.result = req_result;
+	rec.paramsLength = params.length();
+	rec.tablesLength = tables.length();
+	rec.reserved = 0;
+
+	logBinary(TraceBinary::REC_STATEMENT_FINISH, &rec, sizeof(rec), &params, &tables);
+	return true;
+}
+
+
 void TracePluginImpl::register_blr_statement(ITraceBLRStatement* statement)
 {
 	string* description = FB_NEW_POOL(*getDefaultMemoryPool()) string(*getDefaultMemoryPool());
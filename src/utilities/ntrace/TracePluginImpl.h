@@ -31,6 +31,7 @@
 
 #include "firebird.h"
 #include "../../jrd/ntrace.h"
+#include "../../jrd/trace/TraceBinary.h"
 #include "TracePluginConfig.h"
 #include "../../common/SimilarToRegex.h"
 #include "../../common/classes/rwlock.h"
@@ -202,6 +203,16 @@ private:
 	void logRecordServ(const char* action, Firebird::ITraceServiceConnection* service);
 	void logRecordError(const char* action, Firebird::ITraceConnection* connection, Firebird::ITraceStatusVector* status);
 
+	// Write binary records (binary_format = true)
+	void writeLog(const void* buf, FB_SIZE_T size);
+	void logBinary(Jrd::TraceBinary::RecordType type, const void* data, ULONG length,
+		const Firebird::string* text1 = NULL, const Firebird::string* text2 = NULL);
+	void logDescription(Jrd::TraceBinary::DescriptionKind kind, SINT64 id,
+		const Firebird::string& description);
+	bool logStatementFinish(Firebird::ITraceDatabaseConnection* connection,
+		Firebird::ITraceTransaction* transaction, Firebird::ITraceSQLStatement* statement,
+		const Firebird::PerformanceInfo* info, unsigned req_result);
+
 	/* Methods which do logging of events to file */
 	void log_init();
 	void log_finalize();
@@ -3515,7 +3515,10 @@ static void blr_print_verb(gds_ctl* control, SSHORT level)
 				"privs",
 				"in_params",
 				"in_params2",
-				"out_params"
+				"out_params",
+				"role",
+				"in_excess",
+				"data_srcs"
 			};
 
 			int inputs = 0;
@@ -3584,6 +3587,20 @@ static void blr_print_verb(gds_ctl* control, SSHORT level)
 					level--;
 				break;
 
+				case blr_exec_stmt_data_srcs:
+				{
+					int count = blr_print_word(control);
+					offset = blr_print_line(control, offset);
+					level++;
+					while (count--)
+					{
+						blr_print_verb(control, level);
+						offset = blr_print_line(control, offset);
+					}
+					level--;
+				}
+				break;
+
 				case blr_exec_stmt_out_params:
 					offset = blr_print_line(control, offset);
 					level++;